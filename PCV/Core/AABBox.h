@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Maths/OEMaths.h"
+
+#include <limits>
+
+namespace PCV
+{
+
+/**
+ * @brief An axis-aligned bounding box
+ */
+struct AABBox
+{
+    AABBox()
+        : min(std::numeric_limits<float>::max())
+        , max(std::numeric_limits<float>::lowest())
+    {
+    }
+
+    AABBox(const OEMaths::vec3f& minBound, const OEMaths::vec3f& maxBound)
+        : min(minBound), max(maxBound)
+    {
+    }
+
+    void extend(const float x, const float y, const float z)
+    {
+        min.x = x < min.x ? x : min.x;
+        min.y = y < min.y ? y : min.y;
+        min.z = z < min.z ? z : min.z;
+        max.x = x > max.x ? x : max.x;
+        max.y = y > max.y ? y : max.y;
+        max.z = z > max.z ? z : max.z;
+    }
+
+    void extend(const AABBox& other)
+    {
+        extend(other.min.x, other.min.y, other.min.z);
+        extend(other.max.x, other.max.y, other.max.z);
+    }
+
+    bool isValid() const
+    {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    OEMaths::vec3f getCentre() const
+    {
+        return OEMaths::vec3f {
+            (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+    }
+
+    OEMaths::vec3f min;
+    OEMaths::vec3f max;
+};
+
+} // namespace PCV
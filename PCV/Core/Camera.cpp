@@ -74,6 +74,11 @@ OEMaths::mat4f Camera::getMvpMatrix()
     return currentProj * currentView * currentModel;
 }
 
+OEMaths::mat4f Camera::getViewProjMatrix()
+{
+    return currentProj * currentView;
+}
+
 float Camera::getZNear() const
 {
     return zNear;
@@ -94,6 +99,11 @@ OEMaths::vec3f& Camera::getPos()
     return position;
 }
 
+const OEMaths::vec3f& Camera::getFrontVec() const
+{
+    return frontVec;
+}
+
 OEMaths::mat4f& Camera::getProjMatrix()
 {
     return currentProj;
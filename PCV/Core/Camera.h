@@ -18,6 +18,12 @@ public:
 		None
 	};
 
+	enum class CameraType
+	{
+		FirstPerson,
+		ThirdPerson
+	};
+
 	/**
 	 * @brief The uniform buffer used by the shaders. This is updated via the **updateFrame** function.
 	*/
@@ -40,6 +46,9 @@ public:
 
 	OEMaths::mat4f getMvpMatrix();
 
+	/// the projection matrix multiplied by the view matrix - the frustum is extracted from this
+	OEMaths::mat4f getViewProjMatrix();
+
 	float getZNear() const;
 
 	float getZFar() const;
@@ -48,6 +57,9 @@ public:
 
 	OEMaths::vec3f& getPos();
 
+	/// the normalised view direction
+	const OEMaths::vec3f& getFrontVec() const;
+
 	OEMaths::mat4f& getProjMatrix();
 
 	OEMaths::mat4f& getViewMatrix();
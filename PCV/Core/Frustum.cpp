@@ -0,0 +1,217 @@
+#include "Frustum.h"
+
+#include "Core/PackedBounds.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace PCV
+{
+
+void Frustum::projection(const OEMaths::mat4f& viewProj)
+{
+    // the matrix is column major - gather the rows for the plane extraction
+    OEMaths::vec4f rows[4];
+    for (size_t row = 0; row < 4; ++row)
+    {
+        for (size_t col = 0; col < 4; ++col)
+        {
+            rows[row][col] = viewProj[col][row];
+        }
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        planes[Planes::Left][i] = rows[3][i] + rows[0][i];
+        planes[Planes::Right][i] = rows[3][i] - rows[0][i];
+        planes[Planes::Bottom][i] = rows[3][i] + rows[1][i];
+        planes[Planes::Top][i] = rows[3][i] - rows[1][i];
+        planes[Planes::Near][i] = rows[2][i];
+        planes[Planes::Far][i] = rows[3][i] - rows[2][i];
+    }
+
+    for (OEMaths::vec4f& plane : planes)
+    {
+        const float length =
+            std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                plane[i] /= length;
+            }
+        }
+    }
+}
+
+bool Frustum::checkBoxPlaneIntersect(const AABBox& box) const
+{
+    for (const OEMaths::vec4f& plane : planes)
+    {
+        // the corner of the box furthest along the plane normal - if this is behind the plane
+        // then the whole box is outside
+        const float x = plane.x >= 0.0f ? box.max.x : box.min.x;
+        const float y = plane.y >= 0.0f ? box.max.y : box.min.y;
+        const float z = plane.z >= 0.0f ? box.max.z : box.min.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::checkBoxPlaneIntersect(const AABBox& box, PlaneMask& mask) const
+{
+    for (size_t i = 0; i < Planes::Count; ++i)
+    {
+        if (!(mask & (1 << i)))
+        {
+            continue;
+        }
+
+        // the furthest corner along the normal decides if the box is outside, the nearest corner
+        // if it's fully inside
+        const OEMaths::vec4f& plane = planes[i];
+        const bool posX = plane.x >= 0.0f;
+        const bool posY = plane.y >= 0.0f;
+        const bool posZ = plane.z >= 0.0f;
+        const float farDist = plane.x * (posX ? box.max.x : box.min.x) +
+            plane.y * (posY ? box.max.y : box.min.y) + plane.z * (posZ ? box.max.z : box.min.z) +
+            plane.w;
+        if (farDist < 0.0f)
+        {
+            return false;
+        }
+
+        const float nearDist = plane.x * (posX ? box.min.x : box.max.x) +
+            plane.y * (posY ? box.min.y : box.max.y) + plane.z * (posZ ? box.min.z : box.max.z) +
+            plane.w;
+        if (nearDist >= 0.0f)
+        {
+            mask &= ~(1 << i);
+        }
+    }
+    return true;
+}
+
+void Frustum::checkBoxesPlaneIntersect(
+    const PackedBounds& boxes, size_t start, size_t count, uint8_t* visibleMask) const
+{
+    assert(start % 8 == 0);
+    assert(start + count <= boxes.size());
+
+    // as the planes are the same for every box, the furthest corner along each plane's normal is
+    // chosen per plane by picking the min or max arrays, rather than per box
+    const float* cornerX[Planes::Count];
+    const float* cornerY[Planes::Count];
+    const float* cornerZ[Planes::Count];
+    for (size_t i = 0; i < Planes::Count; ++i)
+    {
+        cornerX[i] = planes[i].x >= 0.0f ? boxes.maxX.data() : boxes.minX.data();
+        cornerY[i] = planes[i].y >= 0.0f ? boxes.maxY.data() : boxes.minY.data();
+        cornerZ[i] = planes[i].z >= 0.0f ? boxes.maxZ.data() : boxes.minZ.data();
+    }
+
+    const size_t end = start + count;
+    size_t idx = start;
+
+#if defined(__AVX__)
+    __m256 planeX[Planes::Count];
+    __m256 planeY[Planes::Count];
+    __m256 planeZ[Planes::Count];
+    __m256 planeW[Planes::Count];
+    for (size_t i = 0; i < Planes::Count; ++i)
+    {
+        planeX[i] = _mm256_set1_ps(planes[i].x);
+        planeY[i] = _mm256_set1_ps(planes[i].y);
+        planeZ[i] = _mm256_set1_ps(planes[i].z);
+        planeW[i] = _mm256_set1_ps(planes[i].w);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    for (; idx + 8 <= end; idx += 8)
+    {
+        // the lanes of boxes behind any of the planes - all six planes are tested, as branching
+        // once every box of the eight is rejected rarely pays off
+        __m256 outside = zero;
+        for (size_t i = 0; i < Planes::Count; ++i)
+        {
+            const __m256 x = _mm256_loadu_ps(cornerX[i] + idx);
+            const __m256 y = _mm256_loadu_ps(cornerY[i] + idx);
+            const __m256 z = _mm256_loadu_ps(cornerZ[i] + idx);
+            __m256 dist = _mm256_mul_ps(planeX[i], x);
+            dist = _mm256_add_ps(dist, _mm256_mul_ps(planeY[i], y));
+            dist = _mm256_add_ps(dist, _mm256_mul_ps(planeZ[i], z));
+            dist = _mm256_add_ps(dist, planeW[i]);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+        }
+        visibleMask[idx / 8] = static_cast<uint8_t>(~_mm256_movemask_ps(outside));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    // as above, with each group of eight as two halves of four so the mask is written a byte at a
+    // time
+    __m128 planeX[Planes::Count];
+    __m128 planeY[Planes::Count];
+    __m128 planeZ[Planes::Count];
+    __m128 planeW[Planes::Count];
+    for (size_t i = 0; i < Planes::Count; ++i)
+    {
+        planeX[i] = _mm_set1_ps(planes[i].x);
+        planeY[i] = _mm_set1_ps(planes[i].y);
+        planeZ[i] = _mm_set1_ps(planes[i].z);
+        planeW[i] = _mm_set1_ps(planes[i].w);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    for (; idx + 8 <= end; idx += 8)
+    {
+        __m128 outsideLo = zero;
+        __m128 outsideHi = zero;
+        for (size_t i = 0; i < Planes::Count; ++i)
+        {
+            const size_t hi = idx + 4;
+            __m128 distLo = _mm_mul_ps(planeX[i], _mm_loadu_ps(cornerX[i] + idx));
+            __m128 distHi = _mm_mul_ps(planeX[i], _mm_loadu_ps(cornerX[i] + hi));
+            distLo = _mm_add_ps(distLo, _mm_mul_ps(planeY[i], _mm_loadu_ps(cornerY[i] + idx)));
+            distHi = _mm_add_ps(distHi, _mm_mul_ps(planeY[i], _mm_loadu_ps(cornerY[i] + hi)));
+            distLo = _mm_add_ps(distLo, _mm_mul_ps(planeZ[i], _mm_loadu_ps(cornerZ[i] + idx)));
+            distHi = _mm_add_ps(distHi, _mm_mul_ps(planeZ[i], _mm_loadu_ps(cornerZ[i] + hi)));
+            distLo = _mm_add_ps(distLo, planeW[i]);
+            distHi = _mm_add_ps(distHi, planeW[i]);
+            outsideLo = _mm_or_ps(outsideLo, _mm_cmplt_ps(distLo, zero));
+            outsideHi = _mm_or_ps(outsideHi, _mm_cmplt_ps(distHi, zero));
+        }
+        const int outside = _mm_movemask_ps(outsideLo) | (_mm_movemask_ps(outsideHi) << 4);
+        visibleMask[idx / 8] = static_cast<uint8_t>(~outside);
+    }
+#endif
+
+    // the tail, or all the boxes without SIMD
+    for (; idx < end; idx += 8)
+    {
+        uint8_t mask = 0;
+        const size_t groupEnd = std::min(idx + 8, end);
+        for (size_t box = idx; box < groupEnd; ++box)
+        {
+            bool inside = true;
+            for (size_t i = 0; i < Planes::Count; ++i)
+            {
+                const float dist = planes[i].x * cornerX[i][box] + planes[i].y * cornerY[i][box] +
+                    planes[i].z * cornerZ[i][box] + planes[i].w;
+                inside &= !(dist < 0.0f);
+            }
+            mask |= static_cast<uint8_t>(inside) << (box - idx);
+        }
+        visibleMask[idx / 8] = mask;
+    }
+}
+
+} // namespace PCV
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Core/AABBox.h"
+
+#include "Maths/OEMaths.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PCV
+{
+struct PackedBounds;
+
+/**
+ * @brief The six planes of a view frustum, extracted from a view-projection matrix. Used for
+ * culling bounding boxes against the camera view.
+ */
+class Frustum
+{
+public:
+    enum Planes
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        Count
+    };
+
+    /// a bit per plane, set for the planes a box still needs testing against
+    using PlaneMask = uint8_t;
+    static constexpr PlaneMask AllPlanes = (1 << Planes::Count) - 1;
+
+    Frustum() = default;
+
+    /**
+     * @brief Extracts the frustum planes from the combined view-projection matrix. The planes
+     * are normalised and point inwards. Assumes the Vulkan clip space depth range of [0, 1].
+     */
+    void projection(const OEMaths::mat4f& viewProj);
+
+    /// returns true if the box is inside or intersects the frustum
+    bool checkBoxPlaneIntersect(const AABBox& box) const;
+
+    /**
+     * @brief As above, but only tests the planes set in the mask - used when culling a hierarchy,
+     * where a box contained by its parent can't cross the planes the parent is fully inside of.
+     * @param mask On input the planes to test. On output the planes the box crosses, so zero once
+     * the box is fully inside the frustum and its children need no testing at all
+     */
+    bool checkBoxPlaneIntersect(const AABBox& box, PlaneMask& mask) const;
+
+    /**
+     * @brief Culls the boxes [start, start + count), with the same test as
+     * **checkBoxPlaneIntersect**, eight boxes at a time with AVX or four with SSE. Bit (i % 8) of
+     * visibleMask[i / 8] is set if box i is inside or intersects the frustum - the bytes covering
+     * the range are overwritten, with any bits past the range cleared.
+     * @param start Must be a multiple of eight, so ranges culled in parallel write separate bytes
+     */
+    void checkBoxesPlaneIntersect(
+        const PackedBounds& boxes, size_t start, size_t count, uint8_t* visibleMask) const;
+
+    const OEMaths::vec4f& getPlane(const Planes plane) const
+    {
+        return planes[plane];
+    }
+
+private:
+    /// xyz holds the plane normal and w the distance from the origin
+    OEMaths::vec4f planes[Planes::Count];
+};
+
+} // namespace PCV
@@ -0,0 +1,221 @@
+#include "MortonSort.h"
+
+#include "Core/PointCloud.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/RadixSort.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace PCV
+{
+
+namespace
+{
+
+constexpr uint32_t MaxQuantised = (1u << MortonBitsPerAxis) - 1;
+
+/// spreads the lower 21 bits so there are two zero bits between each bit
+inline uint64_t expandBits(uint64_t value)
+{
+    value &= 0x1fffff;
+    value = (value | value << 32) & 0x1f00000000ffff;
+    value = (value | value << 16) & 0x1f0000ff0000ff;
+    value = (value | value << 8) & 0x100f00f00f00f00f;
+    value = (value | value << 4) & 0x10c30c30c30c30c3;
+    value = (value | value << 2) & 0x1249249249249249;
+    return value;
+}
+
+inline uint32_t quantise(const float value, const float min, const float scale)
+{
+    const float q = (value - min) * scale;
+    return static_cast<uint32_t>(std::min(std::max(q, 0.0f), static_cast<float>(MaxQuantised)));
+}
+
+#if defined(__AVX2__)
+
+inline __m256i expandBits(__m256i value)
+{
+    value = _mm256_and_si256(value, _mm256_set1_epi64x(0x1fffff));
+    value = _mm256_and_si256(
+        _mm256_or_si256(value, _mm256_slli_epi64(value, 32)), _mm256_set1_epi64x(0x1f00000000ffff));
+    value = _mm256_and_si256(
+        _mm256_or_si256(value, _mm256_slli_epi64(value, 16)), _mm256_set1_epi64x(0x1f0000ff0000ff));
+    value = _mm256_and_si256(
+        _mm256_or_si256(value, _mm256_slli_epi64(value, 8)),
+        _mm256_set1_epi64x(0x100f00f00f00f00f));
+    value = _mm256_and_si256(
+        _mm256_or_si256(value, _mm256_slli_epi64(value, 4)),
+        _mm256_set1_epi64x(0x10c30c30c30c30c3));
+    value = _mm256_and_si256(
+        _mm256_or_si256(value, _mm256_slli_epi64(value, 2)),
+        _mm256_set1_epi64x(0x1249249249249249));
+    return value;
+}
+
+inline __m256i quantise(const __m256 value, const __m256 min, const __m256 scale)
+{
+    const __m256 q = _mm256_mul_ps(_mm256_sub_ps(value, min), scale);
+    const __m256 clamped = _mm256_min_ps(
+        _mm256_max_ps(q, _mm256_setzero_ps()), _mm256_set1_ps(static_cast<float>(MaxQuantised)));
+    return _mm256_cvttps_epi32(clamped);
+}
+
+/// the codes of eight points - the quantised values are widened to 64 bits four at a time
+inline void encodeMorton8(
+    const float* x, const float* y, const float* z, const __m256 min[3], const __m256 scale,
+    uint64_t* codes)
+{
+    const __m256i qx = quantise(_mm256_loadu_ps(x), min[0], scale);
+    const __m256i qy = quantise(_mm256_loadu_ps(y), min[1], scale);
+    const __m256i qz = quantise(_mm256_loadu_ps(z), min[2], scale);
+
+    auto encode = [](const __m128i ix, const __m128i iy, const __m128i iz) {
+        const __m256i ex = expandBits(_mm256_cvtepu32_epi64(ix));
+        const __m256i ey = expandBits(_mm256_cvtepu32_epi64(iy));
+        const __m256i ez = expandBits(_mm256_cvtepu32_epi64(iz));
+        return _mm256_or_si256(
+            ex, _mm256_or_si256(_mm256_slli_epi64(ey, 1), _mm256_slli_epi64(ez, 2)));
+    };
+
+    const __m256i low = encode(
+        _mm256_castsi256_si128(qx), _mm256_castsi256_si128(qy), _mm256_castsi256_si128(qz));
+    const __m256i high = encode(
+        _mm256_extracti128_si256(qx, 1),
+        _mm256_extracti128_si256(qy, 1),
+        _mm256_extracti128_si256(qz, 1));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(codes), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(codes + 4), high);
+}
+
+#endif
+
+/// gathers the attribute into a new array in the sorted order
+template <typename T>
+void permute(
+    Util::StridedView<T>& view,
+    std::vector<T>& storage,
+    const std::vector<uint32_t>& order,
+    const size_t threadCount)
+{
+    if (view.empty())
+    {
+        return;
+    }
+
+    std::vector<T> sorted(order.size());
+    auto gather = [&](const size_t start, const size_t count) {
+        for (size_t i = start; i < start + count; ++i)
+        {
+            sorted[i] = view[order[i]];
+        }
+    };
+    ThreadTaskSplitter split {0, order.size(), gather, threadCount};
+    split.run();
+
+    storage.swap(sorted);
+}
+
+} // namespace
+
+void computeMortonCodes(
+    const Util::StridedView<float>& x,
+    const Util::StridedView<float>& y,
+    const Util::StridedView<float>& z,
+    const AABBox& bounds,
+    uint64_t* codes,
+    const size_t threadCount)
+{
+    assert(x.size() == y.size() && x.size() == z.size());
+
+    const OEMaths::vec3f extent = bounds.max - bounds.min;
+    const float size = std::max(extent.x, std::max(extent.y, extent.z));
+    const float scale = size > 0.0f ? static_cast<float>(MaxQuantised) / size : 0.0f;
+
+    auto encodeRange = [&](const size_t start, const size_t count) {
+        size_t i = start;
+        const size_t end = start + count;
+
+#if defined(__AVX2__)
+        if (x.isContiguous() && y.isContiguous() && z.isContiguous())
+        {
+            const __m256 min[3] = {
+                _mm256_set1_ps(bounds.min.x),
+                _mm256_set1_ps(bounds.min.y),
+                _mm256_set1_ps(bounds.min.z)};
+            const __m256 vScale = _mm256_set1_ps(scale);
+            for (; i + 8 <= end; i += 8)
+            {
+                encodeMorton8(x.ptr() + i, y.ptr() + i, z.ptr() + i, min, vScale, codes + i);
+            }
+        }
+#endif
+
+        for (; i < end; ++i)
+        {
+            codes[i] = expandBits(quantise(x[i], bounds.min.x, scale)) |
+                expandBits(quantise(y[i], bounds.min.y, scale)) << 1 |
+                expandBits(quantise(z[i], bounds.min.z, scale)) << 2;
+        }
+    };
+
+    ThreadTaskSplitter split {0, x.size(), encodeRange, threadCount};
+    split.run();
+}
+
+void getMortonOrder(
+    const Util::StridedView<float>& x,
+    const Util::StridedView<float>& y,
+    const Util::StridedView<float>& z,
+    const AABBox& bounds,
+    std::vector<uint32_t>& order,
+    const size_t threadCount)
+{
+    const size_t count = x.size();
+    assert(count <= UINT32_MAX);
+
+    std::vector<uint64_t> codes(count);
+    computeMortonCodes(x, y, z, bounds, codes.data(), threadCount);
+
+    order.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    Util::radixSort(codes.data(), order.data(), count, threadCount);
+}
+
+void sortPointsMorton(PointCloud& cloud, const size_t threadCount)
+{
+    if (cloud.size() < 2 || !cloud.hasAttribute(PointCloud::AttributeFlags::Position))
+    {
+        return;
+    }
+    if (!cloud.getBounds().isValid())
+    {
+        cloud.computeBounds();
+    }
+
+    std::vector<uint32_t> order;
+    getMortonOrder(cloud.posX, cloud.posY, cloud.posZ, cloud.getBounds(), order, threadCount);
+
+    // the attributes are gathered from the views into new arrays, which replace the storage
+    cloud.materialise();
+    PointCloud::Storage& storage = cloud.storage;
+    permute(cloud.posX, storage.posX, order, threadCount);
+    permute(cloud.posY, storage.posY, order, threadCount);
+    permute(cloud.posZ, storage.posZ, order, threadCount);
+    permute(cloud.red, storage.red, order, threadCount);
+    permute(cloud.green, storage.green, order, threadCount);
+    permute(cloud.blue, storage.blue, order, threadCount);
+    permute(cloud.intensity, storage.intensity, order, threadCount);
+    permute(cloud.classification, storage.classification, order, threadCount);
+
+    cloud.bindStorage();
+}
+
+} // namespace PCV
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Core/AABBox.h"
+#include "Utility/StridedView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/// the number of bits each axis is quantised to - three axes fit within a 64-bit code
+constexpr uint32_t MortonBitsPerAxis = 21;
+
+/**
+ * @brief Quantises the positions to a 21-bit grid over the bounds and interleaves the bits of
+ * each axis into a morton code. The grid is cubic, using the largest extent of the bounds, so
+ * the curve follows the shape of the cloud. Runs in parallel, and uses AVX2 when available and
+ * the positions are tightly packed.
+ * @param codes Receives a code for each point - must hold **x.size()** elements
+ */
+void computeMortonCodes(
+    const Util::StridedView<float>& x,
+    const Util::StridedView<float>& y,
+    const Util::StridedView<float>& z,
+    const AABBox& bounds,
+    uint64_t* codes,
+    const size_t threadCount = 0);
+
+/**
+ * @brief Calculates the permutation which sorts the points into morton order.
+ * @param order Receives the index of the source point for each position in the sorted order
+ */
+void getMortonOrder(
+    const Util::StridedView<float>& x,
+    const Util::StridedView<float>& y,
+    const Util::StridedView<float>& z,
+    const AABBox& bounds,
+    std::vector<uint32_t>& order,
+    const size_t threadCount = 0);
+
+/**
+ * @brief Reorders all attributes of the cloud into morton order, which keeps points that are
+ * close in space close in memory. This improves the cache behaviour of anything which walks the
+ * points spatially and the vertex fetch efficiency on the GPU. Mapped clouds are materialised.
+ */
+void sortPointsMorton(PointCloud& cloud, const size_t threadCount = 0);
+
+} // namespace PCV
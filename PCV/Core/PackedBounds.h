@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Core/AABBox.h"
+
+#include <cassert>
+#include <vector>
+
+namespace PCV
+{
+
+/**
+ * @brief The bounds of many boxes stored as separate arrays per component (SoA), so they can be
+ * loaded several boxes at a time for culling rather than one box per pointer.
+ */
+struct PackedBounds
+{
+    void resize(const size_t count)
+    {
+        minX.resize(count);
+        minY.resize(count);
+        minZ.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+        maxZ.resize(count);
+    }
+
+    void clear()
+    {
+        resize(0);
+    }
+
+    void set(const size_t idx, const AABBox& box)
+    {
+        assert(idx < size());
+        minX[idx] = box.min.x;
+        minY[idx] = box.min.y;
+        minZ[idx] = box.min.z;
+        maxX[idx] = box.max.x;
+        maxY[idx] = box.max.y;
+        maxZ[idx] = box.max.z;
+    }
+
+    void add(const AABBox& box)
+    {
+        resize(size() + 1);
+        set(size() - 1, box);
+    }
+
+    size_t size() const
+    {
+        return minX.size();
+    }
+
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+};
+
+} // namespace PCV
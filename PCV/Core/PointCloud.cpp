@@ -0,0 +1,156 @@
+#include "PointCloud.h"
+
+#include "Maths/BatchTransform.h"
+#include "Utility/MappedFile.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace PCV
+{
+
+PointCloud::~PointCloud()
+{
+}
+
+void PointCloud::allocate(size_t count, uint32_t attributes)
+{
+    pointCount = count;
+    attributeFlags = attributes;
+
+    if (attributes & AttributeFlags::Position)
+    {
+        storage.posX.resize(count);
+        storage.posY.resize(count);
+        storage.posZ.resize(count);
+    }
+    if (attributes & AttributeFlags::Colour)
+    {
+        storage.red.resize(count);
+        storage.green.resize(count);
+        storage.blue.resize(count);
+    }
+    if (attributes & AttributeFlags::Intensity)
+    {
+        storage.intensity.resize(count);
+    }
+    if (attributes & AttributeFlags::Classification)
+    {
+        storage.classification.resize(count);
+    }
+
+    bindStorage();
+}
+
+void PointCloud::resize(size_t count)
+{
+    assert(!source);
+    allocate(count, attributeFlags);
+}
+
+void PointCloud::bindStorage()
+{
+    if (attributeFlags & AttributeFlags::Position)
+    {
+        posX = {storage.posX.data(), pointCount};
+        posY = {storage.posY.data(), pointCount};
+        posZ = {storage.posZ.data(), pointCount};
+    }
+    if (attributeFlags & AttributeFlags::Colour)
+    {
+        red = {storage.red.data(), pointCount};
+        green = {storage.green.data(), pointCount};
+        blue = {storage.blue.data(), pointCount};
+    }
+    if (attributeFlags & AttributeFlags::Intensity)
+    {
+        intensity = {storage.intensity.data(), pointCount};
+    }
+    if (attributeFlags & AttributeFlags::Classification)
+    {
+        classification = {storage.classification.data(), pointCount};
+    }
+}
+
+void PointCloud::setSource(std::shared_ptr<Util::MappedFile> file, size_t count)
+{
+    source = std::move(file);
+    pointCount = count;
+}
+
+void PointCloud::materialise()
+{
+    if (!source)
+    {
+        return;
+    }
+
+    // copy each view into owned storage - views which already point at the owned storage (i.e.
+    // attributes that had to be converted on load) are left alone
+    auto copyView = [this](auto& view, auto& dst) {
+        if (view.empty() || view.getBase() == reinterpret_cast<const uint8_t*>(dst.data()))
+        {
+            return;
+        }
+        dst.resize(pointCount);
+        view.copyTo(dst.data(), 0, pointCount);
+    };
+
+    copyView(posX, storage.posX);
+    copyView(posY, storage.posY);
+    copyView(posZ, storage.posZ);
+    copyView(red, storage.red);
+    copyView(green, storage.green);
+    copyView(blue, storage.blue);
+    copyView(intensity, storage.intensity);
+    copyView(classification, storage.classification);
+
+    bindStorage();
+
+    // the file is no longer referenced
+    source.reset();
+}
+
+void PointCloud::computeBounds()
+{
+    bounds = AABBox {};
+    if (posX.isContiguous() && posY.isContiguous() && posZ.isContiguous())
+    {
+        OEMaths::computeBounds(
+            posX.ptr(), posY.ptr(), posZ.ptr(), pointCount, bounds.min, bounds.max);
+        return;
+    }
+
+    // strided or byte swapped positions are unpacked a block at a time
+    constexpr size_t BlockSize = 1024;
+    float block[3][BlockSize];
+    for (size_t start = 0; start < pointCount; start += BlockSize)
+    {
+        const size_t count = std::min(BlockSize, pointCount - start);
+        posX.copyTo(block[0], start, count);
+        posY.copyTo(block[1], start, count);
+        posZ.copyTo(block[2], start, count);
+        OEMaths::computeBounds(block[0], block[1], block[2], count, bounds.min, bounds.max);
+    }
+}
+
+void PointCloud::transform(const OEMaths::mat4f& mat)
+{
+    assert(hasAttribute(AttributeFlags::Position));
+    materialise();
+
+    bounds = AABBox {};
+    OEMaths::transformPoints(
+        mat,
+        storage.posX.data(),
+        storage.posY.data(),
+        storage.posZ.data(),
+        pointCount,
+        storage.posX.data(),
+        storage.posY.data(),
+        storage.posZ.data(),
+        &bounds.min,
+        &bounds.max);
+}
+
+} // namespace PCV
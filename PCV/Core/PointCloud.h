@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Core/AABBox.h"
+#include "Utility/StridedView.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+
+/**
+ * @brief A point cloud stored as separate attribute arrays (SoA). Each attribute is exposed as a
+ * strided view which either points at the storage owned by this object or directly into the file
+ * the cloud was loaded from, in which case the mapped file is kept alive by the cloud.
+ */
+class PointCloud
+{
+public:
+    enum AttributeFlags : uint32_t
+    {
+        Position = 1 << 0,
+        Colour = 1 << 1,
+        Intensity = 1 << 2,
+        Classification = 1 << 3
+    };
+
+    /**
+     * @brief The attribute arrays owned by this cloud. Loaders which have to decode the data
+     * write directly into these arrays after calling **allocate**.
+     */
+    struct Storage
+    {
+        std::vector<float> posX;
+        std::vector<float> posY;
+        std::vector<float> posZ;
+        std::vector<uint8_t> red;
+        std::vector<uint8_t> green;
+        std::vector<uint8_t> blue;
+        std::vector<uint16_t> intensity;
+        std::vector<uint8_t> classification;
+    };
+
+    PointCloud() = default;
+    ~PointCloud();
+
+    // not copyable
+    PointCloud(const PointCloud&) = delete;
+    PointCloud& operator=(const PointCloud&) = delete;
+
+    /**
+     * @brief Allocates owned storage for the requested attributes and binds the views to it.
+     * Any previously bound views are replaced.
+     * @param count The number of points
+     * @param attributes A combination of **AttributeFlags**
+     */
+    void allocate(size_t count, uint32_t attributes);
+
+    /**
+     * @brief Resizes the owned storage of all allocated attributes and rebinds the views. Used by
+     * loaders which over-allocate before the exact number of points is known.
+     */
+    void resize(size_t count);
+
+    /**
+     * @brief Rebinds the views of all allocated attributes to the owned storage. Must be called
+     * if the storage arrays are resized or swapped after allocation.
+     */
+    void bindStorage();
+
+    /**
+     * @brief Sets the memory mapped file that the views reference. The file will be kept open for
+     * the lifetime of this cloud or until **materialise** is called.
+     */
+    void setSource(std::shared_ptr<Util::MappedFile> file, size_t count);
+
+    /**
+     * @brief Copies all attributes that reference the source file into owned storage. This is
+     * required before any operation which reorders or modifies the points.
+     */
+    void materialise();
+
+    /// calculates the bounds from the position attribute
+    void computeBounds();
+
+    /**
+     * @brief Transforms the positions in place by an affine matrix and recalculates the bounds in
+     * the same pass. A mapped cloud is materialised first.
+     */
+    void transform(const OEMaths::mat4f& mat);
+
+    size_t size() const
+    {
+        return pointCount;
+    }
+
+    bool hasAttribute(const AttributeFlags flag) const
+    {
+        return attributeFlags & flag;
+    }
+
+    void addAttribute(const AttributeFlags flag)
+    {
+        attributeFlags |= flag;
+    }
+
+    bool isMapped() const
+    {
+        return source != nullptr;
+    }
+
+    const AABBox& getBounds() const
+    {
+        return bounds;
+    }
+
+    /// sets the bounds directly, i.e. when known from the file header
+    void setBounds(const AABBox& box)
+    {
+        bounds = box;
+    }
+
+    const OEMaths::vec3d& getOrigin() const
+    {
+        return origin;
+    }
+
+    /**
+     * @brief Sets the origin which the positions are relative to. Large world coordinates (i.e.
+     * UTM) would lose most of their precision if stored as floats, so loaders rebase positions to
+     * an origin close to the cloud.
+     */
+    void setOrigin(const OEMaths::vec3d& org)
+    {
+        origin = org;
+    }
+
+public:
+    // ============= attribute views =====================
+    Util::StridedView<float> posX;
+    Util::StridedView<float> posY;
+    Util::StridedView<float> posZ;
+    Util::StridedView<uint8_t> red;
+    Util::StridedView<uint8_t> green;
+    Util::StridedView<uint8_t> blue;
+    Util::StridedView<uint16_t> intensity;
+    Util::StridedView<uint8_t> classification;
+
+    /// the owned attribute arrays - only valid for attributes which have been allocated
+    Storage storage;
+
+private:
+    size_t pointCount = 0;
+
+    uint32_t attributeFlags = 0;
+
+    /// the bounds of the cloud in local space
+    AABBox bounds;
+
+    /// the world space position that the local positions are relative to
+    OEMaths::vec3d origin;
+
+    /// the file which the views point into if this cloud was loaded without copying
+    std::shared_ptr<Util::MappedFile> source;
+};
+
+} // namespace PCV
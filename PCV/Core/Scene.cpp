@@ -2,6 +2,17 @@
 
 #include "Core/Camera.h"
 #include "Core/Engine.h"
+#include "Core/Frustum.h"
+#include "Core/MortonSort.h"
+#include "Core/PointCloud.h"
+#include "Loaders/PointLoader.h"
+#include "Octree/OctreeFile.h"
+#include "Rendering/SoftRasteriser.h"
+#include "Threading/JobSystem.h"
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
 
 namespace PCV
 {
@@ -19,23 +30,38 @@ Scene::~Scene()
 void Scene::getVisibleRenderables(
     Frustum& frustum, std::vector<OEScene::VisibleCandidate>& renderables)
 {
-    size_t workSize = renderables.size();
+    const size_t workSize = renderables.size();
+    candidateBounds.resize(workSize);
+    visibleMask.resize((workSize + 7) / 8);
+
+    // the work is split into groups of eight candidates, each group is culled in one pass and
+    // writes a single byte of the mask
+    auto visibilityCheck = [&frustum, &renderables, this, workSize](
+                               const size_t firstGroup, const size_t groupCount) {
+        const size_t start = firstGroup * 8;
+        const size_t end = std::min(start + groupCount * 8, workSize);
+
+        // gather the bounds into the packed arrays so they can be culled eight at a time
+        for (size_t idx = start; idx < end; ++idx)
+        {
+            const Renderable* rend = renderables[idx].renderable;
+            candidateBounds.set(
+                idx, AABBox {rend->instance->dimensions.min, rend->instance->dimensions.max});
+        }
+        frustum.checkBoxesPlaneIntersect(candidateBounds, start, end - start, visibleMask.data());
 
-    auto visibilityCheck = [&frustum, &renderables](const size_t curr_idx, const size_t chunkSize) {
-        assert(curr_idx + chunkSize <= renderables.size());
-        for (size_t idx = curr_idx; idx < curr_idx + chunkSize; ++idx)
+        for (size_t idx = start; idx < end; ++idx)
         {
-            Renderable* rend = renderables[idx].renderable;
-            AABBox box {rend->instance->dimensions.min, rend->instance->dimensions.max};
-            if (frustum.checkBoxPlaneIntersect(box))
+            if (visibleMask[idx / 8] & (1 << (idx % 8)))
             {
-                rend->visibility |= Renderable::Visible::Render;
+                renderables[idx].renderable->visibility |= Renderable::Visible::Render;
             }
         }
     };
 
-    ThreadTaskSplitter splitWork {0, workSize, visibilityCheck};
-    splitWork.run();
+    // the cost varies with the number of candidates rejected, so the range is split lazily across
+    // the job system's workers
+    engine.getJobSystem().parallelFor(0, visibleMask.size(), visibilityCheck);
 }
 
 bool Scene::update(const double time)
@@ -103,7 +129,7 @@ bool Scene::update(const double time)
     // update the camera matrices before constructing the fustrum
     Frustum frustum;
     camera->updateViewMatrix();
-    frustum.projection(camera->getViewMatrix() * camera->getProjMatrix());
+    frustum.projection(camera->getViewProjMatrix());
 
     // ============ visibility checks and culling ===================
     // first renderables - split work tasks and run async - Sets the visibility bit if passes
@@ -116,8 +142,25 @@ bool Scene::update(const double time)
     // and prepare the visible lighting list
     getVisibleLights(frustum, candLightObjs);
 
+    // ============ octree LOD selection and streaming ===============
+    // the nodes are selected by their screen space error up to the point budget, and requested
+    // from the streamer in priority order - nodes no longer selected are evicted once the GPU
+    // budget is reached. The octree nodes are culled hierarchically during the selection, so they
+    // aren't part of the flat candidate culling above - the nodes and planes tested are reported
+    // in the LOD stats
+    if (streamer)
+    {
+        std::vector<uint32_t> selectedNodes;
+        selectOctreeNodes(frustum, selectedNodes);
+        streamer->update(selectedNodes);
+    }
+
     // ============ render queue generation =========================
-    std::vector<RenderableQueueInfo> queueRend;
+    // built in the queue's free frame slot, so the renderer can still be reading the last frame
+    renderQueue.beginFrame();
+
+    const OEMaths::vec3f& cameraPos = camera->getPos();
+    const OEMaths::vec3f& viewDir = camera->getFrontVec();
 
     // key a count of the number of static and skinned models for later
     size_t staticModelCount = 0;
@@ -149,11 +192,19 @@ bool Scene::update(const double time)
         queueInfo.renderableData = (void*) &rend;
         queueInfo.renderableHandle = this;
         queueInfo.renderFunction = GBufferFillPass::drawCallback;
+
+        // ordered front to back by the centre of the world bounds to reduce overdraw
+        const OEMaths::vec3f centre = (cand.worldAABB.min + cand.worldAABB.max) * 0.5f;
+        const float depth = RenderQueue::getViewDepth(
+            centre, cameraPos, viewDir, camera->getZNear(), camera->getZFar());
         queueInfo.sortingKey = RenderQueue::createSortKey(
-            RenderQueue::Layer::Default, rend->materialId, rend->instance->variantBits.getUint64());
-        queueRend.emplace_back(queueInfo);
+            RenderQueue::Layer::Default,
+            rend->materialId,
+            rend->instance->variantBits.getUint64(),
+            depth);
+        renderQueue.push(queueInfo, RenderQueue::Type::Colour);
     }
-    renderQueue.pushRenderables(queueRend, RenderQueue::Type::Colour);
+    renderQueue.submitFrame();
 
     // ================== update ubos =================================
     // camera buffer is updated every frame as we expect this to change a lot
@@ -167,10 +218,55 @@ bool Scene::update(const double time)
     return true;
 }
 
-void OEScene::updateCameraBuffer()
+void Scene::selectOctreeNodes(const Frustum& frustum, std::vector<uint32_t>& nodes)
+{
+    LodSelector::View view;
+    view.frustum = &frustum;
+    view.position = camera->getPos();
+    view.fov = camera->getFov();
+    view.viewportHeight = static_cast<float>(viewportHeight);
+    lodSelector.select(octrees, view, nodes, engine.getJobSystem());
+}
+
+void Scene::drawSoftware(SoftRasteriser& rasteriser)
+{
+    // the same view and LOD selection as used by update for the Vulkan renderer
+    camera->updateViewMatrix();
+    const OEMaths::mat4f viewProj = camera->getViewProjMatrix();
+    Frustum frustum;
+    frustum.projection(viewProj);
+
+    rasteriser.clear();
+    JobSystem& jobs = engine.getJobSystem();
+    if (!octrees.empty())
+    {
+        std::vector<uint32_t> selectedNodes;
+        selectOctreeNodes(frustum, selectedNodes);
+        rasteriser.drawNodes(octrees, selectedNodes, viewProj, jobs);
+    }
+    for (const std::unique_ptr<PointCloud>& cloud : pointClouds)
+    {
+        rasteriser.drawCloud(*cloud, viewProj, getWorldOffset(cloud->getOrigin()), jobs);
+    }
+}
+
+OEMaths::vec3f Scene::getWorldOffset(const OEMaths::vec3d& origin)
+{
+    if (!hasWorldOrigin)
+    {
+        worldOrigin = origin;
+        hasWorldOrigin = true;
+    }
+    return OEMaths::vec3f {
+        static_cast<float>(origin.x - worldOrigin.x),
+        static_cast<float>(origin.y - worldOrigin.y),
+        static_cast<float>(origin.z - worldOrigin.z)};
+}
+
+void Scene::updateCameraBuffer()
 {
     // update everything in the buffer
-    OECamera::Ubo ubo;
+    Camera::Ubo ubo;
     ubo.mvp = camera->getMvpMatrix();
     ubo.cameraPosition = camera->getPos();
     ubo.projection = camera->getProjMatrix();
@@ -179,7 +275,7 @@ void OEScene::updateCameraBuffer()
     ubo.zNear = camera->getZNear();
     ubo.zFar = camera->getZFar();
 
-    driver.updateUbo(cameraUboName, sizeof(OECamera::Ubo), &ubo);
+    driver.updateUbo(cameraUboName, sizeof(Camera::Ubo), &ubo);
 }
 
 void Scene::setCurrentCamera(Camera* cam)
@@ -193,5 +289,106 @@ Camera* Scene::getCurrentCamera()
     return camera;
 }
 
+PointCloud* Scene::addPointCloud(std::unique_ptr<PointCloud> cloud)
+{
+    assert(cloud);
+    // the first cloud or octree added fixes the world origin
+    getWorldOffset(cloud->getOrigin());
+    pointClouds.emplace_back(std::move(cloud));
+    return pointClouds.back().get();
+}
+
+PointCloud* Scene::loadPointCloud(const char* path, const bool spatialSort)
+{
+    LoadStats stats;
+    std::unique_ptr<PointCloud> cloud = PCV::loadPointCloud(path, stats);
+    if (!cloud)
+    {
+        return nullptr;
+    }
+
+    if (spatialSort)
+    {
+        // the copy out of a mapped file is timed separately as it isn't part of the sort
+        Util::Timer<Util::NanoSeconds> timer;
+        cloud->materialise();
+        stats.materialiseSeconds = timer.getElapsedSeconds();
+
+        timer.reset();
+        sortPointsMorton(*cloud);
+        stats.sortSeconds = timer.getElapsedSeconds();
+    }
+
+    logLoadStats(path, stats);
+    return addPointCloud(std::move(cloud));
+}
+
+bool Scene::addOctree(const char* dir)
+{
+    auto file = std::make_shared<OctreeFile>();
+    if (!file->open(dir))
+    {
+        return false;
+    }
+
+    if (!streamer)
+    {
+        // evicted buffers are kept until no frame in flight can reference them
+        streamOptions.framesInFlight = engine.getFramesInFlight();
+        streamer = std::make_unique<NodeStreamer>(engine.getVkContext(), streamOptions);
+        if (!streamer->prepare())
+        {
+            streamer.reset();
+            LOGGER_ERROR("Unable to prepare the octree node streamer.");
+            return false;
+        }
+    }
+
+    const uint32_t baseId = streamer->addOctree(file);
+    if (baseId == NodeStreamer::InvalidId)
+    {
+        LOGGER_ERROR("Unable to stream the nodes of octree %s.", dir);
+        return false;
+    }
+
+    const Octree::HierarchyHeader& header = file->getHeader();
+    LodSelector::Instance instance;
+    instance.offset =
+        getWorldOffset(OEMaths::vec3d {header.origin[0], header.origin[1], header.origin[2]});
+    instance.baseId = baseId;
+    instance.file = std::move(file);
+    octrees.emplace_back(std::move(instance));
+    return true;
+}
+
+void Scene::setStreamingBudget(const size_t bytes)
+{
+    streamOptions.gpuBudget = bytes;
+    if (streamer)
+    {
+        streamer->setGpuBudget(bytes);
+    }
+}
+
+const NodeStreamer::Stats* Scene::getStreamingStats() const
+{
+    return streamer ? &streamer->getStats() : nullptr;
+}
+
+void Scene::setPointBudget(const size_t budget)
+{
+    lodSelector.setPointBudget(budget);
+}
+
+void Scene::setViewportHeight(const uint32_t height)
+{
+    viewportHeight = height;
+}
+
+const LodSelector::Stats& Scene::getLodStats() const
+{
+    return lodSelector.getStats();
+}
+
 
 } // namespace OmegaEngine
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "Core/PackedBounds.h"
+#include "Octree/LodSelector.h"
+#include "Octree/NodeStreamer.h"
 #include "Rendering/RenderQueue.h"
 
+#include "Maths/OEMaths.h"
+
+#include <memory>
 #include <vector>
 
 namespace VulkanAPI
@@ -15,6 +21,10 @@ namespace PCV
 // forward decleartions
 class Engine;
 class Camera;
+class Frustum;
+class OctreeFile;
+class PointCloud;
+class SoftRasteriser;
 
 class Scene
 {
@@ -52,17 +62,98 @@ public:
     bool addSkybox(OESkybox* sb);
     
     void setCurrentCamera(OECamera* camera);
+
+    /**
+     * @brief Adds a point cloud to the scene. The scene takes ownership of the cloud.
+     * @return A pointer to the registered cloud
+     */
+    PointCloud* addPointCloud(std::unique_ptr<PointCloud> cloud);
+
+    /**
+     * @brief Loads a point cloud from disk and adds it to the scene. The load throughput is
+     * output to the console.
+     * @param path The path of the point cloud file - the format is determined by the extension
+     * @param spatialSort If true, the points are reordered into morton order after loading. Off
+     * by default as sorting copies mapped clouds into owned storage, losing the zero-copy load
+     * @return A pointer to the registered cloud, or nullptr if loading failed
+     */
+    PointCloud* loadPointCloud(const char* path, const bool spatialSort = false);
+
+    /**
+     * @brief Opens an octree written by pcv-convert and adds it to the scene. Only the hierarchy
+     * is loaded - the nodes are streamed in by **update** as they become visible.
+     * @param dir The directory containing the octree
+     */
+    bool addOctree(const char* dir);
+
+    /**
+     * @brief Sets the maximum bytes of octree node data kept on the GPU. Can be changed at any
+     * time - resident nodes are evicted on the next update if over the new budget.
+     */
+    void setStreamingBudget(const size_t bytes);
+
+    /// the per frame streaming counters, or nullptr if no octrees have been added
+    const NodeStreamer::Stats* getStreamingStats() const;
+
+    /**
+     * @brief Sets the maximum number of octree points selected for rendering each frame. Can
+     * be changed at any time and takes effect on the next update.
+     */
+    void setPointBudget(const size_t budget);
+
+    /// the height of the viewport in pixels, used to calculate the screen space error of nodes
+    void setViewportHeight(const uint32_t height);
+
+    /// the counters of the last LOD selection pass
+    const LodSelector::Stats& getLodStats() const;
+
+    /**
+     * @brief Draws the point clouds and octrees from the current camera with the CPU rasteriser,
+     * for rendering without a GPU. Each is placed at its origin relative to the world origin.
+     * The octree nodes are selected as for the Vulkan renderer but read directly from the mapped
+     * node data rather than streamed. The rasteriser is cleared first, its stats hold the points
+     * rasterised per second once done.
+     */
+    void drawSoftware(SoftRasteriser& rasteriser);
     
 	friend class OERenderer;
 
 private:
 
+    /// selects the octree nodes to draw from the current camera
+    void selectOctreeNodes(const Frustum& frustum, std::vector<uint32_t>& nodes);
+
+    /// the offset of an origin from the world origin - the first origin becomes the world origin
+    OEMaths::vec3f getWorldOffset(const OEMaths::vec3d& origin);
+
 	/// per frame: all the renderables after visibility checks
     RenderQueue renderQueue;
+
+    /// per frame: the bounds of the visibility candidates and a bit per candidate set if visible,
+    /// kept to avoid allocating each frame
+    PackedBounds candidateBounds;
+    std::vector<uint8_t> visibleMask;
     
 	/// Current camera used by this scene. The 'world' holds the ownership of the cma
 	Camera* camera;
 
+    /// All point clouds which have been added to this scene
+    std::vector<std::unique_ptr<PointCloud>> pointClouds;
+
+    std::vector<LodSelector::Instance> octrees;
+
+    /// cloud and octree positions are stored relative to their own origin - these are rebased
+    /// to the origin of the first one added so the world positions fit within a float
+    OEMaths::vec3d worldOrigin;
+    bool hasWorldOrigin = false;
+
+    /// created when the first octree is added
+    std::unique_ptr<NodeStreamer> streamer;
+    NodeStreamer::Options streamOptions;
+
+    LodSelector lodSelector {LodSelector::Options {}};
+    uint32_t viewportHeight = 1080;
+
 	/// The world this scene is assocaited with
 	Engine& engine;
 };
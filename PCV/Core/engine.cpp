@@ -5,12 +5,22 @@
 
 #include "Application/NativeWindowWrapper.h"
 
+#include "Vulkan/FrameRing.h"
+#include "Vulkan/OffscreenTarget.h"
 #include "Vulkan/SwapChain.h"
+#include "Vulkan/VkContext.h"
+
+#include "Threading/JobSystem.h"
+#include "Utility/Logger.h"
+
+#include <algorithm>
+#include <cassert>
 
 namespace PCV
 {
 
 Engine::Engine()
+    : jobSystem(std::make_unique<JobSystem>())
 {
 }
 
@@ -24,6 +34,14 @@ Engine::~Engine()
         }
     }
     renderers.clear();
+
+    // the targets wait for their frames in flight before releasing their resources
+    offscreenTargets.clear();
+
+    // the registry waits for any background compiles, which may still add to the cache, and the
+    // cache is then written back so the next run starts warm
+    getVkContext().pipelines.destroy();
+    getVkContext().pipelineCache.destroy();
 }
 
 bool Engine::init(OEWindowInstance* window)
@@ -41,7 +59,36 @@ bool Engine::init(OEWindowInstance* window)
         LOGGER_ERROR("Fatal Error whilst preparing vulkan device.");
         return false;
     }
-    return true;
+
+    return preparePipelines();
+}
+
+bool Engine::initHeadless()
+{
+    // no window system extensions are required without a surface
+    if (!vkDriver->createInstance(nullptr, 0))
+    {
+        LOGGER_ERROR("Fatal Error whilst creating Vulkan instance.");
+        return false;
+    }
+
+    if (!vkDriver->init(vk::SurfaceKHR {}))
+    {
+        LOGGER_ERROR("Fatal Error whilst preparing headless vulkan device.");
+        return false;
+    }
+
+    return preparePipelines();
+}
+
+bool Engine::preparePipelines()
+{
+    VulkanAPI::VkContext& context = vkDriver->getContext();
+    if (!context.pipelineCache.prepare(context.device, context.physical, pipelineCacheDir))
+    {
+        return false;
+    }
+    return context.pipelines.prepare();
 }
 
 SwapchainHandle Engine::createSwapchain(OEWindowInstance* window)
@@ -63,5 +110,43 @@ Renderer* Engine::createRenderer(SwapchainHandle& handle, OEScene* scene)
     return renderer;
 }
 
+VulkanAPI::OffscreenTarget*
+Engine::createOffscreenTarget(const uint32_t width, const uint32_t height)
+{
+    auto target = std::make_unique<VulkanAPI::OffscreenTarget>(vkDriver->getContext());
+    if (!target->prepare(width, height, vk::Format::eR8G8B8A8Unorm, framesInFlight))
+    {
+        LOGGER_ERROR("Unable to create a %ux%u offscreen target.", width, height);
+        return nullptr;
+    }
+    offscreenTargets.emplace_back(std::move(target));
+    return offscreenTargets.back().get();
+}
+
+Renderer* Engine::createRenderer(VulkanAPI::OffscreenTarget& target, OEScene* scene)
+{
+    OERenderer* renderer = new OERenderer(*this, *scene, target, config);
+    assert(renderer);
+    renderers.emplace_back(renderer);
+    return renderer;
+}
+
+void Engine::setFramesInFlight(const uint32_t count)
+{
+    assert(renderers.empty() && offscreenTargets.empty());
+    framesInFlight = std::min(
+        std::max(count, VulkanAPI::FrameRing::MinFramesInFlight),
+        VulkanAPI::FrameRing::MaxFramesInFlight);
+}
+
+VulkanAPI::VkContext& Engine::getVkContext()
+{
+    return vkDriver->getContext();
+}
+
+JobSystem& Engine::getJobSystem()
+{
+    return *jobSystem;
+}
 
 } // namespace OmegaEngine
@@ -3,8 +3,15 @@
 #include "Vulkan/Platform/Surface.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
+namespace VulkanAPI
+{
+struct VkContext;
+class OffscreenTarget;
+}
+
 namespace PCV
 {
 // forward declerations
@@ -13,6 +20,7 @@ class Renderer;
 class OEScene;
 class EngineConfig;
 class OEWindowInstance;
+class JobSystem;
 
 class Engine 
 {
@@ -32,6 +40,12 @@ public:
 	*/
 	bool init(OEWindowInstance* window);
 
+	/**
+	* @brief Initialises a vulkan context without a window or surface, for rendering
+	* into offscreen targets only. Swapchains can't be created with this context
+	*/
+	bool initHeadless();
+
 	/**
 	* @brief This creates a new swapchain instance based upon the platform-specific
 	* ntaive window pointer created by the application
@@ -43,6 +57,48 @@ public:
 	*/
 	Renderer* createRenderer(SwapchainHandle& handle, OEScene* scene);
 
+	/**
+	* @brief Creates an offscreen colour target with async readback, which is owned by
+	* the engine. Returns nullptr if the target couldn't be created
+	*/
+	VulkanAPI::OffscreenTarget* createOffscreenTarget(const uint32_t width, const uint32_t height);
+
+	/**
+	* @brief Creates a new renderer which draws the scene into an offscreen target
+	*/
+	Renderer* createRenderer(VulkanAPI::OffscreenTarget& target, OEScene* scene);
+
+    /**
+     * @brief Sets where the pipeline cache is loaded from when the engine is initialised and
+     * saved to when it is destroyed. Defaults to the working directory
+     */
+    void setPipelineCacheDir(const std::string& dir)
+    {
+        pipelineCacheDir = dir;
+    }
+
+    /**
+     * @brief Sets the number of frames the CPU may run ahead of the GPU, between two and three.
+     * Must be called before any renderers, offscreen targets or octrees are created
+     */
+    void setFramesInFlight(const uint32_t count);
+
+    uint32_t getFramesInFlight() const
+    {
+        return framesInFlight;
+    }
+
+    /// the vulkan device used for all GPU resources
+    VulkanAPI::VkContext& getVkContext();
+
+    /// the job system shared by the scene and renderers, the engine's thread is worker zero
+    JobSystem& getJobSystem();
+
+private:
+
+    /// loads the pipeline cache and starts the pipeline registry's compile thread
+    bool preparePipelines();
+
 private:
  
     // A list of renderers which have been created
@@ -53,6 +109,15 @@ private:
 	// keep a list of active swapchains here
 	std::vector<std::unique_ptr<VulkanAPI::Swapchain>> swapchains;
 
+    // and the offscreen targets used when headless
+    std::vector<std::unique_ptr<VulkanAPI::OffscreenTarget>> offscreenTargets;
+
+    std::unique_ptr<JobSystem> jobSystem;
+
+    std::string pipelineCacheDir = ".";
+
+    uint32_t framesInFlight = 2;
+
 };
 
 }    // namespace OmegaEngine
@@ -0,0 +1,332 @@
+#include "LasLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+#include "Utility/StridedView.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PCV
+{
+
+namespace
+{
+
+// las is always stored as little endian
+template <typename T>
+inline T readLE(const uint8_t* ptr)
+{
+    static const bool swap = !Util::isLittleEndianHost();
+
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return swap ? Util::byteSwap(value) : value;
+}
+
+} // namespace
+
+LasLoader::LasLoader()
+{
+}
+
+LasLoader::~LasLoader()
+{
+}
+
+bool LasLoader::parseHeader(const uint8_t* data, const size_t size, Header& header)
+{
+    if (size < MinHeaderSize || std::memcmp(data, "LASF", 4) != 0)
+    {
+        return false;
+    }
+
+    header.versionMajor = data[24];
+    header.versionMinor = data[25];
+    header.headerSize = readLE<uint16_t>(data + 94);
+    header.pointDataOffset = readLE<uint32_t>(data + 96);
+    header.vlrCount = readLE<uint32_t>(data + 100);
+
+    // bits 6 and 7 of the point format are set by LASzip for compressed files
+    const uint8_t format = data[104];
+    header.isCompressed = (format & 0x80) != 0;
+    header.pointFormat = format & 0x3f;
+    header.recordLength = readLE<uint16_t>(data + 105);
+    header.pointCount = readLE<uint32_t>(data + 107);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        header.scale[i] = readLE<double>(data + 131 + i * 8);
+        header.offset[i] = readLE<double>(data + 155 + i * 8);
+
+        // stored as max x, min x, max y, min y...
+        header.max[i] = readLE<double>(data + 179 + i * 16);
+        header.min[i] = readLE<double>(data + 187 + i * 16);
+    }
+
+    // las 1.4 adds 64-bit point counts - the legacy count is zero for the newer point formats
+    constexpr size_t PointCountOffset14 = 247;
+    if (header.versionMajor == 1 && header.versionMinor >= 4 &&
+        header.headerSize >= PointCountOffset14 + 8 && size >= PointCountOffset14 + 8)
+    {
+        uint64_t count = readLE<uint64_t>(data + PointCountOffset14);
+        if (count > 0)
+        {
+            header.pointCount = count;
+        }
+    }
+
+    if (header.versionMajor != 1 || header.headerSize < MinHeaderSize)
+    {
+        LOGGER_ERROR(
+            "Unsupported las version %u.%u.", header.versionMajor, header.versionMinor);
+        return false;
+    }
+    return true;
+}
+
+bool LasLoader::getRecordLayout(const uint8_t pointFormat, RecordLayout& layout)
+{
+    // the legacy formats 0 - 5 share the first 20 bytes, formats 6 - 10 were added in las 1.4 and
+    // share the first 30 bytes
+    static constexpr size_t RecordSizes[] = {20, 28, 26, 34, 57, 63, 30, 36, 38, 59, 67};
+    if (pointFormat > 10)
+    {
+        return false;
+    }
+
+    layout = RecordLayout {};
+    layout.minSize = RecordSizes[pointFormat];
+    if (pointFormat < 6)
+    {
+        // the classification shares the byte with the synthetic, key-point and withheld flags
+        layout.classification = 15;
+        layout.classMask = 0x1f;
+        if (pointFormat == 2)
+        {
+            layout.rgb = 20;
+        }
+        else if (pointFormat == 3 || pointFormat == 5)
+        {
+            layout.rgb = 28;
+        }
+    }
+    else
+    {
+        layout.classification = 16;
+        layout.classMask = 0xff;
+        if (pointFormat == 7 || pointFormat == 8 || pointFormat == 10)
+        {
+            layout.rgb = 30;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<PointCloud> LasLoader::createCloud(const Header& header, const size_t pointCount)
+{
+    RecordLayout layout;
+    getRecordLayout(header.pointFormat, layout);
+
+    uint32_t attributes = PointCloud::AttributeFlags::Position |
+        PointCloud::AttributeFlags::Intensity | PointCloud::AttributeFlags::Classification;
+    if (layout.rgb >= 0)
+    {
+        attributes |= PointCloud::AttributeFlags::Colour;
+    }
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->allocate(pointCount, attributes);
+
+    // the centre of the bounds is used as the origin - this keeps the local positions as small as
+    // possible so the least amount of precision is lost when converting to float
+    OEMaths::vec3d origin {
+        (header.min[0] + header.max[0]) * 0.5,
+        (header.min[1] + header.max[1]) * 0.5,
+        (header.min[2] + header.max[2]) * 0.5};
+    cloud->setOrigin(origin);
+
+    AABBox bounds;
+    bounds.extend(
+        static_cast<float>(header.min[0] - origin.x),
+        static_cast<float>(header.min[1] - origin.y),
+        static_cast<float>(header.min[2] - origin.z));
+    bounds.extend(
+        static_cast<float>(header.max[0] - origin.x),
+        static_cast<float>(header.max[1] - origin.y),
+        static_cast<float>(header.max[2] - origin.z));
+    cloud->setBounds(bounds);
+
+    return cloud;
+}
+
+uint32_t LasLoader::getRgbShift(
+    const uint8_t* records, const size_t count, const Header& header, const RecordLayout& layout)
+{
+    if (layout.rgb < 0)
+    {
+        return 0;
+    }
+
+    const size_t sampleCount = std::min(count, RgbSampleCount);
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        const uint8_t* rgb = records + i * header.recordLength + layout.rgb;
+        if (readLE<uint16_t>(rgb) > 255 || readLE<uint16_t>(rgb + 2) > 255 ||
+            readLE<uint16_t>(rgb + 4) > 255)
+        {
+            return 8;
+        }
+    }
+    return 0;
+}
+
+void LasLoader::decodeRecords(
+    const uint8_t* records,
+    const size_t count,
+    const Header& header,
+    const RecordLayout& layout,
+    PointCloud& cloud,
+    const size_t dstOffset,
+    const uint32_t rgbShift)
+{
+    assert(dstOffset + count <= cloud.size());
+
+    PointCloud::Storage& storage = cloud.storage;
+    const OEMaths::vec3d& origin = cloud.getOrigin();
+
+    // fold the rebasing into the offset so each coordinate is a single multiply-add
+    const double rebase[3] = {
+        header.offset[0] - origin.x, header.offset[1] - origin.y, header.offset[2] - origin.z};
+    const size_t stride = header.recordLength;
+
+    // each attribute is decoded in its own pass so the writes are sequential
+    float* posX = storage.posX.data() + dstOffset;
+    float* posY = storage.posY.data() + dstOffset;
+    float* posZ = storage.posZ.data() + dstOffset;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* record = records + i * stride;
+        posX[i] = static_cast<float>(readLE<int32_t>(record) * header.scale[0] + rebase[0]);
+        posY[i] = static_cast<float>(readLE<int32_t>(record + 4) * header.scale[1] + rebase[1]);
+        posZ[i] = static_cast<float>(readLE<int32_t>(record + 8) * header.scale[2] + rebase[2]);
+    }
+
+    uint16_t* intensity = storage.intensity.data() + dstOffset;
+    uint8_t* classification = storage.classification.data() + dstOffset;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t* record = records + i * stride;
+        intensity[i] = readLE<uint16_t>(record + layout.intensity);
+        classification[i] = record[layout.classification] & layout.classMask;
+    }
+
+    if (layout.rgb >= 0)
+    {
+        uint8_t* red = storage.red.data() + dstOffset;
+        uint8_t* green = storage.green.data() + dstOffset;
+        uint8_t* blue = storage.blue.data() + dstOffset;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t* rgb = records + i * stride + layout.rgb;
+            red[i] = static_cast<uint8_t>(readLE<uint16_t>(rgb) >> rgbShift);
+            green[i] = static_cast<uint8_t>(readLE<uint16_t>(rgb + 2) >> rgbShift);
+            blue[i] = static_cast<uint8_t>(readLE<uint16_t>(rgb + 4) >> rgbShift);
+        }
+    }
+}
+
+bool LasLoader::open(const char* path)
+{
+    file = std::make_shared<Util::MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+
+    if (!parseHeader(file->data(), file->size(), header))
+    {
+        LOGGER_ERROR("%s is not a valid las file.", path);
+        return false;
+    }
+
+    if (header.isCompressed)
+    {
+        LOGGER_ERROR("%s contains compressed point data.", path);
+        return false;
+    }
+
+    RecordLayout layout;
+    if (!getRecordLayout(header.pointFormat, layout) || header.recordLength < layout.minSize)
+    {
+        LOGGER_ERROR(
+            "Unsupported las point format %u (record length %u).",
+            header.pointFormat,
+            header.recordLength);
+        return false;
+    }
+
+    const uint64_t dataSize = header.pointCount * header.recordLength;
+    if (header.pointCount == 0 || header.pointDataOffset + dataSize > file->size())
+    {
+        LOGGER_ERROR("Las file %s contains no points or is truncated.", path);
+        return false;
+    }
+
+    file->adviseSequential();
+    return true;
+}
+
+std::unique_ptr<PointCloud> LasLoader::createPointCloud()
+{
+    return createPointCloud(0, static_cast<size_t>(header.pointCount));
+}
+
+std::unique_ptr<PointCloud> LasLoader::createPointCloud(const size_t first, const size_t count)
+{
+    if (!file || !file->isOpen() || first + count > header.pointCount || count == 0)
+    {
+        return nullptr;
+    }
+
+    RecordLayout layout;
+    getRecordLayout(header.pointFormat, layout);
+
+    const uint8_t* data = file->data() + header.pointDataOffset;
+    const uint8_t* records = data + first * header.recordLength;
+
+    std::unique_ptr<PointCloud> cloud = createCloud(header, count);
+    const uint32_t rgbShift =
+        getRgbShift(data, static_cast<size_t>(header.pointCount), header, layout);
+
+    // decode in batches - each thread works through a contiguous range of batches
+    const size_t batchCount = (count + BatchSize - 1) / BatchSize;
+    auto decodeBatches = [&](const size_t start, const size_t num) {
+        for (size_t batch = start; batch < start + num; ++batch)
+        {
+            const size_t offset = batch * BatchSize;
+            decodeRecords(
+                records + offset * header.recordLength,
+                std::min(BatchSize, count - offset),
+                header,
+                layout,
+                *cloud,
+                offset,
+                rgbShift);
+        }
+    };
+
+    ThreadTaskSplitter split {0, batchCount, decodeBatches};
+    split.run();
+
+    return cloud;
+}
+
+size_t LasLoader::getFileSize() const
+{
+    return file ? file->size() : 0;
+}
+
+} // namespace PCV
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Maths/OEMaths.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief A loader for the LAS format, versions 1.2 - 1.4 and point data record formats 0 - 10.
+ * Records are decoded in parallel batches straight into the separate attribute arrays of the
+ * point cloud. Positions are rebased to the centre of the header bounds, which is stored in
+ * double precision as the origin of the cloud.
+ */
+class LasLoader
+{
+public:
+    /// the size of the smallest (LAS 1.0 - 1.2) public header block
+    static constexpr size_t MinHeaderSize = 227;
+
+    /// the number of points decoded by a single task
+    static constexpr size_t BatchSize = 1 << 16;
+
+    /// the records at the start of the file checked when determining the colour precision
+    static constexpr size_t RgbSampleCount = 1000;
+
+    struct Header
+    {
+        uint8_t versionMajor = 0;
+        uint8_t versionMinor = 0;
+        uint16_t headerSize = 0;
+        uint32_t pointDataOffset = 0;
+        uint32_t vlrCount = 0;
+
+        /// the point data record format with the compression bits removed
+        uint8_t pointFormat = 0;
+        uint16_t recordLength = 0;
+        uint64_t pointCount = 0;
+
+        double scale[3] = {};
+        double offset[3] = {};
+        double min[3] = {};
+        double max[3] = {};
+
+        /// set if the point format has the LASzip compression bit set
+        bool isCompressed = false;
+    };
+
+    /**
+     * @brief The byte offsets of the decoded attributes within a point record. Negative offsets
+     * state the attribute isn't present in the record format.
+     */
+    struct RecordLayout
+    {
+        size_t minSize = 0;
+        int intensity = 12;
+        int classification = 15;
+        uint8_t classMask = 0xff;
+        int rgb = -1;
+    };
+
+    LasLoader();
+    ~LasLoader();
+
+    /**
+     * @brief Parses the public header block from the start of a las/laz file.
+     * @return Whether this is a valid las header
+     */
+    static bool parseHeader(const uint8_t* data, const size_t size, Header& header);
+
+    /// returns the layout for the point format - false if the format isn't supported
+    static bool getRecordLayout(const uint8_t pointFormat, RecordLayout& layout);
+
+    /**
+     * @brief Creates a point cloud with storage allocated for the attributes of the point format
+     * and sets the origin and bounds from the header.
+     */
+    static std::unique_ptr<PointCloud> createCloud(const Header& header, const size_t pointCount);
+
+    /**
+     * @brief Decodes uncompressed point records into the attribute arrays of the cloud.
+     * @param records Pointer to the first record to decode
+     * @param count The number of records to decode
+     * @param dstOffset The index of the first point in the cloud to write to
+     * @param rgbShift The shift applied to the 16-bit colour values
+     */
+    static void decodeRecords(
+        const uint8_t* records,
+        const size_t count,
+        const Header& header,
+        const RecordLayout& layout,
+        PointCloud& cloud,
+        const size_t dstOffset,
+        const uint32_t rgbShift);
+
+    /**
+     * @brief Determines whether colours are stored with 8 or 16 bit precision. The spec states
+     * colours should be scaled to 16 bits but many writers don't do this.
+     */
+    static uint32_t getRgbShift(
+        const uint8_t* records, const size_t count, const Header& header, const RecordLayout& layout);
+
+    bool open(const char* path);
+
+    std::unique_ptr<PointCloud> createPointCloud();
+
+    /**
+     * @brief Decodes a range of the point records, allowing files larger than the available
+     * memory to be streamed. The colour precision is determined from the start of the file, so
+     * it is consistent across all ranges.
+     */
+    std::unique_ptr<PointCloud> createPointCloud(const size_t first, const size_t count);
+
+    const Header& getHeader() const
+    {
+        return header;
+    }
+
+    size_t getFileSize() const;
+
+private:
+    std::shared_ptr<Util::MappedFile> file;
+
+    Header header;
+};
+
+} // namespace PCV
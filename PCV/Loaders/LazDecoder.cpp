@@ -0,0 +1,1088 @@
+#include "LazDecoder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace PCV
+{
+namespace Laz
+{
+
+namespace
+{
+
+// ================ arithmetic coder constants ================
+// these must match the values used by the LASzip encoder
+
+constexpr uint32_t MinLength = 0x01000000u;
+constexpr uint32_t MaxLength = 0xffffffffu;
+
+constexpr uint32_t BitLengthShift = 13;
+constexpr uint32_t BitMaxCount = 1u << BitLengthShift;
+
+constexpr uint32_t LengthShift = 15;
+constexpr uint32_t MaxCount = 1u << LengthShift;
+
+// ================ gps time constants =========================
+constexpr int32_t GpsTimeMulti = 500;
+constexpr int32_t GpsTimeMultiMinus = -10;
+constexpr uint32_t GpsTimeMultiUnchanged = GpsTimeMulti - GpsTimeMultiMinus + 1;
+constexpr uint32_t GpsTimeMultiCodeFull = GpsTimeMulti - GpsTimeMultiMinus + 2;
+constexpr uint32_t GpsTimeMultiTotal = GpsTimeMulti - GpsTimeMultiMinus + 6;
+
+// the item readers work on little endian records regardless of the host
+inline uint16_t readU16(const uint8_t* ptr)
+{
+    return static_cast<uint16_t>(ptr[0] | (ptr[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t* ptr)
+{
+    return static_cast<uint32_t>(ptr[0]) | (static_cast<uint32_t>(ptr[1]) << 8) |
+        (static_cast<uint32_t>(ptr[2]) << 16) | (static_cast<uint32_t>(ptr[3]) << 24);
+}
+
+inline void writeU16(uint8_t* ptr, const uint16_t value)
+{
+    ptr[0] = static_cast<uint8_t>(value);
+    ptr[1] = static_cast<uint8_t>(value >> 8);
+}
+
+inline void writeU32(uint8_t* ptr, const uint32_t value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        ptr[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+}
+
+inline uint8_t clampU8(const int32_t value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// integer arithmetic in LASzip relies on two's complement wrapping
+inline int32_t wrapMul(const int32_t a, const int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+inline int32_t wrapAdd(const int32_t a, const int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+/**
+ * Returns the median of the last five values added - used to predict the x/y deltas.
+ */
+class StreamingMedian5
+{
+public:
+    void add(const int32_t v)
+    {
+        if (high)
+        {
+            if (v < values[2])
+            {
+                values[4] = values[3];
+                values[3] = values[2];
+                if (v < values[0])
+                {
+                    values[2] = values[1];
+                    values[1] = values[0];
+                    values[0] = v;
+                }
+                else if (v < values[1])
+                {
+                    values[2] = values[1];
+                    values[1] = v;
+                }
+                else
+                {
+                    values[2] = v;
+                }
+            }
+            else
+            {
+                if (v < values[3])
+                {
+                    values[4] = values[3];
+                    values[3] = v;
+                }
+                else
+                {
+                    values[4] = v;
+                }
+                high = false;
+            }
+        }
+        else
+        {
+            if (values[2] < v)
+            {
+                values[0] = values[1];
+                values[1] = values[2];
+                if (values[4] < v)
+                {
+                    values[2] = values[3];
+                    values[3] = values[4];
+                    values[4] = v;
+                }
+                else if (values[3] < v)
+                {
+                    values[2] = values[3];
+                    values[3] = v;
+                }
+                else
+                {
+                    values[2] = v;
+                }
+            }
+            else
+            {
+                if (values[1] < v)
+                {
+                    values[0] = values[1];
+                    values[1] = v;
+                }
+                else
+                {
+                    values[0] = v;
+                }
+                high = true;
+            }
+        }
+    }
+
+    int32_t get() const
+    {
+        return values[2];
+    }
+
+private:
+    int32_t values[5] = {};
+    bool high = true;
+};
+
+// ================ item readers ===============================
+
+/**
+ * The 20 byte point record common to las point formats 0 - 5
+ */
+class Point10Reader : public ItemReader
+{
+public:
+    explicit Point10Reader(ArithmeticDecoder& decoder)
+        : dec(decoder)
+        , changedValues(64)
+        , icIntensity(decoder, 16, 4)
+        , scanAngleRank {ArithmeticModel {256}, ArithmeticModel {256}}
+        , icPointSourceId(decoder, 16)
+        , icDx(decoder, 32, 2)
+        , icDy(decoder, 32, 22)
+        , icZ(decoder, 32, 20)
+    {
+    }
+
+    void init(const uint8_t* item) override
+    {
+        x = static_cast<int32_t>(readU32(item));
+        y = static_cast<int32_t>(readU32(item + 4));
+        z = static_cast<int32_t>(readU32(item + 8));
+        // the intensity isn't used as a prediction for the first point
+        intensity = 0;
+        returnByte = item[14];
+        classification = item[15];
+        scanAngle = item[16];
+        userData = item[17];
+        pointSourceId = readU16(item + 18);
+    }
+
+    void read(uint8_t* item) override
+    {
+        static constexpr uint8_t NumberReturnMap[8][8] = {
+            {15, 14, 13, 12, 11, 10, 9, 8},
+            {14, 0, 1, 3, 6, 10, 10, 9},
+            {13, 1, 2, 4, 7, 11, 11, 10},
+            {12, 3, 4, 5, 8, 12, 12, 11},
+            {11, 6, 7, 8, 9, 13, 13, 12},
+            {10, 10, 11, 12, 13, 14, 14, 13},
+            {9, 10, 11, 12, 13, 14, 15, 14},
+            {8, 9, 10, 11, 12, 13, 14, 15}};
+
+        static constexpr uint8_t NumberReturnLevel[8][8] = {
+            {0, 1, 2, 3, 4, 5, 6, 7},
+            {1, 0, 1, 2, 3, 4, 5, 6},
+            {2, 1, 0, 1, 2, 3, 4, 5},
+            {3, 2, 1, 0, 1, 2, 3, 4},
+            {4, 3, 2, 1, 0, 1, 2, 3},
+            {5, 4, 3, 2, 1, 0, 1, 2},
+            {6, 5, 4, 3, 2, 1, 0, 1},
+            {7, 6, 5, 4, 3, 2, 1, 0}};
+
+        const uint32_t changed = dec.decodeSymbol(changedValues);
+        if (changed & 32)
+        {
+            returnByte = static_cast<uint8_t>(dec.decodeSymbol(getModel(bitByte, returnByte)));
+        }
+
+        const uint32_t r = returnByte & 0x7;
+        const uint32_t n = (returnByte >> 3) & 0x7;
+        const uint32_t m = NumberReturnMap[n][r];
+        const uint32_t l = NumberReturnLevel[n][r];
+
+        if (changed & 16)
+        {
+            intensity = static_cast<uint16_t>(
+                icIntensity.decompress(lastIntensity[m], m < 3 ? m : 3));
+            lastIntensity[m] = intensity;
+        }
+        else if (changed)
+        {
+            intensity = lastIntensity[m];
+        }
+        if (changed & 8)
+        {
+            classification =
+                static_cast<uint8_t>(dec.decodeSymbol(getModel(classModels, classification)));
+        }
+        if (changed & 4)
+        {
+            const uint32_t direction = (returnByte >> 6) & 0x1;
+            scanAngle =
+                static_cast<uint8_t>(dec.decodeSymbol(scanAngleRank[direction]) + scanAngle);
+        }
+        if (changed & 2)
+        {
+            userData = static_cast<uint8_t>(dec.decodeSymbol(getModel(userDataModels, userData)));
+        }
+        if (changed & 1)
+        {
+            pointSourceId = static_cast<uint16_t>(icPointSourceId.decompress(pointSourceId));
+        }
+
+        // the x and y deltas are predicted from the median of the last five deltas
+        int32_t diff = icDx.decompress(diffMedianX[m].get(), n == 1);
+        x = wrapAdd(x, diff);
+        diffMedianX[m].add(diff);
+
+        uint32_t kBits = icDx.getK();
+        diff = icDy.decompress(diffMedianY[m].get(), (n == 1) + (kBits < 20 ? kBits & ~1u : 20));
+        y = wrapAdd(y, diff);
+        diffMedianY[m].add(diff);
+
+        // z is predicted from the last point with the same return level
+        kBits = (icDx.getK() + icDy.getK()) / 2;
+        z = icZ.decompress(lastHeight[l], (n == 1) + (kBits < 18 ? kBits & ~1u : 18));
+        lastHeight[l] = z;
+
+        writeU32(item, static_cast<uint32_t>(x));
+        writeU32(item + 4, static_cast<uint32_t>(y));
+        writeU32(item + 8, static_cast<uint32_t>(z));
+        writeU16(item + 12, intensity);
+        item[14] = returnByte;
+        item[15] = classification;
+        item[16] = scanAngle;
+        item[17] = userData;
+        writeU16(item + 18, pointSourceId);
+    }
+
+private:
+    // the byte models are only created for the values which are actually encountered
+    ArithmeticModel& getModel(std::unique_ptr<ArithmeticModel>* models, const uint8_t idx)
+    {
+        if (!models[idx])
+        {
+            models[idx] = std::make_unique<ArithmeticModel>(256);
+        }
+        return *models[idx];
+    }
+
+private:
+    ArithmeticDecoder& dec;
+
+    ArithmeticModel changedValues;
+    IntegerDecompressor icIntensity;
+    ArithmeticModel scanAngleRank[2];
+    IntegerDecompressor icPointSourceId;
+    IntegerDecompressor icDx;
+    IntegerDecompressor icDy;
+    IntegerDecompressor icZ;
+
+    std::unique_ptr<ArithmeticModel> bitByte[256];
+    std::unique_ptr<ArithmeticModel> classModels[256];
+    std::unique_ptr<ArithmeticModel> userDataModels[256];
+
+    StreamingMedian5 diffMedianX[16];
+    StreamingMedian5 diffMedianY[16];
+    uint16_t lastIntensity[16] = {};
+    int32_t lastHeight[8] = {};
+
+    // the last decoded point
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t z = 0;
+    uint16_t intensity = 0;
+    uint8_t returnByte = 0;
+    uint8_t classification = 0;
+    uint8_t scanAngle = 0;
+    uint8_t userData = 0;
+    uint16_t pointSourceId = 0;
+};
+
+/**
+ * The gps time is encoded as a multiple of the last delta where possible. Up to four sequences
+ * are tracked to cope with interleaved flight lines.
+ */
+class GpsTime11Reader : public ItemReader
+{
+public:
+    explicit GpsTime11Reader(ArithmeticDecoder& decoder)
+        : dec(decoder)
+        , gpsTimeMulti(GpsTimeMultiTotal)
+        , gpsTime0Diff(6)
+        , icGpsTime(decoder, 32, 9)
+    {
+    }
+
+    void init(const uint8_t* item) override
+    {
+        lastTime[0] = static_cast<uint64_t>(readU32(item)) |
+            (static_cast<uint64_t>(readU32(item + 4)) << 32);
+    }
+
+    void read(uint8_t* item) override
+    {
+        decodeTime();
+        writeU32(item, static_cast<uint32_t>(lastTime[last]));
+        writeU32(item + 4, static_cast<uint32_t>(lastTime[last] >> 32));
+    }
+
+private:
+    void decodeTime()
+    {
+        if (lastDiff[last] == 0)
+        {
+            const uint32_t multi = dec.decodeSymbol(gpsTime0Diff);
+            if (multi == 1)
+            {
+                // the difference fits in 32 bits
+                lastDiff[last] = icGpsTime.decompress(0, 0);
+                lastTime[last] += static_cast<int64_t>(lastDiff[last]);
+                extremeCounter[last] = 0;
+            }
+            else if (multi == 2)
+            {
+                readFullTime();
+            }
+            else if (multi > 2)
+            {
+                // switch to another sequence
+                last = (last + multi - 2) & 3;
+                decodeTime();
+            }
+            return;
+        }
+
+        uint32_t multi = dec.decodeSymbol(gpsTimeMulti);
+        if (multi == 1)
+        {
+            lastTime[last] += static_cast<int64_t>(icGpsTime.decompress(lastDiff[last], 1));
+            extremeCounter[last] = 0;
+        }
+        else if (multi < GpsTimeMultiUnchanged)
+        {
+            int32_t diff;
+            if (multi == 0)
+            {
+                diff = icGpsTime.decompress(0, 7);
+                updateExtreme(diff);
+            }
+            else if (multi < static_cast<uint32_t>(GpsTimeMulti))
+            {
+                const int32_t pred = wrapMul(static_cast<int32_t>(multi), lastDiff[last]);
+                diff = icGpsTime.decompress(pred, multi < 10 ? 2 : 3);
+            }
+            else if (multi == static_cast<uint32_t>(GpsTimeMulti))
+            {
+                diff = icGpsTime.decompress(wrapMul(GpsTimeMulti, lastDiff[last]), 4);
+                updateExtreme(diff);
+            }
+            else
+            {
+                const int32_t negMulti = GpsTimeMulti - static_cast<int32_t>(multi);
+                if (negMulti > GpsTimeMultiMinus)
+                {
+                    diff = icGpsTime.decompress(wrapMul(negMulti, lastDiff[last]), 5);
+                }
+                else
+                {
+                    diff = icGpsTime.decompress(wrapMul(GpsTimeMultiMinus, lastDiff[last]), 6);
+                    updateExtreme(diff);
+                }
+            }
+            lastTime[last] += static_cast<int64_t>(diff);
+        }
+        else if (multi == GpsTimeMultiCodeFull)
+        {
+            readFullTime();
+        }
+        else if (multi > GpsTimeMultiCodeFull)
+        {
+            last = (last + multi - GpsTimeMultiCodeFull) & 3;
+            decodeTime();
+        }
+    }
+
+    // the time delta is too large - the upper 32 bits are predicted and the lower bits stored raw
+    void readFullTime()
+    {
+        next = (next + 1) & 3;
+        const int32_t high = static_cast<int32_t>(lastTime[last] >> 32);
+        lastTime[next] = static_cast<uint64_t>(static_cast<uint32_t>(icGpsTime.decompress(high, 8)))
+            << 32;
+        lastTime[next] |= dec.readInt();
+        last = next;
+        lastDiff[last] = 0;
+        extremeCounter[last] = 0;
+    }
+
+    void updateExtreme(const int32_t diff)
+    {
+        if (++extremeCounter[last] > 3)
+        {
+            lastDiff[last] = diff;
+            extremeCounter[last] = 0;
+        }
+    }
+
+private:
+    ArithmeticDecoder& dec;
+
+    ArithmeticModel gpsTimeMulti;
+    ArithmeticModel gpsTime0Diff;
+    IntegerDecompressor icGpsTime;
+
+    uint32_t last = 0;
+    uint32_t next = 0;
+    uint64_t lastTime[4] = {};
+    int32_t lastDiff[4] = {};
+    int32_t extremeCounter[4] = {};
+};
+
+/**
+ * Colours are coded per byte, with green and blue predicted from the change in red.
+ */
+class Rgb12Reader : public ItemReader
+{
+public:
+    explicit Rgb12Reader(ArithmeticDecoder& decoder)
+        : dec(decoder)
+        , byteUsed(128)
+        , rgbDiff {
+              ArithmeticModel {256},
+              ArithmeticModel {256},
+              ArithmeticModel {256},
+              ArithmeticModel {256},
+              ArithmeticModel {256},
+              ArithmeticModel {256}}
+    {
+    }
+
+    void init(const uint8_t* item) override
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            last[i] = readU16(item + i * 2);
+        }
+    }
+
+    void read(uint8_t* item) override
+    {
+        uint16_t rgb[3];
+        const uint32_t sym = dec.decodeSymbol(byteUsed);
+
+        rgb[0] = (sym & 1) ? decodeFold(0, last[0] & 0xff) : last[0] & 0xff;
+        rgb[0] |= (sym & 2) ? decodeFold(1, last[0] >> 8) << 8 : last[0] & 0xff00;
+
+        if (sym & 64)
+        {
+            int32_t diff = (rgb[0] & 0xff) - (last[0] & 0xff);
+            rgb[1] = (sym & 4) ? decodeFold(2, clampU8(diff + (last[1] & 0xff))) : last[1] & 0xff;
+            if (sym & 16)
+            {
+                diff = (diff + ((rgb[1] & 0xff) - (last[1] & 0xff))) / 2;
+                rgb[2] = decodeFold(4, clampU8(diff + (last[2] & 0xff)));
+            }
+            else
+            {
+                rgb[2] = last[2] & 0xff;
+            }
+
+            diff = (rgb[0] >> 8) - (last[0] >> 8);
+            rgb[1] |=
+                (sym & 8) ? decodeFold(3, clampU8(diff + (last[1] >> 8))) << 8 : last[1] & 0xff00;
+            if (sym & 32)
+            {
+                diff = (diff + ((rgb[1] >> 8) - (last[1] >> 8))) / 2;
+                rgb[2] |= decodeFold(5, clampU8(diff + (last[2] >> 8))) << 8;
+            }
+            else
+            {
+                rgb[2] |= last[2] & 0xff00;
+            }
+        }
+        else
+        {
+            // greyscale
+            rgb[1] = rgb[0];
+            rgb[2] = rgb[0];
+        }
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            last[i] = rgb[i];
+            writeU16(item + i * 2, rgb[i]);
+        }
+    }
+
+private:
+    inline uint16_t decodeFold(const size_t model, const uint32_t pred)
+    {
+        return static_cast<uint8_t>(dec.decodeSymbol(rgbDiff[model]) + pred);
+    }
+
+private:
+    ArithmeticDecoder& dec;
+
+    ArithmeticModel byteUsed;
+    ArithmeticModel rgbDiff[6];
+
+    uint16_t last[3] = {};
+};
+
+/**
+ * Extra bytes - each byte is coded as the difference to the last value with its own model.
+ */
+class ByteReader : public ItemReader
+{
+public:
+    ByteReader(ArithmeticDecoder& decoder, const size_t count)
+        : dec(decoder)
+        , models(count, ArithmeticModel {256})
+        , last(count, 0)
+    {
+    }
+
+    void init(const uint8_t* item) override
+    {
+        std::memcpy(last.data(), item, last.size());
+    }
+
+    void read(uint8_t* item) override
+    {
+        for (size_t i = 0; i < last.size(); ++i)
+        {
+            last[i] = static_cast<uint8_t>(last[i] + dec.decodeSymbol(models[i]));
+        }
+        std::memcpy(item, last.data(), last.size());
+    }
+
+private:
+    ArithmeticDecoder& dec;
+
+    std::vector<ArithmeticModel> models;
+    std::vector<uint8_t> last;
+};
+
+} // namespace
+
+// ================ models ===================================
+
+ArithmeticBitModel::ArithmeticBitModel()
+{
+    init();
+}
+
+void ArithmeticBitModel::init()
+{
+    // start with equal probabilities
+    bit0Count = 1;
+    bitCount = 2;
+    bit0Prob = 1u << (BitLengthShift - 1);
+    updateCycle = bitsUntilUpdate = 4;
+}
+
+void ArithmeticBitModel::update()
+{
+    // halve the counts when the threshold is reached
+    if ((bitCount += updateCycle) > BitMaxCount)
+    {
+        bitCount = (bitCount + 1) >> 1;
+        bit0Count = (bit0Count + 1) >> 1;
+        if (bit0Count == bitCount)
+        {
+            ++bitCount;
+        }
+    }
+
+    const uint32_t scale = 0x80000000u / bitCount;
+    bit0Prob = (bit0Count * scale) >> (31 - BitLengthShift);
+
+    updateCycle = (5 * updateCycle) >> 2;
+    if (updateCycle > 64)
+    {
+        updateCycle = 64;
+    }
+    bitsUntilUpdate = updateCycle;
+}
+
+ArithmeticModel::ArithmeticModel(const uint32_t numSymbols)
+    : symbols(numSymbols)
+    , lastSymbol(numSymbols - 1)
+{
+    assert(symbols >= 2 && symbols <= (1u << 11));
+
+    // a lookup table is used to speed up the symbol search for the larger models
+    if (symbols > 16)
+    {
+        uint32_t tableBits = 3;
+        while (symbols > (1u << (tableBits + 2)))
+        {
+            ++tableBits;
+        }
+        tableSize = 1u << tableBits;
+        tableShift = LengthShift - tableBits;
+        decoderTable.resize(tableSize + 2);
+    }
+
+    distribution.resize(symbols);
+    symbolCount.resize(symbols);
+    init();
+}
+
+void ArithmeticModel::init()
+{
+    totalCount = 0;
+    updateCycle = symbols;
+    std::fill(symbolCount.begin(), symbolCount.end(), 1u);
+
+    update();
+    symbolsUntilUpdate = updateCycle = (symbols + 6) >> 1;
+}
+
+void ArithmeticModel::update()
+{
+    // halve the counts when the threshold is reached
+    if ((totalCount += updateCycle) > MaxCount)
+    {
+        totalCount = 0;
+        for (uint32_t n = 0; n < symbols; ++n)
+        {
+            totalCount += (symbolCount[n] = (symbolCount[n] + 1) >> 1);
+        }
+    }
+
+    // compute the cumulative distribution and the decoder table
+    uint32_t sum = 0;
+    uint32_t s = 0;
+    const uint32_t scale = 0x80000000u / totalCount;
+    for (uint32_t k = 0; k < symbols; ++k)
+    {
+        distribution[k] = (scale * sum) >> (31 - LengthShift);
+        sum += symbolCount[k];
+
+        if (tableSize)
+        {
+            const uint32_t w = distribution[k] >> tableShift;
+            while (s < w)
+            {
+                decoderTable[++s] = k - 1;
+            }
+        }
+    }
+
+    if (tableSize)
+    {
+        decoderTable[0] = 0;
+        while (s <= tableSize)
+        {
+            decoderTable[++s] = symbols - 1;
+        }
+    }
+
+    updateCycle = (5 * updateCycle) >> 2;
+    const uint32_t maxCycle = (symbols + 6) << 3;
+    if (updateCycle > maxCycle)
+    {
+        updateCycle = maxCycle;
+    }
+    symbolsUntilUpdate = updateCycle;
+}
+
+// ================ arithmetic decoder =======================
+
+ArithmeticDecoder::ArithmeticDecoder(const uint8_t* data, const size_t size)
+    : curr(data)
+    , end(data + size)
+{
+}
+
+void ArithmeticDecoder::init()
+{
+    length = MaxLength;
+    value = static_cast<uint32_t>(getByte()) << 24;
+    value |= static_cast<uint32_t>(getByte()) << 16;
+    value |= static_cast<uint32_t>(getByte()) << 8;
+    value |= static_cast<uint32_t>(getByte());
+}
+
+void ArithmeticDecoder::renormalise()
+{
+    do
+    {
+        value = (value << 8) | getByte();
+    } while ((length <<= 8) < MinLength);
+}
+
+uint32_t ArithmeticDecoder::decodeBit(ArithmeticBitModel& model)
+{
+    const uint32_t x = model.bit0Prob * (length >> BitLengthShift);
+    const uint32_t sym = value >= x;
+
+    if (sym == 0)
+    {
+        length = x;
+        ++model.bit0Count;
+    }
+    else
+    {
+        value -= x;
+        length -= x;
+    }
+
+    if (length < MinLength)
+    {
+        renormalise();
+    }
+    if (--model.bitsUntilUpdate == 0)
+    {
+        model.update();
+    }
+    return sym;
+}
+
+uint32_t ArithmeticDecoder::decodeSymbol(ArithmeticModel& model)
+{
+    uint32_t n;
+    uint32_t sym;
+    uint32_t x;
+    uint32_t y = length;
+
+    if (model.tableSize)
+    {
+        // use the table to find the initial search range, then bisect
+        const uint32_t dv = value / (length >>= LengthShift);
+        const uint32_t t = dv >> model.tableShift;
+
+        sym = model.decoderTable[t];
+        n = model.decoderTable[t + 1] + 1;
+        while (n > sym + 1)
+        {
+            const uint32_t k = (sym + n) >> 1;
+            if (model.distribution[k] > dv)
+            {
+                n = k;
+            }
+            else
+            {
+                sym = k;
+            }
+        }
+
+        x = model.distribution[sym] * length;
+        if (sym != model.lastSymbol)
+        {
+            y = model.distribution[sym + 1] * length;
+        }
+    }
+    else
+    {
+        // bisection search of the small models
+        x = sym = 0;
+        length >>= LengthShift;
+        n = model.symbols;
+        uint32_t k = n >> 1;
+        do
+        {
+            const uint32_t z = length * model.distribution[k];
+            if (z > value)
+            {
+                n = k;
+                y = z;
+            }
+            else
+            {
+                sym = k;
+                x = z;
+            }
+        } while ((k = (sym + n) >> 1) != sym);
+    }
+
+    value -= x;
+    length = y - x;
+
+    if (length < MinLength)
+    {
+        renormalise();
+    }
+
+    ++model.symbolCount[sym];
+    if (--model.symbolsUntilUpdate == 0)
+    {
+        model.update();
+    }
+    return sym;
+}
+
+uint32_t ArithmeticDecoder::readBits(uint32_t bits)
+{
+    assert(bits && bits <= 32);
+
+    if (bits > 19)
+    {
+        const uint32_t lower = readShort();
+        const uint32_t upper = readBits(bits - 16) << 16;
+        return upper | lower;
+    }
+
+    const uint32_t sym = value / (length >>= bits);
+    value -= length * sym;
+    if (length < MinLength)
+    {
+        renormalise();
+    }
+    return sym;
+}
+
+uint32_t ArithmeticDecoder::readShort()
+{
+    const uint32_t sym = value / (length >>= 16);
+    value -= length * sym;
+    if (length < MinLength)
+    {
+        renormalise();
+    }
+    return sym;
+}
+
+uint32_t ArithmeticDecoder::readInt()
+{
+    const uint32_t lower = readShort();
+    const uint32_t upper = readShort();
+    return (upper << 16) | lower;
+}
+
+// ================ integer decompressor =====================
+
+IntegerDecompressor::IntegerDecompressor(
+    ArithmeticDecoder& decoder, const uint32_t bits, const uint32_t contexts, const uint32_t high)
+    : dec(decoder)
+    , bitsHigh(high)
+{
+    if (bits && bits < 32)
+    {
+        corrBits = bits;
+        corrRange = 1u << bits;
+        corrMin = -static_cast<int32_t>(corrRange / 2);
+    }
+    else
+    {
+        corrBits = 32;
+        corrRange = 0;
+        corrMin = INT32_MIN;
+    }
+
+    bitModels.reserve(contexts);
+    for (uint32_t i = 0; i < contexts; ++i)
+    {
+        bitModels.emplace_back(corrBits + 1);
+    }
+
+    correctors.reserve(corrBits + 1);
+    correctors.emplace_back(2);
+    for (uint32_t i = 1; i <= corrBits; ++i)
+    {
+        correctors.emplace_back(1u << (i <= bitsHigh ? i : bitsHigh));
+    }
+}
+
+int32_t IntegerDecompressor::decompress(const int32_t pred, const uint32_t context)
+{
+    assert(context < bitModels.size());
+
+    uint32_t real = static_cast<uint32_t>(pred) +
+        static_cast<uint32_t>(readCorrector(bitModels[context]));
+
+    // fold the value back into the valid range
+    if (corrRange)
+    {
+        if (static_cast<int32_t>(real) < 0)
+        {
+            real += corrRange;
+        }
+        else if (real >= corrRange)
+        {
+            real -= corrRange;
+        }
+    }
+    return static_cast<int32_t>(real);
+}
+
+int32_t IntegerDecompressor::readCorrector(ArithmeticModel& model)
+{
+    k = dec.decodeSymbol(model);
+    if (k == 0)
+    {
+        return static_cast<int32_t>(dec.decodeBit(corrector0));
+    }
+    if (k >= 32)
+    {
+        return corrMin;
+    }
+
+    int32_t c;
+    if (k <= bitsHigh)
+    {
+        c = static_cast<int32_t>(dec.decodeSymbol(correctors[k]));
+    }
+    else
+    {
+        // the high bits are modelled, the remaining low bits are stored raw
+        const uint32_t k1 = k - bitsHigh;
+        c = static_cast<int32_t>(dec.decodeSymbol(correctors[k]));
+        c = static_cast<int32_t>((static_cast<uint32_t>(c) << k1) | dec.readBits(k1));
+    }
+
+    // translate c back into its correct interval
+    if (c >= (1 << (k - 1)))
+    {
+        return c + 1;
+    }
+    return static_cast<int32_t>(static_cast<uint32_t>(c) - ((1u << k) - 1));
+}
+
+// ================ chunk decoder ============================
+
+bool ChunkDecoder::isSupported(const std::vector<Item>& items)
+{
+    if (items.empty() || items[0].type != ItemType::Point10)
+    {
+        return false;
+    }
+
+    for (const Item& item : items)
+    {
+        if (item.version != 2)
+        {
+            return false;
+        }
+        switch (item.type)
+        {
+            case ItemType::Point10:
+                if (item.size != 20)
+                {
+                    return false;
+                }
+                break;
+            case ItemType::GpsTime11:
+                if (item.size != 8)
+                {
+                    return false;
+                }
+                break;
+            case ItemType::Rgb12:
+                if (item.size != 6)
+                {
+                    return false;
+                }
+                break;
+            case ItemType::Byte:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+ChunkDecoder::ChunkDecoder(const std::vector<Item>& chunkItems)
+    : items(chunkItems)
+{
+    for (const Item& item : items)
+    {
+        recordLength += item.size;
+    }
+}
+
+ChunkDecoder::~ChunkDecoder()
+{
+}
+
+void ChunkDecoder::decode(
+    const uint8_t* data, const size_t size, const size_t count, uint8_t* dst)
+{
+    if (count == 0 || size < recordLength)
+    {
+        return;
+    }
+
+    // the arithmetic coded stream follows the raw first point
+    ArithmeticDecoder dec {data + recordLength, size - recordLength};
+
+    // the models are reset for each chunk, so the readers are created per chunk
+    std::vector<std::unique_ptr<ItemReader>> readers;
+    readers.reserve(items.size());
+    for (const Item& item : items)
+    {
+        switch (item.type)
+        {
+            case ItemType::Point10:
+                readers.emplace_back(std::make_unique<Point10Reader>(dec));
+                break;
+            case ItemType::GpsTime11:
+                readers.emplace_back(std::make_unique<GpsTime11Reader>(dec));
+                break;
+            case ItemType::Rgb12:
+                readers.emplace_back(std::make_unique<Rgb12Reader>(dec));
+                break;
+            default:
+                readers.emplace_back(std::make_unique<ByteReader>(dec, item.size));
+                break;
+        }
+    }
+
+    std::memcpy(dst, data, recordLength);
+    size_t offset = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        readers[i]->init(dst + offset);
+        offset += items[i].size;
+    }
+    dec.init();
+
+    for (size_t p = 1; p < count; ++p)
+    {
+        uint8_t* record = dst + p * recordLength;
+        offset = 0;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            readers[i]->read(record + offset);
+            offset += items[i].size;
+        }
+    }
+}
+
+} // namespace Laz
+} // namespace PCV
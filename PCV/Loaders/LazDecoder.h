@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PCV
+{
+namespace Laz
+{
+
+/**
+ * @brief The item types which make up a compressed point record, as stored in the laszip vlr
+ */
+enum class ItemType : uint16_t
+{
+    Byte = 0,
+    Short = 1,
+    Int = 2,
+    Long = 3,
+    Float = 4,
+    Double = 5,
+    Point10 = 6,
+    GpsTime11 = 7,
+    Rgb12 = 8,
+    WavePacket13 = 9,
+    Point14 = 10,
+    Rgb14 = 11,
+    RgbNir14 = 12,
+    WavePacket14 = 13,
+    Byte14 = 14
+};
+
+struct Item
+{
+    ItemType type;
+    uint16_t size;
+    uint16_t version;
+};
+
+/**
+ * @brief An adaptive binary model used by the arithmetic decoder
+ */
+class ArithmeticBitModel
+{
+public:
+    ArithmeticBitModel();
+
+    void init();
+    void update();
+
+    uint32_t bit0Count;
+    uint32_t bitCount;
+    uint32_t bit0Prob;
+    uint32_t updateCycle;
+    uint32_t bitsUntilUpdate;
+};
+
+/**
+ * @brief An adaptive multi-symbol model used by the arithmetic decoder. Models with more than 16
+ * symbols use a lookup table to speed up the symbol search.
+ */
+class ArithmeticModel
+{
+public:
+    explicit ArithmeticModel(const uint32_t symbols);
+
+    void init();
+    void update();
+
+    uint32_t symbols;
+    uint32_t lastSymbol;
+    uint32_t totalCount = 0;
+    uint32_t updateCycle = 0;
+    uint32_t symbolsUntilUpdate = 0;
+    uint32_t tableSize = 0;
+    uint32_t tableShift = 0;
+
+    std::vector<uint32_t> distribution;
+    std::vector<uint32_t> symbolCount;
+    std::vector<uint32_t> decoderTable;
+};
+
+/**
+ * @brief The range decoder used by LASzip. Reads from a fixed block of memory - reading past the
+ * end returns zeros rather than faulting.
+ */
+class ArithmeticDecoder
+{
+public:
+    ArithmeticDecoder(const uint8_t* data, const size_t size);
+
+    /// reads the initial four bytes of the stream
+    void init();
+
+    uint32_t decodeBit(ArithmeticBitModel& model);
+    uint32_t decodeSymbol(ArithmeticModel& model);
+
+    uint32_t readBits(uint32_t bits);
+    uint32_t readShort();
+    uint32_t readInt();
+
+private:
+    inline uint8_t getByte()
+    {
+        return curr < end ? *curr++ : 0;
+    }
+
+    void renormalise();
+
+private:
+    const uint8_t* curr;
+    const uint8_t* end;
+
+    uint32_t value = 0;
+    uint32_t length = 0;
+};
+
+/**
+ * @brief Decompresses integers which were predicted from a previous value. The corrector is
+ * stored as the number of bits (k) followed by the bits themselves.
+ */
+class IntegerDecompressor
+{
+public:
+    IntegerDecompressor(
+        ArithmeticDecoder& dec,
+        const uint32_t bits = 16,
+        const uint32_t contexts = 1,
+        const uint32_t bitsHigh = 8);
+
+    int32_t decompress(const int32_t pred, const uint32_t context = 0);
+
+    /// the number of bits of the last corrector - used as context by the point readers
+    uint32_t getK() const
+    {
+        return k;
+    }
+
+private:
+    int32_t readCorrector(ArithmeticModel& model);
+
+private:
+    ArithmeticDecoder& dec;
+
+    uint32_t bitsHigh;
+    uint32_t corrBits;
+    uint32_t corrRange;
+    int32_t corrMin;
+
+    uint32_t k = 0;
+
+    std::vector<ArithmeticModel> bitModels;
+    ArithmeticBitModel corrector0;
+
+    /// corrector models for k = 1 to corrBits, index zero is unused
+    std::vector<ArithmeticModel> correctors;
+};
+
+/**
+ * @brief Base class for the decompressors of each item type
+ */
+class ItemReader
+{
+public:
+    virtual ~ItemReader() = default;
+
+    /// initialises the contexts using the first (uncompressed) item of the chunk
+    virtual void init(const uint8_t* item) = 0;
+
+    virtual void read(uint8_t* item) = 0;
+};
+
+/**
+ * @brief Decodes the points of a single chunk. Each chunk starts with a raw point followed by the
+ * arithmetic coded stream, so chunks can be decoded independently of each other.
+ */
+class ChunkDecoder
+{
+public:
+    /// whether all items can be decoded - only the version 2 point10 based items are supported
+    static bool isSupported(const std::vector<Item>& items);
+
+    ChunkDecoder(const std::vector<Item>& items);
+    ~ChunkDecoder();
+
+    /**
+     * @brief Decodes a chunk into raw las point records.
+     * @param data Pointer to the start of the chunk
+     * @param size The size of the chunk in bytes
+     * @param count The number of points in the chunk
+     * @param dst The output records - must be large enough to hold count records
+     */
+    void decode(const uint8_t* data, const size_t size, const size_t count, uint8_t* dst);
+
+    size_t getRecordLength() const
+    {
+        return recordLength;
+    }
+
+private:
+    std::vector<Item> items;
+
+    size_t recordLength = 0;
+};
+
+} // namespace Laz
+} // namespace PCV
@@ -0,0 +1,338 @@
+#include "LazLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+#include "Utility/StridedView.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PCV
+{
+
+namespace
+{
+
+template <typename T>
+inline T readLE(const uint8_t* ptr)
+{
+    static const bool swap = !Util::isLittleEndianHost();
+
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return swap ? Util::byteSwap(value) : value;
+}
+
+// the size of the header which precedes each variable length record
+constexpr size_t VlrHeaderSize = 54;
+
+// the user id and record id identifying the laszip vlr
+constexpr char LaszipUserId[] = "laszip encoded";
+constexpr uint16_t LaszipRecordId = 22204;
+
+// the size of the laszip vlr before the item list
+constexpr size_t LaszipVlrSize = 34;
+
+// a chunk size of this value signifies variable sized chunks, whose point counts are stored in
+// the chunk table
+constexpr uint32_t VariableChunkSize = 0xffffffffu;
+
+} // namespace
+
+LazLoader::LazLoader()
+{
+}
+
+LazLoader::~LazLoader()
+{
+}
+
+bool LazLoader::open(const char* path)
+{
+    file = std::make_shared<Util::MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+
+    if (!LasLoader::parseHeader(file->data(), file->size(), header))
+    {
+        LOGGER_ERROR("%s is not a valid laz file.", path);
+        return false;
+    }
+
+    if (!parseLaszipVlr())
+    {
+        LOGGER_ERROR("Unable to find a laszip vlr in %s.", path);
+        return false;
+    }
+
+    // the layered compressor is only used by the las 1.4 point formats
+    LasLoader::RecordLayout layout;
+    if (compressor != Compressor::Pointwise && compressor != Compressor::PointwiseChunked)
+    {
+        LOGGER_ERROR(
+            "%s uses an unsupported laszip compressor (%u).",
+            path,
+            static_cast<uint32_t>(compressor));
+        return false;
+    }
+    if (!Laz::ChunkDecoder::isSupported(items) ||
+        !LasLoader::getRecordLayout(header.pointFormat, layout) || header.pointFormat > 5)
+    {
+        LOGGER_ERROR(
+            "%s uses unsupported laszip items (point format %u).", path, header.pointFormat);
+        return false;
+    }
+
+    Laz::ChunkDecoder decoder {items};
+    if (decoder.getRecordLength() != header.recordLength || header.recordLength < layout.minSize)
+    {
+        LOGGER_ERROR("The laszip items of %s don't match the point record length.", path);
+        return false;
+    }
+
+    if (header.pointCount == 0 || !readChunkTable())
+    {
+        LOGGER_ERROR("Laz file %s contains no points or is truncated.", path);
+        return false;
+    }
+    return true;
+}
+
+bool LazLoader::parseLaszipVlr()
+{
+    const uint8_t* data = file->data();
+    const size_t size = file->size();
+
+    size_t offset = header.headerSize;
+    for (uint32_t i = 0; i < header.vlrCount && offset + VlrHeaderSize <= size; ++i)
+    {
+        const uint8_t* vlr = data + offset;
+        const uint16_t recordId = readLE<uint16_t>(vlr + 18);
+        const uint16_t length = readLE<uint16_t>(vlr + 20);
+        const uint8_t* payload = vlr + VlrHeaderSize;
+        offset += VlrHeaderSize + length;
+
+        if (recordId != LaszipRecordId ||
+            std::strncmp(reinterpret_cast<const char*>(vlr + 2), LaszipUserId, 16) != 0 ||
+            length < LaszipVlrSize || offset > size)
+        {
+            continue;
+        }
+
+        compressor = static_cast<Compressor>(readLE<uint16_t>(payload));
+        chunkSize = readLE<uint32_t>(payload + 12);
+
+        const uint16_t itemCount = readLE<uint16_t>(payload + 32);
+        if (LaszipVlrSize + itemCount * 6u > length)
+        {
+            return false;
+        }
+
+        items.resize(itemCount);
+        for (size_t j = 0; j < itemCount; ++j)
+        {
+            const uint8_t* item = payload + LaszipVlrSize + j * 6;
+            items[j].type = static_cast<Laz::ItemType>(readLE<uint16_t>(item));
+            items[j].size = readLE<uint16_t>(item + 2);
+            items[j].version = readLE<uint16_t>(item + 4);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool LazLoader::readChunkTable()
+{
+    const uint8_t* data = file->data();
+    const uint64_t size = file->size();
+    chunks.clear();
+
+    // the pointwise compressor stores all points in a single stream
+    if (compressor == Compressor::Pointwise)
+    {
+        Chunk chunk;
+        chunk.byteOffset = header.pointDataOffset;
+        chunk.byteSize = size - header.pointDataOffset;
+        chunk.pointCount = static_cast<uint32_t>(header.pointCount);
+        chunks.emplace_back(chunk);
+        return header.pointDataOffset < size;
+    }
+
+    // the offset of the chunk table is written before the point data. If the writer was unable to
+    // seek back (i.e. streamed output), this is -1 and the offset is stored at the end of the file
+    if (header.pointDataOffset + 8 > size)
+    {
+        return false;
+    }
+    int64_t tableOffset = readLE<int64_t>(data + header.pointDataOffset);
+    if (tableOffset == -1)
+    {
+        tableOffset = readLE<int64_t>(data + size - 8);
+    }
+
+    const uint64_t chunksStart = header.pointDataOffset + 8;
+    if (tableOffset < static_cast<int64_t>(chunksStart) ||
+        static_cast<uint64_t>(tableOffset) + 8 > size)
+    {
+        return false;
+    }
+
+    const uint8_t* table = data + tableOffset;
+    const uint32_t version = readLE<uint32_t>(table);
+    const uint32_t chunkCount = readLE<uint32_t>(table + 4);
+    if (version != 0 || chunkCount == 0)
+    {
+        return false;
+    }
+
+    // the point counts and byte sizes are compressed, each predicted from the previous chunk
+    Laz::ArithmeticDecoder dec {table + 8, static_cast<size_t>(size - tableOffset - 8)};
+    dec.init();
+    Laz::IntegerDecompressor ic {dec, 32, 2};
+
+    const bool variableSize = chunkSize == VariableChunkSize;
+    std::vector<uint32_t> counts(chunkCount, chunkSize);
+    std::vector<uint32_t> byteSizes(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        if (variableSize)
+        {
+            counts[i] = static_cast<uint32_t>(ic.decompress(i ? counts[i - 1] : 0, 0));
+        }
+        byteSizes[i] = static_cast<uint32_t>(ic.decompress(i ? byteSizes[i - 1] : 0, 1));
+    }
+
+    chunks.resize(chunkCount);
+    uint64_t byteOffset = chunksStart;
+    uint64_t pointOffset = 0;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        Chunk& chunk = chunks[i];
+        chunk.byteOffset = byteOffset;
+        chunk.byteSize = byteSizes[i];
+        chunk.pointOffset = pointOffset;
+        const uint64_t remaining = header.pointCount - std::min(pointOffset, header.pointCount);
+        chunk.pointCount = static_cast<uint32_t>(std::min<uint64_t>(counts[i], remaining));
+
+        byteOffset += chunk.byteSize;
+        pointOffset += chunk.pointCount;
+    }
+
+    if (byteOffset > static_cast<uint64_t>(tableOffset) || pointOffset != header.pointCount)
+    {
+        LOGGER_ERROR("The laz chunk table doesn't match the point data.");
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<PointCloud> LazLoader::createPointCloud()
+{
+    std::vector<size_t> chunkIndices(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        chunkIndices[i] = i;
+    }
+    return createPointCloud(chunkIndices);
+}
+
+std::unique_ptr<PointCloud> LazLoader::createPointCloud(const std::vector<size_t>& chunkIndices)
+{
+    if (!file || !file->isOpen() || chunkIndices.empty())
+    {
+        return nullptr;
+    }
+
+    LasLoader::RecordLayout layout;
+    LasLoader::getRecordLayout(header.pointFormat, layout);
+
+    // the destination of each chunk in the cloud
+    std::vector<size_t> dstOffset(chunkIndices.size() + 1, 0);
+    for (size_t i = 0; i < chunkIndices.size(); ++i)
+    {
+        if (chunkIndices[i] >= chunks.size())
+        {
+            LOGGER_ERROR("Laz chunk index %zu is out of range.", chunkIndices[i]);
+            return nullptr;
+        }
+        dstOffset[i + 1] = dstOffset[i] + chunks[chunkIndices[i]].pointCount;
+    }
+    const size_t pointCount = dstOffset.back();
+
+    const uint32_t rgbShift = getRgbShift(layout);
+    std::unique_ptr<PointCloud> cloud = LasLoader::createCloud(header, pointCount);
+
+    Util::Timer<Util::NanoSeconds> timer;
+    auto decodeChunks = [&](const size_t start, const size_t count) {
+        // the raw records are decoded into a scratch buffer which is reused for each chunk
+        Laz::ChunkDecoder decoder {items};
+        std::vector<uint8_t> records;
+        for (size_t i = start; i < start + count; ++i)
+        {
+            const Chunk& chunk = chunks[chunkIndices[i]];
+            records.resize(static_cast<size_t>(chunk.pointCount) * header.recordLength);
+            decoder.decode(
+                file->data() + chunk.byteOffset,
+                static_cast<size_t>(chunk.byteSize),
+                chunk.pointCount,
+                records.data());
+            LasLoader::decodeRecords(
+                records.data(), chunk.pointCount, header, layout, *cloud, dstOffset[i], rgbShift);
+        }
+    };
+
+    ThreadTaskSplitter split {0, chunkIndices.size(), decodeChunks, threadCount};
+    split.run();
+
+    const double seconds = timer.getElapsedSeconds();
+    const size_t usedThreads = std::min(
+        chunkIndices.size(),
+        threadCount ? threadCount : ThreadTaskSplitter::getHardwareThreadCount());
+    LOGGER_INFO(
+        "Decompressed %zu laz chunks on %zu threads: %.2fM points/s (%.2fM points/s per thread)",
+        chunkIndices.size(),
+        usedThreads,
+        static_cast<double>(pointCount) / seconds / 1.0e6,
+        static_cast<double>(pointCount) / seconds / 1.0e6 / static_cast<double>(usedThreads));
+
+    return cloud;
+}
+
+uint32_t LazLoader::getRgbShift(const LasLoader::RecordLayout& layout) const
+{
+    if (layout.rgb < 0)
+    {
+        return 0;
+    }
+
+    const size_t sampleCount =
+        static_cast<size_t>(std::min<uint64_t>(header.pointCount, LasLoader::RgbSampleCount));
+    std::vector<uint8_t> records(sampleCount * header.recordLength);
+    Laz::ChunkDecoder decoder {items};
+
+    // the points are decoded in order, so only the start of the last chunk needed is decoded
+    size_t decoded = 0;
+    for (size_t i = 0; i < chunks.size() && decoded < sampleCount; ++i)
+    {
+        const size_t count = std::min<size_t>(chunks[i].pointCount, sampleCount - decoded);
+        decoder.decode(
+            file->data() + chunks[i].byteOffset,
+            static_cast<size_t>(chunks[i].byteSize),
+            count,
+            records.data() + decoded * header.recordLength);
+        decoded += count;
+    }
+    return LasLoader::getRgbShift(records.data(), decoded, header, layout);
+}
+
+size_t LazLoader::getFileSize() const
+{
+    return file ? file->size() : 0;
+}
+
+} // namespace PCV
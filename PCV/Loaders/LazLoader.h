@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Loaders/LasLoader.h"
+#include "Loaders/LazDecoder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief A loader for LASzip compressed las files. Compressed files are split into chunks which
+ * each reset the arithmetic coder, so the chunk table is read up front and the chunks are
+ * decompressed in parallel straight into the point cloud. Only the pointwise chunked compressor
+ * with the version 2 items (point formats 0 - 3 plus extra bytes) is supported - the layered
+ * compressor used for the las 1.4 point formats is not.
+ */
+class LazLoader
+{
+public:
+    /// the compressor types stored in the laszip vlr
+    enum class Compressor : uint16_t
+    {
+        None = 0,
+        Pointwise = 1,
+        PointwiseChunked = 2,
+        LayeredChunked = 3
+    };
+
+    struct Chunk
+    {
+        /// the offset of the chunk from the start of the file
+        uint64_t byteOffset = 0;
+        uint64_t byteSize = 0;
+
+        /// the index of the first point of this chunk
+        uint64_t pointOffset = 0;
+        uint32_t pointCount = 0;
+    };
+
+    LazLoader();
+    ~LazLoader();
+
+    bool open(const char* path);
+
+    /// decompresses all chunks
+    std::unique_ptr<PointCloud> createPointCloud();
+
+    /**
+     * @brief Decompresses a subset of the chunks. The points are stored in the order of the chunk
+     * indices given.
+     */
+    std::unique_ptr<PointCloud> createPointCloud(const std::vector<size_t>& chunkIndices);
+
+    const std::vector<Chunk>& getChunks() const
+    {
+        return chunks;
+    }
+
+    const LasLoader::Header& getHeader() const
+    {
+        return header;
+    }
+
+    size_t getFileSize() const;
+
+    /// the threads used to decompress the chunks - zero uses all hardware threads
+    void setThreadCount(const size_t count)
+    {
+        threadCount = count;
+    }
+
+private:
+    bool parseLaszipVlr();
+    bool readChunkTable();
+
+    /**
+     * @brief Determines the colour precision from the same records LasLoader samples - the first
+     * **LasLoader::RgbSampleCount** of the file - so a file is loaded the same whether compressed
+     * or not. Only the chunks holding these records are decompressed.
+     */
+    uint32_t getRgbShift(const LasLoader::RecordLayout& layout) const;
+
+private:
+    std::shared_ptr<Util::MappedFile> file;
+
+    LasLoader::Header header;
+
+    Compressor compressor = Compressor::None;
+    uint32_t chunkSize = 0;
+    std::vector<Laz::Item> items;
+
+    std::vector<Chunk> chunks;
+
+    size_t threadCount = 0;
+};
+
+} // namespace PCV
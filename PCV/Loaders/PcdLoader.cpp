@@ -0,0 +1,778 @@
+#include "PcdLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Loaders/TextLoader.h"
+#include "Utility/Logger.h"
+#include "Utility/Lzf.h"
+#include "Utility/MappedFile.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace PCV
+{
+
+namespace
+{
+
+// field names as exported by PCL
+const char* const PositionXNames[] = {"x", nullptr};
+const char* const PositionYNames[] = {"y", nullptr};
+const char* const PositionZNames[] = {"z", nullptr};
+const char* const RgbNames[] = {"rgb", "rgba", nullptr};
+const char* const IntensityNames[] = {"intensity", nullptr};
+const char* const ClassNames[] = {"label", "classification", nullptr};
+
+// the size of the block header of binary_compressed data - compressed and uncompressed sizes
+constexpr size_t CompressedHeaderSize = 8;
+
+template <typename T>
+bool isNativeType(const PcdLoader::Field& field)
+{
+    const char type =
+        std::is_floating_point<T>::value ? 'F' : (std::is_signed<T>::value ? 'I' : 'U');
+    return field.size == sizeof(T) && field.type == type && field.count == 1;
+}
+
+// interleaved fields are transposed into blocks of this many values before converting, so the
+// conversion always runs on contiguous values
+constexpr size_t TransposeBlockSize = 256;
+
+template <typename Src, typename Dst>
+void convertScalar(const uint8_t* src, const size_t count, Dst* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        Src value;
+        std::memcpy(&value, src + i * sizeof(Src), sizeof(Src));
+        if (std::is_floating_point<Dst>::value)
+        {
+            dst[i] = static_cast<Dst>(value);
+        }
+        else
+        {
+            const double clamped = std::min(
+                std::max(static_cast<double>(value), 0.0),
+                static_cast<double>(std::numeric_limits<Dst>::max()));
+            dst[i] = static_cast<Dst>(clamped);
+        }
+    }
+}
+
+/**
+ * Converts **count** contiguous values of type Src to the destination type. Integer destinations
+ * are clamped to their range. The conversions of PCL's point types - float intensities, uint32
+ * labels and double positions - have SSE2 kernels.
+ */
+template <typename Src, typename Dst>
+void convertContiguous(const uint8_t* src, const size_t count, Dst* dst)
+{
+    convertScalar<Src>(src, count, dst);
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+template <>
+void convertContiguous<float, uint16_t>(const uint8_t* src, const size_t count, uint16_t* dst)
+{
+    // there is no unsigned saturating pack in SSE2, so the values are biased into the signed
+    // range, packed and then unbiased. NaNs are clamped to zero by the max
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(65535.0f);
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i unbias = _mm_set1_epi16(-32768);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 lo = _mm_loadu_ps(reinterpret_cast<const float*>(src + i * sizeof(float)));
+        __m128 hi = _mm_loadu_ps(reinterpret_cast<const float*>(src + (i + 4) * sizeof(float)));
+        lo = _mm_min_ps(_mm_max_ps(lo, zero), maxValue);
+        hi = _mm_min_ps(_mm_max_ps(hi, zero), maxValue);
+        const __m128i packed = _mm_packs_epi32(
+            _mm_sub_epi32(_mm_cvttps_epi32(lo), bias), _mm_sub_epi32(_mm_cvttps_epi32(hi), bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(packed, unbias));
+    }
+    convertScalar<float>(src + i * sizeof(float), count - i, dst + i);
+}
+
+template <>
+void convertContiguous<uint32_t, uint8_t>(const uint8_t* src, const size_t count, uint8_t* dst)
+{
+    // values above 255 are saturated before packing, as the packs are signed
+    const __m128i maxValue = _mm_set1_epi32(255);
+    auto saturate = [&maxValue](const uint8_t* values) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        const __m128i inRange = _mm_cmpeq_epi32(_mm_srli_epi32(v, 8), _mm_setzero_si128());
+        return _mm_or_si128(_mm_and_si128(inRange, v), _mm_andnot_si128(inRange, maxValue));
+    };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const uint8_t* values = src + i * sizeof(uint32_t);
+        const __m128i lo = _mm_packs_epi32(saturate(values), saturate(values + 16));
+        const __m128i hi = _mm_packs_epi32(saturate(values + 32), saturate(values + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    convertScalar<uint32_t>(src + i * sizeof(uint32_t), count - i, dst + i);
+}
+
+template <>
+void convertContiguous<double, float>(const uint8_t* src, const size_t count, float* dst)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const double* values = reinterpret_cast<const double*>(src + i * sizeof(double));
+        const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(values));
+        const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(values + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(lo, hi));
+    }
+    convertScalar<double>(src + i * sizeof(double), count - i, dst + i);
+}
+
+#endif
+
+/**
+ * Converts **count** values of type Src, separated by **stride** bytes, to the destination type.
+ * Interleaved values are transposed a block at a time into a stack buffer first.
+ */
+template <typename Src, typename Dst>
+void convertValues(const uint8_t* src, const size_t stride, const size_t count, Dst* dst)
+{
+    if (stride == sizeof(Src))
+    {
+        if (std::is_same<Src, Dst>::value)
+        {
+            std::memcpy(dst, src, count * sizeof(Dst));
+            return;
+        }
+        convertContiguous<Src>(src, count, dst);
+        return;
+    }
+
+    uint8_t block[TransposeBlockSize * sizeof(Src)];
+    for (size_t first = 0; first < count; first += TransposeBlockSize)
+    {
+        const size_t blockCount = std::min(TransposeBlockSize, count - first);
+        const uint8_t* blockSrc = src + first * stride;
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            std::memcpy(block + i * sizeof(Src), blockSrc + i * stride, sizeof(Src));
+        }
+        convertContiguous<Src>(block, blockCount, dst + first);
+    }
+}
+
+template <typename Dst>
+bool convertField(
+    const PcdLoader::Field& field,
+    const uint8_t* src,
+    const size_t stride,
+    const size_t count,
+    Dst* dst)
+{
+    switch (field.type)
+    {
+        case 'F':
+            if (field.size == 4)
+            {
+                convertValues<float>(src, stride, count, dst);
+                return true;
+            }
+            if (field.size == 8)
+            {
+                convertValues<double>(src, stride, count, dst);
+                return true;
+            }
+            break;
+        case 'I':
+            if (field.size == 1)
+            {
+                convertValues<int8_t>(src, stride, count, dst);
+                return true;
+            }
+            if (field.size == 2)
+            {
+                convertValues<int16_t>(src, stride, count, dst);
+                return true;
+            }
+            if (field.size == 4)
+            {
+                convertValues<int32_t>(src, stride, count, dst);
+                return true;
+            }
+            break;
+        case 'U':
+            if (field.size == 1)
+            {
+                convertValues<uint8_t>(src, stride, count, dst);
+                return true;
+            }
+            if (field.size == 2)
+            {
+                convertValues<uint16_t>(src, stride, count, dst);
+                return true;
+            }
+            if (field.size == 4)
+            {
+                convertValues<uint32_t>(src, stride, count, dst);
+                return true;
+            }
+            break;
+    }
+    return false;
+}
+
+/// copies a field into the owned storage, converting to the attribute type where required
+template <typename T>
+bool copyField(
+    const PcdLoader::Field& field,
+    const uint8_t* src,
+    const size_t stride,
+    const size_t count,
+    std::vector<T>& dst)
+{
+    dst.resize(count);
+    if (!convertField(field, src, stride, count, dst.data()))
+    {
+        LOGGER_ERROR("Unsupported type for pcd field %s.", field.name.c_str());
+        return false;
+    }
+    return true;
+}
+
+/// unpacks **count** contiguous colours stored as 0x00RRGGBB into separate channels
+void unpackRgbContiguous(
+    const uint8_t* src, const size_t count, uint8_t* red, uint8_t* green, uint8_t* blue)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i mask = _mm_set1_epi32(0xff);
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i r[4];
+        __m128i g[4];
+        __m128i b[4];
+        for (size_t j = 0; j < 4; ++j)
+        {
+            const __m128i rgb = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(src + (i + j * 4) * sizeof(uint32_t)));
+            r[j] = _mm_and_si128(_mm_srli_epi32(rgb, 16), mask);
+            g[j] = _mm_and_si128(_mm_srli_epi32(rgb, 8), mask);
+            b[j] = _mm_and_si128(rgb, mask);
+        }
+        auto pack = [](const __m128i* channel) {
+            return _mm_packus_epi16(
+                _mm_packs_epi32(channel[0], channel[1]), _mm_packs_epi32(channel[2], channel[3]));
+        };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(red + i), pack(r));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(green + i), pack(g));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(blue + i), pack(b));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint32_t rgb;
+        std::memcpy(&rgb, src + i * sizeof(uint32_t), sizeof(uint32_t));
+        red[i] = static_cast<uint8_t>(rgb >> 16);
+        green[i] = static_cast<uint8_t>(rgb >> 8);
+        blue[i] = static_cast<uint8_t>(rgb);
+    }
+}
+
+/// unpacks colours stored as 0x00RRGGBB into separate channels
+void unpackRgb(
+    const uint8_t* src, const size_t stride, const size_t count, PointCloud::Storage& storage)
+{
+    storage.red.resize(count);
+    storage.green.resize(count);
+    storage.blue.resize(count);
+    if (stride == sizeof(uint32_t))
+    {
+        unpackRgbContiguous(
+            src, count, storage.red.data(), storage.green.data(), storage.blue.data());
+        return;
+    }
+
+    uint8_t block[TransposeBlockSize * sizeof(uint32_t)];
+    for (size_t first = 0; first < count; first += TransposeBlockSize)
+    {
+        const size_t blockCount = std::min(TransposeBlockSize, count - first);
+        const uint8_t* blockSrc = src + first * stride;
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            std::memcpy(block + i * sizeof(uint32_t), blockSrc + i * stride, sizeof(uint32_t));
+        }
+        unpackRgbContiguous(
+            block,
+            blockCount,
+            storage.red.data() + first,
+            storage.green.data() + first,
+            storage.blue.data() + first);
+    }
+}
+
+} // namespace
+
+PcdLoader::PcdLoader()
+{
+}
+
+PcdLoader::~PcdLoader()
+{
+}
+
+bool PcdLoader::open(const char* path)
+{
+    // the loader can be reused for several files
+    fields.clear();
+    encoding = Encoding::Ascii;
+    pointCount = 0;
+    pointStride = 0;
+    dataOffset = 0;
+
+    file = std::make_shared<Util::MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+
+    if (!parseHeader())
+    {
+        LOGGER_ERROR("Unable to parse the header of pcd file %s.", path);
+        return false;
+    }
+    return true;
+}
+
+bool PcdLoader::parseHeader()
+{
+    const char* begin = reinterpret_cast<const char*>(file->data());
+    const char* end = begin + file->size();
+    const char* curr = begin;
+
+    size_t width = 0;
+    size_t height = 1;
+    bool hasData = false;
+
+    while (curr < end && !hasData)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(curr, '\n', end - curr));
+        if (!lineEnd)
+        {
+            return false;
+        }
+
+        std::string line {curr, static_cast<size_t>(lineEnd - curr)};
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        curr = lineEnd + 1;
+
+        std::istringstream ss {line};
+        std::string keyword;
+        ss >> keyword;
+
+        if (keyword == "FIELDS")
+        {
+            std::string name;
+            while (ss >> name)
+            {
+                Field field;
+                field.name = name;
+                fields.emplace_back(field);
+            }
+        }
+        else if (keyword == "SIZE")
+        {
+            for (Field& field : fields)
+            {
+                ss >> field.size;
+            }
+        }
+        else if (keyword == "TYPE")
+        {
+            for (Field& field : fields)
+            {
+                ss >> field.type;
+            }
+        }
+        else if (keyword == "COUNT")
+        {
+            for (Field& field : fields)
+            {
+                ss >> field.count;
+            }
+        }
+        else if (keyword == "WIDTH")
+        {
+            ss >> width;
+        }
+        else if (keyword == "HEIGHT")
+        {
+            ss >> height;
+        }
+        else if (keyword == "POINTS")
+        {
+            ss >> pointCount;
+        }
+        else if (keyword == "DATA")
+        {
+            std::string type;
+            ss >> type;
+            if (type == "ascii")
+            {
+                encoding = Encoding::Ascii;
+            }
+            else if (type == "binary")
+            {
+                encoding = Encoding::Binary;
+            }
+            else if (type == "binary_compressed")
+            {
+                encoding = Encoding::BinaryCompressed;
+            }
+            else
+            {
+                LOGGER_ERROR("Unknown pcd data encoding: %s", type.c_str());
+                return false;
+            }
+            hasData = true;
+        }
+        // comments, VERSION and VIEWPOINT are ignored
+    }
+
+    if (!hasData || fields.empty())
+    {
+        return false;
+    }
+    dataOffset = static_cast<size_t>(curr - begin);
+
+    // older files don't state the point count
+    if (pointCount == 0)
+    {
+        pointCount = width * height;
+    }
+    if (pointCount == 0)
+    {
+        LOGGER_ERROR("Pcd file contains no points.");
+        return false;
+    }
+
+    size_t column = 0;
+    for (Field& field : fields)
+    {
+        field.offset = pointStride;
+        field.column = column;
+        pointStride += field.size * field.count;
+        column += field.count;
+    }
+
+    if (encoding == Encoding::Binary && dataOffset + pointStride * pointCount > file->size())
+    {
+        LOGGER_ERROR("Pcd file is truncated.");
+        return false;
+    }
+    if (encoding == Encoding::BinaryCompressed && dataOffset + CompressedHeaderSize > file->size())
+    {
+        LOGGER_ERROR("Pcd file is truncated.");
+        return false;
+    }
+    return true;
+}
+
+size_t PcdLoader::getFileSize() const
+{
+    return file ? file->size() : 0;
+}
+
+const PcdLoader::Field* PcdLoader::findField(const char* const* names) const
+{
+    for (; *names; ++names)
+    {
+        for (const Field& field : fields)
+        {
+            if (field.name == *names)
+            {
+                return &field;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::unique_ptr<PointCloud> PcdLoader::createPointCloud()
+{
+    if (!file || !file->isOpen())
+    {
+        return nullptr;
+    }
+
+    if (!findField(PositionXNames) || !findField(PositionYNames) || !findField(PositionZNames))
+    {
+        LOGGER_ERROR("Pcd file has no position fields.");
+        return nullptr;
+    }
+
+    switch (encoding)
+    {
+        case Encoding::Ascii:
+            return createFromAscii();
+        case Encoding::Binary:
+            return createFromBinary();
+        case Encoding::BinaryCompressed:
+            return createFromCompressed();
+    }
+    return nullptr;
+}
+
+std::unique_ptr<PointCloud> PcdLoader::createFromAscii()
+{
+    // only the columns up to the last one used need parsing
+    size_t columnCount = 0;
+    auto getColumn = [&columnCount](const Field* field) -> int {
+        if (!field || field->count != 1)
+        {
+            return -1;
+        }
+        columnCount = std::max(columnCount, field->column + 1);
+        return static_cast<int>(field->column);
+    };
+
+    TextLoader::Layout layout;
+    layout.posX = getColumn(findField(PositionXNames));
+    layout.posY = getColumn(findField(PositionYNames));
+    layout.posZ = getColumn(findField(PositionZNames));
+    layout.packedRgb = getColumn(findField(RgbNames));
+    layout.intensity = getColumn(findField(IntensityNames));
+    layout.classification = getColumn(findField(ClassNames));
+    layout.columnCount = columnCount;
+
+    if (layout.columnCount > TextLoader::MaxColumns)
+    {
+        LOGGER_ERROR(
+            "Ascii pcd files with attributes beyond column %zu are not supported.",
+            TextLoader::MaxColumns);
+        return nullptr;
+    }
+
+    const char* begin = reinterpret_cast<const char*>(file->data());
+    return TextLoader::parse(begin + dataOffset, begin + file->size(), layout);
+}
+
+std::unique_ptr<PointCloud> PcdLoader::createFromBinary()
+{
+    const uint8_t* data = file->data() + dataOffset;
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->setSource(file, pointCount);
+
+    // binds a view directly to the mapped file if the stored type matches the attribute type,
+    // otherwise the field is converted into the owned storage
+    bool success = true;
+    auto bindAttribute = [&](const Field& field, auto& view, auto& dst) {
+        using Type = typename std::decay_t<decltype(dst)>::value_type;
+        if (isNativeType<Type>(field))
+        {
+            view = {data + field.offset, pointStride, pointCount};
+            return;
+        }
+        success &= copyField(field, data + field.offset, pointStride, pointCount, dst);
+        view = {dst.data(), dst.size()};
+    };
+
+    bindAttribute(*findField(PositionXNames), cloud->posX, cloud->storage.posX);
+    bindAttribute(*findField(PositionYNames), cloud->posY, cloud->storage.posY);
+    bindAttribute(*findField(PositionZNames), cloud->posZ, cloud->storage.posZ);
+    cloud->addAttribute(PointCloud::AttributeFlags::Position);
+
+    const Field* rgb = findField(RgbNames);
+    if (rgb && rgb->size == 4)
+    {
+        // the packed colour is stored as BGRA in memory, so each channel can be viewed directly
+        if (Util::isLittleEndianHost())
+        {
+            const uint8_t* base = data + rgb->offset;
+            cloud->red = {base + 2, pointStride, pointCount};
+            cloud->green = {base + 1, pointStride, pointCount};
+            cloud->blue = {base, pointStride, pointCount};
+        }
+        else
+        {
+            unpackRgb(data + rgb->offset, pointStride, pointCount, cloud->storage);
+            cloud->red = {cloud->storage.red.data(), pointCount};
+            cloud->green = {cloud->storage.green.data(), pointCount};
+            cloud->blue = {cloud->storage.blue.data(), pointCount};
+        }
+        cloud->addAttribute(PointCloud::AttributeFlags::Colour);
+    }
+
+    const Field* intensity = findField(IntensityNames);
+    if (intensity)
+    {
+        bindAttribute(*intensity, cloud->intensity, cloud->storage.intensity);
+        cloud->addAttribute(PointCloud::AttributeFlags::Intensity);
+    }
+
+    const Field* label = findField(ClassNames);
+    if (label)
+    {
+        bindAttribute(*label, cloud->classification, cloud->storage.classification);
+        cloud->addAttribute(PointCloud::AttributeFlags::Classification);
+    }
+
+    return success ? std::move(cloud) : nullptr;
+}
+
+std::unique_ptr<PointCloud> PcdLoader::createFromCompressed()
+{
+    const uint8_t* header = file->data() + dataOffset;
+    uint32_t compressedSize;
+    uint32_t uncompressedSize;
+    std::memcpy(&compressedSize, header, sizeof(uint32_t));
+    std::memcpy(&uncompressedSize, header + 4, sizeof(uint32_t));
+
+    if (dataOffset + CompressedHeaderSize + compressedSize > file->size() ||
+        uncompressedSize != pointStride * pointCount)
+    {
+        LOGGER_ERROR("Pcd compressed data block is truncated or has an invalid size.");
+        return nullptr;
+    }
+
+    const Field* posX = findField(PositionXNames);
+    const Field* posY = findField(PositionYNames);
+    const Field* posZ = findField(PositionZNames);
+    const Field* rgb = findField(RgbNames);
+    const Field* intensity = findField(IntensityNames);
+    const Field* label = findField(ClassNames);
+    if (rgb && rgb->size != 4)
+    {
+        rgb = nullptr;
+    }
+
+    uint32_t attributes = PointCloud::AttributeFlags::Position;
+    if (rgb)
+    {
+        attributes |= PointCloud::AttributeFlags::Colour;
+    }
+    if (intensity)
+    {
+        attributes |= PointCloud::AttributeFlags::Intensity;
+    }
+    if (label)
+    {
+        attributes |= PointCloud::AttributeFlags::Classification;
+    }
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->allocate(pointCount, attributes);
+    PointCloud::Storage& storage = cloud->storage;
+
+    // the block decompresses to one array per field, in field order. Fields already stored in
+    // the attribute type are decompressed straight into the attribute storage, the rest go to
+    // the scratch buffer to be converted afterwards
+    std::vector<Util::LzfSegment> segments(fields.size());
+    std::vector<size_t> scratchOffsets(fields.size(), SIZE_MAX);
+    size_t scratchSize = 0;
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+        const Field& field = fields[i];
+        segments[i].size = field.size * field.count * pointCount;
+
+        auto bindDirect = [&](const Field* attribute, auto& dst) {
+            using Type = typename std::decay_t<decltype(dst)>::value_type;
+            if (attribute == &field && isNativeType<Type>(field))
+            {
+                segments[i].data = reinterpret_cast<uint8_t*>(dst.data());
+            }
+        };
+        bindDirect(posX, storage.posX);
+        bindDirect(posY, storage.posY);
+        bindDirect(posZ, storage.posZ);
+        bindDirect(intensity, storage.intensity);
+        bindDirect(label, storage.classification);
+
+        if (!segments[i].data)
+        {
+            scratchOffsets[i] = scratchSize;
+            scratchSize += segments[i].size;
+        }
+    }
+
+    // the scratch buffer is kept by the loader, so it is only allocated once when a loader is
+    // reused for several files - loadPointCloud creates a loader per file so allocates it each load
+    if (scratch.size() < scratchSize)
+    {
+        scratch.resize(scratchSize);
+    }
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+        if (scratchOffsets[i] != SIZE_MAX)
+        {
+            segments[i].data = scratch.data() + scratchOffsets[i];
+        }
+    }
+
+    Util::Timer<Util::NanoSeconds> timer;
+    const size_t size = Util::lzfDecompress(
+        header + CompressedHeaderSize, compressedSize, segments.data(), segments.size());
+    if (size != uncompressedSize)
+    {
+        LOGGER_ERROR("Unable to decompress pcd point data.");
+        return nullptr;
+    }
+    const double decompressTime = timer.getElapsedSeconds();
+    timer.reset();
+
+    // converts a field which was decompressed into the scratch buffer. Each point of a field
+    // holds **count** values, only the first of which is used
+    bool success = true;
+    auto convertScratch = [&](const Field* field, auto& dst) {
+        const size_t index = static_cast<size_t>(field - fields.data());
+        if (scratchOffsets[index] != SIZE_MAX)
+        {
+            const uint8_t* src = segments[index].data;
+            success &= copyField(*field, src, field->size * field->count, pointCount, dst);
+        }
+    };
+
+    convertScratch(posX, storage.posX);
+    convertScratch(posY, storage.posY);
+    convertScratch(posZ, storage.posZ);
+    if (rgb)
+    {
+        const size_t index = static_cast<size_t>(rgb - fields.data());
+        unpackRgb(segments[index].data, rgb->size * rgb->count, pointCount, storage);
+    }
+    if (intensity)
+    {
+        convertScratch(intensity, storage.intensity);
+    }
+    if (label)
+    {
+        convertScratch(label, storage.classification);
+    }
+
+    if (!success)
+    {
+        return nullptr;
+    }
+
+    LOGGER_INFO(
+        "Decompressed %.2fMB of pcd point data in %.3fs, converted the fields in %.3fs.",
+        static_cast<double>(uncompressedSize) / (1024.0 * 1024.0),
+        decompressTime,
+        timer.getElapsedSeconds());
+    return cloud;
+}
+
+} // namespace PCV
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief A loader for the PCD format used by the Point Cloud Library. All three data encodings
+ * are supported:
+ * - ascii data is handed to the **TextLoader**.
+ * - binary data is stored as interleaved points in the mapped file, so fields that are stored in
+ * the attribute type are referenced directly without copying.
+ * - binary_compressed data is a single LZF block that decompresses to one array per field. Fields
+ * stored in the attribute type are decompressed straight into the attribute storage, the others
+ * into a scratch buffer and then converted with SSE2 kernels. The scratch buffer is only reused
+ * when the same loader opens several files.
+ */
+class PcdLoader
+{
+public:
+    enum class Encoding
+    {
+        Ascii,
+        Binary,
+        BinaryCompressed
+    };
+
+    struct Field
+    {
+        std::string name;
+
+        /// the size of a single value in bytes
+        size_t size = 4;
+
+        /// I - signed, U - unsigned or F - floating point
+        char type = 'F';
+
+        /// the number of values per point
+        size_t count = 1;
+
+        /// byte offset within a binary point. For compressed data, the field array begins at this
+        /// offset multiplied by the point count
+        size_t offset = 0;
+
+        /// the index of the first ascii column of this field
+        size_t column = 0;
+    };
+
+    PcdLoader();
+    ~PcdLoader();
+
+    /**
+     * @brief Maps the file and parses the header, replacing any previously opened file.
+     * @param path The path to the pcd file
+     * @return Whether the header was successfully parsed and the file contains points
+     */
+    bool open(const char* path);
+
+    std::unique_ptr<PointCloud> createPointCloud();
+
+    /// finds a field using the first matching name in the null terminated list
+    const Field* findField(const char* const* names) const;
+
+    Encoding getEncoding() const
+    {
+        return encoding;
+    }
+
+    size_t getPointCount() const
+    {
+        return pointCount;
+    }
+
+    size_t getFileSize() const;
+
+private:
+    bool parseHeader();
+
+    std::unique_ptr<PointCloud> createFromAscii();
+    std::unique_ptr<PointCloud> createFromBinary();
+    std::unique_ptr<PointCloud> createFromCompressed();
+
+private:
+    std::shared_ptr<Util::MappedFile> file;
+
+    Encoding encoding = Encoding::Ascii;
+
+    std::vector<Field> fields;
+
+    size_t pointCount = 0;
+
+    /// the size of a single point in bytes
+    size_t pointStride = 0;
+
+    /// byte offset to the start of the point data
+    size_t dataOffset = 0;
+
+    /// compressed fields which need converting are decompressed here first
+    std::vector<uint8_t> scratch;
+};
+
+} // namespace PCV
@@ -0,0 +1,516 @@
+#include "PlyLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Loaders/TextLoader.h"
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+namespace PCV
+{
+
+namespace
+{
+
+template <typename T>
+double readValue(const uint8_t* ptr, const bool swap)
+{
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return static_cast<double>(swap ? Util::byteSwap(value) : value);
+}
+
+double readAsDouble(const uint8_t* ptr, const PlyLoader::PropertyType type, const bool swap)
+{
+    switch (type)
+    {
+        case PlyLoader::PropertyType::Int8:
+            return readValue<int8_t>(ptr, swap);
+        case PlyLoader::PropertyType::UInt8:
+            return readValue<uint8_t>(ptr, swap);
+        case PlyLoader::PropertyType::Int16:
+            return readValue<int16_t>(ptr, swap);
+        case PlyLoader::PropertyType::UInt16:
+            return readValue<uint16_t>(ptr, swap);
+        case PlyLoader::PropertyType::Int32:
+            return readValue<int32_t>(ptr, swap);
+        case PlyLoader::PropertyType::UInt32:
+            return readValue<uint32_t>(ptr, swap);
+        case PlyLoader::PropertyType::Float32:
+            return readValue<float>(ptr, swap);
+        case PlyLoader::PropertyType::Float64:
+            return readValue<double>(ptr, swap);
+        default:
+            return 0.0;
+    }
+}
+
+// property names as exported by the most common tools
+const char* const PositionXNames[] = {"x", nullptr};
+const char* const PositionYNames[] = {"y", nullptr};
+const char* const PositionZNames[] = {"z", nullptr};
+const char* const RedNames[] = {"red", "diffuse_red", "r", nullptr};
+const char* const GreenNames[] = {"green", "diffuse_green", "g", nullptr};
+const char* const BlueNames[] = {"blue", "diffuse_blue", "b", nullptr};
+const char* const IntensityNames[] = {"intensity", "scalar_intensity", "scalar_Intensity", nullptr};
+const char* const ClassNames[] = {
+    "classification", "scalar_classification", "scalar_Classification", nullptr};
+
+} // namespace
+
+PlyLoader::PlyLoader()
+{
+}
+
+PlyLoader::~PlyLoader()
+{
+}
+
+size_t PlyLoader::getTypeSize(const PropertyType type)
+{
+    switch (type)
+    {
+        case PropertyType::Int8:
+        case PropertyType::UInt8:
+            return 1;
+        case PropertyType::Int16:
+        case PropertyType::UInt16:
+            return 2;
+        case PropertyType::Int32:
+        case PropertyType::UInt32:
+        case PropertyType::Float32:
+            return 4;
+        case PropertyType::Float64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+PlyLoader::PropertyType PlyLoader::getTypeFromName(const std::string& name)
+{
+    if (name == "char" || name == "int8")
+    {
+        return PropertyType::Int8;
+    }
+    if (name == "uchar" || name == "uint8")
+    {
+        return PropertyType::UInt8;
+    }
+    if (name == "short" || name == "int16")
+    {
+        return PropertyType::Int16;
+    }
+    if (name == "ushort" || name == "uint16")
+    {
+        return PropertyType::UInt16;
+    }
+    if (name == "int" || name == "int32")
+    {
+        return PropertyType::Int32;
+    }
+    if (name == "uint" || name == "uint32")
+    {
+        return PropertyType::UInt32;
+    }
+    if (name == "float" || name == "float32")
+    {
+        return PropertyType::Float32;
+    }
+    if (name == "double" || name == "float64")
+    {
+        return PropertyType::Float64;
+    }
+    return PropertyType::Invalid;
+}
+
+bool PlyLoader::open(const char* path)
+{
+    file = std::make_shared<Util::MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+
+    if (!parseHeader())
+    {
+        LOGGER_ERROR("Unable to parse the header of ply file %s.", path);
+        return false;
+    }
+    return true;
+}
+
+bool PlyLoader::parseHeader()
+{
+    const char* begin = reinterpret_cast<const char*>(file->data());
+    const char* end = begin + file->size();
+    const char* curr = begin;
+
+    bool hasMagic = false;
+    bool hasFormat = false;
+
+    while (curr < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(curr, '\n', end - curr));
+        if (!lineEnd)
+        {
+            // no end_header found
+            return false;
+        }
+
+        std::string line {curr, static_cast<size_t>(lineEnd - curr)};
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        curr = lineEnd + 1;
+
+        std::istringstream ss {line};
+        std::string keyword;
+        ss >> keyword;
+
+        if (!hasMagic)
+        {
+            if (keyword != "ply")
+            {
+                return false;
+            }
+            hasMagic = true;
+        }
+        else if (keyword == "format")
+        {
+            std::string type;
+            ss >> type;
+            if (type == "ascii")
+            {
+                format = Format::Ascii;
+            }
+            else if (type == "binary_little_endian")
+            {
+                format = Format::BinaryLittleEndian;
+            }
+            else if (type == "binary_big_endian")
+            {
+                format = Format::BinaryBigEndian;
+            }
+            else
+            {
+                LOGGER_ERROR("Unknown ply format: %s", type.c_str());
+                return false;
+            }
+            hasFormat = true;
+        }
+        else if (keyword == "element")
+        {
+            Element element;
+            ss >> element.name >> element.count;
+            elements.emplace_back(element);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+            {
+                return false;
+            }
+
+            Property prop;
+            std::string type;
+            ss >> type;
+            if (type == "list")
+            {
+                std::string countType;
+                ss >> countType >> type;
+                prop.isList = true;
+                prop.countType = getTypeFromName(countType);
+            }
+            prop.type = getTypeFromName(type);
+            ss >> prop.name;
+
+            if (prop.type == PropertyType::Invalid ||
+                (prop.isList && prop.countType == PropertyType::Invalid))
+            {
+                LOGGER_ERROR("Invalid type for ply property %s.", prop.name.c_str());
+                return false;
+            }
+            elements.back().properties.emplace_back(prop);
+        }
+        else if (keyword == "end_header")
+        {
+            headerSize = static_cast<size_t>(curr - begin);
+            break;
+        }
+        // comments and obj_info are ignored
+    }
+
+    if (!hasFormat || headerSize == 0)
+    {
+        return false;
+    }
+
+    // calculate the property offsets and element strides - elements with lists have no fixed size
+    for (Element& element : elements)
+    {
+        size_t offset = 0;
+        bool hasList = false;
+        for (Property& prop : element.properties)
+        {
+            prop.offset = offset;
+            offset += getTypeSize(prop.type);
+            hasList |= prop.isList;
+        }
+        element.stride = hasList ? 0 : offset;
+    }
+
+    auto iter = std::find_if(elements.begin(), elements.end(), [](const Element& element) {
+        return element.name == "vertex";
+    });
+    if (iter == elements.end() || iter->count == 0)
+    {
+        LOGGER_ERROR("Ply file contains no vertices.");
+        return false;
+    }
+    vertexIndex = static_cast<size_t>(iter - elements.begin());
+
+    if (format == Format::Ascii)
+    {
+        const Element& vertex = elements[vertexIndex];
+        if (vertex.stride == 0)
+        {
+            LOGGER_ERROR("Ply vertex elements with list properties are not supported.");
+            return false;
+        }
+
+        // each ascii element is a single line, so skip the lines of any preceeding elements
+        size_t skipCount = 0;
+        for (size_t i = 0; i < vertexIndex; ++i)
+        {
+            skipCount += elements[i].count;
+        }
+        const char* vertexBegin = TextLoader::skipLines(begin + headerSize, end, skipCount);
+        const char* vertexEnd = TextLoader::skipLines(vertexBegin, end, vertex.count);
+
+        vertexData = reinterpret_cast<const uint8_t*>(vertexBegin);
+        vertexDataEnd = reinterpret_cast<const uint8_t*>(vertexEnd);
+        return true;
+    }
+
+    // the vertex data is located after any preceeding elements. We can only skip these if they are
+    // of a fixed size
+    size_t dataOffset = headerSize;
+    for (size_t i = 0; i < vertexIndex; ++i)
+    {
+        if (elements[i].stride == 0)
+        {
+            LOGGER_ERROR(
+                "Ply elements with list properties before the vertex data are not supported.");
+            return false;
+        }
+        dataOffset += elements[i].stride * elements[i].count;
+    }
+
+    const Element& vertex = elements[vertexIndex];
+    if (vertex.stride == 0)
+    {
+        LOGGER_ERROR("Ply vertex elements with list properties are not supported.");
+        return false;
+    }
+    if (dataOffset + vertex.stride * vertex.count > file->size())
+    {
+        LOGGER_ERROR("Ply file is truncated.");
+        return false;
+    }
+
+    vertexData = file->data() + dataOffset;
+    vertexDataEnd = vertexData + vertex.stride * vertex.count;
+    return true;
+}
+
+bool PlyLoader::requiresSwap() const
+{
+    return (format == Format::BinaryBigEndian) == Util::isLittleEndianHost();
+}
+
+size_t PlyLoader::getVertexCount() const
+{
+    return elements.empty() ? 0 : elements[vertexIndex].count;
+}
+
+size_t PlyLoader::getFileSize() const
+{
+    return file ? file->size() : 0;
+}
+
+const PlyLoader::Property* PlyLoader::findVertexProperty(const char* const* names) const
+{
+    const Element& vertex = elements[vertexIndex];
+    for (; *names; ++names)
+    {
+        for (const Property& prop : vertex.properties)
+        {
+            if (prop.name == *names)
+            {
+                return &prop;
+            }
+        }
+    }
+    return nullptr;
+}
+
+double PlyLoader::readVertexProperty(const Property& prop, const size_t idx) const
+{
+    const Element& vertex = elements[vertexIndex];
+    assert(idx < vertex.count);
+    return readAsDouble(vertexData + idx * vertex.stride + prop.offset, prop.type, requiresSwap());
+}
+
+template <typename T>
+void PlyLoader::convertProperty(const Property& prop, std::vector<T>& dst, const double scale)
+{
+    const size_t count = getVertexCount();
+    const double maxValue = std::is_floating_point<T>::value ?
+        std::numeric_limits<double>::max() :
+        static_cast<double>(std::numeric_limits<T>::max());
+
+    dst.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        double value = readVertexProperty(prop, i) * scale;
+        if (!std::is_floating_point<T>::value)
+        {
+            value = std::min(std::max(value, 0.0), maxValue);
+        }
+        dst[i] = static_cast<T>(value);
+    }
+}
+
+std::unique_ptr<PointCloud> PlyLoader::createPointCloud()
+{
+    if (!vertexData)
+    {
+        return nullptr;
+    }
+
+    const Property* propX = findVertexProperty(PositionXNames);
+    const Property* propY = findVertexProperty(PositionYNames);
+    const Property* propZ = findVertexProperty(PositionZNames);
+    if (!propX || !propY || !propZ)
+    {
+        LOGGER_ERROR("Ply vertex element has no position properties.");
+        return nullptr;
+    }
+
+    if (format == Format::Ascii)
+    {
+        return createFromAscii();
+    }
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->setSource(file, getVertexCount());
+
+    // binds a view directly to the mapped file if the stored type matches the attribute type,
+    // otherwise the property is converted into the owned storage
+    auto bindAttribute = [this](const Property& prop, auto& view, auto& dst, const double scale) {
+        using Type = typename std::decay_t<decltype(dst)>::value_type;
+        view = getVertexView<Type>(prop);
+        if (view.empty())
+        {
+            convertProperty(prop, dst, scale);
+            view = {dst.data(), dst.size()};
+        }
+    };
+
+    bindAttribute(*propX, cloud->posX, cloud->storage.posX, 1.0);
+    bindAttribute(*propY, cloud->posY, cloud->storage.posY, 1.0);
+    bindAttribute(*propZ, cloud->posZ, cloud->storage.posZ, 1.0);
+    cloud->addAttribute(PointCloud::AttributeFlags::Position);
+
+    const Property* propRed = findVertexProperty(RedNames);
+    const Property* propGreen = findVertexProperty(GreenNames);
+    const Property* propBlue = findVertexProperty(BlueNames);
+    if (propRed && propGreen && propBlue)
+    {
+        // 16-bit colours are reduced to 8-bit and floating point colours are in the 0-1 range
+        auto colourScale = [](const Property& prop) {
+            if (prop.type == PropertyType::UInt16)
+            {
+                return 1.0 / 256.0;
+            }
+            return (prop.type == PropertyType::Float32 || prop.type == PropertyType::Float64) ?
+                255.0 :
+                1.0;
+        };
+        bindAttribute(*propRed, cloud->red, cloud->storage.red, colourScale(*propRed));
+        bindAttribute(*propGreen, cloud->green, cloud->storage.green, colourScale(*propGreen));
+        bindAttribute(*propBlue, cloud->blue, cloud->storage.blue, colourScale(*propBlue));
+        cloud->addAttribute(PointCloud::AttributeFlags::Colour);
+    }
+
+    const Property* propIntensity = findVertexProperty(IntensityNames);
+    if (propIntensity)
+    {
+        bindAttribute(*propIntensity, cloud->intensity, cloud->storage.intensity, 1.0);
+        cloud->addAttribute(PointCloud::AttributeFlags::Intensity);
+    }
+
+    const Property* propClass = findVertexProperty(ClassNames);
+    if (propClass)
+    {
+        bindAttribute(*propClass, cloud->classification, cloud->storage.classification, 1.0);
+        cloud->addAttribute(PointCloud::AttributeFlags::Classification);
+    }
+
+    return cloud;
+}
+
+std::unique_ptr<PointCloud> PlyLoader::createFromAscii()
+{
+    const Element& vertex = elements[vertexIndex];
+
+    // the column of each property is its index in the vertex element
+    auto getColumn = [&vertex](const Property* prop) -> int {
+        return prop ? static_cast<int>(prop - vertex.properties.data()) : -1;
+    };
+
+    const Property* propRed = findVertexProperty(RedNames);
+    const Property* propGreen = findVertexProperty(GreenNames);
+    const Property* propBlue = findVertexProperty(BlueNames);
+
+    TextLoader::Layout layout;
+    layout.posX = getColumn(findVertexProperty(PositionXNames));
+    layout.posY = getColumn(findVertexProperty(PositionYNames));
+    layout.posZ = getColumn(findVertexProperty(PositionZNames));
+    layout.intensity = getColumn(findVertexProperty(IntensityNames));
+    layout.classification = getColumn(findVertexProperty(ClassNames));
+    if (propRed && propGreen && propBlue)
+    {
+        layout.red = getColumn(propRed);
+        layout.green = getColumn(propGreen);
+        layout.blue = getColumn(propBlue);
+        if (propRed->type == PropertyType::Float32 || propRed->type == PropertyType::Float64)
+        {
+            layout.colourScale = 255.0;
+        }
+    }
+    layout.columnCount = vertex.properties.size();
+
+    if (layout.columnCount > TextLoader::MaxColumns)
+    {
+        LOGGER_ERROR(
+            "Ascii ply files with more than %zu properties are not supported.",
+            TextLoader::MaxColumns);
+        return nullptr;
+    }
+
+    return TextLoader::parse(
+        reinterpret_cast<const char*>(vertexData),
+        reinterpret_cast<const char*>(vertexDataEnd),
+        layout);
+}
+
+} // namespace PCV
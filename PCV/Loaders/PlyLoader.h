@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Utility/StridedView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief A loader for the PLY format. The file is memory mapped and only the header is parsed on
+ * opening. Binary vertex properties are exposed as strided views into the mapped file, so no
+ * copying or parsing of the vertex data takes place unless a property has to be converted to a
+ * different type. ASCII vertex data is handed to the **TextLoader**.
+ */
+class PlyLoader
+{
+public:
+    enum class Format
+    {
+        Ascii,
+        BinaryLittleEndian,
+        BinaryBigEndian
+    };
+
+    enum class PropertyType
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64,
+        Invalid
+    };
+
+    struct Property
+    {
+        std::string name;
+        PropertyType type = PropertyType::Invalid;
+
+        /// list properties have a count followed by a variable number of values
+        bool isList = false;
+        PropertyType countType = PropertyType::Invalid;
+
+        /// byte offset from the start of the element - only valid for fixed size elements
+        size_t offset = 0;
+    };
+
+    struct Element
+    {
+        std::string name;
+        size_t count = 0;
+        std::vector<Property> properties;
+
+        /// the size of a single element in bytes - zero if the element contains lists
+        size_t stride = 0;
+    };
+
+    PlyLoader();
+    ~PlyLoader();
+
+    static size_t getTypeSize(const PropertyType type);
+    static PropertyType getTypeFromName(const std::string& name);
+
+    template <typename T>
+    static constexpr PropertyType getPropertyType()
+    {
+        if constexpr (std::is_same<T, int8_t>::value)
+        {
+            return PropertyType::Int8;
+        }
+        else if constexpr (std::is_same<T, uint8_t>::value)
+        {
+            return PropertyType::UInt8;
+        }
+        else if constexpr (std::is_same<T, int16_t>::value)
+        {
+            return PropertyType::Int16;
+        }
+        else if constexpr (std::is_same<T, uint16_t>::value)
+        {
+            return PropertyType::UInt16;
+        }
+        else if constexpr (std::is_same<T, int32_t>::value)
+        {
+            return PropertyType::Int32;
+        }
+        else if constexpr (std::is_same<T, uint32_t>::value)
+        {
+            return PropertyType::UInt32;
+        }
+        else if constexpr (std::is_same<T, float>::value)
+        {
+            return PropertyType::Float32;
+        }
+        else if constexpr (std::is_same<T, double>::value)
+        {
+            return PropertyType::Float64;
+        }
+        return PropertyType::Invalid;
+    }
+
+    /**
+     * @brief Maps the file and parses the header.
+     * @param path The path to the ply file
+     * @return Whether the header was successfully parsed and the file contains vertices
+     */
+    bool open(const char* path);
+
+    /**
+     * @brief Creates a point cloud from the vertex element. Properties that are stored in the
+     * native attribute type reference the mapped file directly.
+     */
+    std::unique_ptr<PointCloud> createPointCloud();
+
+    /// finds a vertex property using the first matching name in the null terminated list
+    const Property* findVertexProperty(const char* const* names) const;
+
+    /**
+     * @brief Returns a view into the mapped file for a binary vertex property. The type must match
+     * the property type, otherwise an empty view is returned.
+     */
+    template <typename T>
+    Util::StridedView<T> getVertexView(const Property& prop) const
+    {
+        if (format == Format::Ascii || prop.type != getPropertyType<T>() || prop.isList)
+        {
+            return {};
+        }
+        const Element& vertex = elements[vertexIndex];
+        return Util::StridedView<T> {
+            vertexData + prop.offset, vertex.stride, vertex.count, requiresSwap()};
+    }
+
+    /// reads a binary vertex property as a double regardless of its stored type
+    double readVertexProperty(const Property& prop, const size_t idx) const;
+
+    Format getFormat() const
+    {
+        return format;
+    }
+
+    size_t getVertexCount() const;
+
+    size_t getFileSize() const;
+
+    /// the size of the header including the end_header line
+    size_t getHeaderSize() const
+    {
+        return headerSize;
+    }
+
+private:
+    bool parseHeader();
+
+    bool requiresSwap() const;
+
+    /// ascii vertex data is parsed into owned storage by the text loader
+    std::unique_ptr<PointCloud> createFromAscii();
+
+    /// converts the property into the owned array of the point cloud
+    template <typename T>
+    void convertProperty(const Property& prop, std::vector<T>& dst, const double scale);
+
+private:
+    std::shared_ptr<Util::MappedFile> file;
+
+    Format format = Format::BinaryLittleEndian;
+
+    std::vector<Element> elements;
+
+    size_t headerSize = 0;
+
+    /// index into the element list for the vertex element
+    size_t vertexIndex = 0;
+
+    /// pointer to the start of the vertex data in the mapped file
+    const uint8_t* vertexData = nullptr;
+    const uint8_t* vertexDataEnd = nullptr;
+};
+
+} // namespace PCV
@@ -0,0 +1,133 @@
+#include "PointLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Loaders/LasLoader.h"
+#include "Loaders/LazLoader.h"
+#include "Loaders/PcdLoader.h"
+#include "Loaders/PlyLoader.h"
+#include "Loaders/TextLoader.h"
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace PCV
+{
+
+std::string getFileExtension(const char* path)
+{
+    std::string filename {path};
+    size_t pos = filename.find_last_of('.');
+    if (pos == std::string::npos)
+    {
+        return {};
+    }
+
+    std::string ext = filename.substr(pos + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return ext;
+}
+
+std::unique_ptr<PointCloud> loadPointCloud(const char* path, LoadStats& stats)
+{
+    Util::Timer<Util::NanoSeconds> timer;
+
+    std::string ext = getFileExtension(path);
+    std::unique_ptr<PointCloud> cloud;
+
+    if (ext == "ply")
+    {
+        PlyLoader loader;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+            stats.bytes = loader.getFileSize();
+        }
+    }
+    else if (ext == "las")
+    {
+        LasLoader loader;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+            stats.bytes = loader.getFileSize();
+        }
+    }
+    else if (ext == "laz")
+    {
+        LazLoader loader;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+            stats.bytes = loader.getFileSize();
+        }
+    }
+    else if (ext == "pcd")
+    {
+        PcdLoader loader;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+            stats.bytes = loader.getFileSize();
+        }
+    }
+    else if (ext == "xyz" || ext == "pts" || ext == "txt" || ext == "asc" || ext == "csv")
+    {
+        TextLoader loader;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+            stats.bytes = loader.getFileSize();
+        }
+    }
+    else
+    {
+        LOGGER_ERROR("Unsupported point cloud format: %s", path);
+        return nullptr;
+    }
+
+    if (!cloud)
+    {
+        LOGGER_ERROR("Unable to load point cloud %s.", path);
+        return nullptr;
+    }
+
+    stats.pointCount = cloud->size();
+    stats.seconds = timer.getElapsedSeconds();
+    return cloud;
+}
+
+void logLoadStats(const char* path, const LoadStats& stats)
+{
+    LOGGER_INFO(
+        "Loaded %s: %zu points, %.2fMB in %.3fs (%.1f MB/s, %.2fM points/s)",
+        path,
+        stats.pointCount,
+        static_cast<double>(stats.bytes) / (1024.0 * 1024.0),
+        stats.seconds,
+        stats.getThroughput(),
+        stats.getPointsPerSecond() / 1.0e6);
+
+    if (stats.materialiseSeconds > 0.0)
+    {
+        LOGGER_INFO(
+            "Copied mapped %s into owned storage in %.3fs (%.2fM points/s)",
+            path,
+            stats.materialiseSeconds,
+            static_cast<double>(stats.pointCount) / stats.materialiseSeconds / 1.0e6);
+    }
+    if (stats.sortSeconds > 0.0)
+    {
+        LOGGER_INFO(
+            "Sorted %s into morton order in %.3fs (%.2fM points/s)",
+            path,
+            stats.sortSeconds,
+            static_cast<double>(stats.pointCount) / stats.sortSeconds / 1.0e6);
+    }
+}
+
+} // namespace PCV
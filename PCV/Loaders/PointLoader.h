@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief Timing information gathered whilst loading a point cloud. Used to keep track of loader
+ * performance regressions.
+ */
+struct LoadStats
+{
+    /// the number of bytes of the source file
+    size_t bytes = 0;
+    size_t pointCount = 0;
+    double seconds = 0.0;
+
+    /// the time taken to copy a mapped cloud into owned storage so it could be reordered, zero if
+    /// the cloud wasn't mapped or wasn't reordered
+    double materialiseSeconds = 0.0;
+
+    /// the time taken to reorder the points after loading, zero if they weren't reordered
+    double sortSeconds = 0.0;
+
+    double getThroughput() const
+    {
+        return seconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / seconds : 0.0;
+    }
+
+    double getPointsPerSecond() const
+    {
+        return seconds > 0.0 ? static_cast<double>(pointCount) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Loads a point cloud from disk, the loader used is determined by the file extension.
+ * @param path The path of the file to load
+ * @param stats Filled with the timings for this load
+ * @return The loaded cloud, or nullptr if the format isn't supported or loading failed
+ */
+std::unique_ptr<PointCloud> loadPointCloud(const char* path, LoadStats& stats);
+
+/// returns the lower case extension of the path, without the dot
+std::string getFileExtension(const char* path);
+
+/// outputs the load stats to the console
+void logLoadStats(const char* path, const LoadStats& stats);
+
+} // namespace PCV
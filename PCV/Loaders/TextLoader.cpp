@@ -0,0 +1,452 @@
+#include "TextLoader.h"
+
+#include "Core/PointCloud.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace PCV
+{
+
+namespace
+{
+
+// the number of chunks per thread - more chunks helps to even out the work when line lengths vary
+constexpr size_t ChunksPerThread = 4;
+
+// chunks smaller than this aren't worth splitting across threads
+constexpr size_t MinChunkSize = 1 << 20;
+
+inline bool isDelimiter(const char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+/**
+ * Parses up to **count** numeric columns from the line starting at **curr**. Returns the number of
+ * columns parsed - parsing stops at the first non-numeric token or the end of the line.
+ */
+size_t parseColumns(const char* curr, const char* end, double* values, const size_t count)
+{
+    size_t parsed = 0;
+    while (parsed < count)
+    {
+        while (curr < end && isDelimiter(*curr))
+        {
+            ++curr;
+        }
+        if (curr == end || *curr == '\n')
+        {
+            break;
+        }
+        // from_chars doesn't accept a leading plus sign
+        if (*curr == '+')
+        {
+            ++curr;
+        }
+
+        auto result = std::from_chars(curr, end, values[parsed]);
+        if (result.ec != std::errc())
+        {
+            break;
+        }
+        curr = result.ptr;
+        ++parsed;
+    }
+    return parsed;
+}
+
+inline const char* nextLine(const char* curr, const char* end)
+{
+    const char* lineEnd = static_cast<const char*>(std::memchr(curr, '\n', end - curr));
+    return lineEnd ? lineEnd + 1 : end;
+}
+
+template <typename T>
+inline T clampTo(const double value, const double maxValue)
+{
+    return static_cast<T>(std::min(std::max(value, 0.0), maxValue));
+}
+
+size_t countLines(const char* begin, const char* end)
+{
+    size_t count = 0;
+    const char* curr = begin;
+    while (curr < end)
+    {
+        curr = nextLine(curr, end);
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * Packed colours are either written as the integer value or as the float whose bits hold the
+ * colour (the PCL convention). The latter gives tiny or non-integer values.
+ */
+uint32_t unpackRgb(const double value)
+{
+    if (value >= 1.0 && value < 4294967296.0 && value == std::floor(value))
+    {
+        return static_cast<uint32_t>(value);
+    }
+    const float packed = static_cast<float>(value);
+    uint32_t rgb;
+    std::memcpy(&rgb, &packed, sizeof(uint32_t));
+    return rgb;
+}
+
+/// the bounds of the positions parsed by a chunk, before conversion to float
+struct ChunkBounds
+{
+    double min[3] = {DBL_MAX, DBL_MAX, DBL_MAX};
+    double max[3] = {-DBL_MAX, -DBL_MAX, -DBL_MAX};
+
+    void extend(const double* pos)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            min[i] = std::min(min[i], pos[i]);
+            max[i] = std::max(max[i], pos[i]);
+        }
+    }
+};
+
+uint32_t getAttributes(const TextLoader::Layout& layout)
+{
+    uint32_t attributes = PointCloud::AttributeFlags::Position;
+    if ((layout.red >= 0 && layout.green >= 0 && layout.blue >= 0) || layout.packedRgb >= 0)
+    {
+        attributes |= PointCloud::AttributeFlags::Colour;
+    }
+    if (layout.intensity >= 0)
+    {
+        attributes |= PointCloud::AttributeFlags::Intensity;
+    }
+    if (layout.classification >= 0)
+    {
+        attributes |= PointCloud::AttributeFlags::Classification;
+    }
+    return attributes;
+}
+
+} // namespace
+
+TextLoader::TextLoader()
+{
+}
+
+TextLoader::~TextLoader()
+{
+}
+
+const char* TextLoader::skipLines(const char* curr, const char* end, size_t count)
+{
+    for (size_t i = 0; i < count && curr < end; ++i)
+    {
+        curr = nextLine(curr, end);
+    }
+    return curr;
+}
+
+bool TextLoader::open(const char* path)
+{
+    file = std::make_shared<Util::MappedFile>();
+    if (!file->open(path))
+    {
+        return false;
+    }
+    file->adviseSequential();
+
+    std::string filename {path};
+    std::string ext = filename.substr(filename.find_last_of('.') + 1);
+    const bool isPts = ext == "pts" || ext == "PTS";
+
+    if (!detectLayout(isPts))
+    {
+        LOGGER_ERROR("Unable to find any point data in %s.", path);
+        return false;
+    }
+    return true;
+}
+
+bool TextLoader::detectLayout(const bool isPts)
+{
+    // the maximum number of lines that will be checked for a header before giving up
+    constexpr size_t MaxHeaderLines = 100;
+
+    const char* begin = reinterpret_cast<const char*>(file->data());
+    const char* end = begin + file->size();
+    const char* curr = begin;
+
+    // pts files start with the point count - this is ignored as we count the lines ourselves
+    if (isPts)
+    {
+        curr = nextLine(curr, end);
+    }
+
+    double values[MaxColumns];
+    for (size_t line = 0; line < MaxHeaderLines && curr < end; ++line)
+    {
+        size_t columns = parseColumns(curr, end, values, MaxColumns);
+        if (columns < 3)
+        {
+            // header or empty line
+            curr = nextLine(curr, end);
+            continue;
+        }
+
+        // the layout is guessed from the number of columns. This follows the conventions used by
+        // the common exporters: x y z [i] [r g b]
+        layout = Layout {};
+        if (columns == 4 || columns >= 7)
+        {
+            layout.intensity = 3;
+        }
+        if (columns == 6)
+        {
+            layout.red = 3;
+            layout.green = 4;
+            layout.blue = 5;
+        }
+        else if (columns >= 7)
+        {
+            layout.red = 4;
+            layout.green = 5;
+            layout.blue = 6;
+        }
+        layout.columnCount = std::min<size_t>(columns, 7);
+        layout.intensityOffset = isPts ? 2048.0 : 0.0;
+
+        dataOffset = static_cast<size_t>(curr - begin);
+        return true;
+    }
+    return false;
+}
+
+size_t TextLoader::getFileSize() const
+{
+    return file ? file->size() : 0;
+}
+
+std::unique_ptr<PointCloud> TextLoader::createPointCloud()
+{
+    if (!file || !file->isOpen())
+    {
+        return nullptr;
+    }
+
+    const char* begin = reinterpret_cast<const char*>(file->data());
+    return parse(begin + dataOffset, begin + file->size(), layout);
+}
+
+std::unique_ptr<PointCloud>
+TextLoader::parse(const char* begin, const char* end, const Layout& layout)
+{
+    assert(layout.columnCount <= MaxColumns);
+    assert(begin <= end);
+
+    // ========= split into newline aligned chunks ==========
+    const size_t size = static_cast<size_t>(end - begin);
+    const size_t threadCount = ThreadTaskSplitter::getHardwareThreadCount();
+    const size_t chunkCount =
+        std::max<size_t>(1, std::min(threadCount * ChunksPerThread, size / MinChunkSize));
+
+    std::vector<const char*> chunkStart(chunkCount + 1);
+    chunkStart[0] = begin;
+    chunkStart[chunkCount] = end;
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        const char* split = begin + (size / chunkCount) * i;
+        split = std::max(split, chunkStart[i - 1]);
+        chunkStart[i] = nextLine(split, end);
+    }
+
+    // ========= count the lines of each chunk ==============
+    // this gives the upper bound of points per chunk and hence the offset into the arrays
+    std::vector<size_t> lineCount(chunkCount);
+    auto countChunk = [&chunkStart, &lineCount](const size_t start, const size_t count) {
+        for (size_t i = start; i < start + count; ++i)
+        {
+            lineCount[i] = countLines(chunkStart[i], chunkStart[i + 1]);
+        }
+    };
+    ThreadTaskSplitter countWork {0, chunkCount, countChunk};
+    countWork.run();
+
+    std::vector<size_t> chunkOffset(chunkCount + 1, 0);
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        chunkOffset[i + 1] = chunkOffset[i] + lineCount[i];
+    }
+
+    // ========= find a provisional origin ===================
+    // the bounds aren't known until every chunk is parsed, so the positions are first stored
+    // relative to the first point. This keeps them small - georeferenced coordinates would lose
+    // most of their precision as floats - and they're rebased to the centre of the bounds below.
+    double base[3];
+    {
+        double values[MaxColumns];
+        const char* curr = begin;
+        while (curr < end &&
+               parseColumns(curr, end, values, layout.columnCount) < layout.columnCount)
+        {
+            curr = nextLine(curr, end);
+        }
+        if (curr == end)
+        {
+            return nullptr;
+        }
+        base[0] = values[layout.posX];
+        base[1] = values[layout.posY];
+        base[2] = values[layout.posZ];
+    }
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->allocate(chunkOffset[chunkCount], getAttributes(layout));
+    PointCloud::Storage& storage = cloud->storage;
+
+    // ========= parse each chunk in parallel ================
+    std::vector<size_t> validCount(chunkCount, 0);
+    std::vector<ChunkBounds> chunkBounds(chunkCount);
+    auto parseChunk = [&](const size_t start, const size_t count) {
+        double values[MaxColumns];
+        for (size_t i = start; i < start + count; ++i)
+        {
+            const char* curr = chunkStart[i];
+            const char* chunkEnd = chunkStart[i + 1];
+            size_t idx = chunkOffset[i];
+            ChunkBounds& bounds = chunkBounds[i];
+
+            while (curr < chunkEnd)
+            {
+                size_t columns = parseColumns(curr, chunkEnd, values, layout.columnCount);
+                curr = nextLine(curr, chunkEnd);
+                if (columns < layout.columnCount)
+                {
+                    continue;
+                }
+
+                const double pos[3] = {
+                    values[layout.posX], values[layout.posY], values[layout.posZ]};
+                bounds.extend(pos);
+                storage.posX[idx] = static_cast<float>(pos[0] - base[0]);
+                storage.posY[idx] = static_cast<float>(pos[1] - base[1]);
+                storage.posZ[idx] = static_cast<float>(pos[2] - base[2]);
+                if (!storage.red.empty() && layout.packedRgb >= 0)
+                {
+                    const uint32_t rgb = unpackRgb(values[layout.packedRgb]);
+                    storage.red[idx] = static_cast<uint8_t>(rgb >> 16);
+                    storage.green[idx] = static_cast<uint8_t>(rgb >> 8);
+                    storage.blue[idx] = static_cast<uint8_t>(rgb);
+                }
+                else if (!storage.red.empty())
+                {
+                    storage.red[idx] =
+                        clampTo<uint8_t>(values[layout.red] * layout.colourScale, 255.0);
+                    storage.green[idx] =
+                        clampTo<uint8_t>(values[layout.green] * layout.colourScale, 255.0);
+                    storage.blue[idx] =
+                        clampTo<uint8_t>(values[layout.blue] * layout.colourScale, 255.0);
+                }
+                if (!storage.intensity.empty())
+                {
+                    storage.intensity[idx] = clampTo<uint16_t>(
+                        values[layout.intensity] + layout.intensityOffset, 65535.0);
+                }
+                if (!storage.classification.empty())
+                {
+                    storage.classification[idx] =
+                        clampTo<uint8_t>(values[layout.classification], 255.0);
+                }
+                ++idx;
+            }
+            validCount[i] = idx - chunkOffset[i];
+        }
+    };
+    ThreadTaskSplitter parseWork {0, chunkCount, parseChunk};
+    parseWork.run();
+
+    // ========= concatenate the chunks ======================
+    // lines which were skipped (headers, blank lines) leave gaps at the end of each chunk
+    auto compact = [](auto& array, const size_t dst, const size_t src, const size_t count) {
+        if (!array.empty() && dst != src)
+        {
+            std::memmove(&array[dst], &array[src], count * sizeof(array[0]));
+        }
+    };
+
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        const size_t src = chunkOffset[i];
+        const size_t count = validCount[i];
+        compact(storage.posX, total, src, count);
+        compact(storage.posY, total, src, count);
+        compact(storage.posZ, total, src, count);
+        compact(storage.red, total, src, count);
+        compact(storage.green, total, src, count);
+        compact(storage.blue, total, src, count);
+        compact(storage.intensity, total, src, count);
+        compact(storage.classification, total, src, count);
+        total += count;
+    }
+
+    if (total == 0)
+    {
+        return nullptr;
+    }
+    cloud->resize(total);
+
+    // ========= rebase to the centre of the bounds ==========
+    // as LasLoader does, so the local positions are as small as possible
+    ChunkBounds bounds;
+    for (const ChunkBounds& chunk : chunkBounds)
+    {
+        bounds.extend(chunk.min);
+        bounds.extend(chunk.max);
+    }
+    const OEMaths::vec3d origin {
+        (bounds.min[0] + bounds.max[0]) * 0.5,
+        (bounds.min[1] + bounds.max[1]) * 0.5,
+        (bounds.min[2] + bounds.max[2]) * 0.5};
+    cloud->setOrigin(origin);
+
+    const float shift[3] = {
+        static_cast<float>(base[0] - origin.x),
+        static_cast<float>(base[1] - origin.y),
+        static_cast<float>(base[2] - origin.z)};
+    auto rebase = [&storage, &shift](const size_t start, const size_t count) {
+        for (size_t i = start; i < start + count; ++i)
+        {
+            storage.posX[i] += shift[0];
+            storage.posY[i] += shift[1];
+            storage.posZ[i] += shift[2];
+        }
+    };
+    ThreadTaskSplitter rebaseWork {0, total, rebase};
+    rebaseWork.run();
+
+    AABBox localBounds;
+    localBounds.extend(
+        static_cast<float>(bounds.min[0] - origin.x),
+        static_cast<float>(bounds.min[1] - origin.y),
+        static_cast<float>(bounds.min[2] - origin.z));
+    localBounds.extend(
+        static_cast<float>(bounds.max[0] - origin.x),
+        static_cast<float>(bounds.max[1] - origin.y),
+        static_cast<float>(bounds.max[2] - origin.z));
+    cloud->setBounds(localBounds);
+    return cloud;
+}
+
+} // namespace PCV
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief A loader for ASCII point formats (XYZ, PTS, CSV and the body of ASCII ply/pcd files). The
+ * mapped file is split into newline aligned chunks which are parsed in parallel directly into
+ * the preallocated attribute arrays of the point cloud.
+ */
+class TextLoader
+{
+public:
+    /// the maximum number of columns per line that can be parsed
+    static constexpr size_t MaxColumns = 16;
+
+    /**
+     * @brief Maps each attribute to a column index. A negative index states the attribute isn't
+     * present.
+     */
+    struct Layout
+    {
+        int posX = 0;
+        int posY = 1;
+        int posZ = 2;
+        int intensity = -1;
+        int red = -1;
+        int green = -1;
+        int blue = -1;
+        int classification = -1;
+
+        /// a single column holding the colour packed as 0x00RRGGBB, as used by pcd files
+        int packedRgb = -1;
+
+        /// the number of columns which need parsing for each line
+        size_t columnCount = 3;
+
+        /// added to the intensity - PTS files store intensity in the range -2048 to 2047
+        double intensityOffset = 0.0;
+
+        /// applied to the colour values - i.e. 255 for colours in the 0-1 range
+        double colourScale = 1.0;
+    };
+
+    TextLoader();
+    ~TextLoader();
+
+    /**
+     * @brief Maps the file, skips any header lines and determines the column layout from the first
+     * line of point data.
+     */
+    bool open(const char* path);
+
+    std::unique_ptr<PointCloud> createPointCloud();
+
+    size_t getFileSize() const;
+
+    /**
+     * @brief Parses the text in the range [begin, end) using all available threads. Lines which
+     * don't contain enough numeric columns are skipped. The positions are rebased to the centre
+     * of their bounds, which is set as the origin of the cloud.
+     */
+    static std::unique_ptr<PointCloud>
+    parse(const char* begin, const char* end, const Layout& layout);
+
+    /// returns a pointer to the start of the line after skipping **count** lines
+    static const char* skipLines(const char* curr, const char* end, size_t count);
+
+private:
+    bool detectLayout(const bool isPts);
+
+private:
+    std::shared_ptr<Util::MappedFile> file;
+
+    Layout layout;
+
+    /// byte offset to the first line of point data
+    size_t dataOffset = 0;
+};
+
+} // namespace PCV
@@ -0,0 +1,258 @@
+#include "BatchTransform.h"
+
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace OEMaths
+{
+
+namespace
+{
+
+// the points are processed a register at a time - eight points with AVX, or four with SSE which
+// is part of the x86-64 baseline. The wrappers keep a single kernel for both widths
+
+#if defined(__AVX__)
+
+#define OEMATHS_BATCH_SIMD 1
+
+using Batch = __m256;
+constexpr size_t BatchSize = 8;
+
+inline Batch batchSet(const float value)
+{
+    return _mm256_set1_ps(value);
+}
+inline Batch batchLoad(const float* ptr)
+{
+    return _mm256_loadu_ps(ptr);
+}
+inline void batchStore(float* ptr, const Batch value)
+{
+    _mm256_storeu_ps(ptr, value);
+}
+inline Batch batchAdd(const Batch a, const Batch b)
+{
+    return _mm256_add_ps(a, b);
+}
+inline Batch batchMul(const Batch a, const Batch b)
+{
+    return _mm256_mul_ps(a, b);
+}
+inline Batch batchMin(const Batch a, const Batch b)
+{
+    return _mm256_min_ps(a, b);
+}
+inline Batch batchMax(const Batch a, const Batch b)
+{
+    return _mm256_max_ps(a, b);
+}
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#define OEMATHS_BATCH_SIMD 1
+
+using Batch = __m128;
+constexpr size_t BatchSize = 4;
+
+inline Batch batchSet(const float value)
+{
+    return _mm_set1_ps(value);
+}
+inline Batch batchLoad(const float* ptr)
+{
+    return _mm_loadu_ps(ptr);
+}
+inline void batchStore(float* ptr, const Batch value)
+{
+    _mm_storeu_ps(ptr, value);
+}
+inline Batch batchAdd(const Batch a, const Batch b)
+{
+    return _mm_add_ps(a, b);
+}
+inline Batch batchMul(const Batch a, const Batch b)
+{
+    return _mm_mul_ps(a, b);
+}
+inline Batch batchMin(const Batch a, const Batch b)
+{
+    return _mm_min_ps(a, b);
+}
+inline Batch batchMax(const Batch a, const Batch b)
+{
+    return _mm_max_ps(a, b);
+}
+
+#endif
+
+#if defined(OEMATHS_BATCH_SIMD)
+
+/// the minimum and maximum of the lanes of each register
+inline void reduceBounds(const Batch min, const Batch max, float& outMin, float& outMax)
+{
+    alignas(32) float lanes[BatchSize];
+    batchStore(lanes, min);
+    outMin = std::min(outMin, *std::min_element(lanes, lanes + BatchSize));
+    batchStore(lanes, max);
+    outMax = std::max(outMax, *std::max_element(lanes, lanes + BatchSize));
+}
+
+#endif
+
+/**
+ * @brief The shared implementation - the bounds are only tracked when needed, which the compiler
+ * removes entirely when **TrackBounds** is false
+ */
+template <bool Transform, bool TrackBounds>
+void processPoints(
+    const mat4f& mat,
+    const float* inX,
+    const float* inY,
+    const float* inZ,
+    const size_t count,
+    float* outX,
+    float* outY,
+    float* outZ,
+    vec3f& boundsMin,
+    vec3f& boundsMax)
+{
+    size_t i = 0;
+
+#if defined(OEMATHS_BATCH_SIMD)
+    // the matrix elements are broadcast once, each row of the result is then three multiplies and
+    // three adds in the same order as the scalar path
+    Batch m[4][3];
+    for (size_t col = 0; col < 4; ++col)
+    {
+        for (size_t row = 0; row < 3; ++row)
+        {
+            m[col][row] = batchSet(mat.data[col][row]);
+        }
+    }
+
+    Batch minX = batchSet(boundsMin.x);
+    Batch minY = batchSet(boundsMin.y);
+    Batch minZ = batchSet(boundsMin.z);
+    Batch maxX = batchSet(boundsMax.x);
+    Batch maxY = batchSet(boundsMax.y);
+    Batch maxZ = batchSet(boundsMax.z);
+
+    for (; i + BatchSize <= count; i += BatchSize)
+    {
+        Batch x = batchLoad(inX + i);
+        Batch y = batchLoad(inY + i);
+        Batch z = batchLoad(inZ + i);
+
+        if constexpr (Transform)
+        {
+            Batch out[3];
+            for (size_t row = 0; row < 3; ++row)
+            {
+                Batch sum = batchMul(m[0][row], x);
+                sum = batchAdd(sum, batchMul(m[1][row], y));
+                sum = batchAdd(sum, batchMul(m[2][row], z));
+                out[row] = batchAdd(sum, m[3][row]);
+            }
+            x = out[0];
+            y = out[1];
+            z = out[2];
+            batchStore(outX + i, x);
+            batchStore(outY + i, y);
+            batchStore(outZ + i, z);
+        }
+
+        if constexpr (TrackBounds)
+        {
+            minX = batchMin(minX, x);
+            minY = batchMin(minY, y);
+            minZ = batchMin(minZ, z);
+            maxX = batchMax(maxX, x);
+            maxY = batchMax(maxY, y);
+            maxZ = batchMax(maxZ, z);
+        }
+    }
+
+    if constexpr (TrackBounds)
+    {
+        reduceBounds(minX, maxX, boundsMin.x, boundsMax.x);
+        reduceBounds(minY, maxY, boundsMin.y, boundsMax.y);
+        reduceBounds(minZ, maxZ, boundsMin.z, boundsMax.z);
+    }
+#endif
+
+    // the tail, or all the points without SIMD
+    for (; i < count; ++i)
+    {
+        float x = inX[i];
+        float y = inY[i];
+        float z = inZ[i];
+
+        if constexpr (Transform)
+        {
+            const float tx = mat.data[0][0] * x + mat.data[1][0] * y + mat.data[2][0] * z +
+                mat.data[3][0];
+            const float ty = mat.data[0][1] * x + mat.data[1][1] * y + mat.data[2][1] * z +
+                mat.data[3][1];
+            const float tz = mat.data[0][2] * x + mat.data[1][2] * y + mat.data[2][2] * z +
+                mat.data[3][2];
+            x = tx;
+            y = ty;
+            z = tz;
+            outX[i] = x;
+            outY[i] = y;
+            outZ[i] = z;
+        }
+
+        if constexpr (TrackBounds)
+        {
+            boundsMin.x = std::min(boundsMin.x, x);
+            boundsMin.y = std::min(boundsMin.y, y);
+            boundsMin.z = std::min(boundsMin.z, z);
+            boundsMax.x = std::max(boundsMax.x, x);
+            boundsMax.y = std::max(boundsMax.y, y);
+            boundsMax.z = std::max(boundsMax.z, z);
+        }
+    }
+}
+
+} // namespace
+
+void transformPoints(
+    const mat4f& mat,
+    const float* inX,
+    const float* inY,
+    const float* inZ,
+    const size_t count,
+    float* outX,
+    float* outY,
+    float* outZ,
+    vec3f* boundsMin,
+    vec3f* boundsMax)
+{
+    assert((boundsMin == nullptr) == (boundsMax == nullptr));
+    if (boundsMin)
+    {
+        processPoints<true, true>(
+            mat, inX, inY, inZ, count, outX, outY, outZ, *boundsMin, *boundsMax);
+        return;
+    }
+
+    vec3f unused;
+    processPoints<true, false>(mat, inX, inY, inZ, count, outX, outY, outZ, unused, unused);
+}
+
+void computeBounds(
+    const float* x, const float* y, const float* z, const size_t count, vec3f& min, vec3f& max)
+{
+    const mat4f identity;
+    processPoints<false, true>(
+        identity, x, y, z, count, nullptr, nullptr, nullptr, min, max);
+}
+
+} // namespace OEMaths
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "OEMaths.h"
+
+#include <cstddef>
+
+namespace OEMaths
+{
+
+/**
+ * @brief Transforms points stored as separate x, y and z arrays (SoA) by an affine matrix, i.e.
+ * for rebasing or moving points into world space. Eight points are transformed at a time with AVX
+ * when available and four with SSE otherwise, with the remainder done one at a time. The output
+ * arrays may be the same as the input arrays to transform the points in place.
+ * @param boundsMin If not null, extended by the minimum of the transformed points - so bounds can
+ * be accumulated across several calls
+ * @param boundsMax As **boundsMin**, for the maximum
+ */
+void transformPoints(
+    const mat4f& mat,
+    const float* inX,
+    const float* inY,
+    const float* inZ,
+    size_t count,
+    float* outX,
+    float* outY,
+    float* outZ,
+    vec3f* boundsMin = nullptr,
+    vec3f* boundsMax = nullptr);
+
+/**
+ * @brief Extends the bounds by the points stored as separate x, y and z arrays
+ */
+void computeBounds(
+    const float* x, const float* y, const float* z, size_t count, vec3f& min, vec3f& max);
+
+} // namespace OEMaths
@@ -13,17 +13,16 @@ class MatN<T, 2, 2> : public MatMathOperators<MatN, T, 2, 2>
 {
 public:
 
-    inline void setCol(size_t col, const VecN<T, 2>& vec)
+    inline constexpr void setCol(size_t col, const VecN<T, 2>& vec)
     {
         assert(col < NUM_COLS);
         data[col] = vec;
     }
 
     // init as identity matrix
-    MatN()
+    constexpr MatN()
+        : data {{T(1), T(0)}, {T(0), T(1)}}
     {
-        setCol(0, { 1.0f, 0.0f });
-        setCol(1, { 0.0f, 1.0f });
     }
 
     inline constexpr VecN<T, 2>& operator[](const size_t &idx)
@@ -44,8 +43,8 @@ public:
 
     inline constexpr MatN<T, 2, 2>& setDiag(const VecN<T, 2>& vec)
     {
-        data[0][0] = vec.x;
-        data[1][1] = vec.y;
+        data[0][0] = vec[0];
+        data[1][1] = vec[1];
         return *this;
     }
     
@@ -15,18 +15,16 @@ class MatN<T, 3, 3> : public MatMathOperators<MatN, T,3, 3>
 {
 public:
 
-    inline void setCol(size_t col, const VecN<T, 3>& vec)
+    inline constexpr void setCol(size_t col, const VecN<T, 3>& vec)
     {
         assert(col < NUM_COLS);
         data[col] = vec;
     }
 
     // init as identity matrix
-    MatN()
+    constexpr MatN()
+        : data {{T(1), T(0), T(0)}, {T(0), T(1), T(0)}, {T(0), T(0), T(1)}}
     {
-        setCol(0, { 1.0f, 0.0f, 0.0f });
-        setCol(1, { 0.0f, 1.0f, 0.0f });
-        setCol(2, { 0.0f, 0.0f, 1.0f });
     }
 
     // contrsuctor - converts a quaternion to a 3x3 matrix
@@ -73,17 +71,17 @@ public:
 
     inline constexpr MatN<T, 3, 3> setDiag(const VecN<T, 3>& vec)
     {
-        data[0][0] = vec.x;
-        data[1][1] = vec.y;
-        data[2][2] = vec.z;
+        data[0][0] = vec[0];
+        data[1][1] = vec[1];
+        data[2][2] = vec[2];
         return *this;
     }
     
     inline constexpr MatN<T, 3, 3> translate(const VecN<T, 3>& trans)
     {
-        data[2][0] = trans.x;
-        data[2][1] = trans.y;
-        data[2][2] = trans.z;
+        data[2][0] = trans[0];
+        data[2][1] = trans[1];
+        data[2][2] = trans[2];
         return *this;
     }
 
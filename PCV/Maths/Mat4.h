@@ -10,6 +10,12 @@
 #include <cstddef>
 #include <cstdint>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 namespace OEMaths
 {
 
@@ -21,19 +27,20 @@ public:
     static constexpr size_t NUM_COLS = 4;
     static constexpr size_t MAT_SIZE = 16;
 
-    inline void setCol(size_t col, const VecN<T, 4>& vec)
+    inline constexpr void setCol(size_t col, const VecN<T, 4>& vec)
     {
         assert(col < 4);
         data[col] = vec;
     }
 
     // init as identity matrix
-    MatN()
+    constexpr MatN()
+        : data {
+              {T(1), T(0), T(0), T(0)},
+              {T(0), T(1), T(0), T(0)},
+              {T(0), T(0), T(1), T(0)},
+              {T(0), T(0), T(0), T(1)}}
     {
-        setCol(0, {1.0f, 0.0f, 0.0f, 0.0f});
-        setCol(1, {0.0f, 1.0f, 0.0f, 0.0f});
-        setCol(2, {0.0f, 0.0f, 1.0f, 0.0f});
-        setCol(3, {0.0f, 0.0f, 0.0f, 1.0f});
     }
 
     // contrsuctor - converts a queternion to a 3x3 rotation matrix, fitted into a 4x4
@@ -66,10 +73,10 @@ public:
 public:
     inline constexpr MatN<T, 4, 4> setDiag(const VecN<T, 4>& vec)
     {
-        data[0][0] = vec.x;
-        data[1][1] = vec.y;
-        data[2][2] = vec.z;
-        data[3][3] = vec.w;
+        data[0][0] = vec[0];
+        data[1][1] = vec[1];
+        data[2][2] = vec[2];
+        data[3][3] = vec[3];
         return *this;
     }
 
@@ -86,14 +93,14 @@ public:
         MatN<T, 3, 3> result;
         for (size_t i = 0; i < 3; ++i)
         {
-            result.data[i] = data[i].xyz;
+            result.data[i] = VecN<T, 3> {data[i][0], data[i][1], data[i][2]};
         }
         return result;
     }
 
     inline constexpr VecN<T, 3> getTrans()
     {
-        return data[3].xyz;
+        return VecN<T, 3> {data[3][0], data[3][1], data[3][2]};
     }
 
     // ========= static matrix transforms ==================
@@ -101,9 +108,9 @@ public:
     static inline constexpr MatN<T, 4, 4> translate(const VecN<T, 3>& trans)
     {
         MatN<T, 4, 4> result;
-        result.data[3][0] = trans.x;
-        result.data[3][1] = trans.y;
-        result.data[3][2] = trans.z;
+        result.data[3][0] = trans[0];
+        result.data[3][1] = trans[1];
+        result.data[3][2] = trans[2];
         result.data[3][3] = T(1);
         return result;
     }
@@ -111,9 +118,9 @@ public:
     static inline constexpr MatN<T, 4, 4> scale(const VecN<T, 3>& scale)
     {
         MatN<T, 4, 4> result;
-        result.data[0][0] = scale.x;
-        result.data[1][1] = scale.y;
-        result.data[2][2] = scale.z;
+        result.data[0][0] = scale[0];
+        result.data[1][1] = scale[1];
+        result.data[2][2] = scale[2];
         return result;
     }
 
@@ -153,105 +160,378 @@ public:
     }
 
     /**
-     * @brief A faster version of the inverse function (comapred to the MatN version) for mat4x4
+     * @brief A faster version of the inverse function (comapred to the MatN version) for mat4x4.
+     * Returns the identity matrix if the matrix is singular.
      */
-    static MatN<T, 4, 4> inverse(MatN<T, 4, 4>& mat)
+    static MatN<T, 4, 4> inverse(const MatN<T, 4, 4>& mat)
     {
-        MatN<T, 4, 4> inv, result;
-        T det;
+        return matInverse(mat);
+    }
 
-        inv[0] = mat[1][1] * mat[2][2] * mat[3][3] - mat[1][1] * mat[2][1] * mat[3][1] -
-            mat[2][1] * mat[1][2] * mat[3][3] + mat[2][1] * mat[1][3] * mat[3][2] +
-            mat[3][1] * mat[1][2] * mat[2][3] - mat[3][1] * mat[1][3] * mat[2][2];
+public:
+    /**
+     * coloumn major - data can be accesed by [col][row] format.
+     */
+    VecN<T, NUM_ROWS> data[NUM_COLS];
+};
 
-        inv[4] = -mat[1][0] * mat[2][2] * mat[3][3] + mat[1][0] * mat[2][1] * mat[3][2] +
-            mat[2][0] * mat[1][2] * mat[3][3] - mat[2][0] * mat[1][3] * mat[3][2] -
-            mat[3][0] * mat[1][2] * mat[2][3] + mat[3][0] * mat[1][3] * mat[2][2];
+using mat4f = MatN<float, 4, 4>;
+using mat4d = MatN<double, 4, 4>;
 
-        inv[8] = mat[1][0] * mat[2][1] * mat[3][3] - mat[1][0] * mat[2][3] * mat[3][1] -
-            mat[2][0] * mat[1][1] * mat[3][3] + mat[2][0] * mat[1][3] * mat[3][1] +
-            mat[3][0] * mat[1][1] * mat[2][3] - mat[3][0] * mat[1][3] * mat[2][1];
+// ================ scalar kernels ======================
+// the reference implementations, used for all types without a SIMD kernel
 
-        inv[12] = -mat[1][0] * mat[2][1] * mat[3][2] + mat[1][0] * mat[2][2] * mat[3][1] +
-            mat[2][0] * mat[1][1] * mat[3][2] - mat[2][0] * mat[1][2] * mat[3][1] -
-            mat[3][0] * mat[1][1] * mat[2][2] + mat[3][0] * mat[1][2] * mat[2][1];
+namespace Scalar
+{
 
-        inv[1] = -mat[0][1] * mat[2][2] * mat[3][3] + mat[0][1] * mat[2][3] * mat[3][2] +
-            mat[2][1] * mat[0][2] * mat[3][3] - mat[2][1] * mat[0][3] * mat[3][2] -
-            mat[3][1] * mat[0][2] * mat[2][3] + mat[3][1] * mat[0][3] * mat[2][2];
+template <typename T>
+constexpr MatN<T, 4, 4> multiply(const MatN<T, 4, 4>& m1, const MatN<T, 4, 4>& m2)
+{
+    MatN<T, 4, 4> result;
+    for (size_t j = 0; j < 4; ++j)
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            result.data[j][i] = m1.data[0][i] * m2.data[j][0] + m1.data[1][i] * m2.data[j][1] +
+                m1.data[2][i] * m2.data[j][2] + m1.data[3][i] * m2.data[j][3];
+        }
+    }
+    return result;
+}
 
-        inv[5] = mat[0][0] * mat[2][2] * mat[3][3] - mat[0][0] * mat[11] * mat[3][2] -
-            mat[2][0] * mat[0][2] * mat[3][3] + mat[2][0] * mat[0][3] * mat[3][2] +
-            mat[3][0] * mat[0][2] * mat[11] - mat[3][0] * mat[0][3] * mat[2][2];
+template <typename T>
+constexpr VecN<T, 4> multiply(const MatN<T, 4, 4>& mat, const VecN<T, 4>& vec)
+{
+    VecN<T, 4> result;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        result[i] = mat.data[0][i] * vec[0] + mat.data[1][i] * vec[1] + mat.data[2][i] * vec[2] +
+            mat.data[3][i] * vec[3];
+    }
+    return result;
+}
 
-        inv[9] = -mat[0][0] * mat[2][1] * mat[3][3] + mat[0][0] * mat[2][3] * mat[3][1] +
-            mat[2][0] * mat[0][1] * mat[3][3] - mat[2][0] * mat[0][3] * mat[3][1] -
-            mat[3][0] * mat[0][1] * mat[2][3] + mat[3][0] * mat[0][3] * mat[2][1];
+/**
+ * @brief Inverse by cofactor expansion. As the inverse of the transpose is the transpose of the
+ * inverse, this works on the flattened matrix whichever way it is ordered.
+ */
+template <typename T>
+MatN<T, 4, 4> inverse(const MatN<T, 4, 4>& mat)
+{
+    T m[16];
+    for (size_t i = 0; i < 16; ++i)
+    {
+        m[i] = mat.data[i / 4][i % 4];
+    }
 
-        inv[13] = mat[0][0] * mat[2][1] * mat[3][2] - mat[0][0] * mat[2][2] * mat[3][1] -
-            mat[2][0] * mat[0][1] * mat[3][2] + mat[2][0] * mat[0][2] * mat[3][1] +
-            mat[3][0] * mat[0][1] * mat[2][2] - mat[3][0] * mat[0][2] * mat[2][1];
+    T inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+        m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
 
-        inv[2] = mat[0][1] * mat[1][2] * mat[3][3] - mat[0][1] * mat[1][3] * mat[3][2] -
-            mat[1][1] * mat[0][2] * mat[3][3] + mat[1][1] * mat[0][3] * mat[3][2] +
-            mat[3][1] * mat[0][2] * mat[1][3] - mat[3][1] * mat[0][3] * mat[1][2];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+        m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
 
-        inv[6] = -mat[0][0] * mat[1][2] * mat[3][3] + mat[0][0] * mat[1][3] * mat[3][2] +
-            mat[1][0] * mat[0][2] * mat[3][3] - mat[1][0] * mat[0][3] * mat[3][2] -
-            mat[3][0] * mat[0][2] * mat[1][3] + mat[3][0] * mat[0][3] * mat[1][2];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+        m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
 
-        inv[10] = mat[0][0] * mat[1][1] * mat[3][3] - mat[0][0] * mat[1][3] * mat[3][1] -
-            mat[1][0] * mat[0][1] * mat[3][3] + mat[1][0] * mat[0][3] * mat[3][1] +
-            mat[3][0] * mat[0][1] * mat[1][3] - mat[3][0] * mat[0][3] * mat[1][1];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+        m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
 
-        inv[14] = -mat[0][0] * mat[1][1] * mat[3][2] + mat[0][0] * mat[1][2] * mat[3][1] +
-            mat[1][0] * mat[0][1] * mat[3][2] - mat[1][0] * mat[0][2] * mat[3][1] -
-            mat[3][0] * mat[0][1] * mat[1][2] + mat[3][0] * mat[0][2] * mat[1][1];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
+        m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
 
-        inv[3] = -mat[0][1] * mat[1][2] * mat[2][3] + mat[0][1] * mat[1][3] * mat[2][2] +
-            mat[1][1] * mat[0][2] * mat[2][3] - mat[1][1] * mat[0][3] * mat[2][2] -
-            mat[2][1] * mat[0][2] * mat[1][3] + mat[2][1] * mat[0][3] * mat[1][2];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+        m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
 
-        inv[7] = mat[0][0] * mat[1][2] * mat[2][3] - mat[0][0] * mat[1][3] * mat[2][2] -
-            mat[1][0] * mat[0][2] * mat[2][3] + mat[1][0] * mat[0][3] * mat[2][2] +
-            mat[2][0] * mat[0][2] * mat[1][3] - mat[2][0] * mat[0][3] * mat[1][2];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
+        m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
 
-        inv[11] = -mat[0][0] * mat[1][1] * mat[2][3] + mat[0][0] * mat[1][3] * mat[2][1] +
-            mat[1][0] * mat[0][1] * mat[2][3] - mat[1][0] * mat[0][3] * mat[2][1] -
-            mat[2][0] * mat[0][1] * mat[1][3] + mat[2][0] * mat[0][3] * mat[1][1];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+        m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
 
-        inv[15] = mat[0][0] * mat[1][1] * mat[2][2] - mat[0][0] * mat[1][2] * mat[2][1] -
-            mat[1][0] * mat[0][1] * mat[2][2] + mat[1][0] * mat[0][2] * mat[2][1] +
-            mat[2][0] * mat[0][1] * mat[1][2] - mat[2][0] * mat[0][2] * mat[1][1];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+        m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
 
-        det = mat[0][0] * inv[0][0] + mat[0][1] * inv[1][0] + mat[0][2] * inv[2][0] +
-            mat[0][3] * inv[3][0];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+        m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
 
-        if (det == 0.0f)
-        {
-            // just return a identity matrix
-            return {};
-        }
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+        m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
 
-        det = 1.0f / det;
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
+        m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
 
-        for (uint32_t i = 0; i < 16; i++)
-        {
-            result[i] = inv[i] * det;
-        }
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+        m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
 
-        return result;
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+        m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+        m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+        m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    const T det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == T(0))
+    {
+        // just return a identity matrix
+        return {};
     }
 
-public:
-    /**
-     * coloumn major - data can be accesed by [col][row] format.
-     */
-    VecN<T, NUM_ROWS> data[NUM_COLS];
-};
+    const T invDet = T(1) / det;
+    MatN<T, 4, 4> result;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        result.data[i / 4][i % 4] = inv[i] * invDet;
+    }
+    return result;
+}
 
-using mat4f = MatN<float, 4, 4>;
-using mat4d = MatN<double, 4, 4>;
+} // namespace Scalar
+
+// ================ SIMD kernels ========================
+// SSE is part of the x86-64 baseline so is always used there, while AVX is used for the matrix
+// product when the compiler targets it. The products follow the same order of operations as the
+// scalar kernels so give the same results, unless the compiler contracts either into FMAs
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define OEMATHS_SIMD_SSE 1
+#endif
+
+#if defined(OEMATHS_SIMD_SSE)
+
+namespace Simd
+{
+
+inline MatN<float, 4, 4> multiply(const MatN<float, 4, 4>& m1, const MatN<float, 4, 4>& m2)
+{
+    MatN<float, 4, 4> result;
+#if defined(__AVX__)
+    // two result columns at a time, with the columns of m1 duplicated into both lanes
+    const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1.data[0].data));
+    const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1.data[1].data));
+    const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1.data[2].data));
+    const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m1.data[3].data));
+    for (size_t j = 0; j < 4; j += 2)
+    {
+        const __m256 cols = _mm256_loadu_ps(m2.data[j].data);
+        __m256 sum = _mm256_mul_ps(c0, _mm256_shuffle_ps(cols, cols, 0x00));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(c1, _mm256_shuffle_ps(cols, cols, 0x55)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(c2, _mm256_shuffle_ps(cols, cols, 0xaa)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(c3, _mm256_shuffle_ps(cols, cols, 0xff)));
+        _mm256_storeu_ps(result.data[j].data, sum);
+    }
+#else
+    const __m128 c0 = _mm_loadu_ps(m1.data[0].data);
+    const __m128 c1 = _mm_loadu_ps(m1.data[1].data);
+    const __m128 c2 = _mm_loadu_ps(m1.data[2].data);
+    const __m128 c3 = _mm_loadu_ps(m1.data[3].data);
+    for (size_t j = 0; j < 4; ++j)
+    {
+        const __m128 col = _mm_loadu_ps(m2.data[j].data);
+        __m128 sum = _mm_mul_ps(c0, _mm_shuffle_ps(col, col, 0x00));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_shuffle_ps(col, col, 0x55)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_shuffle_ps(col, col, 0xaa)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_shuffle_ps(col, col, 0xff)));
+        _mm_storeu_ps(result.data[j].data, sum);
+    }
+#endif
+    return result;
+}
+
+inline VecN<float, 4> multiply(const MatN<float, 4, 4>& mat, const VecN<float, 4>& vec)
+{
+    const __m128 v = _mm_loadu_ps(vec.data);
+    __m128 sum = _mm_mul_ps(_mm_loadu_ps(mat.data[0].data), _mm_shuffle_ps(v, v, 0x00));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat.data[1].data), _mm_shuffle_ps(v, v, 0x55)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat.data[2].data), _mm_shuffle_ps(v, v, 0xaa)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(mat.data[3].data), _mm_shuffle_ps(v, v, 0xff)));
+
+    VecN<float, 4> result;
+    _mm_storeu_ps(result.data, sum);
+    return result;
+}
+
+namespace Detail
+{
+
+// the 2x2 matrices are stored in a single register as (m00, m01, m10, m11)
+#define OEMATHS_SHUFFLE(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+
+// A * B
+inline __m128 mat2Mul(const __m128 a, const __m128 b)
+{
+    return _mm_add_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, OEMATHS_SHUFFLE(0, 3, 0, 3))),
+        _mm_mul_ps(
+            _mm_shuffle_ps(a, a, OEMATHS_SHUFFLE(1, 0, 3, 2)),
+            _mm_shuffle_ps(b, b, OEMATHS_SHUFFLE(2, 1, 2, 1))));
+}
+
+// adj(A) * B
+inline __m128 mat2AdjMul(const __m128 a, const __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(a, a, OEMATHS_SHUFFLE(3, 3, 0, 0)), b),
+        _mm_mul_ps(
+            _mm_shuffle_ps(a, a, OEMATHS_SHUFFLE(1, 1, 2, 2)),
+            _mm_shuffle_ps(b, b, OEMATHS_SHUFFLE(2, 3, 0, 1))));
+}
+
+// A * adj(B)
+inline __m128 mat2MulAdj(const __m128 a, const __m128 b)
+{
+    return _mm_sub_ps(
+        _mm_mul_ps(a, _mm_shuffle_ps(b, b, OEMATHS_SHUFFLE(3, 0, 3, 0))),
+        _mm_mul_ps(
+            _mm_shuffle_ps(a, a, OEMATHS_SHUFFLE(1, 0, 3, 2)),
+            _mm_shuffle_ps(b, b, OEMATHS_SHUFFLE(2, 1, 2, 1))));
+}
+
+} // namespace Detail
+
+/**
+ * @brief Inverse using 2x2 sub-matrices - the inverse of the block matrix (A B, C D) is built from
+ * the adjugates and determinants of the blocks. The columns are treated as the rows, which gives
+ * the inverse of the transpose - and so the inverse when stored back as columns.
+ */
+inline MatN<float, 4, 4> inverse(const MatN<float, 4, 4>& mat)
+{
+    using namespace Detail;
+
+    const __m128 r0 = _mm_loadu_ps(mat.data[0].data);
+    const __m128 r1 = _mm_loadu_ps(mat.data[1].data);
+    const __m128 r2 = _mm_loadu_ps(mat.data[2].data);
+    const __m128 r3 = _mm_loadu_ps(mat.data[3].data);
+
+    const __m128 a = _mm_movelh_ps(r0, r1);
+    const __m128 b = _mm_movehl_ps(r1, r0);
+    const __m128 c = _mm_movelh_ps(r2, r3);
+    const __m128 d = _mm_movehl_ps(r3, r2);
+
+    // the determinants of the blocks as (|A|, |B|, |C|, |D|)
+    const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(
+            _mm_shuffle_ps(r0, r2, OEMATHS_SHUFFLE(0, 2, 0, 2)),
+            _mm_shuffle_ps(r1, r3, OEMATHS_SHUFFLE(1, 3, 1, 3))),
+        _mm_mul_ps(
+            _mm_shuffle_ps(r0, r2, OEMATHS_SHUFFLE(1, 3, 1, 3)),
+            _mm_shuffle_ps(r1, r3, OEMATHS_SHUFFLE(0, 2, 0, 2))));
+    const __m128 detA = _mm_shuffle_ps(detSub, detSub, OEMATHS_SHUFFLE(0, 0, 0, 0));
+    const __m128 detB = _mm_shuffle_ps(detSub, detSub, OEMATHS_SHUFFLE(1, 1, 1, 1));
+    const __m128 detC = _mm_shuffle_ps(detSub, detSub, OEMATHS_SHUFFLE(2, 2, 2, 2));
+    const __m128 detD = _mm_shuffle_ps(detSub, detSub, OEMATHS_SHUFFLE(3, 3, 3, 3));
+
+    const __m128 adjDC = mat2AdjMul(d, c);
+    const __m128 adjAB = mat2AdjMul(a, b);
+
+    // the adjugates of the blocks of the inverse, scaled by its determinant
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Mul(b, adjDC));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Mul(c, adjAB));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MulAdj(d, adjAB));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MulAdj(a, adjDC));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 tr = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, OEMATHS_SHUFFLE(0, 2, 1, 3)));
+    tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, OEMATHS_SHUFFLE(1, 0, 3, 2)));
+    tr = _mm_shuffle_ps(tr, tr, OEMATHS_SHUFFLE(0, 0, 0, 0));
+    const __m128 det =
+        _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    if (_mm_cvtss_f32(det) == 0.0f)
+    {
+        // just return a identity matrix
+        return {};
+    }
+
+    // the signs also apply the adjugate to the blocks
+    const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, invDet);
+    y = _mm_mul_ps(y, invDet);
+    z = _mm_mul_ps(z, invDet);
+    w = _mm_mul_ps(w, invDet);
+
+    MatN<float, 4, 4> result;
+    _mm_storeu_ps(result.data[0].data, _mm_shuffle_ps(x, y, OEMATHS_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(result.data[1].data, _mm_shuffle_ps(x, y, OEMATHS_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(result.data[2].data, _mm_shuffle_ps(z, w, OEMATHS_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_ps(result.data[3].data, _mm_shuffle_ps(z, w, OEMATHS_SHUFFLE(2, 0, 2, 0)));
+    return result;
+}
+
+#undef OEMATHS_SHUFFLE
+
+} // namespace Simd
+
+#endif
+
+// ================ kernel selection ====================
+
+template <typename T>
+constexpr MatN<T, 4, 4> matMul(const MatN<T, 4, 4>& m1, const MatN<T, 4, 4>& m2)
+{
+    return Scalar::multiply(m1, m2);
+}
+
+template <typename T>
+constexpr VecN<T, 4> matVecMul(const MatN<T, 4, 4>& mat, const VecN<T, 4>& vec)
+{
+    return Scalar::multiply(mat, vec);
+}
+
+template <typename T>
+MatN<T, 4, 4> matInverse(const MatN<T, 4, 4>& mat)
+{
+    return Scalar::inverse(mat);
+}
+
+#if defined(OEMATHS_SIMD_SSE)
+
+// the intrinsics can't be evaluated at compile time, so the products of constant expressions use
+// the scalar kernels. Compilers without the builtin always use the SIMD kernels, so the products
+// can't be constant expressions there
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define OEMATHS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define OEMATHS_SIMD_CONSTEXPR constexpr
+#define OEMATHS_CONSTEXPR_MAT4_PRODUCTS 1
+#else
+#define OEMATHS_CONSTANT_EVALUATED() false
+#define OEMATHS_SIMD_CONSTEXPR
+#endif
+
+inline OEMATHS_SIMD_CONSTEXPR mat4f matMul(const mat4f& m1, const mat4f& m2)
+{
+    if (OEMATHS_CONSTANT_EVALUATED())
+    {
+        return Scalar::multiply(m1, m2);
+    }
+    return Simd::multiply(m1, m2);
+}
+
+inline OEMATHS_SIMD_CONSTEXPR vec4f matVecMul(const mat4f& mat, const vec4f& vec)
+{
+    if (OEMATHS_CONSTANT_EVALUATED())
+    {
+        return Scalar::multiply(mat, vec);
+    }
+    return Simd::multiply(mat, vec);
+}
+
+inline mat4f matInverse(const mat4f& mat)
+{
+    return Simd::inverse(mat);
+}
+
+#endif
+
+// without the SIMD kernels the products are always constant expressions
+#if !defined(OEMATHS_SIMD_SSE)
+#define OEMATHS_CONSTEXPR_MAT4_PRODUCTS 1
+#endif
 
 
 } // namespace OEMaths
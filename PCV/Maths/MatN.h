@@ -16,39 +16,34 @@ template <
     size_t rows>
 class MatMathOperators
 {
+public:
     // muliplication
-    Mat<T, cols, rows>& operator*=(const T& div)
+    inline constexpr Mat<T, cols, rows>& operator*=(const T& value)
     {
-        Mat<T, cols, rows>& lhs = static_cast<Mat<T, cols, rows>&>(&this);
+        Mat<T, cols, rows>& lhs = static_cast<Mat<T, cols, rows>&>(*this);
         for (size_t i = 0; i < cols; ++i)
         {
-            lhs[i] *= div;
+            lhs[i] *= value;
         }
         return lhs;
     }
 
-    inline friend Mat<T, cols, rows>
+    // the products are forwarded to free functions so sizes with SIMD kernels (i.e. mat4f) can
+    // overload them - see Mat4.h
+    inline friend constexpr Mat<T, cols, rows>
     operator*(const Mat<T, cols, rows>& m1, const Mat<T, cols, rows>& m2)
     {
-        Mat<T, cols, rows> result;
-        for (size_t j = 0; j < cols; ++j)
-        {
-            result[j] = m1 * m2[j];
-        }
-        return result;
+        return matMul(m1, m2);
     }
 
-    inline friend VecN<T, rows> operator*(const Mat<T, cols, rows>& mat, const VecN<T, cols>& vec)
+    inline friend constexpr VecN<T, rows>
+    operator*(const Mat<T, cols, rows>& mat, const VecN<T, cols>& vec)
     {
-        VecN<T, rows> result {T(0)};
-        for (size_t j = 0; j < cols; ++j)
-        {
-            result += mat[j] * vec[j];
-        }
-        return result;
+        return matVecMul(mat, vec);
     }
 
-    inline friend VecN<T, rows> operator*(const VecN<T, rows>& vec, const Mat<T, cols, rows>& mat)
+    inline friend constexpr VecN<T, rows>
+    operator*(const VecN<T, rows>& vec, const Mat<T, cols, rows>& mat)
     {
         VecN<T, rows> result {T(0)};
         for (size_t j = 0; j < cols; ++j)
@@ -58,7 +53,8 @@ class MatMathOperators
         return result;
     }
 
-    inline friend VecN<T, rows> operator*(const Mat<T, cols, rows>& mat, const T& sca)
+    inline friend constexpr Mat<T, cols, rows>
+    operator*(const Mat<T, cols, rows>& mat, const T& sca)
     {
         Mat<T, cols, rows> result;
         for (size_t j = 0; j < cols; ++j)
@@ -69,12 +65,12 @@ class MatMathOperators
     }
 
     // division
-    Mat<T, cols, rows>& operator/=(const T& div)
+    inline constexpr Mat<T, cols, rows>& operator/=(const T& value)
     {
-        Mat<T, cols, rows>& lhs = static_cast<Mat<T, cols, rows>&>(&this);
+        Mat<T, cols, rows>& lhs = static_cast<Mat<T, cols, rows>&>(*this);
         for (size_t i = 0; i < cols; ++i)
         {
-            lhs[i] /= div;
+            lhs[i] /= value;
         }
         return lhs;
     }
@@ -85,30 +81,21 @@ class MatN : public MatMathOperators<MatN, T, cols, rows>
 {
 public:
     // initialise to identity
-    MatN()
+    constexpr MatN()
     {
-    }
-
-    // copy
-    MatN(const MatN<T, cols, rows>& other)
-    {
-        for (size_t i = 0; i < cols; ++i)
+        for (size_t i = 0; i < cols && i < rows; ++i)
         {
-            data[i] = other[i];
+            data[i][i] = T(1);
         }
     }
 
-    // assignment
-    inline MatN<T, cols, rows>& operator=(const MatN<T, cols, rows>& other)
+    inline constexpr VecN<T, rows>& operator[](const size_t idx)
     {
-        if (this != &other)
-        {
-            MatN {other};
-        }
-        return *this;
+        assert(idx < cols);
+        return data[idx];
     }
 
-    inline constexpr MatN<T, cols, rows>& operator[](const size_t idx)
+    inline constexpr VecN<T, rows> operator[](const size_t idx) const
     {
         assert(idx < cols);
         return data[idx];
@@ -122,20 +109,45 @@ public:
     VecN<T, ROW_SIZE> data[COL_SIZE];
 };
 
+// ================ matrix products ======================
+
+template <typename T, size_t cols, size_t rows>
+constexpr MatN<T, cols, rows> matMul(const MatN<T, cols, rows>& m1, const MatN<T, cols, rows>& m2)
+{
+    MatN<T, cols, rows> result;
+    for (size_t j = 0; j < cols; ++j)
+    {
+        result[j] = m1 * m2[j];
+    }
+    return result;
+}
+
+template <typename T, size_t cols, size_t rows>
+constexpr VecN<T, rows> matVecMul(const MatN<T, cols, rows>& mat, const VecN<T, cols>& vec)
+{
+    VecN<T, rows> result {T(0)};
+    for (size_t j = 0; j < cols; ++j)
+    {
+        result += mat[j] * vec[j];
+    }
+    return result;
+}
+
 // ================ matrix functions =====================
 
 
 template <typename T, size_t cols, size_t rows>
-MatN<T, cols, rows> transpose(MatN<T, cols, rows>& mat)
+constexpr MatN<T, rows, cols> transpose(const MatN<T, cols, rows>& mat)
 {
-    MatN<T, cols, rows> result;
+    MatN<T, rows, cols> result;
     for (size_t i = 0; i < cols; ++i)
     {
         for (size_t j = 0; j < rows; ++j)
         {
-            result[i][j] = mat[j][i];
+            result.data[j][i] = mat.data[i][j];
         }
     }
+    return result;
 }
 
 // ================= inverse functions ====================
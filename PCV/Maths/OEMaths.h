@@ -13,6 +13,7 @@
 
 #include <assert.h>
 #include <cstdint>
+#include <type_traits>
 
 #define M_DBL_PI 6.28318530718
 
@@ -33,4 +34,32 @@ T radians(const T deg)
 	return deg * static_cast<T>(M_PI / 180.0);
 }
 
+// the maths types are copied in bulk with memcpy and into mapped gpu memory, so must stay
+// trivially copyable with no padding or hidden members
+template <typename T>
+constexpr bool isPlainData =
+    std::is_trivially_copyable<T>::value && std::is_standard_layout<T>::value;
+
+static_assert(isPlainData<vec2f> && isPlainData<vec3f> && isPlainData<vec4f>, "");
+static_assert(isPlainData<mat2f> && isPlainData<mat3f> && isPlainData<mat4f>, "");
+static_assert(isPlainData<quatf>, "");
+static_assert(isPlainData<VecN<float, 5>> && isPlainData<MatN<float, 5, 5>>, "");
+static_assert(sizeof(vec3f) == 3 * sizeof(float), "vec3f must be tightly packed");
+static_assert(sizeof(mat4f) == 16 * sizeof(float), "mat4f must be tightly packed");
+
+// the types can be built and combined at compile time
+static_assert((vec3f {1.0f, 2.0f, 3.0f} + vec3f {1.0f, 2.0f, 3.0f})[2] == 6.0f, "");
+static_assert(mat4f {}[3][3] == 1.0f && mat4f {}[3][0] == 0.0f, "");
+
+// the products - the mat4 products use the SIMD kernels at runtime, so are only constant
+// expressions where the compiler can tell the two apart
+static_assert((mat3f {} * mat3f {})[1][1] == 1.0f && (mat3f {} * vec3f {1.0f})[2] == 1.0f, "");
+static_assert((mat2f {} * vec2f {2.0f})[0] == 2.0f, "");
+
+#if defined(OEMATHS_CONSTEXPR_MAT4_PRODUCTS)
+constexpr mat4f testMat4 = mat4f::translate(vec3f {1.0f, 2.0f, 3.0f});
+static_assert((testMat4 * vec4f {1.0f, 1.0f, 1.0f, 1.0f})[2] == 4.0f, "");
+static_assert((testMat4 * testMat4)[3][1] == 4.0f, "");
+#endif
+
 }    // namespace OEMaths
@@ -14,36 +14,33 @@ template <typename T, size_t size = 4>
 class Quarternion : public MathOperators<Quarternion, T, 4>
 {
 public:
-	Quarternion()
-	    : x(T(0))
-	    , y(T(0))
-	    , z(T(0))
-	    , w(T(0))
+	constexpr Quarternion()
+	    : data {T(0), T(0), T(0), T(0)}
 	{
 	}
 
-	Quarternion(const T& n)
-	    : x(n)
-	    , y(n)
-	    , z(n)
-	    , w(n)
+	constexpr Quarternion(const T& n)
+	    : data {n, n, n, n}
 	{
 	}
 
-	Quarternion(const T& in_x, const T& in_y, const T& in_z, const T& in_w)
-	    : x(in_x)
-	    , y(in_y)
-	    , z(in_z)
-	    , w(in_w)
+	constexpr Quarternion(const T& in_x, const T& in_y, const T& in_z, const T& in_w)
+	    : data {in_x, in_y, in_z, in_w}
 	{
 	}
 
-	Quarternion(VecN<T, 3>& vec, const T& value)
+	constexpr Quarternion(const VecN<T, 3>& vec, const T& value)
+	    : data {vec[0], vec[1], vec[2], value}
 	{
-		VecN{ vec.data[0], vec.data[1], vec.data[3], value };
 	}
 
-	T& operator[](const size_t idx)
+	inline constexpr T& operator[](const size_t idx)
+	{
+		assert(idx < 4);
+		return data[idx];
+	}
+
+	inline constexpr T operator[](const size_t idx) const
 	{
 		assert(idx < 4);
 		return data[idx];
@@ -11,21 +11,18 @@ template <typename T>
 class VecN<T, 2> : public MathOperators<VecN, T, 2>
 {
 public:
-	VecN()
-	    : x(T(0))
-	    , y(T(0))
+	constexpr VecN()
+	    : data {T(0), T(0)}
 	{
 	}
 
-	VecN(const T& n)
-	    : x(n)
-	    , y(n)
+	constexpr VecN(const T& n)
+	    : data {n, n}
 	{
 	}
 
-	VecN(const T& in_x, const T& in_y)
-	    : x(in_x)
-	    , y(in_y)
+	constexpr VecN(const T& in_x, const T& in_y)
+	    : data {in_x, in_y}
 	{
 	}
 
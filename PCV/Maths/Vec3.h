@@ -9,32 +9,33 @@ template <typename T>
 class VecN<T, 3> : public MathOperators<VecN, T, 3>
 {
 public:
-    VecN() : x(T(0)), y(T(0)), z(T(0))
+    // the constructors initialise **data**, which the operators access, so the vectors can be
+    // used in constant expressions
+    constexpr VecN() : data {T(0), T(0), T(0)}
     {
     }
 
-    VecN(const T& n) : x(n), y(n), z(n)
+    constexpr VecN(const T& n) : data {n, n, n}
     {
     }
 
-    VecN(const T& in_x, const T& in_y, const T& in_z) : x(in_x), y(in_y), z(in_z)
+    constexpr VecN(const T& in_x, const T& in_y, const T& in_z) : data {in_x, in_y, in_z}
     {
     }
 
-    VecN(VecN<T, 2>& vec, const T& value) : x(vec.x), y(vec.y), z(value)
+    constexpr VecN(const VecN<T, 2>& vec, const T& value) : data {vec[0], vec[1], value}
     {
     }
 
     /**
      * Only makes sense to cross a vector3, hence why this function is here
      */
-    static constexpr VecN<T, 3> cross(VecN<T, 3>& vec1, VecN<T, 3>& vec2)
+    static constexpr VecN<T, 3> cross(const VecN<T, 3>& vec1, const VecN<T, 3>& vec2)
     {
-        VecN<T, 3> result;
-        result.x = vec1.y * vec2.z - vec1.z * vec2.y;
-        result.y = vec1.z * vec2.x - vec1.x * vec2.z;
-        result.z = vec1.x * vec2.y - vec1.y * vec2.x;
-        return result;
+        return VecN<T, 3> {
+            vec1[1] * vec2[2] - vec1[2] * vec2[1],
+            vec1[2] * vec2[0] - vec1[0] * vec2[2],
+            vec1[0] * vec2[1] - vec1[1] * vec2[0]};
     }
 
     inline constexpr T& operator[](const size_t idx)
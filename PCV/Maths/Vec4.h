@@ -10,20 +10,21 @@ template <typename T>
 class VecN<T, 4> : public MathOperators<VecN, T, 4>
 {
 public:
-    VecN() : x(T(0)), y(T(0)), z(T(0)), w(T(0))
+    constexpr VecN() : data {T(0), T(0), T(0), T(0)}
     {
     }
 
-    VecN(const T& n) : x(n), y(n), z(n), w(n)
+    constexpr VecN(const T& n) : data {n, n, n, n}
     {
     }
 
-    VecN(const T& in_x, const T& in_y, const T& in_z, const T& in_w)
-        : x(in_x), y(in_y), z(in_z), w(in_w)
+    constexpr VecN(const T& in_x, const T& in_y, const T& in_z, const T& in_w)
+        : data {in_x, in_y, in_z, in_w}
     {
     }
 
-    VecN(VecN<T, 3>& vec, const T& value) : x(vec.x), y(vec.y), z(vec.z), w(value)
+    constexpr VecN(const VecN<T, 3>& vec, const T& value)
+        : data {vec[0], vec[1], vec[2], value}
     {
     }
 
@@ -23,7 +23,8 @@ public:
         return lhs;
     }
 
-    friend inline Vec<T, size> operator+(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
+    friend inline constexpr Vec<T, size>
+    operator+(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
     {
         Vec<T, size> result = vec1;
         result += vec2;
@@ -41,7 +42,8 @@ public:
         return lhs;
     }
 
-    friend inline Vec<T, size> operator-(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
+    friend inline constexpr Vec<T, size>
+    operator-(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
     {
         Vec<T, size> result = vec1;
         result -= vec2;
@@ -59,7 +61,7 @@ public:
         return lhs;
     }
 
-    inline friend Vec<T, size> operator*(const Vec<T, size>& vec, const T& value)
+    inline friend constexpr Vec<T, size> operator*(const Vec<T, size>& vec, const T& value)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -69,7 +71,7 @@ public:
         return result;
     }
 
-    inline friend Vec<T, size> operator*(const T& value, const Vec<T, size>& vec)
+    inline friend constexpr Vec<T, size> operator*(const T& value, const Vec<T, size>& vec)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -79,7 +81,8 @@ public:
         return result;
     }
 
-    inline friend Vec<T, size> operator*(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
+    inline friend constexpr Vec<T, size>
+    operator*(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -100,7 +103,7 @@ public:
         return lhs;
     }
 
-    inline friend Vec<T, size> operator/(const Vec<T, size>& vec, const T& value)
+    inline friend constexpr Vec<T, size> operator/(const Vec<T, size>& vec, const T& value)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -110,7 +113,7 @@ public:
         return result;
     }
 
-    inline friend Vec<T, size> operator/(const T& value, const Vec<T, size>& vec)
+    inline friend constexpr Vec<T, size> operator/(const T& value, const Vec<T, size>& vec)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -120,7 +123,8 @@ public:
         return result;
     }
 
-    inline friend Vec<T, size> operator/(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
+    inline friend constexpr Vec<T, size>
+    operator/(const Vec<T, size>& vec1, const Vec<T, size>& vec2)
     {
         Vec<T, size> result;
         for (size_t i = 0; i < size; ++i)
@@ -135,40 +139,22 @@ template <typename T, size_t size>
 class VecN : public MathOperators<VecN, T, size>
 {
 public:
-    VecN()
-    {
-    }
-
-    // copy
-    VecN(const VecN<T, size>& other)
-    {
-        for (size_t i = 0; i < size; ++i)
-        {
-            data[i] = other.data[i];
-        }
-    }
+    constexpr VecN() = default;
 
-    // assignment
-    VecN<T, size>& operator=(const VecN<T, size>& other)
+    inline constexpr T& operator[](const size_t idx)
     {
-        if (this != &other)
-        {
-            for (size_t i = 0; i < size; ++i)
-            {
-                data[i] = other.data[i];
-            }
-        }
-        return *this;
+        assert(idx < size);
+        return data[idx];
     }
 
-    VecN<T, size>& operator[](const size_t idx)
+    inline constexpr T operator[](const size_t idx) const
     {
         assert(idx < size);
         return data[idx];
     }
 
 public:
-    T data[size];
+    T data[size] = {};
 };
 
 // =========== helpers =====================
@@ -227,7 +213,7 @@ inline constexpr T dot(const VecN<T, size>& vec1, const VecN<T, size>& vec2)
 }
 
 template <typename T, size_t size>
-inline constexpr VecN<T, size> min(VecN<T, size>& vec1, VecN<T, size>& vec2)
+inline constexpr VecN<T, size> min(const VecN<T, size>& vec1, const VecN<T, size>& vec2)
 {
     VecN<T, size> result;
     for (uint8_t i = 0; i < size; ++i)
@@ -238,7 +224,7 @@ inline constexpr VecN<T, size> min(VecN<T, size>& vec1, VecN<T, size>& vec2)
 }
 
 template <typename T, size_t size>
-inline constexpr VecN<T, size> max(VecN<T, size>& vec1, VecN<T, size>& vec2)
+inline constexpr VecN<T, size> max(const VecN<T, size>& vec1, const VecN<T, size>& vec2)
 {
     VecN<T, size> result;
     for (uint8_t i = 0; i < size; ++i)
@@ -0,0 +1,366 @@
+#include "LodSelector.h"
+
+#include "Core/AABBox.h"
+#include "Core/Frustum.h"
+#include "Octree/OctreeFile.h"
+#include "Threading/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <limits>
+
+namespace PCV
+{
+
+namespace
+{
+
+// the priorities of the nodes down to this depth are computed up front, each job expanding a
+// single node - the top of the octrees is where the subtrees diverge most in cost. Deeper nodes are
+// evaluated by the selection as it reaches them, so their cost is bounded by the point budget.
+// This also keeps the number of jobs in flight well within the job system's ring.
+constexpr uint8_t MaxJobDepth = 3;
+
+struct Traversal
+{
+    const std::vector<LodSelector::Instance>* octrees;
+    const LodSelector::View* view;
+    std::vector<std::vector<float>>* priorities;
+    std::vector<std::vector<Frustum::PlaneMask>>* planeMasks;
+    JobSystem* jobs;
+    JobSystem::Job* root;
+    float projScale;
+    float maxScreenError;
+    size_t pointBudget;
+
+    /// summed from the counters of each job once it completes - the only state the jobs write
+    mutable std::atomic<size_t> testedNodes {0};
+    mutable std::atomic<size_t> planeTests {0};
+    mutable std::atomic<size_t> evaluatedNodes {0};
+};
+
+/// the culling work of a single job, counted locally to avoid contention on the totals
+struct CullCounters
+{
+    size_t testedNodes = 0;
+    size_t planeTests = 0;
+    size_t evaluatedNodes = 0;
+};
+
+/// converts a world space size at a distance of one into pixels
+float getProjScale(const LodSelector::View& view)
+{
+    return view.viewportHeight * 0.5f / std::tan(OEMaths::radians(view.fov) * 0.5f);
+}
+
+// returns a negative priority if the node is outside the frustum. The mask holds the planes the
+// parent crosses - a node is contained by its parent, so it can only cross the same planes - and
+// is updated to the planes this node crosses for its children
+float getPriority(
+    const Traversal& traversal,
+    const LodSelector::Instance& octree,
+    const Octree::NodeRecord& record,
+    Frustum::PlaneMask& mask,
+    CullCounters& counters)
+{
+    const LodSelector::View& view = *traversal.view;
+    const AABBox box {
+        OEMaths::vec3f {record.boundsMin[0], record.boundsMin[1], record.boundsMin[2]} +
+            octree.offset,
+        OEMaths::vec3f {record.boundsMax[0], record.boundsMax[1], record.boundsMax[2]} +
+            octree.offset};
+
+    ++counters.evaluatedNodes;
+
+    // nodes within a subtree which is fully inside the frustum are accepted without any tests
+    if (mask)
+    {
+        ++counters.testedNodes;
+        counters.planeTests += std::bitset<Frustum::Planes::Count>(mask).count();
+        if (!view.frustum->checkBoxPlaneIntersect(box, mask))
+        {
+            return -1.0f;
+        }
+    }
+
+    const OEMaths::vec3f centre = box.getCentre();
+    const OEMaths::vec3f extent = box.max - centre;
+    const float radius = OEMaths::length(extent);
+    const float distance = OEMaths::length(centre - view.position);
+
+    // the camera is inside the node's bounding sphere
+    if (distance <= radius)
+    {
+        return std::numeric_limits<float>::max();
+    }
+    return radius * traversal.projScale / distance;
+}
+
+// the priority is the projected radius, so the projected spacing can be derived from it without
+// recalculating the distance
+float getScreenError(
+    const OctreeFile& file, const Octree::NodeRecord& record, const float priority)
+{
+    const float size = record.boundsMax[0] - record.boundsMin[0];
+    const float spacing = file.getHeader().spacing / static_cast<float>(1u << record.depth);
+    const float radius = size * 0.8660254f;
+    return priority * spacing / radius;
+}
+
+void expandNodeJob(
+    const Traversal& traversal,
+    const uint32_t octreeIdx,
+    const uint32_t nodeIdx,
+    const size_t pointsAbove);
+
+// computes the priorities of the children of a node the selection would refine, and hands them to
+// jobs of their own until **MaxJobDepth**. The ancestors of a node are all selected before it, so
+// once their points exceed the budget the selection can't reach the node's children.
+void expandNode(
+    const Traversal& traversal,
+    const uint32_t octreeIdx,
+    const uint32_t nodeIdx,
+    const size_t pointsAbove,
+    CullCounters& counters)
+{
+    const LodSelector::Instance& octree = (*traversal.octrees)[octreeIdx];
+    const std::vector<Octree::NodeRecord>& records = octree.file->getNodes();
+    const Octree::NodeRecord& record = records[nodeIdx];
+    std::vector<float>& priorities = (*traversal.priorities)[octreeIdx];
+    std::vector<Frustum::PlaneMask>& planeMasks = (*traversal.planeMasks)[octreeIdx];
+
+    const float priority = priorities[nodeIdx];
+    const size_t points = pointsAbove + record.pointCount;
+    if (priority < 0.0f || points > traversal.pointBudget ||
+        getScreenError(*octree.file, record, priority) < traversal.maxScreenError)
+    {
+        return;
+    }
+
+    // the children are stored contiguously
+    uint32_t child = record.firstChild;
+    for (uint32_t bit = 0; bit < 8; ++bit)
+    {
+        if (!(record.childMask & (1 << bit)))
+        {
+            continue;
+        }
+
+        Frustum::PlaneMask childMask = planeMasks[nodeIdx];
+        priorities[child] = getPriority(traversal, octree, records[child], childMask, counters);
+        planeMasks[child] = childMask;
+        if (record.depth + 1 < MaxJobDepth)
+        {
+            const Traversal* data = &traversal;
+            JobSystem& jobs = *traversal.jobs;
+            jobs.run(jobs.createJob(
+                [data, octreeIdx, child, points]() {
+                    expandNodeJob(*data, octreeIdx, child, points);
+                },
+                traversal.root));
+        }
+        ++child;
+    }
+}
+
+// expands a node as a job of its own, adding its counters to the totals once done
+void expandNodeJob(
+    const Traversal& traversal,
+    const uint32_t octreeIdx,
+    const uint32_t nodeIdx,
+    const size_t pointsAbove)
+{
+    CullCounters counters;
+    expandNode(traversal, octreeIdx, nodeIdx, pointsAbove, counters);
+    traversal.testedNodes.fetch_add(counters.testedNodes, std::memory_order_relaxed);
+    traversal.planeTests.fetch_add(counters.planeTests, std::memory_order_relaxed);
+    traversal.evaluatedNodes.fetch_add(counters.evaluatedNodes, std::memory_order_relaxed);
+}
+
+} // namespace
+
+LodSelector::LodSelector(const Options& opts)
+    : options(opts)
+{
+}
+
+template <typename PushChild>
+void LodSelector::selectNodes(
+    const std::vector<Instance>& octrees, std::vector<uint32_t>& nodes, PushChild pushChild)
+{
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        const Candidate candidate = heap.back();
+        heap.pop_back();
+
+        const Instance& octree = octrees[candidate.octree];
+        const std::vector<Octree::NodeRecord>& records = octree.file->getNodes();
+        const Octree::NodeRecord& record = records[candidate.node];
+
+        if (stats.selectedPoints + record.pointCount > options.pointBudget)
+        {
+            stats.budgetReached = true;
+            break;
+        }
+        stats.selectedPoints += record.pointCount;
+        ++stats.selectedNodes;
+        nodes.emplace_back(octree.baseId + candidate.node);
+
+        if (getScreenError(*octree.file, record, candidate.priority) < options.maxScreenError)
+        {
+            continue;
+        }
+
+        // the children are stored contiguously
+        uint32_t child = record.firstChild;
+        for (uint32_t bit = 0; bit < 8; ++bit)
+        {
+            if (record.childMask & (1 << bit))
+            {
+                pushChild(candidate, child++);
+            }
+        }
+    }
+}
+
+void LodSelector::select(
+    const std::vector<Instance>& octrees,
+    const View& view,
+    std::vector<uint32_t>& nodes,
+    JobSystem& jobs)
+{
+    assert(view.frustum);
+    stats = {};
+    heap.clear();
+
+    // ============ node priorities =====================
+    // each node's priority only depends on the view, so the top of the octrees can be expanded in
+    // parallel. The arrays are only read for nodes written below, so they don't need clearing
+    // between frames
+    if (priorities.size() < octrees.size())
+    {
+        priorities.resize(octrees.size());
+        planeMasks.resize(octrees.size());
+    }
+    for (size_t i = 0; i < octrees.size(); ++i)
+    {
+        priorities[i].resize(octrees[i].file->getNodes().size());
+        planeMasks[i].resize(octrees[i].file->getNodes().size());
+    }
+
+    Traversal traversal;
+    traversal.octrees = &octrees;
+    traversal.view = &view;
+    traversal.priorities = &priorities;
+    traversal.planeMasks = &planeMasks;
+    traversal.jobs = &jobs;
+    traversal.root = jobs.createJob([]() {});
+    traversal.projScale = getProjScale(view);
+    traversal.maxScreenError = options.maxScreenError;
+    traversal.pointBudget = options.pointBudget;
+
+    const Traversal* data = &traversal;
+    CullCounters counters;
+    for (uint32_t i = 0; i < octrees.size(); ++i)
+    {
+        const std::vector<Octree::NodeRecord>& records = octrees[i].file->getNodes();
+        if (records.empty())
+        {
+            continue;
+        }
+        Frustum::PlaneMask mask = Frustum::AllPlanes;
+        priorities[i][0] = getPriority(traversal, octrees[i], records[0], mask, counters);
+        planeMasks[i][0] = mask;
+        jobs.run(jobs.createJob([data, i]() { expandNodeJob(*data, i, 0, 0); }, traversal.root));
+    }
+    // the root has no work of its own, running it leaves it waiting on the subtrees only
+    jobs.run(traversal.root);
+    jobs.wait(traversal.root);
+
+    // ============ budgeted selection =====================
+    // nodes below the expanded levels are evaluated as they're reached
+    auto push = [&](const uint32_t octreeIdx, const uint32_t nodeIdx, Frustum::PlaneMask mask) {
+        const Octree::NodeRecord& record = octrees[octreeIdx].file->getNodes()[nodeIdx];
+        float priority;
+        if (record.depth <= MaxJobDepth)
+        {
+            priority = priorities[octreeIdx][nodeIdx];
+            mask = planeMasks[octreeIdx][nodeIdx];
+        }
+        else
+        {
+            priority = getPriority(traversal, octrees[octreeIdx], record, mask, counters);
+        }
+
+        ++stats.visitedNodes;
+        if (priority < 0.0f)
+        {
+            ++stats.culledNodes;
+            return;
+        }
+        heap.push_back({priority, octreeIdx, nodeIdx, mask});
+        std::push_heap(heap.begin(), heap.end());
+    };
+
+    for (uint32_t i = 0; i < octrees.size(); ++i)
+    {
+        if (!octrees[i].file->getNodes().empty())
+        {
+            push(i, 0, Frustum::AllPlanes);
+        }
+    }
+    selectNodes(octrees, nodes, [&](const Candidate& parent, const uint32_t child) {
+        push(parent.octree, child, parent.planeMask);
+    });
+
+    stats.testedNodes = counters.testedNodes + traversal.testedNodes.load();
+    stats.planeTests = counters.planeTests + traversal.planeTests.load();
+    stats.evaluatedNodes = counters.evaluatedNodes + traversal.evaluatedNodes.load();
+}
+
+void LodSelector::select(
+    const std::vector<Instance>& octrees, const View& view, std::vector<uint32_t>& nodes)
+{
+    assert(view.frustum);
+    stats = {};
+    heap.clear();
+
+    Traversal traversal;
+    traversal.octrees = &octrees;
+    traversal.view = &view;
+    traversal.projScale = getProjScale(view);
+    CullCounters counters;
+
+    auto push = [&](const uint32_t octreeIdx, const uint32_t nodeIdx, Frustum::PlaneMask mask) {
+        const Octree::NodeRecord& record = octrees[octreeIdx].file->getNodes()[nodeIdx];
+        const float priority = getPriority(traversal, octrees[octreeIdx], record, mask, counters);
+        ++stats.visitedNodes;
+        if (priority < 0.0f)
+        {
+            ++stats.culledNodes;
+            return;
+        }
+        heap.push_back({priority, octreeIdx, nodeIdx, mask});
+        std::push_heap(heap.begin(), heap.end());
+    };
+
+    for (uint32_t i = 0; i < octrees.size(); ++i)
+    {
+        if (!octrees[i].file->getNodes().empty())
+        {
+            push(i, 0, Frustum::AllPlanes);
+        }
+    }
+    selectNodes(octrees, nodes, [&](const Candidate& parent, const uint32_t child) {
+        push(parent.octree, child, parent.planeMask);
+    });
+
+    stats.testedNodes = counters.testedNodes;
+    stats.planeTests = counters.planeTests;
+    stats.evaluatedNodes = counters.evaluatedNodes;
+}
+
+} // namespace PCV
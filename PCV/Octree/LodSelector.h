@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Maths/OEMaths.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PCV
+{
+// forward declerations
+class Frustum;
+class JobSystem;
+class OctreeFile;
+
+/**
+ * @brief Selects the octree nodes to render each frame. Nodes are visited in order of their
+ * projected size on screen, largest first, so the nodes closest to the camera are refined first.
+ * The traversal stops once the point budget is reached, which bounds the per frame cost
+ * regardless of the size of the dataset. A node is only refined while the projected spacing of
+ * its points - the screen space error - is larger than the error threshold.
+ *
+ * The priorities of the top few levels of the octrees are computed up front in parallel as jobs,
+ * stopping below nodes whose ancestors alone exceed the point budget. The budgeted selection then
+ * runs on a single thread, evaluating the deeper nodes as it reaches them, so the result is the
+ * same as a serial traversal and the work stays bounded by the budget.
+ *
+ * Culling is hierarchical - each node is only tested against the frustum planes its parent
+ * crosses, so whole subtrees inside the frustum are accepted without testing, and subtrees
+ * outside it are rejected with their root.
+ */
+class LodSelector
+{
+public:
+    struct Options
+    {
+        /// the maximum number of points selected per frame, across all octrees
+        size_t pointBudget = 5'000'000;
+
+        /// nodes are not refined once the projected point spacing drops below this, in pixels
+        float maxScreenError = 1.0f;
+    };
+
+    /// an octree registered with the scene
+    struct Instance
+    {
+        std::shared_ptr<OctreeFile> file;
+
+        /// the global id of the root node within the streamer
+        uint32_t baseId = 0;
+
+        /// the position of the octree origin relative to the world origin
+        OEMaths::vec3f offset;
+    };
+
+    struct View
+    {
+        const Frustum* frustum = nullptr;
+        OEMaths::vec3f position;
+
+        /// the vertical field of view in degrees
+        float fov = 40.0f;
+
+        /// the height of the viewport in pixels
+        float viewportHeight = 1080.0f;
+    };
+
+    struct Stats
+    {
+        size_t selectedNodes = 0;
+        size_t selectedPoints = 0;
+        size_t visitedNodes = 0;
+        size_t culledNodes = 0;
+
+        /// nodes tested against the frustum - nodes within a subtree fully inside the frustum
+        /// are accepted untested, and only the planes the parent crosses are tested
+        size_t testedNodes = 0;
+        size_t planeTests = 0;
+
+        /// nodes whose priority was computed - when selecting in parallel, this includes nodes
+        /// expanded up front which the selection didn't reach
+        size_t evaluatedNodes = 0;
+
+        /// set if the traversal was cut short by the point budget
+        bool budgetReached = false;
+    };
+
+    explicit LodSelector(const Options& options);
+
+    /**
+     * @brief Traverses all octrees and selects the nodes to render.
+     * @param octrees The octrees to traverse
+     * @param view The camera parameters used for culling and projecting the nodes
+     * @param nodes Filled with the global ids of the selected nodes, in order of decreasing
+     * priority - ready to be passed to the node streamer
+     * @param jobs Used to compute the node priorities in parallel
+     */
+    void select(
+        const std::vector<Instance>& octrees,
+        const View& view,
+        std::vector<uint32_t>& nodes,
+        JobSystem& jobs);
+
+    /**
+     * @brief Selects the same nodes as **select** on the calling thread, computing the priority
+     * of each node as it is reached. Used when there is no job system, and as the reference the
+     * parallel selection is measured against.
+     */
+    void select(
+        const std::vector<Instance>& octrees, const View& view, std::vector<uint32_t>& nodes);
+
+    void setPointBudget(const size_t budget)
+    {
+        options.pointBudget = budget;
+    }
+
+    size_t getPointBudget() const
+    {
+        return options.pointBudget;
+    }
+
+    void setMaxScreenError(const float error)
+    {
+        options.maxScreenError = error;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    struct Candidate
+    {
+        float priority;
+        uint32_t octree;
+        uint32_t node;
+
+        /// the frustum planes the node crosses, tested against its children
+        uint8_t planeMask;
+
+        /// nodes with the same priority - i.e. those containing the camera - are ordered by
+        /// index, so the selection doesn't depend on the order the nodes were pushed in
+        bool operator<(const Candidate& other) const
+        {
+            if (priority != other.priority)
+            {
+                return priority < other.priority;
+            }
+            if (octree != other.octree)
+            {
+                return octree > other.octree;
+            }
+            return node > other.node;
+        }
+    };
+
+    /// the budgeted best first selection shared by both traversals, starting from the roots
+    /// already in the heap - **pushChild** adds a child of a refined candidate to the heap
+    template <typename PushChild>
+    void selectNodes(
+        const std::vector<Instance>& octrees, std::vector<uint32_t>& nodes, PushChild pushChild);
+
+    Options options;
+    Stats stats;
+
+    /// reused between frames to avoid reallocating
+    std::vector<Candidate> heap;
+
+    /// the priority and the frustum planes crossed of each node expanded up front this frame,
+    /// indexed by octree and then node
+    std::vector<std::vector<float>> priorities;
+    std::vector<std::vector<uint8_t>> planeMasks;
+};
+
+} // namespace PCV
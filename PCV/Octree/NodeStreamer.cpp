@@ -0,0 +1,362 @@
+#include "NodeStreamer.h"
+
+#include "Octree/OctreeFile.h"
+
+#include "Vulkan/Buffer.h"
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PCV
+{
+
+NodeStreamer::NodeStreamer(VulkanAPI::VkContext& ctx, const Options& opts)
+    : context(ctx)
+    , options(opts)
+    , nodePool(
+          ctx,
+          vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst,
+          vk::MemoryPropertyFlagBits::eDeviceLocal,
+          opts.poolBlockSize)
+    , uploader(ctx)
+{
+}
+
+NodeStreamer::~NodeStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock {queueMutex};
+        stopThreads = true;
+    }
+    queueCondition.notify_all();
+    for (std::thread& thread : ioThreads)
+    {
+        thread.join();
+    }
+
+    // the pooled buffers may still be in use by the last frames
+    context.device.waitIdle();
+}
+
+bool NodeStreamer::prepare()
+{
+    if (!uploader.prepare(options.stagingSize, options.framesInFlight))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < std::max<size_t>(options.ioThreadCount, 1); ++i)
+    {
+        ioThreads.emplace_back(&NodeStreamer::ioThreadMain, this);
+    }
+    return true;
+}
+
+uint32_t NodeStreamer::addOctree(std::shared_ptr<OctreeFile> file)
+{
+    assert(file);
+
+    const uint32_t baseId = static_cast<uint32_t>(entries.size());
+    const uint32_t octreeIdx = static_cast<uint32_t>(octrees.size());
+    const size_t nodeCount = file->getNodes().size();
+
+    // every node must fit into the staging buffer to be uploaded, otherwise the larger nodes
+    // would be deferred forever
+    uint32_t maxNodeSize = 0;
+    for (const Octree::NodeRecord& record : file->getNodes())
+    {
+        maxNodeSize = std::max(maxNodeSize, record.byteSize);
+    }
+    if (!uploader.reserve(maxNodeSize))
+    {
+        LOGGER_ERROR("Unable to create a staging buffer of %u bytes.", maxNodeSize);
+        return InvalidId;
+    }
+
+    // the I/O threads hold references to the entries
+    std::lock_guard<std::mutex> lock {queueMutex};
+    entries.resize(entries.size() + nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        NodeEntry& entry = entries[baseId + i];
+        entry.octree = octreeIdx;
+        entry.node = static_cast<uint32_t>(i);
+    }
+    octrees.emplace_back(std::move(file));
+    return baseId;
+}
+
+void NodeStreamer::ioThreadMain()
+{
+    while (true)
+    {
+        uint32_t id;
+        uint32_t node;
+        const OctreeFile* file;
+        {
+            std::unique_lock<std::mutex> lock {queueMutex};
+            queueCondition.wait(lock, [this]() { return stopThreads || !loadQueue.empty(); });
+            if (stopThreads)
+            {
+                return;
+            }
+
+            id = loadQueue.front();
+            loadQueue.pop_front();
+            entries[id].state = NodeState::Loading;
+            file = octrees[entries[id].octree].get();
+            node = entries[id].node;
+            ++loadingCount;
+        }
+
+        // reading the mapped blob is where the disk access takes place, so this is done without
+        // holding the lock
+        const size_t size = file->getNodes()[node].byteSize;
+        std::vector<uint8_t> data(size);
+        std::memcpy(data.data(), file->getNodeData(node), size);
+
+        std::lock_guard<std::mutex> lock {queueMutex};
+        entries[id].data = std::move(data);
+        entries[id].state = NodeState::Loaded;
+        loadedNodes.emplace_back(id);
+        --loadingCount;
+    }
+}
+
+void NodeStreamer::update(const std::vector<uint32_t>& nodes)
+{
+    ++frameIndex;
+    stats.uploads = 0;
+    stats.uploadedBytes = 0;
+    stats.evictions = 0;
+
+    // only the highest priority nodes which fit within the budget are requested, otherwise
+    // nodes would be continually loaded and dropped once the budget is full
+    std::vector<uint32_t> requested;
+    size_t requestBytes = 0;
+    for (uint32_t id : nodes)
+    {
+        // a node larger than the whole budget can never be resident
+        const size_t size = getNodeSize(id);
+        if (size > options.gpuBudget)
+        {
+            continue;
+        }
+        requestBytes += size;
+        if (requestBytes > options.gpuBudget)
+        {
+            break;
+        }
+        entries[id].lastRequestFrame = frameIndex;
+        entries[id].requestIndex = static_cast<uint32_t>(requested.size());
+        requested.emplace_back(id);
+    }
+    residentSorted = false;
+
+    std::vector<uint32_t> loaded;
+    {
+        std::lock_guard<std::mutex> lock {queueMutex};
+
+        // nodes which are queued but no longer required are dropped - the queue is rebuilt in the
+        // order of this frame's priorities
+        for (uint32_t id : loadQueue)
+        {
+            entries[id].state = NodeState::Unloaded;
+        }
+        loadQueue.clear();
+        for (uint32_t id : requested)
+        {
+            if (entries[id].state == NodeState::Unloaded)
+            {
+                entries[id].state = NodeState::Queued;
+                loadQueue.emplace_back(id);
+            }
+        }
+        loaded.swap(loadedNodes);
+        stats.pendingLoads = loadQueue.size() + loadingCount;
+    }
+    queueCondition.notify_all();
+
+    // upload the highest priority nodes first, in case the staging buffer fills
+    std::sort(loaded.begin(), loaded.end(), [this](const uint32_t lhs, const uint32_t rhs) {
+        const NodeEntry& lEntry = entries[lhs];
+        const NodeEntry& rEntry = entries[rhs];
+        if (lEntry.lastRequestFrame != rEntry.lastRequestFrame)
+        {
+            return lEntry.lastRequestFrame > rEntry.lastRequestFrame;
+        }
+        return lEntry.requestIndex < rEntry.requestIndex;
+    });
+    uploadNodes(loaded);
+
+    // the budget may have been lowered since the last frame
+    evictNodes(0);
+
+    releaseRetired();
+
+    stats.residentNodes = residentNodes.size();
+    stats.reservedBytes = nodePool.getReservedBytes();
+    stats.poolBlocks = nodePool.getBlockCount();
+}
+
+void NodeStreamer::uploadNodes(std::vector<uint32_t>& loaded)
+{
+    uploader.begin();
+
+    // nodes which don't fit into the staging buffer this frame are kept for the next
+    std::vector<uint32_t> deferred;
+
+    for (uint32_t id : loaded)
+    {
+        NodeEntry& entry = entries[id];
+        assert(entry.state == NodeState::Loaded);
+
+        const size_t blobSize = entry.data.size();
+        const size_t size = getNodeSize(id);
+        if (entry.lastRequestFrame == frameIndex && blobSize > uploader.getFreeSpace())
+        {
+            deferred.emplace_back(id);
+            continue;
+        }
+
+        // nodes no longer required, or which would exceed the budget, are dropped and will be
+        // read again if requested later
+        if (entry.lastRequestFrame != frameIndex || !evictNodes(size))
+        {
+            entry.data.clear();
+            entry.data.shrink_to_fit();
+            entry.state = NodeState::Unloaded;
+            continue;
+        }
+
+        // empty nodes are resident without a buffer
+        if (blobSize > 0)
+        {
+            VulkanAPI::BufferPool::Allocation alloc = nodePool.allocate(blobSize);
+            if (!alloc)
+            {
+                LOGGER_ERROR("Unable to allocate the buffer for octree node %u.", id);
+                entry.data.clear();
+                entry.data.shrink_to_fit();
+                entry.state = NodeState::Unloaded;
+                continue;
+            }
+
+            // nothing has been recorded for the range, so it can be freed straight away
+            if (!uploader.upload(*alloc.buffer, entry.data.data(), blobSize, alloc.offset))
+            {
+                nodePool.free(alloc);
+                deferred.emplace_back(id);
+                continue;
+            }
+            assert(alloc.size == size);
+            stats.residentBytes += size;
+            entry.allocation = alloc;
+        }
+
+        entry.data.clear();
+        entry.data.shrink_to_fit();
+        entry.state = NodeState::Resident;
+
+        // requested this frame, so the resident list remains in request order
+        residentNodes.emplace_back(id);
+
+        ++stats.uploads;
+        stats.uploadedBytes += blobSize;
+    }
+
+    uploader.submit();
+
+    if (!deferred.empty())
+    {
+        std::lock_guard<std::mutex> lock {queueMutex};
+        loadedNodes.insert(loadedNodes.end(), deferred.begin(), deferred.end());
+    }
+}
+
+bool NodeStreamer::evictNodes(const size_t requiredBytes)
+{
+    if (stats.residentBytes + requiredBytes <= options.gpuBudget)
+    {
+        return true;
+    }
+
+    // least recently requested first - the request frames only change once per frame
+    if (!residentSorted)
+    {
+        std::sort(
+            residentNodes.begin(),
+            residentNodes.end(),
+            [this](const uint32_t lhs, const uint32_t rhs) {
+                return entries[lhs].lastRequestFrame < entries[rhs].lastRequestFrame;
+            });
+        residentSorted = true;
+    }
+
+    size_t evicted = 0;
+    while (evicted < residentNodes.size() &&
+           stats.residentBytes + requiredBytes > options.gpuBudget)
+    {
+        NodeEntry& entry = entries[residentNodes[evicted]];
+        if (entry.lastRequestFrame == frameIndex)
+        {
+            break;
+        }
+
+        if (entry.allocation)
+        {
+            stats.residentBytes -= entry.allocation.size;
+            retired.push_back({entry.allocation, frameIndex});
+            entry.allocation = {};
+        }
+        entry.state = NodeState::Unloaded;
+        ++evicted;
+    }
+    residentNodes.erase(residentNodes.begin(), residentNodes.begin() + evicted);
+    stats.evictions += evicted;
+
+    return stats.residentBytes + requiredBytes <= options.gpuBudget;
+}
+
+void NodeStreamer::releaseRetired()
+{
+    // an evicted range may still be referenced by the command buffers of every frame in flight
+    const uint64_t retireFrames = options.framesInFlight + 1;
+    auto iter = std::remove_if(retired.begin(), retired.end(), [&](RetiredAllocation& range) {
+        if (frameIndex - range.frame < retireFrames)
+        {
+            return false;
+        }
+        nodePool.free(range.allocation);
+        return true;
+    });
+    retired.erase(iter, retired.end());
+}
+
+size_t NodeStreamer::getNodeSize(const uint32_t id) const
+{
+    const NodeEntry& entry = entries[id];
+    const size_t blobSize = octrees[entry.octree]->getNodes()[entry.node].byteSize;
+    return static_cast<size_t>(VulkanAPI::BufferPool::getAlignedSize(blobSize));
+}
+
+VulkanAPI::BufferPool::Allocation NodeStreamer::getNodeBuffer(const uint32_t id) const
+{
+    assert(id < entries.size());
+    if (entries[id].state != NodeState::Resident)
+    {
+        return {};
+    }
+    return entries[id].allocation;
+}
+
+bool NodeStreamer::isResident(const uint32_t id) const
+{
+    assert(id < entries.size());
+    return entries[id].state == NodeState::Resident;
+}
+
+} // namespace PCV
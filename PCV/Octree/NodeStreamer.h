@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Vulkan/BufferPool.h"
+#include "Vulkan/StagingUploader.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VulkanAPI
+{
+struct VkContext;
+} // namespace VulkanAPI
+
+namespace PCV
+{
+// forward declerations
+class OctreeFile;
+
+/**
+ * @brief Keeps the octree nodes requested by the scene resident on the GPU. Nodes are read from
+ * disk by background I/O threads, uploaded to device local vertex buffers through a staging
+ * buffer and evicted, least recently visible first, when the resident size exceeds the budget.
+ * The node buffers are ranges sub-allocated from large pooled blocks rather than an allocation
+ * each. Each range holds the node blob exactly as stored on disk, so the attribute arrays can be
+ * bound directly at the range offset plus the offsets given by **Octree::getBlobLayout**.
+ *
+ * Nodes of all octrees share a single budget, so each node is identified by a global id - the
+ * base id returned when the octree was added plus the index of the node within the octree.
+ */
+class NodeStreamer
+{
+public:
+    struct Options
+    {
+        /// the maximum bytes of node data resident on the GPU
+        size_t gpuBudget = size_t(1024) << 20;
+
+        /// the size of the staging buffer, which limits the bytes uploaded each frame. There is a
+        /// staging buffer per frame in flight
+        size_t stagingSize = size_t(64) << 20;
+
+        size_t ioThreadCount = 2;
+
+        /// the frames the renderer may have in flight, which evicted buffers are kept alive for
+        uint32_t framesInFlight = 2;
+
+        /// the size of the device local blocks the node buffers are sub-allocated from
+        size_t poolBlockSize = size_t(64) << 20;
+    };
+
+    /// returned by **addOctree** if the octree's nodes can't be streamed
+    static constexpr uint32_t InvalidId = UINT32_MAX;
+
+    /// counters which are reset at the start of each frame, apart from the resident totals
+    struct Stats
+    {
+        /// the sub-allocated bytes of the resident nodes - the measure the budget applies to
+        size_t residentBytes = 0;
+        size_t residentNodes = 0;
+
+        /// the memory of the pool blocks, including the free ranges within them
+        size_t reservedBytes = 0;
+        size_t poolBlocks = 0;
+
+        /// nodes which are queued or currently being read
+        size_t pendingLoads = 0;
+
+        size_t uploads = 0;
+        size_t uploadedBytes = 0;
+        size_t evictions = 0;
+    };
+
+    NodeStreamer(VulkanAPI::VkContext& context, const Options& options);
+    ~NodeStreamer();
+
+    // not copyable
+    NodeStreamer(const NodeStreamer&) = delete;
+    NodeStreamer& operator=(const NodeStreamer&) = delete;
+
+    /// creates the staging buffer and starts the I/O threads
+    bool prepare();
+
+    /**
+     * @brief Registers the nodes of an octree with the streamer. No node data is loaded until
+     * the node is requested.
+     * @return The global id of the first node of the octree, or **InvalidId** if the staging
+     * buffers can't be grown to fit the largest node
+     */
+    uint32_t addOctree(std::shared_ptr<OctreeFile> file);
+
+    /**
+     * @brief Called once per frame with the nodes that should be resident. Reprioritises the
+     * outstanding loads, uploads the nodes which have finished loading and evicts nodes if the
+     * budget has been exceeded. Nodes beyond the point where the budget is reached are ignored.
+     * @param nodes The global ids of the required nodes, in order of decreasing priority
+     */
+    void update(const std::vector<uint32_t>& nodes);
+
+    /// the range of the pooled buffer holding a node, or a null allocation if the node isn't
+    /// resident or is empty
+    VulkanAPI::BufferPool::Allocation getNodeBuffer(const uint32_t id) const;
+
+    bool isResident(const uint32_t id) const;
+
+    void setGpuBudget(const size_t bytes)
+    {
+        options.gpuBudget = bytes;
+    }
+
+    size_t getGpuBudget() const
+    {
+        return options.gpuBudget;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    enum class NodeState : uint8_t
+    {
+        Unloaded,
+        Queued,
+        Loading,
+        Loaded,
+        Resident
+    };
+
+    struct NodeEntry
+    {
+        /// the octree the node belongs to and its index within it
+        uint32_t octree = 0;
+        uint32_t node = 0;
+
+        NodeState state = NodeState::Unloaded;
+        uint64_t lastRequestFrame = 0;
+
+        /// the position of the node in the last request list - lower is a higher priority
+        uint32_t requestIndex = 0;
+
+        /// the node blob, held between being read and uploaded
+        std::vector<uint8_t> data;
+
+        VulkanAPI::BufferPool::Allocation allocation;
+    };
+
+    /// the range of an evicted node, which may still be referenced by frames in flight
+    struct RetiredAllocation
+    {
+        VulkanAPI::BufferPool::Allocation allocation;
+        uint64_t frame = 0;
+    };
+
+    void ioThreadMain();
+
+    /// uploads the nodes which have finished loading, in order of request
+    void uploadNodes(std::vector<uint32_t>& loaded);
+
+    /**
+     * @brief Evicts resident nodes, least recently requested first, until **requiredBytes** can
+     * be added without exceeding the budget. Nodes requested this frame are never evicted.
+     * @return false if the budget can't be met
+     */
+    bool evictNodes(const size_t requiredBytes);
+
+    void releaseRetired();
+
+    /// the bytes a node uses on the GPU - its blob size rounded up to the pool alignment
+    size_t getNodeSize(const uint32_t id) const;
+
+private:
+    VulkanAPI::VkContext& context;
+    Options options;
+
+    std::vector<std::shared_ptr<OctreeFile>> octrees;
+
+    /// all nodes of all octrees, indexed by global id
+    std::vector<NodeEntry> entries;
+
+    std::vector<uint32_t> residentNodes;
+
+    /// set once the resident nodes have been sorted by request frame this frame
+    bool residentSorted = false;
+
+    std::vector<RetiredAllocation> retired;
+
+    VulkanAPI::BufferPool nodePool;
+    VulkanAPI::StagingUploader uploader;
+
+    uint64_t frameIndex = 0;
+    Stats stats;
+
+    // ========= I/O threads ===============================
+    std::vector<std::thread> ioThreads;
+
+    /// guards the load queue, the loaded list and the state of entries which are being loaded
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<uint32_t> loadQueue;
+    std::vector<uint32_t> loadedNodes;
+    size_t loadingCount = 0;
+    bool stopThreads = false;
+};
+
+} // namespace PCV
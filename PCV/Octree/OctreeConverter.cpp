@@ -0,0 +1,1048 @@
+#include "OctreeConverter.h"
+
+#include "Core/MortonSort.h"
+#include "Core/PointCloud.h"
+#include "Loaders/LasLoader.h"
+#include "Loaders/LazLoader.h"
+#include "Loaders/PointLoader.h"
+#include "Maths/BatchTransform.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <limits>
+#include <random>
+
+namespace PCV
+{
+
+namespace
+{
+
+// the number of bytes held by each thread for every point of a chunk whilst indexing - the
+// points, the split child arrays and the blob being written
+constexpr size_t IndexingBytesPerPoint = 64;
+
+// the counting grid size is chosen by the total number of points so each cell holds a reasonable
+// number of points without the grid itself using too much memory
+uint32_t getGridDepth(const uint64_t pointCount)
+{
+    if (pointCount < 100'000'000)
+    {
+        return 7;
+    }
+    return 8;
+}
+
+bool isStreamable(const std::string& ext)
+{
+    return ext == "las" || ext == "laz";
+}
+
+// the number of bucket files kept open while distributing, well below the usual descriptor limit
+constexpr size_t MaxOpenBuckets = 256;
+
+/**
+ * The files of the chunk buckets, which are kept open between flushes. If there are more chunks
+ * than **MaxOpenBuckets**, the file opened longest ago is closed to make room.
+ */
+class BucketFiles
+{
+public:
+    explicit BucketFiles(const size_t count)
+        : files(count, nullptr)
+        , created(count, false)
+    {
+    }
+
+    ~BucketFiles()
+    {
+        closeAll();
+    }
+
+    FILE* get(const size_t idx, const std::string& path)
+    {
+        if (files[idx])
+        {
+            return files[idx];
+        }
+        if (openOrder.size() >= MaxOpenBuckets)
+        {
+            const size_t oldest = openOrder.front();
+            openOrder.pop_front();
+            success &= fclose(files[oldest]) == 0;
+            files[oldest] = nullptr;
+        }
+
+        // a bucket left by an earlier run is overwritten
+        files[idx] = fopen(path.c_str(), created[idx] ? "ab" : "wb");
+        created[idx] = true;
+        if (files[idx])
+        {
+            openOrder.push_back(idx);
+        }
+        return files[idx];
+    }
+
+    /// closes every file, returning false if any buffered write failed
+    bool closeAll()
+    {
+        for (size_t idx : openOrder)
+        {
+            success &= fclose(files[idx]) == 0;
+            files[idx] = nullptr;
+        }
+        openOrder.clear();
+        return success;
+    }
+
+private:
+    std::vector<FILE*> files;
+    std::vector<bool> created;
+    std::deque<size_t> openOrder;
+    bool success = true;
+};
+
+} // namespace
+
+OctreeConverter::OctreeConverter(const Options& opts)
+    : options(opts)
+{
+    if (options.threadCount == 0)
+    {
+        options.threadCount = ThreadTaskSplitter::getHardwareThreadCount();
+    }
+}
+
+OctreeConverter::~OctreeConverter()
+{
+    if (dataFile)
+    {
+        fclose(dataFile);
+    }
+}
+
+bool OctreeConverter::run()
+{
+    namespace fs = std::filesystem;
+
+    Util::Timer<Util::NanoSeconds> timer;
+
+    std::error_code ec;
+    fs::create_directories(options.outputDir, ec);
+    tempDir = options.outputDir + "/.buckets";
+    fs::create_directories(tempDir, ec);
+    if (ec)
+    {
+        LOGGER_ERROR("Unable to create the output directory %s.", options.outputDir.c_str());
+        return false;
+    }
+
+    // ========= bounds ========================================
+    if (!scanInputs())
+    {
+        return false;
+    }
+    LOGGER_INFO(
+        "Converting %llu points from %zu files.",
+        static_cast<unsigned long long>(pointCount),
+        options.inputs.size());
+
+    // ========= counting ======================================
+    countPoints();
+    createChunks();
+    LOGGER_INFO(
+        "Counted points into %zu chunks in %.2fs.", chunks.size(), timer.getElapsedSeconds());
+
+    // ========= distribution ==================================
+    if (!distributePoints())
+    {
+        return false;
+    }
+    LOGGER_INFO("Distributed points to chunks in %.2fs.", timer.getElapsedSeconds());
+
+    // ========= indexing ======================================
+    const std::string dataPath = options.outputDir + "/" + Octree::NodeDataFilename;
+    dataFile = fopen(dataPath.c_str(), "wb");
+    if (!dataFile)
+    {
+        LOGGER_ERROR("Unable to create %s.", dataPath.c_str());
+        return false;
+    }
+
+    if (!indexChunks() || !buildUpperLevels())
+    {
+        return false;
+    }
+    fclose(dataFile);
+    dataFile = nullptr;
+
+    if (!writeHierarchy())
+    {
+        return false;
+    }
+    fs::remove_all(tempDir, ec);
+
+    LOGGER_INFO(
+        "Wrote %zu nodes to %s in %.2fs.",
+        records.size(),
+        options.outputDir.c_str(),
+        timer.getElapsedSeconds());
+    return true;
+}
+
+bool OctreeConverter::scanInputs()
+{
+    for (size_t i = 0; i < 3; ++i)
+    {
+        boundsMin[i] = std::numeric_limits<double>::max();
+        boundsMax[i] = std::numeric_limits<double>::lowest();
+    }
+
+    auto extend = [this](const double* min, const double* max) {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            boundsMin[i] = std::min(boundsMin[i], min[i]);
+            boundsMax[i] = std::max(boundsMax[i], max[i]);
+        }
+    };
+
+    for (const std::string& path : options.inputs)
+    {
+        const std::string ext = getFileExtension(path.c_str());
+        if (isStreamable(ext))
+        {
+            // the header holds everything required, so there's no need to read the points
+            LasLoader::Header header;
+            if (ext == "las")
+            {
+                LasLoader loader;
+                if (!loader.open(path.c_str()))
+                {
+                    return false;
+                }
+                header = loader.getHeader();
+            }
+            else
+            {
+                LazLoader loader;
+                if (!loader.open(path.c_str()))
+                {
+                    return false;
+                }
+                header = loader.getHeader();
+            }
+
+            LasLoader::RecordLayout layout;
+            LasLoader::getRecordLayout(header.pointFormat, layout);
+            attributes |= PointCloud::AttributeFlags::Intensity |
+                PointCloud::AttributeFlags::Classification;
+            if (layout.rgb >= 0)
+            {
+                attributes |= PointCloud::AttributeFlags::Colour;
+            }
+            extend(header.min, header.max);
+            pointCount += header.pointCount;
+            continue;
+        }
+
+        // other formats can't be streamed, so have to be loaded to find the bounds
+        LoadStats stats;
+        std::unique_ptr<PointCloud> cloud = loadPointCloud(path.c_str(), stats);
+        if (!cloud)
+        {
+            return false;
+        }
+        cloud->computeBounds();
+
+        const AABBox& bounds = cloud->getBounds();
+        const OEMaths::vec3d& org = cloud->getOrigin();
+        const double min[3] = {org.x + bounds.min.x, org.y + bounds.min.y, org.z + bounds.min.z};
+        const double max[3] = {org.x + bounds.max.x, org.y + bounds.max.y, org.z + bounds.max.z};
+        extend(min, max);
+
+        attributes |= PointCloud::AttributeFlags::Position;
+        const PointCloud::AttributeFlags optional[] = {
+            PointCloud::AttributeFlags::Colour,
+            PointCloud::AttributeFlags::Intensity,
+            PointCloud::AttributeFlags::Classification};
+        for (PointCloud::AttributeFlags flag : optional)
+        {
+            if (cloud->hasAttribute(flag))
+            {
+                attributes |= flag;
+            }
+        }
+        pointCount += cloud->size();
+    }
+    attributes |= PointCloud::AttributeFlags::Position;
+
+    if (pointCount == 0)
+    {
+        LOGGER_ERROR("The input files contain no points.");
+        return false;
+    }
+
+    // the octree is cubic - slightly enlarged so points on the max bounds fall inside the grid
+    cubeSize = 0.0;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        cubeSize = std::max(cubeSize, boundsMax[i] - boundsMin[i]);
+    }
+    cubeSize = std::max(cubeSize * 1.0001, 1e-3);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        cubeMin[i] = (boundsMin[i] + boundsMax[i]) * 0.5 - cubeSize * 0.5;
+    }
+    origin = {
+        cubeMin[0] + cubeSize * 0.5, cubeMin[1] + cubeSize * 0.5, cubeMin[2] + cubeSize * 0.5};
+    return true;
+}
+
+bool OctreeConverter::forEachBatch(const BatchFunc& func)
+{
+    for (const std::string& path : options.inputs)
+    {
+        const std::string ext = getFileExtension(path.c_str());
+        if (ext == "las")
+        {
+            LasLoader loader;
+            if (!loader.open(path.c_str()))
+            {
+                return false;
+            }
+            const size_t count = static_cast<size_t>(loader.getHeader().pointCount);
+            for (size_t first = 0; first < count; first += options.batchSize)
+            {
+                auto batch =
+                    loader.createPointCloud(first, std::min(options.batchSize, count - first));
+                if (!batch)
+                {
+                    return false;
+                }
+                func(*batch);
+            }
+        }
+        else if (ext == "laz")
+        {
+            // laz files can only be decompressed a chunk at a time
+            LazLoader loader;
+            if (!loader.open(path.c_str()))
+            {
+                return false;
+            }
+            const std::vector<LazLoader::Chunk>& lazChunks = loader.getChunks();
+            std::vector<size_t> indices;
+            size_t batchPoints = 0;
+            for (size_t i = 0; i < lazChunks.size(); ++i)
+            {
+                indices.emplace_back(i);
+                batchPoints += lazChunks[i].pointCount;
+                if (batchPoints >= options.batchSize || i == lazChunks.size() - 1)
+                {
+                    auto batch = loader.createPointCloud(indices);
+                    if (!batch)
+                    {
+                        return false;
+                    }
+                    func(*batch);
+                    indices.clear();
+                    batchPoints = 0;
+                }
+            }
+        }
+        else
+        {
+            LoadStats stats;
+            std::unique_ptr<PointCloud> cloud = loadPointCloud(path.c_str(), stats);
+            if (!cloud)
+            {
+                return false;
+            }
+            func(*cloud);
+        }
+    }
+    return true;
+}
+
+void OctreeConverter::rebaseBatch(const PointCloud& batch)
+{
+    // the batch and octree origins are both close to the points, so the offset between them is
+    // small enough to apply in single precision
+    const OEMaths::vec3d offset = batch.getOrigin() - origin;
+    const OEMaths::mat4f translation = OEMaths::mat4f::translate(OEMaths::vec3f {
+        static_cast<float>(offset.x),
+        static_cast<float>(offset.y),
+        static_cast<float>(offset.z)});
+
+    const size_t count = batch.size();
+    rebased.x.resize(count);
+    rebased.y.resize(count);
+    rebased.z.resize(count);
+
+    auto rebaseRange = [&](const size_t start, const size_t num) {
+        float* x = rebased.x.data() + start;
+        float* y = rebased.y.data() + start;
+        float* z = rebased.z.data() + start;
+        batch.posX.copyTo(x, start, num);
+        batch.posY.copyTo(y, start, num);
+        batch.posZ.copyTo(z, start, num);
+        OEMaths::transformPoints(translation, x, y, z, num, x, y, z);
+    };
+    ThreadTaskSplitter split {0, count, rebaseRange, options.threadCount};
+    split.run();
+}
+
+OctreeConverter::Point OctreeConverter::toPoint(const PointCloud& batch, const size_t idx) const
+{
+    Point point;
+    point.x = rebased.x[idx];
+    point.y = rebased.y[idx];
+    point.z = rebased.z[idx];
+    point.intensity = batch.hasAttribute(PointCloud::AttributeFlags::Intensity) ?
+        batch.intensity[idx] :
+        0;
+    point.classification = batch.hasAttribute(PointCloud::AttributeFlags::Classification) ?
+        batch.classification[idx] :
+        0;
+    if (batch.hasAttribute(PointCloud::AttributeFlags::Colour))
+    {
+        point.red = batch.red[idx];
+        point.green = batch.green[idx];
+        point.blue = batch.blue[idx];
+    }
+    else
+    {
+        point.red = point.green = point.blue = 255;
+    }
+    return point;
+}
+
+size_t OctreeConverter::getCellIndex(const Point& point) const
+{
+    const double half = cubeSize * 0.5;
+    const double scale = static_cast<double>(gridSize) / cubeSize;
+    const float pos[3] = {point.x, point.y, point.z};
+
+    size_t cell[3];
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const double value = (static_cast<double>(pos[i]) + half) * scale;
+        cell[i] = static_cast<size_t>(std::min(std::max(value, 0.0), gridSize - 1.0));
+    }
+    return cell[0] + (cell[1] + cell[2] * gridSize) * gridSize;
+}
+
+void OctreeConverter::getNodeBounds(const NodeKey& key, float* min, float& size) const
+{
+    const double nodeSize = cubeSize / static_cast<double>(1u << key.depth);
+    const uint32_t coords[3] = {key.x, key.y, key.z};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        min[i] = static_cast<float>(coords[i] * nodeSize - cubeSize * 0.5);
+    }
+    size = static_cast<float>(nodeSize);
+}
+
+void OctreeConverter::countPoints()
+{
+    gridDepth = getGridDepth(pointCount);
+    gridSize = 1u << gridDepth;
+
+    const size_t cellCount = static_cast<size_t>(gridSize) * gridSize * gridSize;
+    cellCounts = std::make_unique<std::atomic<uint32_t>[]>(cellCount);
+    for (size_t i = 0; i < cellCount; ++i)
+    {
+        cellCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    forEachBatch([this](const PointCloud& batch) {
+        rebaseBatch(batch);
+        auto countRange = [&](const size_t start, const size_t count) {
+            for (size_t i = start; i < start + count; ++i)
+            {
+                const size_t cell = getCellIndex(toPoint(batch, i));
+                cellCounts[cell].fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+        ThreadTaskSplitter split {0, batch.size(), countRange, options.threadCount};
+        split.run();
+    });
+}
+
+void OctreeConverter::createChunks()
+{
+    // each thread holds a complete chunk in memory whilst indexing
+    maxChunkPoints = std::max<uint64_t>(
+        options.maxLeafPoints * 8,
+        options.memoryBudget / (options.threadCount * IndexingBytesPerPoint));
+
+    // build the count pyramid from the finest level up
+    std::vector<std::vector<uint64_t>> levels(gridDepth + 1);
+    levels[gridDepth].resize(static_cast<size_t>(gridSize) * gridSize * gridSize);
+    for (size_t i = 0; i < levels[gridDepth].size(); ++i)
+    {
+        levels[gridDepth][i] = cellCounts[i].load(std::memory_order_relaxed);
+    }
+    for (uint32_t level = gridDepth; level > 0; --level)
+    {
+        const size_t size = size_t(1) << level;
+        const size_t parentSize = size >> 1;
+        levels[level - 1].assign(parentSize * parentSize * parentSize, 0);
+        for (size_t z = 0; z < size; ++z)
+        {
+            for (size_t y = 0; y < size; ++y)
+            {
+                for (size_t x = 0; x < size; ++x)
+                {
+                    const size_t parent =
+                        (x >> 1) + ((y >> 1) + (z >> 1) * parentSize) * parentSize;
+                    levels[level - 1][parent] += levels[level][x + (y + z * size) * size];
+                }
+            }
+        }
+    }
+
+    // descend from the root until the cells are small enough to be a chunk
+    cellToChunk.assign(levels[gridDepth].size(), -1);
+    std::function<void(const NodeKey&)> visit = [&](const NodeKey& key) {
+        const size_t size = size_t(1) << key.depth;
+        const uint64_t count = levels[key.depth][key.x + (key.y + key.z * size) * size];
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (count > maxChunkPoints && key.depth < gridDepth)
+        {
+            for (uint32_t child = 0; child < 8; ++child)
+            {
+                NodeKey childKey;
+                childKey.depth = key.depth + 1;
+                childKey.x = key.x * 2 + (child & 1);
+                childKey.y = key.y * 2 + ((child >> 1) & 1);
+                childKey.z = key.z * 2 + ((child >> 2) & 1);
+                visit(childKey);
+            }
+            return;
+        }
+
+        Chunk chunk;
+        chunk.key = key;
+        chunk.pointCount = count;
+        chunk.bucketPath = tempDir + "/chunk_" + std::to_string(chunks.size()) + ".bin";
+
+        // mark all the finest cells covered by this chunk
+        const uint32_t shift = gridDepth - key.depth;
+        const size_t cells = size_t(1) << shift;
+        for (size_t z = 0; z < cells; ++z)
+        {
+            for (size_t y = 0; y < cells; ++y)
+            {
+                for (size_t x = 0; x < cells; ++x)
+                {
+                    const size_t cx = (key.x << shift) + x;
+                    const size_t cy = (key.y << shift) + y;
+                    const size_t cz = (key.z << shift) + z;
+                    cellToChunk[cx + (cy + cz * gridSize) * gridSize] =
+                        static_cast<int32_t>(chunks.size());
+                }
+            }
+        }
+        chunks.emplace_back(chunk);
+    };
+    visit(NodeKey {});
+
+    // the counts aren't required any longer
+    cellCounts.reset();
+}
+
+bool OctreeConverter::distributePoints()
+{
+    // each chunk buffers points in memory and appends them to its bucket when full
+    const size_t bufferSize = std::min<size_t>(
+        std::max<size_t>(1024, options.memoryBudget / (4 * chunks.size() * sizeof(Point))),
+        1 << 20);
+    std::vector<std::vector<Point>> buffers(chunks.size());
+    BucketFiles files {chunks.size()};
+
+    bool success = true;
+    auto flush = [&](const size_t idx) {
+        std::vector<Point>& buffer = buffers[idx];
+        if (buffer.empty())
+        {
+            return;
+        }
+        FILE* fp = files.get(idx, chunks[idx].bucketPath);
+        if (!fp || fwrite(buffer.data(), sizeof(Point), buffer.size(), fp) != buffer.size())
+        {
+            LOGGER_ERROR("Unable to write to bucket %s.", chunks[idx].bucketPath.c_str());
+            success = false;
+        }
+        buffer.clear();
+    };
+
+    success &= forEachBatch([&](const PointCloud& batch) {
+        rebaseBatch(batch);
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            const Point point = toPoint(batch, i);
+            const int32_t chunk = cellToChunk[getCellIndex(point)];
+            assert(chunk >= 0);
+
+            std::vector<Point>& buffer = buffers[chunk];
+            buffer.emplace_back(point);
+            if (buffer.size() >= bufferSize)
+            {
+                flush(chunk);
+            }
+        }
+    });
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        flush(i);
+    }
+
+    // the buckets are read back while indexing, so everything must be on disk
+    if (!files.closeAll())
+    {
+        LOGGER_ERROR("Unable to write the chunk buckets.");
+        success = false;
+    }
+    return success;
+}
+
+std::unique_ptr<OctreeConverter::BuildNode>
+OctreeConverter::buildNode(const NodeKey& key, std::vector<Point>& points)
+{
+    auto node = std::make_unique<BuildNode>();
+    node->key = key;
+
+    if (points.size() <= options.maxLeafPoints || key.depth >= Octree::MaxDepth)
+    {
+        node->points = std::move(points);
+        return node;
+    }
+
+    float min[3];
+    float size;
+    getNodeBounds(key, min, size);
+    const float half = size * 0.5f;
+    const float centre[3] = {min[0] + half, min[1] + half, min[2] + half};
+
+    // split the points between the children
+    std::vector<Point> childPoints[8];
+    for (const Point& point : points)
+    {
+        const uint32_t child = (point.x >= centre[0] ? 1 : 0) | (point.y >= centre[1] ? 2 : 0) |
+            (point.z >= centre[2] ? 4 : 0);
+        childPoints[child].emplace_back(point);
+    }
+    points.clear();
+    points.shrink_to_fit();
+
+    for (uint32_t child = 0; child < 8; ++child)
+    {
+        if (childPoints[child].empty())
+        {
+            continue;
+        }
+        NodeKey childKey;
+        childKey.depth = key.depth + 1;
+        childKey.x = key.x * 2 + (child & 1);
+        childKey.y = key.y * 2 + ((child >> 1) & 1);
+        childKey.z = key.z * 2 + ((child >> 2) & 1);
+        node->children[child] = buildNode(childKey, childPoints[child]);
+        node->hasChildren = true;
+    }
+    return node;
+}
+
+void OctreeConverter::subsample(BuildNode& node, Sampler& sampler) const
+{
+    constexpr size_t GridSize = Octree::NodeGridSize;
+    sampler.occupied.resize(GridSize * GridSize * GridSize, 0);
+
+    float min[3];
+    float size;
+    getNodeBounds(node.key, min, size);
+    const float scale = static_cast<float>(GridSize) / size;
+
+    for (std::unique_ptr<BuildNode>& child : node.children)
+    {
+        if (!child)
+        {
+            continue;
+        }
+
+        // the first point to fall into an empty cell is moved up to this node. The points were
+        // shuffled when the chunk was loaded so this gives a random sample of each cell
+        std::vector<Point>& childPoints = child->points;
+        size_t kept = 0;
+        for (size_t i = 0; i < childPoints.size(); ++i)
+        {
+            const Point& point = childPoints[i];
+            const float pos[3] = {point.x, point.y, point.z};
+            size_t cell[3];
+            for (size_t j = 0; j < 3; ++j)
+            {
+                const float value = (pos[j] - min[j]) * scale;
+                cell[j] = static_cast<size_t>(
+                    std::min(std::max(value, 0.0f), static_cast<float>(GridSize - 1)));
+            }
+
+            const size_t idx = cell[0] + (cell[1] + cell[2] * GridSize) * GridSize;
+            if (!sampler.occupied[idx])
+            {
+                sampler.occupied[idx] = 1;
+                sampler.touched.emplace_back(static_cast<uint32_t>(idx));
+                node.points.emplace_back(point);
+            }
+            else
+            {
+                childPoints[kept++] = point;
+            }
+        }
+        childPoints.resize(kept);
+
+        // leaves which have had all of their points moved up are no longer required
+        if (childPoints.empty() && !child->hasChildren)
+        {
+            child.reset();
+        }
+    }
+
+    for (uint32_t idx : sampler.touched)
+    {
+        sampler.occupied[idx] = 0;
+    }
+    sampler.touched.clear();
+}
+
+bool OctreeConverter::writeTree(BuildNode& node, const BuildNode* exclude)
+{
+    bool success = true;
+    for (std::unique_ptr<BuildNode>& child : node.children)
+    {
+        if (child)
+        {
+            success &= writeTree(*child, exclude);
+            child.reset();
+        }
+    }
+    if (&node != exclude)
+    {
+        success &= writeNode(node.key, node.points);
+        node.points.clear();
+        node.points.shrink_to_fit();
+    }
+    return success;
+}
+
+bool OctreeConverter::writeNode(const NodeKey& key, const std::vector<Point>& points)
+{
+    const size_t count = points.size();
+    const Octree::BlobLayout layout = Octree::getBlobLayout(count, attributes);
+
+    float min[3];
+    float size;
+    getNodeBounds(key, min, size);
+
+    // the points are stored in morton order, so points which are close in space are also close
+    // in the vertex buffer. Each chunk is indexed on its own thread so this is single threaded
+    std::vector<uint32_t> order;
+    if (count)
+    {
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(points.data());
+        const Util::StridedView<float> x {base + offsetof(Point, x), sizeof(Point), count};
+        const Util::StridedView<float> y {base + offsetof(Point, y), sizeof(Point), count};
+        const Util::StridedView<float> z {base + offsetof(Point, z), sizeof(Point), count};
+        const AABBox bounds {
+            {min[0], min[1], min[2]}, {min[0] + size, min[1] + size, min[2] + size}};
+        getMortonOrder(x, y, z, bounds, order, 1);
+    }
+
+    // convert to the separate attribute arrays of the blob
+    std::vector<uint8_t> blob(layout.size);
+    auto writeArray = [&](const size_t offset, auto getValue) {
+        using Type = decltype(getValue(points[0]));
+        Type* dst = reinterpret_cast<Type*>(blob.data() + offset);
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] = getValue(points[order[i]]);
+        }
+    };
+
+    if (count)
+    {
+        writeArray(layout.posX, [](const Point& p) { return p.x; });
+        writeArray(layout.posY, [](const Point& p) { return p.y; });
+        writeArray(layout.posZ, [](const Point& p) { return p.z; });
+        if (attributes & PointCloud::AttributeFlags::Intensity)
+        {
+            writeArray(layout.intensity, [](const Point& p) { return p.intensity; });
+        }
+        if (attributes & PointCloud::AttributeFlags::Colour)
+        {
+            writeArray(layout.red, [](const Point& p) { return p.red; });
+            writeArray(layout.green, [](const Point& p) { return p.green; });
+            writeArray(layout.blue, [](const Point& p) { return p.blue; });
+        }
+        if (attributes & PointCloud::AttributeFlags::Classification)
+        {
+            writeArray(layout.classification, [](const Point& p) { return p.classification; });
+        }
+    }
+
+    Octree::NodeRecord record {};
+    record.byteSize = static_cast<uint32_t>(layout.size);
+    record.pointCount = static_cast<uint32_t>(count);
+    record.depth = static_cast<uint8_t>(key.depth);
+    record.x = key.x;
+    record.y = key.y;
+    record.z = key.z;
+    record.parent = -1;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        record.boundsMin[i] = min[i];
+        record.boundsMax[i] = min[i] + size;
+    }
+
+    std::lock_guard<std::mutex> lock {writeMutex};
+
+    // each blob starts on an aligned offset, so the arrays are aligned in the mapped file too
+    const size_t padding = Octree::alignBlobOffset(dataOffset) - dataOffset;
+    const uint8_t zeros[Octree::BlobAlignment] = {};
+    if (padding && fwrite(zeros, 1, padding, dataFile) != padding)
+    {
+        LOGGER_ERROR("Unable to write the octree node data.");
+        return false;
+    }
+    dataOffset += padding;
+
+    record.byteOffset = dataOffset;
+    if (!blob.empty() && fwrite(blob.data(), 1, blob.size(), dataFile) != blob.size())
+    {
+        LOGGER_ERROR("Unable to write the octree node data.");
+        return false;
+    }
+    dataOffset += blob.size();
+    records.emplace_back(record);
+    return true;
+}
+
+bool OctreeConverter::indexChunks()
+{
+    Util::Timer<Util::NanoSeconds> timer;
+    std::atomic<bool> success {true};
+
+    auto indexRange = [&](const size_t start, const size_t count) {
+        Sampler sampler;
+        for (size_t i = start; i < start + count && success; ++i)
+        {
+            const Chunk& chunk = chunks[i];
+
+            std::vector<Point> points(static_cast<size_t>(chunk.pointCount));
+            FILE* fp = fopen(chunk.bucketPath.c_str(), "rb");
+            const size_t read = fp ? fread(points.data(), sizeof(Point), points.size(), fp) : 0;
+            if (fp)
+            {
+                fclose(fp);
+            }
+            if (read != points.size())
+            {
+                LOGGER_ERROR("Unable to read bucket %s.", chunk.bucketPath.c_str());
+                success = false;
+                return;
+            }
+            std::remove(chunk.bucketPath.c_str());
+
+            // the subsampling takes the first point of each cell, so randomise the order
+            std::mt19937 rng {static_cast<uint32_t>(i)};
+            std::shuffle(points.begin(), points.end(), rng);
+
+            std::unique_ptr<BuildNode> root = buildNode(chunk.key, points);
+
+            // subsample bottom up - the inner nodes are visited after their children
+            std::function<void(BuildNode&)> sampleTree = [&](BuildNode& node) {
+                if (!node.hasChildren)
+                {
+                    return;
+                }
+                for (std::unique_ptr<BuildNode>& child : node.children)
+                {
+                    if (child)
+                    {
+                        sampleTree(*child);
+                    }
+                }
+                subsample(node, sampler);
+            };
+            sampleTree(*root);
+
+            // the chunk root is subsampled again when building the upper levels
+            if (!writeTree(*root, root.get()))
+            {
+                success = false;
+                return;
+            }
+            std::lock_guard<std::mutex> lock {chunkRootMutex};
+            chunkRoots.emplace_back(std::move(root));
+        }
+    };
+
+    ThreadTaskSplitter split {0, chunks.size(), indexRange, options.threadCount};
+    split.run();
+
+    LOGGER_INFO(
+        "Indexed %zu chunks on %zu threads in %.2fs.",
+        chunks.size(),
+        std::min(options.threadCount, chunks.size()),
+        timer.getElapsedSeconds());
+    return success;
+}
+
+bool OctreeConverter::buildUpperLevels()
+{
+    Sampler sampler;
+
+    uint32_t maxDepth = 0;
+    for (const std::unique_ptr<BuildNode>& root : chunkRoots)
+    {
+        maxDepth = std::max(maxDepth, root->key.depth);
+    }
+
+    // the pending nodes of each depth - starting with the chunk roots
+    std::vector<std::vector<std::unique_ptr<BuildNode>>> pending(maxDepth + 1);
+    for (std::unique_ptr<BuildNode>& root : chunkRoots)
+    {
+        pending[root->key.depth].emplace_back(std::move(root));
+    }
+    chunkRoots.clear();
+
+    for (uint32_t depth = maxDepth; depth > 0; --depth)
+    {
+        std::vector<std::unique_ptr<BuildNode>>& nodes = pending[depth];
+
+        // group the nodes by their parent
+        auto getParentCode = [](const BuildNode& node) {
+            return Octree::getMortonCode(node.key.x >> 1, node.key.y >> 1, node.key.z >> 1);
+        };
+        std::sort(nodes.begin(), nodes.end(), [&](const auto& lhs, const auto& rhs) {
+            return getParentCode(*lhs) < getParentCode(*rhs);
+        });
+
+        for (size_t i = 0; i < nodes.size();)
+        {
+            auto parent = std::make_unique<BuildNode>();
+            parent->key.depth = depth - 1;
+            parent->key.x = nodes[i]->key.x >> 1;
+            parent->key.y = nodes[i]->key.y >> 1;
+            parent->key.z = nodes[i]->key.z >> 1;
+            parent->hasChildren = true;
+
+            const uint64_t code = getParentCode(*nodes[i]);
+            for (; i < nodes.size() && getParentCode(*nodes[i]) == code; ++i)
+            {
+                const NodeKey& key = nodes[i]->key;
+                const uint32_t child = (key.x & 1) | ((key.y & 1) << 1) | ((key.z & 1) << 2);
+                parent->children[child] = std::move(nodes[i]);
+            }
+
+            subsample(*parent, sampler);
+            if (!writeTree(*parent, parent.get()))
+            {
+                return false;
+            }
+            pending[depth - 1].emplace_back(std::move(parent));
+        }
+        nodes.clear();
+    }
+
+    assert(pending[0].size() == 1);
+    return writeNode(pending[0][0]->key, pending[0][0]->points);
+}
+
+bool OctreeConverter::writeHierarchy()
+{
+    // sort by depth and then morton order, which places the children of each node contiguously
+    auto getCode = [](const Octree::NodeRecord& record) {
+        return Octree::getMortonCode(record.x, record.y, record.z);
+    };
+    auto compare = [&](const Octree::NodeRecord& lhs, const Octree::NodeRecord& rhs) {
+        return lhs.depth != rhs.depth ? lhs.depth < rhs.depth : getCode(lhs) < getCode(rhs);
+    };
+    std::sort(records.begin(), records.end(), compare);
+
+    // link the children to their parents
+    for (size_t i = 1; i < records.size(); ++i)
+    {
+        Octree::NodeRecord& record = records[i];
+        Octree::NodeRecord key {};
+        key.depth = record.depth - 1;
+        key.x = record.x >> 1;
+        key.y = record.y >> 1;
+        key.z = record.z >> 1;
+
+        auto iter = std::lower_bound(records.begin(), records.begin() + i, key, compare);
+        if (iter == records.begin() + i || iter->depth != key.depth ||
+            getCode(*iter) != getCode(key))
+        {
+            LOGGER_ERROR("Octree node is missing its parent.");
+            return false;
+        }
+
+        const uint32_t parentIdx = static_cast<uint32_t>(iter - records.begin());
+        const uint32_t child = (record.x & 1) | ((record.y & 1) << 1) | ((record.z & 1) << 2);
+        if (iter->childMask == 0)
+        {
+            iter->firstChild = static_cast<uint32_t>(i);
+        }
+        iter->childMask |= 1 << child;
+        record.parent = static_cast<int32_t>(parentIdx);
+    }
+
+    Octree::HierarchyHeader header {};
+    std::memcpy(header.magic, Octree::Magic, sizeof(Octree::Magic));
+    header.version = Octree::FormatVersion;
+    header.nodeCount = static_cast<uint32_t>(records.size());
+    header.attributes = attributes;
+    header.pointCount = pointCount;
+    header.origin[0] = origin.x;
+    header.origin[1] = origin.y;
+    header.origin[2] = origin.z;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        header.boundsMin[i] = static_cast<float>(-cubeSize * 0.5);
+        header.boundsMax[i] = static_cast<float>(cubeSize * 0.5);
+    }
+    header.spacing = static_cast<float>(cubeSize / Octree::NodeGridSize);
+    for (const Octree::NodeRecord& record : records)
+    {
+        header.depth = std::max<uint32_t>(header.depth, record.depth);
+    }
+
+    const std::string path = options.outputDir + "/" + Octree::HierarchyFilename;
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp)
+    {
+        LOGGER_ERROR("Unable to create %s.", path.c_str());
+        return false;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+    success &= fwrite(records.data(), sizeof(Octree::NodeRecord), records.size(), fp) ==
+        records.size();
+    fclose(fp);
+    return success;
+}
+
+} // namespace PCV
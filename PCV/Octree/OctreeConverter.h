@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Octree/OctreeFormat.h"
+
+#include "Maths/OEMaths.h"
+
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief Converts point clouds of any size into the tiled on-disk octree read by **OctreeFile**.
+ * The conversion works in bounded memory, following the same approach as the Potree converter:
+ * 1. The inputs are streamed and the points counted into a coarse grid.
+ * 2. Neighbouring grid cells are merged into chunks small enough to fit into the memory budget.
+ * 3. The inputs are streamed again and each point is appended to the on-disk bucket of its chunk.
+ * 4. The chunks are indexed in parallel - each is loaded, split into an octree and the inner
+ * nodes are filled by moving a grid subsample of their children up the tree.
+ * 5. The levels above the chunks are built by subsampling the chunk roots.
+ */
+class OctreeConverter
+{
+public:
+    struct Options
+    {
+        std::vector<std::string> inputs;
+        std::string outputDir;
+
+        /// the approximate upper limit of memory used while indexing, in bytes
+        size_t memoryBudget = size_t(4096) << 20;
+
+        /// the number of threads used for indexing - zero uses all hardware threads
+        size_t threadCount = 0;
+
+        /// nodes with more points than this are split
+        size_t maxLeafPoints = 20000;
+
+        /// the number of points read from the inputs at a time
+        size_t batchSize = 1 << 20;
+    };
+
+    explicit OctreeConverter(const Options& options);
+    ~OctreeConverter();
+
+    bool run();
+
+private:
+    /// the point format of the buckets and of the nodes while they are being indexed
+    struct Point
+    {
+        float x;
+        float y;
+        float z;
+        uint16_t intensity;
+        uint8_t red;
+        uint8_t green;
+        uint8_t blue;
+        uint8_t classification;
+    };
+
+    struct NodeKey
+    {
+        uint32_t depth = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t z = 0;
+    };
+
+    struct BuildNode
+    {
+        NodeKey key;
+        std::vector<Point> points;
+        std::unique_ptr<BuildNode> children[8];
+
+        /// set if the node has descendants, even if they have already been written
+        bool hasChildren = false;
+    };
+
+    struct Chunk
+    {
+        NodeKey key;
+        uint64_t pointCount = 0;
+        std::string bucketPath;
+    };
+
+    /// the positions of a batch relative to the octree origin
+    struct Positions
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+    };
+
+    /// tracks which cells of a node are occupied while subsampling - reused between nodes
+    struct Sampler
+    {
+        std::vector<uint8_t> occupied;
+        std::vector<uint32_t> touched;
+    };
+
+    using BatchFunc = std::function<void(const PointCloud& batch)>;
+
+    bool scanInputs();
+    bool forEachBatch(const BatchFunc& func);
+
+    void countPoints();
+    void createChunks();
+    bool distributePoints();
+    bool indexChunks();
+    bool buildUpperLevels();
+    bool writeHierarchy();
+
+    /// moves the positions of the batch from its origin to the octree origin, into **rebased**
+    void rebaseBatch(const PointCloud& batch);
+
+    /// converts a point of the batch last passed to **rebaseBatch**
+    Point toPoint(const PointCloud& batch, const size_t idx) const;
+
+    /// the index of the counting grid cell containing the point
+    size_t getCellIndex(const Point& point) const;
+
+    /// the min corner and size of a node, relative to the octree origin
+    void getNodeBounds(const NodeKey& key, float* min, float& size) const;
+
+    std::unique_ptr<BuildNode> buildNode(const NodeKey& key, std::vector<Point>& points);
+
+    /// moves a grid subsample of the points of the children up into the node
+    void subsample(BuildNode& node, Sampler& sampler) const;
+
+    /// writes the node and all of its descendants, except for nodes in **exclude**
+    bool writeTree(BuildNode& node, const BuildNode* exclude);
+
+    bool writeNode(const NodeKey& key, const std::vector<Point>& points);
+
+private:
+    Options options;
+
+    // ========= bounds ===============================
+    double boundsMin[3] = {};
+    double boundsMax[3] = {};
+    double cubeMin[3] = {};
+    double cubeSize = 0.0;
+    OEMaths::vec3d origin;
+
+    uint32_t attributes = 0;
+    uint64_t pointCount = 0;
+
+    // ========= counting grid ========================
+    uint32_t gridDepth = 0;
+    uint32_t gridSize = 0;
+    std::unique_ptr<std::atomic<uint32_t>[]> cellCounts;
+    std::vector<int32_t> cellToChunk;
+
+    std::vector<Chunk> chunks;
+    uint64_t maxChunkPoints = 0;
+
+    /// the positions of the current batch, reused between batches
+    Positions rebased;
+
+    /// the chunk roots, which are held back to build the upper levels of the tree
+    std::vector<std::unique_ptr<BuildNode>> chunkRoots;
+    std::mutex chunkRootMutex;
+
+    // ========= output ===============================
+    std::string tempDir;
+    FILE* dataFile = nullptr;
+    uint64_t dataOffset = 0;
+    std::vector<Octree::NodeRecord> records;
+    std::mutex writeMutex;
+};
+
+} // namespace PCV
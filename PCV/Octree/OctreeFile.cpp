@@ -0,0 +1,132 @@
+#include "OctreeFile.h"
+
+#include "Core/PointCloud.h"
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+
+#include <cstring>
+
+namespace PCV
+{
+
+OctreeFile::OctreeFile()
+{
+}
+
+OctreeFile::~OctreeFile()
+{
+}
+
+bool OctreeFile::open(const char* dir)
+{
+    const std::string hierarchyPath = std::string {dir} + "/" + Octree::HierarchyFilename;
+    const std::string dataPath = std::string {dir} + "/" + Octree::NodeDataFilename;
+
+    Util::MappedFile hierarchy;
+    if (!hierarchy.open(hierarchyPath.c_str()))
+    {
+        return false;
+    }
+
+    if (hierarchy.size() < sizeof(Octree::HierarchyHeader))
+    {
+        LOGGER_ERROR("Octree hierarchy %s is truncated.", hierarchyPath.c_str());
+        return false;
+    }
+    std::memcpy(&header, hierarchy.data(), sizeof(Octree::HierarchyHeader));
+
+    if (std::memcmp(header.magic, Octree::Magic, sizeof(Octree::Magic)) != 0 ||
+        header.version != Octree::FormatVersion)
+    {
+        LOGGER_ERROR("%s is not a valid octree hierarchy.", hierarchyPath.c_str());
+        return false;
+    }
+    if (sizeof(Octree::HierarchyHeader) + header.nodeCount * sizeof(Octree::NodeRecord) >
+        hierarchy.size())
+    {
+        LOGGER_ERROR("Octree hierarchy %s is truncated.", hierarchyPath.c_str());
+        return false;
+    }
+
+    nodes.resize(header.nodeCount);
+    std::memcpy(
+        nodes.data(),
+        hierarchy.data() + sizeof(Octree::HierarchyHeader),
+        header.nodeCount * sizeof(Octree::NodeRecord));
+
+    nodeData = std::make_shared<Util::MappedFile>();
+    if (!nodeData->open(dataPath.c_str()))
+    {
+        return false;
+    }
+
+    for (const Octree::NodeRecord& node : nodes)
+    {
+        if (node.byteOffset + node.byteSize > nodeData->size())
+        {
+            LOGGER_ERROR("Octree node data %s is truncated.", dataPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+const uint8_t* OctreeFile::getNodeData(const size_t idx) const
+{
+    if (!nodeData || idx >= nodes.size())
+    {
+        return nullptr;
+    }
+    return nodeData->data() + nodes[idx].byteOffset;
+}
+
+std::unique_ptr<PointCloud> OctreeFile::loadNode(const size_t idx) const
+{
+    if (!nodeData || idx >= nodes.size())
+    {
+        return nullptr;
+    }
+
+    const Octree::NodeRecord& node = nodes[idx];
+    const size_t count = node.pointCount;
+    const Octree::BlobLayout layout = Octree::getBlobLayout(count, header.attributes);
+    const uint8_t* blob = nodeData->data() + node.byteOffset;
+
+    auto cloud = std::make_unique<PointCloud>();
+    cloud->setSource(nodeData, count);
+
+    // the blob arrays are tightly packed so the stride is the size of the attribute type
+    auto bind = [blob, count](auto& view, const size_t offset) {
+        view = {blob + offset, sizeof(view[0]), count};
+    };
+
+    bind(cloud->posX, layout.posX);
+    bind(cloud->posY, layout.posY);
+    bind(cloud->posZ, layout.posZ);
+    cloud->addAttribute(PointCloud::AttributeFlags::Position);
+    if (header.attributes & PointCloud::AttributeFlags::Intensity)
+    {
+        bind(cloud->intensity, layout.intensity);
+        cloud->addAttribute(PointCloud::AttributeFlags::Intensity);
+    }
+    if (header.attributes & PointCloud::AttributeFlags::Colour)
+    {
+        bind(cloud->red, layout.red);
+        bind(cloud->green, layout.green);
+        bind(cloud->blue, layout.blue);
+        cloud->addAttribute(PointCloud::AttributeFlags::Colour);
+    }
+    if (header.attributes & PointCloud::AttributeFlags::Classification)
+    {
+        bind(cloud->classification, layout.classification);
+        cloud->addAttribute(PointCloud::AttributeFlags::Classification);
+    }
+
+    cloud->setOrigin({header.origin[0], header.origin[1], header.origin[2]});
+    cloud->setBounds(AABBox {
+        {node.boundsMin[0], node.boundsMin[1], node.boundsMin[2]},
+        {node.boundsMax[0], node.boundsMax[1], node.boundsMax[2]}});
+    return cloud;
+}
+
+} // namespace PCV
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Octree/OctreeFormat.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+class MappedFile;
+}
+
+namespace PCV
+{
+// forward declerations
+class PointCloud;
+
+/**
+ * @brief Opens an octree written by pcv-convert. Only the hierarchy is read on opening - the
+ * node data file is memory mapped and the points of a node are only paged in when the node is
+ * loaded, so the hierarchy of clouds much larger than the available memory can be traversed.
+ */
+class OctreeFile
+{
+public:
+    OctreeFile();
+    ~OctreeFile();
+
+    /**
+     * @brief Reads the hierarchy and maps the node data.
+     * @param dir The directory the converter wrote the octree to
+     */
+    bool open(const char* dir);
+
+    /**
+     * @brief Creates a point cloud for a single node. The attribute views reference the mapped
+     * node data directly, so no copying takes place.
+     */
+    std::unique_ptr<PointCloud> loadNode(const size_t idx) const;
+
+    /**
+     * @brief The mapped blob of a node - laid out as described by **Octree::getBlobLayout**.
+     * Reading the blob pages in the node data, so this should be done away from the render thread.
+     */
+    const uint8_t* getNodeData(const size_t idx) const;
+
+    const Octree::HierarchyHeader& getHeader() const
+    {
+        return header;
+    }
+
+    const std::vector<Octree::NodeRecord>& getNodes() const
+    {
+        return nodes;
+    }
+
+private:
+    Octree::HierarchyHeader header;
+
+    std::vector<Octree::NodeRecord> nodes;
+
+    std::shared_ptr<Util::MappedFile> nodeData;
+};
+
+} // namespace PCV
@@ -0,0 +1,58 @@
+#include "OctreeFormat.h"
+
+#include "Core/PointCloud.h"
+
+namespace PCV
+{
+namespace Octree
+{
+
+BlobLayout getBlobLayout(const size_t pointCount, const uint32_t attributes)
+{
+    BlobLayout layout;
+    size_t offset = 0;
+
+    auto addArray = [&offset, pointCount](size_t& dst, const size_t typeSize) {
+        dst = offset;
+        offset += pointCount * typeSize;
+    };
+
+    addArray(layout.posX, sizeof(float));
+    addArray(layout.posY, sizeof(float));
+    addArray(layout.posZ, sizeof(float));
+    if (attributes & PointCloud::AttributeFlags::Intensity)
+    {
+        addArray(layout.intensity, sizeof(uint16_t));
+    }
+    if (attributes & PointCloud::AttributeFlags::Colour)
+    {
+        addArray(layout.red, sizeof(uint8_t));
+        addArray(layout.green, sizeof(uint8_t));
+        addArray(layout.blue, sizeof(uint8_t));
+    }
+    if (attributes & PointCloud::AttributeFlags::Classification)
+    {
+        addArray(layout.classification, sizeof(uint8_t));
+    }
+
+    layout.size = offset;
+    return layout;
+}
+
+uint64_t getMortonCode(const uint32_t x, const uint32_t y, const uint32_t z)
+{
+    // spreads the lower 21 bits so there are two zero bits between each
+    auto split = [](const uint32_t value) {
+        uint64_t v = value & 0x1fffff;
+        v = (v | (v << 32)) & 0x1f00000000ffffull;
+        v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+        v = (v | (v << 8)) & 0x100f00f00f00f00full;
+        v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+        v = (v | (v << 2)) & 0x1249249249249249ull;
+        return v;
+    };
+    return split(x) | (split(y) << 1) | (split(z) << 2);
+}
+
+} // namespace Octree
+} // namespace PCV
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace PCV
+{
+namespace Octree
+{
+
+/**
+ * The on-disk octree written by pcv-convert is a directory containing two files:
+ * - the hierarchy, which is a **HierarchyHeader** followed by a **NodeRecord** for every node.
+ * The nodes are sorted by depth and then by morton order, so the children of a node are stored
+ * contiguously.
+ * - the node data, which holds the points of every node as a separate blob. Each blob stores the
+ * attributes as separate arrays (see **BlobLayout**) so they can be referenced directly by a
+ * point cloud without any conversion. Blobs start on a multiple of **BlobAlignment**, with zero
+ * padding between them.
+ */
+constexpr char HierarchyFilename[] = "hierarchy.bin";
+constexpr char NodeDataFilename[] = "octree.bin";
+
+constexpr char Magic[4] = {'P', 'C', 'V', 'O'};
+constexpr uint32_t FormatVersion = 1;
+
+/// the maximum depth of the octree - keeps the node coordinates within a 63-bit morton code
+constexpr uint32_t MaxDepth = 20;
+
+/// the number of subsampling cells along each axis of a node - the spacing of a node is its size
+/// divided by this value
+constexpr uint32_t NodeGridSize = 128;
+
+struct HierarchyHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+
+    /// the attributes stored for every point - a combination of PointCloud::AttributeFlags
+    uint32_t attributes;
+
+    uint64_t pointCount;
+
+    /// the world space origin which all positions and bounds are relative to
+    double origin[3];
+
+    /// the cubic bounds of the root node
+    float boundsMin[3];
+    float boundsMax[3];
+
+    /// the minimum distance between points of the root node
+    float spacing;
+    uint32_t depth;
+};
+
+struct NodeRecord
+{
+    /// offset of the node blob in the node data file
+    uint64_t byteOffset;
+    uint32_t byteSize;
+    uint32_t pointCount;
+
+    float boundsMin[3];
+    float boundsMax[3];
+
+    /// index of the first child - the children are stored contiguously in the order of the bits
+    /// set in the child mask
+    uint32_t firstChild;
+    int32_t parent;
+
+    uint8_t depth;
+    uint8_t childMask;
+    uint16_t reserved;
+
+    /// the integer coordinates of the node at its depth
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+};
+
+static_assert(std::is_trivially_copyable<HierarchyHeader>::value, "Header must be copyable");
+static_assert(std::is_trivially_copyable<NodeRecord>::value, "Record must be copyable");
+static_assert(sizeof(HierarchyHeader) == 80, "Unexpected padding in the hierarchy header");
+static_assert(sizeof(NodeRecord) == 64, "Unexpected padding in the node record");
+
+/**
+ * @brief The byte offset of each attribute array within a node blob. The arrays are ordered from
+ * the largest type to the smallest so every array is naturally aligned.
+ */
+struct BlobLayout
+{
+    size_t posX = 0;
+    size_t posY = 0;
+    size_t posZ = 0;
+    size_t intensity = 0;
+    size_t red = 0;
+    size_t green = 0;
+    size_t blue = 0;
+    size_t classification = 0;
+
+    /// the total size of the blob in bytes
+    size_t size = 0;
+};
+
+/// the alignment of each blob within the node data - the same as the copies into the staging
+/// buffer, so both ends of an upload are aligned
+constexpr size_t BlobAlignment = 16;
+
+inline uint64_t alignBlobOffset(const uint64_t offset)
+{
+    return (offset + BlobAlignment - 1) & ~uint64_t(BlobAlignment - 1);
+}
+
+/// calculates the layout of a blob holding **pointCount** points with the given attributes
+BlobLayout getBlobLayout(const size_t pointCount, const uint32_t attributes);
+
+/// interleaves the bits of the coordinates - x occupies the lowest bit
+uint64_t getMortonCode(const uint32_t x, const uint32_t y, const uint32_t z);
+
+} // namespace Octree
+} // namespace PCV
@@ -2,11 +2,21 @@
 
 #include "Threading/ThreadPool.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace OmegaEngine
 {
 
+namespace
+{
+
+// below this a comparison sort of the renderables in place is faster than sorting the keys and
+// gathering the renderables - measured with pcv-bench queue, where the two cross at ~1.5k
+constexpr size_t MinRadixQueueSize = 1536;
+
+} // namespace
+
 RenderQueue::RenderQueue()
 {
 }
@@ -17,41 +27,93 @@ RenderQueue::~RenderQueue()
 
 void RenderQueue::resetAll()
 {
+    for (Frame& frame : frames)
+    {
+        for (size_t i = 0; i < RenderQueue::Type::Count; ++i)
+        {
+            frame.renderables[i].clear();
+        }
+    }
+}
+
+void RenderQueue::beginFrame()
+{
+    writeSlot = readSlot.load(std::memory_order_acquire) ^ 1;
+
+    // clearing keeps the capacity, so the slot doesn't reallocate once it has grown
     for (size_t i = 0; i < RenderQueue::Type::Count; ++i)
     {
-        renderables[i].clear();
+        frames[writeSlot].renderables[i].clear();
     }
 }
 
+void RenderQueue::push(const RenderableQueueInfo& info, const RenderQueue::Type type)
+{
+    frames[writeSlot].renderables[type].emplace_back(info);
+}
+
 void RenderQueue::pushRenderables(
-    std::vector<RenderableQueueInfo>& newRenderables, const RenderQueue::Type type)
+    const std::vector<RenderableQueueInfo>& newRenderables, const RenderQueue::Type type)
 {
-    size_t newSize = newRenderables.size();
-    std::vector<RenderableQueueInfo>& rQueue = renderables[type];
-    rQueue.clear();
-    rQueue.resize(newSize);
+    std::vector<RenderableQueueInfo>& rQueue = frames[writeSlot].renderables[type];
+    rQueue.insert(rQueue.end(), newRenderables.begin(), newRenderables.end());
+}
 
-    std::copy(newRenderables.begin(), newRenderables.end(), rQueue.begin());
+void RenderQueue::submitFrame()
+{
+    sortAll();
+
+    // the renderer picks up the new frame the next time it fetches a queue
+    readSlot.store(writeSlot, std::memory_order_release);
 }
 
-std::vector<RenderableQueueInfo> RenderQueue::getQueue(const RenderQueue::Type type)
+Util::Span<const RenderableQueueInfo> RenderQueue::getQueue(const RenderQueue::Type type) const
 {
-    return renderables[type];
+    return frames[readSlot.load(std::memory_order_acquire)].renderables[type];
 }
 
 void RenderQueue::sortQueue(const RenderQueue::Type type)
 {
-    std::vector<RenderableQueueInfo>& rQueue = renderables[type];
+    std::vector<RenderableQueueInfo>& rQueue = frames[writeSlot].renderables[type];
     if (rQueue.empty())
     {
         return;
     }
 
-    // TODO : use a radix sort instead
-    std::sort(
-        rQueue.begin(), rQueue.end(), [](const RenderableQueueInfo& lhs, RenderableQueueInfo& rhs) {
-            return lhs.sortingKey.u.flags < rhs.sortingKey.u.flags;
-        });
+    // short queues are sorted in place - extracting the keys and gathering the renderables costs
+    // more than the radix sort saves
+    const size_t count = rQueue.size();
+    if (count < MinRadixQueueSize)
+    {
+        std::sort(
+            rQueue.begin(),
+            rQueue.end(),
+            [](const RenderableQueueInfo& lhs, const RenderableQueueInfo& rhs) {
+                return lhs.sortingKey.u.flags < rhs.sortingKey.u.flags;
+            });
+        return;
+    }
+
+    // the keys are sorted along with the queue indices, then the renderables are gathered in
+    // the sorted order - this avoids moving the larger renderable structs on every pass
+    sortKeys.resize(count);
+    sortIndices.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        sortKeys[i] = rQueue[i].sortingKey.u.flags;
+        sortIndices[i] = static_cast<uint32_t>(i);
+    }
+    sorter.sort(sortKeys.data(), sortIndices.data(), count);
+
+    sortedQueue.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        sortedQueue[i] = rQueue[sortIndices[i]];
+    }
+
+    // copied back rather than swapped, as swapping would move the capacity between the queues
+    // and cause them to reallocate
+    std::copy(sortedQueue.begin(), sortedQueue.end(), rQueue.begin());
 }
 
 void RenderQueue::sortAll()
@@ -62,15 +124,41 @@ void RenderQueue::sortAll()
     }
 }
 
-SortKey RenderQueue::createSortKey(Layer layer, size_t materialId, uint64_t variantId)
+SortKey RenderQueue::createSortKey(
+    Layer layer, size_t materialId, uint64_t variantId, const float depth)
 {
-    SortKey key;
+    // linear 24-bit depth - the bits above are taken by the layer, shader and material
+    constexpr uint32_t MaxDepthId = (1u << 24) - 1;
+    const float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+    uint32_t depthId = static_cast<uint32_t>(clamped * static_cast<float>(MaxDepthId));
 
-    key.u.s.layerId = (uint64_t) layer; // layer is the highest priority to group
-    key.u.s.textureId = materialId; // then materials
-    key.u.s.shaderId = variantId; // then shader variant
-    key.u.s.depthId = 0; // TODO - this is camera-view . mesh_centre - camera-pos
+    // the furthest renderables must be drawn first for blending
+    if (layer == Layer::Transparent)
+    {
+        depthId = MaxDepthId - depthId;
+    }
+
+    SortKey key;
+    key.u.flags = 0;
+    key.u.s.layerId = static_cast<uint64_t>(layer); // layer is the highest priority to group
+    key.u.s.shaderId = variantId & 0xfff; // then shader variant
+    key.u.s.textureId = materialId & 0xfff; // then materials
+    key.u.s.depthId = depthId; // and finally the distance from the camera
+    key.depth = depth;
 
     return key;
 }
+
+float RenderQueue::getViewDepth(
+    const OEMaths::vec3f& point,
+    const OEMaths::vec3f& cameraPos,
+    const OEMaths::vec3f& viewDir,
+    const float zNear,
+    const float zFar)
+{
+    assert(zFar > zNear);
+    const float viewZ = OEMaths::dot(point - cameraPos, viewDir);
+    return std::min(std::max((viewZ - zNear) / (zFar - zNear), 0.0f), 1.0f);
+}
+
 } // namespace OmegaEngine
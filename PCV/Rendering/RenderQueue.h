@@ -1,7 +1,15 @@
 #pragma once
 
 
+#include "Maths/OEMaths.h"
+
+#include "Utility/RadixSort.h"
+#include "Utility/Span.h"
+
 #include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
@@ -21,13 +29,14 @@ struct SortKey
 {
     union
     {
+        // declared from the least to the most significant bits, as the supported compilers
+        // allocate bit-fields from the lowest bit - the layer is the primary sort
         struct
         {
-            // in order of sorting importance
-            uint64_t layerId : 4;
-            uint64_t shaderId : 12;
+            uint64_t depthId : 24;
             uint64_t textureId : 12;
-            uint64_t depthId : 12;
+            uint64_t shaderId : 12;
+            uint64_t layerId : 4;
         } s;
 
         uint64_t flags;
@@ -54,6 +63,17 @@ struct RenderableQueueInfo
     SortKey sortingKey;
 };
 
+/**
+ * @brief The renderables to draw each frame, partitioned by queue type. The queue holds two frame
+ * slots so the scene can build the next frame while the renderer reads the last submitted one,
+ * without copying the queues or taking a lock. The slots are written in turn, so the renderer must
+ * have finished with a frame before the scene begins building the frame after next. The queue is
+ * only read on the CPU while recording, so this holds however many frames are in flight on the
+ * GPU.
+ *
+ * The storage of each slot is reused, so no allocations are made once the queues have grown to
+ * their largest size.
+ */
 class RenderQueue
 {
 public:
@@ -75,7 +95,9 @@ public:
     {
         Default,
         Front,
-        Back
+        Back,
+        /// drawn after all opaque layers, back to front
+        Transparent
     };
 
     RenderQueue();
@@ -85,27 +107,79 @@ public:
     RenderQueue(const RenderQueue&) = delete;
     RenderQueue& operator=(const RenderQueue&) = delete;
 
+    /// clears the queues of both frames
     void resetAll();
 
-    void pushRenderables(std::vector<RenderableQueueInfo>& newRenderables, const Type type);
+    /// starts building a new frame in the slot which isn't being read, clearing its queues
+    void beginFrame();
+
+    /// adds a renderable to the frame being built
+    void push(const RenderableQueueInfo& info, const Type type);
+
+    /// adds the renderables to the frame being built
+    void pushRenderables(const std::vector<RenderableQueueInfo>& newRenderables, const Type type);
+
+    /// sorts the queues of the frame being built and makes it the frame returned by **getQueue**
+    void submitFrame();
+
+    /**
+     * @brief Creates the key which orders a renderable by layer, shader variant, material and
+     * then depth. Opaque layers are ordered front to back so the early depth test rejects as much
+     * as possible, the transparent layer back to front so it blends correctly.
+     * @param depth The normalised view depth of the renderable, from **getViewDepth**
+     */
+    static SortKey createSortKey(
+        Layer layer, size_t materialId, uint64_t variantId, const float depth = 0.0f);
 
-    static SortKey createSortKey(Layer layer, size_t materialId, uint64_t variantId);
+    /**
+     * @brief The view space depth of a point (i.e. the centre of the renderable's world bounds)
+     * mapped linearly from the near to the far plane onto [0, 1]
+     * @param viewDir The normalised camera view direction
+     */
+    static float getViewDepth(
+        const OEMaths::vec3f& point,
+        const OEMaths::vec3f& cameraPos,
+        const OEMaths::vec3f& viewDir,
+        const float zNear,
+        const float zFar);
 
+    /**
+     * @brief Sorts a queue of the frame being built by the sort key flags, using a radix sort on
+     * key/index pairs. The radix sort is stable, so renderables with equal keys keep the order they
+     * were pushed in. Queues shorter than 1.5k renderables are faster to sort in place with
+     * std::sort, which doesn't keep that order - as before the radix sort was added.
+     */
     void sortQueue(const Type type);
 
     void sortAll();
 
     /**
-     * @brief Returns all renderables in the specified queue
-     * @param part Specifies whether the queue should be sorted before fetching
-     * @return A vector containing the renderables in the specified range
+     * @brief Returns a view of a queue of the last submitted frame. The view remains valid until
+     * the frame after next begins.
      */
-    std::vector<RenderableQueueInfo> getQueue(const Type type);
+    Util::Span<const RenderableQueueInfo> getQueue(const Type type) const;
 
     friend class OERenderer;
 
 private:
-    // ordered by queue type
-    std::vector<RenderableQueueInfo> renderables[Type::Count];
+    struct Frame
+    {
+        // ordered by queue type
+        std::vector<RenderableQueueInfo> renderables[Type::Count];
+    };
+
+    Frame frames[2];
+
+    /// the slot being built by the scene
+    uint32_t writeSlot = 0;
+
+    /// the slot last submitted, which is read by the renderer
+    std::atomic<uint32_t> readSlot {1};
+
+    // scratch space for sorting, kept to avoid allocating each frame
+    Util::RadixSorter sorter;
+    std::vector<uint64_t> sortKeys;
+    std::vector<uint32_t> sortIndices;
+    std::vector<RenderableQueueInfo> sortedQueue;
 };
 } // namespace OmegaEngine
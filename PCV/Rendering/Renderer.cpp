@@ -11,20 +11,46 @@
 #include "Rendering/SkyboxPass.h"
 #include "Rendering/CompositionPass.h"
 #include "Scripting/OEConfig.h"
-#include "Threading/ThreadPool.h"
-#include "VulkanAPI/CommandBuffer.h"
-#include "VulkanAPI/CBufferManager.h"
+#include "Threading/JobSystem.h"
+#include "Utility/Timer.h"
+#include "Vulkan/CBufferManager.h"
+#include "Vulkan/CommandBuffer.h"
+#include "Vulkan/FrameRing.h"
+#include "Vulkan/OffscreenTarget.h"
+#include "Vulkan/SwapChain.h"
 #include "VulkanAPI/VkDriver.h"
 #include "utility/Logger.h"
 
 namespace OmegaEngine
 {
 
+namespace
+{
+
+/// the uniform memory available to each frame in flight
+constexpr vk::DeviceSize FrameUniformSize = 256 * 1024;
+
+/// the number of frames between the recording stats being logged
+constexpr uint64_t StatsInterval = 300;
+
+} // namespace
+
 OERenderer::OERenderer(
     OEEngine& eng, OEScene& scene, VulkanAPI::Swapchain& swapchain, EngineConfig& config)
     : vkDriver(eng.getVkDriver())
     , rGraph(std::make_unique<RenderGraph>(vkDriver))
-    , swapchain(swapchain)
+    , swapchain(&swapchain)
+    , engine(eng)
+    , scene(scene)
+    , config(config)
+{
+}
+
+OERenderer::OERenderer(
+    OEEngine& eng, OEScene& scene, VulkanAPI::OffscreenTarget& offscreen, EngineConfig& config)
+    : vkDriver(eng.getVkDriver())
+    , rGraph(std::make_unique<RenderGraph>(vkDriver))
+    , offscreen(&offscreen)
     , engine(eng)
     , scene(scene)
     , config(config)
@@ -37,6 +63,29 @@ OERenderer::~OERenderer()
 
 bool OERenderer::prepare()
 {
+    VulkanAPI::VkContext& context = vkDriver.getContext();
+    uint32_t framesInFlight;
+    if (swapchain)
+    {
+        frames = std::make_unique<VulkanAPI::FrameRing>(context);
+        if (!frames->prepare(engine.getFramesInFlight(), FrameUniformSize))
+        {
+            return false;
+        }
+        framesInFlight = frames->getFramesInFlight();
+    }
+    else
+    {
+        framesInFlight = offscreen->getFramesInFlight();
+    }
+
+    // every worker of the job system may record secondary buffers
+    cmdBuffers = std::make_unique<VulkanAPI::CBufferManager>(context);
+    if (!cmdBuffers->prepare(engine.getJobSystem().getThreadCount(), framesInFlight))
+    {
+        return false;
+    }
+
     // TODO: At the moment only a deffered renderer is supported. Maybe add a forward renderer as
     // well?!
     for (const RenderStage& stage : deferredStages)
@@ -61,8 +110,18 @@ bool OERenderer::prepare()
         }
     }
 
-    // the last stage is always the composition pass - writes to the surface
-    rStages.emplace_back(std::make_unique<CompositionPass>(*rGraph, "Stage_Comp", swapchain));
+    // the last stage is always the composition pass - writes to the surface, or the offscreen
+    // image when headless
+    if (offscreen)
+    {
+        rStages.emplace_back(
+            std::make_unique<CompositionPass>(*rGraph, "Stage_Comp", *offscreen));
+    }
+    else
+    {
+        rStages.emplace_back(
+            std::make_unique<CompositionPass>(*rGraph, "Stage_Comp", *swapchain));
+    }
 
     for (auto& stage : rStages)
     {
@@ -92,44 +151,133 @@ bool OERenderer::update()
 
 void OERenderer::draw()
 {
-    vkDriver.beginFrame(swapchain);
+    if (offscreen)
+    {
+        // only blocks if all the target's frames are still in flight
+        vk::CommandBuffer cmds = offscreen->beginFrame();
+        cmdBuffers->beginFrame(offscreen->getFrameIndex(), cmds);
+
+        // the offscreen target is a single image, so is always image zero of the final pass
+        rGraph->execute(cmds, 0);
+        logFrameStats();
+
+        // the copy to the readback buffer is part of the frame's submission, earlier frames
+        // which have completed are delivered without waiting
+        offscreen->endFrame();
+        offscreen->processReadbacks();
+        return;
+    }
+
+    // only blocks if the GPU is still executing the frame which last used these resources, so
+    // the scene update and recording of this frame overlap the GPU executing the previous ones
+    VulkanAPI::VkContext& context = vkDriver.getContext();
+    VulkanAPI::FrameRing::Frame& frame = frames->beginFrame();
+
+    uint32_t imageIndex;
+    if (!swapchain->acquireNextImage(context, frame.imageAcquired, frame.fence, imageIndex))
+    {
+        LOGGER_WARN("The swapchain is out of date, skipping the frame.");
+        frames->abandonFrame();
+        return;
+    }
+
+    // the frame's fence has been waited on, so its secondary buffers can be reset
+    cmdBuffers->beginFrame(frames->getFrameIndex(), frame.cmdBuffer);
 
     // executes the user-defined callback for all of the passes in-turn.
-    rGraph->execute();
+    rGraph->execute(frame.cmdBuffer, imageIndex);
+    logFrameStats();
+
+    // the colour output waits for the image to be released by the presentation engine, which
+    // in turn waits for the frame to complete. The CPU carries on with the next frame.
+    frames->submit(frame.imageAcquired, frame.renderComplete);
+    swapchain->present(context, imageIndex, frame.renderComplete);
+}
+
+void OERenderer::logFrameStats()
+{
+    if (++frameCount % StatsInterval != 0)
+    {
+        return;
+    }
 
-    // finally send to the swap-chain presentation
-    vkDriver.endFrame(swapchain);
+    // the spread of the recording times shows how evenly the chunks were stolen
+    const VulkanAPI::CBufferManager::Stats& stats = cmdBuffers->getStats();
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    size_t renderables = 0;
+    for (size_t i = 0; i < stats.threads.size(); ++i)
+    {
+        const VulkanAPI::CBufferManager::ThreadStats& thread = stats.threads[i];
+        minMs = i ? std::min(minMs, thread.recordMs) : thread.recordMs;
+        maxMs = std::max(maxMs, thread.recordMs);
+        renderables += thread.renderables;
+    }
+    LOGGER_INFO(
+        "Frame %llu: %zu renderables in %zu secondary buffers, %.3f - %.3fms per worker.",
+        static_cast<unsigned long long>(frameCount),
+        renderables,
+        stats.secondaryCount,
+        minMs,
+        maxMs);
+}
+
+double OERenderer::getFenceWaitMs() const
+{
+    return offscreen ? offscreen->getWaitMs() : frames->getStats().totalWaitMs;
 }
 
-void OERenderer::drawQueueThreaded(VulkanAPI::CBufferManager& manager, RGraphContext& context)
+void OERenderer::drawQueueThreaded(RGraphContext& context)
 {
+    VulkanAPI::CBufferManager& manager = *cmdBuffers;
     VulkanAPI::RenderPass* renderpass = context.rGraph->getRenderpass(context.rpass);
     VulkanAPI::FrameBuffer* fbuffer = context.rGraph->getFramebuffer(context.framebuffer);
-    
-    auto queue = scene.renderQueue.getQueue(RenderQueue::Type::Colour);
 
-    auto thread_draw = [&queue, &context, &renderpass, &fbuffer, &manager](size_t start, size_t end) {
-        assert(end < queue.size());
-        assert(start < end);
-        for (size_t idx = start; idx < end; ++idx)
+    Util::Span<const RenderableQueueInfo> queue =
+        scene.renderQueue.getQueue(RenderQueue::Type::Colour);
+
+    // the queue is split into more chunks than there are workers so idle workers can steal chunks
+    // whose renderables are expensive to record. Each chunk is recorded into its own secondary
+    // buffer from the pool of the worker which picks it up, and the buffers are executed in chunk
+    // order so the draw order within the pass is preserved
+    PCV::JobSystem& jobs = engine.getJobSystem();
+    const size_t chunkCount = std::min(jobs.getThreadCount() * 4, queue.size());
+    const size_t chunkSize = chunkCount ? (queue.size() + chunkCount - 1) / chunkCount : 0;
+
+    chunkBuffers.clear();
+    chunkBuffers.resize(chunkCount, nullptr);
+
+    auto recordChunks = [&](const size_t startChunk, const size_t count) {
+        const size_t thread = jobs.getWorkerIndex();
+        for (size_t chunk = startChunk; chunk < startChunk + count; ++chunk)
         {
-            RenderableQueueInfo& info = queue[idx];
-            
-             // a cmd pool per thread with a buffer
-            VulkanAPI::CmdBuffer* cbSecondary = manager.createSecondaryCmdBuffer();
+            const size_t first = chunk * chunkSize;
+            const size_t last = std::min(first + chunkSize, queue.size());
+            if (first >= last)
+            {
+                continue;
+            }
+
+            Util::Timer<Util::NanoSeconds> timer;
+
+            VulkanAPI::CmdBuffer* cbSecondary = manager.getSecondaryCmdBuffer(thread);
             cbSecondary->beginSecondary(*renderpass, *fbuffer);
-            
-            info.renderFunction(cbSecondary, info.renderableData, context);
+            for (size_t idx = first; idx < last; ++idx)
+            {
+                const RenderableQueueInfo& info = queue[idx];
+                info.renderFunction(cbSecondary, info.renderableData, context);
+            }
+            cbSecondary->end();
+
+            chunkBuffers[chunk] = cbSecondary;
+            manager.addThreadStats(thread, timer.getElapsedSeconds() * 1000.0, last - first);
         }
     };
 
-    // split task up equally per thtread - using a new secondary cmd buffer per thread
-    size_t workSize = queue.size();
-    ThreadTaskSplitter split {0, workSize, thread_draw};
-    split.run();
+    jobs.parallelFor(0, chunkCount, recordChunks, 1);
 
-    // check all task have finished here before execute?
-    manager.executeSecondaryCommands();
+    // parallelFor waits on all chunks, so the buffers are complete
+    manager.executeSecondaryCommands(chunkBuffers);
 }
 
 // ==================== front-end =============================
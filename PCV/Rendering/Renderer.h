@@ -13,6 +13,8 @@ namespace VulkanAPI
 {
 // forward declearions
 class Swapchain;
+class FrameRing;
+class OffscreenTarget;
 class VkDriver;
 class ProgramManager;
 class CmdBuffer;
@@ -76,6 +78,16 @@ public:
 
     OERenderer(
         OEEngine& engine, OEScene& scene, VulkanAPI::Swapchain& swapchain, EngineConfig& config);
+
+    /**
+     * @brief A renderer which draws into an offscreen target rather than presenting, its frames
+     * are handed to the target's readback callback once the GPU has finished with them.
+     */
+    OERenderer(
+        OEEngine& engine,
+        OEScene& scene,
+        VulkanAPI::OffscreenTarget& offscreen,
+        EngineConfig& config);
     ~OERenderer();
 
     /**
@@ -96,10 +108,31 @@ public:
      */
     void draw();
 
-    void drawQueueThreaded(VulkanAPI::CBufferManager& manager, RGraphContext& context);
+    /**
+     * @brief Records the colour queue into secondary buffers on the job system's workers and
+     * executes them from the pass's primary buffer. Called from the execute callback of the
+     * colour pass.
+     */
+    void drawQueueThreaded(RGraphContext& context);
+
+    /**
+     * @brief The total time the CPU has spent waiting on the fences of earlier frames in flight
+     * before it could begin a frame. If this grows steadily, the GPU is the bottleneck.
+     */
+    double getFenceWaitMs() const;
+
+    /// the secondary buffers and per worker recording times of the last frame
+    const VulkanAPI::CBufferManager& getCmdBuffers() const
+    {
+        return *cmdBuffers;
+    }
 
     using RenderStagePtr = std::unique_ptr<RenderStageBase>;
 
+private:
+    /// logs the recording stats of the frame just drawn, every **StatsInterval** frames
+    void logFrameStats();
+
 private:
     /// The current vulkan instance
     VulkanAPI::VkDriver& vkDriver;
@@ -110,14 +143,29 @@ private:
     /// Contains the layout of the rendering stages
     std::unique_ptr<RenderGraph> rGraph;
 
-    // swap chain used for rendering to surface
-    VulkanAPI::Swapchain& swapchain;
+    // swap chain used for rendering to surface - only one of the swapchain or offscreen target
+    // is set
+    VulkanAPI::Swapchain* swapchain = nullptr;
+    VulkanAPI::OffscreenTarget* offscreen = nullptr;
+
+    /// the command buffers, sync objects and per frame resources of each frame in flight when
+    /// rendering to the swapchain - offscreen targets have their own
+    std::unique_ptr<VulkanAPI::FrameRing> frames;
 
     // locally stored
     OEEngine& engine;
     OEScene& scene;
 
     EngineConfig& config;
+
+    /// the pools the secondary buffers are recorded from by each worker, for each frame in flight
+    std::unique_ptr<VulkanAPI::CBufferManager> cmdBuffers;
+
+    /// the secondary buffer recorded for each chunk of the queue, kept to avoid allocating
+    /// each frame
+    std::vector<VulkanAPI::CmdBuffer*> chunkBuffers;
+
+    uint64_t frameCount = 0;
 };
 
 } // namespace OmegaEngine
@@ -0,0 +1,308 @@
+#include "SoftRasteriser.h"
+
+#include "Core/PointCloud.h"
+#include "Octree/OctreeFile.h"
+#include "Threading/JobSystem.h"
+#include "Utility/ImageWriter.h"
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace PCV
+{
+
+namespace
+{
+
+// points are gathered into blocks, so strided and mapped views are read the same way as owned
+// arrays and the projection loop can be vectorised
+constexpr size_t BlockSize = 1024;
+
+// the number of points rasterised by each job when drawing a single cloud
+constexpr size_t PointGrainSize = size_t(64) << 10;
+
+uint32_t packColour(const uint8_t r, const uint8_t g, const uint8_t b)
+{
+    return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | 0xff000000u;
+}
+
+/// keeps the nearest value - the depth is positive, so its bits order the same as the float
+void depthTest(std::atomic<uint64_t>& pixel, const uint64_t value)
+{
+    uint64_t current = pixel.load(std::memory_order_relaxed);
+    while (value < current &&
+           !pixel.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+} // namespace
+
+SoftRasteriser::SoftRasteriser(const Options& opts)
+    : options(opts)
+{
+    assert(options.width > 0 && options.height > 0 && options.pointSize > 0);
+    pixels = std::make_unique<std::atomic<uint64_t>[]>(size_t(options.width) * options.height);
+
+    // the far plane is at a depth of one, the background is further than anything drawn
+    uint32_t farDepth;
+    const float depth = std::numeric_limits<float>::max();
+    memcpy(&farDepth, &depth, sizeof(float));
+    clearValue = (uint64_t(farDepth) << 32) |
+        packColour(options.background[0], options.background[1], options.background[2]);
+    clear();
+}
+
+SoftRasteriser::~SoftRasteriser()
+{
+}
+
+void SoftRasteriser::clear()
+{
+    const size_t pixelCount = size_t(options.width) * options.height;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        pixels[i].store(clearValue, std::memory_order_relaxed);
+    }
+    stats = {};
+}
+
+size_t SoftRasteriser::drawPoints(
+    const PointCloud& cloud, const OEMaths::mat4f& mvp, const size_t start, const size_t count)
+{
+    const bool hasColour = cloud.hasAttribute(PointCloud::AttributeFlags::Colour);
+    const bool hasIntensity = cloud.hasAttribute(PointCloud::AttributeFlags::Intensity);
+
+    const float halfWidth = static_cast<float>(options.width) * 0.5f;
+    const float halfHeight = static_cast<float>(options.height) * 0.5f;
+    const int32_t halfSize = static_cast<int32_t>(options.pointSize) / 2;
+    const int32_t maxX = static_cast<int32_t>(options.width) - 1;
+    const int32_t maxY = static_cast<int32_t>(options.height) - 1;
+
+    float x[BlockSize];
+    float y[BlockSize];
+    float z[BlockSize];
+    float clipX[BlockSize];
+    float clipY[BlockSize];
+    float clipZ[BlockSize];
+    float clipW[BlockSize];
+    uint8_t red[BlockSize];
+    uint8_t green[BlockSize];
+    uint8_t blue[BlockSize];
+    uint16_t intensity[BlockSize];
+
+    size_t rasterised = 0;
+    for (size_t blockStart = start; blockStart < start + count; blockStart += BlockSize)
+    {
+        const size_t blockCount = std::min(BlockSize, start + count - blockStart);
+        cloud.posX.copyTo(x, blockStart, blockCount);
+        cloud.posY.copyTo(y, blockStart, blockCount);
+        cloud.posZ.copyTo(z, blockStart, blockCount);
+        if (hasColour)
+        {
+            cloud.red.copyTo(red, blockStart, blockCount);
+            cloud.green.copyTo(green, blockStart, blockCount);
+            cloud.blue.copyTo(blue, blockStart, blockCount);
+        }
+        else if (hasIntensity)
+        {
+            cloud.intensity.copyTo(intensity, blockStart, blockCount);
+        }
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            clipX[i] = mvp.data[0][0] * x[i] + mvp.data[1][0] * y[i] + mvp.data[2][0] * z[i] +
+                mvp.data[3][0];
+            clipY[i] = mvp.data[0][1] * x[i] + mvp.data[1][1] * y[i] + mvp.data[2][1] * z[i] +
+                mvp.data[3][1];
+            clipZ[i] = mvp.data[0][2] * x[i] + mvp.data[1][2] * y[i] + mvp.data[2][2] * z[i] +
+                mvp.data[3][2];
+            clipW[i] = mvp.data[0][3] * x[i] + mvp.data[1][3] * y[i] + mvp.data[2][3] * z[i] +
+                mvp.data[3][3];
+        }
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            // clipped by the near and far planes - Vulkan's depth range is [0, 1]
+            const float w = clipW[i];
+            if (!(clipZ[i] >= 0.0f && clipZ[i] <= w && w > 0.0f))
+            {
+                continue;
+            }
+
+            const float invW = 1.0f / w;
+            const float screenX = (clipX[i] * invW + 1.0f) * halfWidth;
+            const float screenY = (clipY[i] * invW + 1.0f) * halfHeight;
+            if (!(screenX >= 0.0f && screenX < static_cast<float>(options.width) &&
+                  screenY >= 0.0f && screenY < static_cast<float>(options.height)))
+            {
+                continue;
+            }
+
+            uint32_t colour;
+            if (hasColour)
+            {
+                colour = packColour(red[i], green[i], blue[i]);
+            }
+            else if (hasIntensity)
+            {
+                const uint8_t grey = static_cast<uint8_t>(intensity[i] >> 8);
+                colour = packColour(grey, grey, grey);
+            }
+            else
+            {
+                colour = packColour(255, 255, 255);
+            }
+
+            uint32_t depthBits;
+            const float depth = clipZ[i] * invW;
+            memcpy(&depthBits, &depth, sizeof(float));
+            const uint64_t value = (uint64_t(depthBits) << 32) | colour;
+
+            const int32_t pixelX = static_cast<int32_t>(screenX);
+            const int32_t pixelY = static_cast<int32_t>(screenY);
+            if (options.pointSize == 1)
+            {
+                depthTest(pixels[size_t(pixelY) * options.width + pixelX], value);
+            }
+            else
+            {
+                // the splat is clipped to the image, rather than moved inside it
+                const int32_t pointSize = static_cast<int32_t>(options.pointSize);
+                const int32_t x0 = std::max(pixelX - halfSize, 0);
+                const int32_t y0 = std::max(pixelY - halfSize, 0);
+                const int32_t x1 = std::min(pixelX - halfSize + pointSize - 1, maxX);
+                const int32_t y1 = std::min(pixelY - halfSize + pointSize - 1, maxY);
+                for (int32_t py = y0; py <= y1; ++py)
+                {
+                    for (int32_t px = x0; px <= x1; ++px)
+                    {
+                        depthTest(pixels[size_t(py) * options.width + px], value);
+                    }
+                }
+            }
+            ++rasterised;
+        }
+    }
+    return rasterised;
+}
+
+void SoftRasteriser::addStats(const size_t submitted, const size_t rasterised, const double seconds)
+{
+    stats.submittedPoints += submitted;
+    stats.rasterisedPoints += rasterised;
+    stats.rasterSeconds += seconds;
+}
+
+void SoftRasteriser::drawCloud(const PointCloud& cloud, const OEMaths::mat4f& mvp, JobSystem& jobs)
+{
+    if (!cloud.hasAttribute(PointCloud::AttributeFlags::Position))
+    {
+        return;
+    }
+
+    Util::Timer<Util::NanoSeconds> timer;
+    std::atomic<size_t> rasterised {0};
+    jobs.parallelFor(
+        0,
+        cloud.size(),
+        [&](const size_t start, const size_t count) {
+            rasterised.fetch_add(drawPoints(cloud, mvp, start, count), std::memory_order_relaxed);
+        },
+        PointGrainSize);
+    addStats(cloud.size(), rasterised.load(), timer.getElapsedSeconds());
+}
+
+void SoftRasteriser::drawCloud(
+    const PointCloud& cloud,
+    const OEMaths::mat4f& viewProj,
+    const OEMaths::vec3f& worldOffset,
+    JobSystem& jobs)
+{
+    drawCloud(cloud, viewProj * OEMaths::mat4f::translate(worldOffset), jobs);
+}
+
+void SoftRasteriser::drawNodes(
+    const std::vector<LodSelector::Instance>& octrees,
+    const std::vector<uint32_t>& nodes,
+    const OEMaths::mat4f& viewProj,
+    JobSystem& jobs)
+{
+    Util::Timer<Util::NanoSeconds> timer;
+
+    // the positions of each octree are relative to its own origin
+    std::vector<OEMaths::mat4f> octreeMvps(octrees.size());
+    for (size_t i = 0; i < octrees.size(); ++i)
+    {
+        octreeMvps[i] = viewProj * OEMaths::mat4f::translate(octrees[i].offset);
+    }
+
+    std::atomic<size_t> submitted {0};
+    std::atomic<size_t> rasterised {0};
+    auto drawNodeRange = [&](const size_t start, const size_t count) {
+        for (size_t i = start; i < start + count; ++i)
+        {
+            const uint32_t id = nodes[i];
+            for (size_t octreeIdx = 0; octreeIdx < octrees.size(); ++octreeIdx)
+            {
+                const LodSelector::Instance& octree = octrees[octreeIdx];
+                if (id < octree.baseId || id - octree.baseId >= octree.file->getNodes().size())
+                {
+                    continue;
+                }
+
+                // the views reference the mapped node data, so nothing is copied
+                std::unique_ptr<PointCloud> cloud = octree.file->loadNode(id - octree.baseId);
+                if (cloud)
+                {
+                    submitted.fetch_add(cloud->size(), std::memory_order_relaxed);
+                    rasterised.fetch_add(
+                        drawPoints(*cloud, octreeMvps[octreeIdx], 0, cloud->size()),
+                        std::memory_order_relaxed);
+                }
+                break;
+            }
+        }
+    };
+
+    // the nodes vary a lot in size, so each is a job of its own
+    jobs.parallelFor(0, nodes.size(), drawNodeRange, 1);
+    addStats(submitted.load(), rasterised.load(), timer.getElapsedSeconds());
+}
+
+void SoftRasteriser::resolve(std::vector<uint8_t>& rgb) const
+{
+    const size_t pixelCount = size_t(options.width) * options.height;
+    rgb.resize(pixelCount * 3);
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        const uint64_t value = pixels[i].load(std::memory_order_relaxed);
+        rgb[i * 3] = static_cast<uint8_t>(value);
+        rgb[i * 3 + 1] = static_cast<uint8_t>(value >> 8);
+        rgb[i * 3 + 2] = static_cast<uint8_t>(value >> 16);
+    }
+}
+
+bool SoftRasteriser::writeImage(const char* path) const
+{
+    std::vector<uint8_t> rgb;
+    resolve(rgb);
+
+    const char* ext = strrchr(path, '.');
+    if (ext && !strcmp(ext, ".ppm"))
+    {
+        return Util::writePpm(path, options.width, options.height, rgb.data());
+    }
+    if (ext && !strcmp(ext, ".png"))
+    {
+        return Util::writePng(path, options.width, options.height, rgb.data());
+    }
+    LOGGER_ERROR("Unsupported image format %s - the image must be a png or ppm.", path);
+    return false;
+}
+
+} // namespace PCV
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Octree/LodSelector.h"
+
+#include "Maths/OEMaths.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace PCV
+{
+// forward declerations
+class JobSystem;
+class PointCloud;
+
+/**
+ * @brief A point splatting backend which runs on the CPU, for machines without a GPU such as
+ * render nodes producing previews. It draws the same clouds and LOD selection as the Vulkan
+ * renderer - each point is projected with the view-projection matrix and written to the pixels
+ * it covers.
+ *
+ * Depth and colour are packed into one 64-bit value per pixel with the depth in the upper bits,
+ * so the nearest point is resolved with an atomic min and the points can be rasterised in
+ * parallel without locks. Points at the same depth resolve to the lowest colour, so the image
+ * doesn't depend on the order the workers ran in.
+ */
+class SoftRasteriser
+{
+public:
+    struct Options
+    {
+        uint32_t width = 1280;
+        uint32_t height = 720;
+
+        /// the width of the square drawn for each point, in pixels
+        uint32_t pointSize = 1;
+
+        uint8_t background[3] = {0, 0, 0};
+    };
+
+    /// counters which are accumulated across draws until **clear** is called
+    struct Stats
+    {
+        size_t submittedPoints = 0;
+
+        /// the points which passed clipping and were depth tested
+        size_t rasterisedPoints = 0;
+
+        double rasterSeconds = 0.0;
+
+        double getPointsPerSecond() const
+        {
+            return rasterSeconds > 0.0 ? static_cast<double>(submittedPoints) / rasterSeconds
+                                       : 0.0;
+        }
+    };
+
+    explicit SoftRasteriser(const Options& options);
+    ~SoftRasteriser();
+
+    // not copyable
+    SoftRasteriser(const SoftRasteriser&) = delete;
+    SoftRasteriser& operator=(const SoftRasteriser&) = delete;
+
+    /// clears the framebuffer to the background colour and resets the stats
+    void clear();
+
+    /**
+     * @brief Draws all points of a cloud.
+     * @param mvp Transforms the local positions of the cloud into Vulkan clip space
+     */
+    void drawCloud(const PointCloud& cloud, const OEMaths::mat4f& mvp, JobSystem& jobs);
+
+    /**
+     * @brief Draws all points of a cloud as placed in the world, as the scene does.
+     * @param viewProj Transforms world positions into Vulkan clip space
+     * @param worldOffset The cloud's origin relative to the world origin
+     */
+    void drawCloud(
+        const PointCloud& cloud,
+        const OEMaths::mat4f& viewProj,
+        const OEMaths::vec3f& worldOffset,
+        JobSystem& jobs);
+
+    /**
+     * @brief Draws octree nodes, read directly from the mapped node data.
+     * @param nodes The global ids of the nodes as returned by **LodSelector::select**
+     * @param viewProj Transforms world positions - relative to the origin the octree offsets are
+     * relative to - into Vulkan clip space
+     */
+    void drawNodes(
+        const std::vector<LodSelector::Instance>& octrees,
+        const std::vector<uint32_t>& nodes,
+        const OEMaths::mat4f& viewProj,
+        JobSystem& jobs);
+
+    /// the colour of each pixel, three bytes per pixel, row by row from the top of the image
+    void resolve(std::vector<uint8_t>& rgb) const;
+
+    /// writes the resolved image - the format is chosen by the extension, png or ppm
+    bool writeImage(const char* path) const;
+
+    uint32_t getWidth() const
+    {
+        return options.width;
+    }
+
+    uint32_t getHeight() const
+    {
+        return options.height;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    /// draws the points [start, start + count) of the cloud, returning the number rasterised
+    size_t drawPoints(
+        const PointCloud& cloud, const OEMaths::mat4f& mvp, const size_t start, const size_t count);
+
+    void addStats(const size_t submitted, const size_t rasterised, const double seconds);
+
+private:
+    Options options;
+    Stats stats;
+
+    /// depth in the upper 32 bits and RGBA colour in the lower
+    std::unique_ptr<std::atomic<uint64_t>[]> pixels;
+    uint64_t clearValue = 0;
+};
+
+} // namespace PCV
@@ -0,0 +1,90 @@
+#include "Core/AABBox.h"
+#include "Core/Camera.h"
+#include "Core/Frustum.h"
+#include "Core/PackedBounds.h"
+#include "Tests/TestCheck.h"
+
+#include <cstdlib>
+
+/**
+ * Builds the frustum from the camera as the scene does and checks boxes in front of the camera
+ * are reported visible, while those behind it, off to the side or past the far plane are culled.
+ * The single box, hierarchical and packed tests must all agree.
+ */
+
+namespace
+{
+
+struct Case
+{
+    const char* name;
+    PCV::AABBox box;
+    bool visible;
+};
+
+} // namespace
+
+int main()
+{
+    // looking down the negative z axis from ten units away from the origin
+    PCV::Camera camera;
+    camera.setAspect(1.0f);
+    camera.setPerspective();
+    camera.setPosition(OEMaths::vec3f {0.0f, 0.0f, 10.0f});
+    camera.updateViewMatrix();
+
+    PCV::Frustum frustum;
+    frustum.projection(camera.getViewProjMatrix());
+
+    const Case cases[] = {
+        {"in front",
+         {OEMaths::vec3f {-1.0f, -1.0f, -1.0f}, OEMaths::vec3f {1.0f, 1.0f, 1.0f}},
+         true},
+        {"crossing the left plane",
+         {OEMaths::vec3f {-10.0f, -1.0f, -1.0f}, OEMaths::vec3f {-2.0f, 1.0f, 1.0f}},
+         true},
+        {"behind",
+         {OEMaths::vec3f {-1.0f, -1.0f, 15.0f}, OEMaths::vec3f {1.0f, 1.0f, 20.0f}},
+         false},
+        {"to the right",
+         {OEMaths::vec3f {50.0f, -1.0f, -1.0f}, OEMaths::vec3f {60.0f, 1.0f, 1.0f}},
+         false},
+        {"past the far plane",
+         {OEMaths::vec3f {-1.0f, -1.0f, -2000.0f}, OEMaths::vec3f {1.0f, 1.0f, -1500.0f}},
+         false},
+    };
+    constexpr size_t CaseCount = sizeof(cases) / sizeof(Case);
+
+    PCV::PackedBounds packed;
+    for (const Case& test : cases)
+    {
+        packed.add(test.box);
+    }
+    uint8_t visibleMask = 0;
+    frustum.checkBoxesPlaneIntersect(packed, 0, CaseCount, &visibleMask);
+
+    for (size_t i = 0; i < CaseCount; ++i)
+    {
+        const Case& test = cases[i];
+        PCV::Frustum::PlaneMask planes = PCV::Frustum::AllPlanes;
+        const bool single = frustum.checkBoxPlaneIntersect(test.box);
+        const bool hierarchical = frustum.checkBoxPlaneIntersect(test.box, planes);
+        const bool packedVisible = (visibleMask >> i) & 1;
+        if (single != test.visible || hierarchical != test.visible || packedVisible != test.visible)
+        {
+            fprintf(
+                stderr, "box %s: expected %s\n", test.name, test.visible ? "visible" : "culled");
+        }
+        TEST_CHECK(single == test.visible);
+        TEST_CHECK(hierarchical == test.visible);
+        TEST_CHECK(packedVisible == test.visible);
+    }
+
+    // the box in front is fully inside the frustum, so its children need no plane tests
+    PCV::Frustum::PlaneMask planes = PCV::Frustum::AllPlanes;
+    frustum.checkBoxPlaneIntersect(cases[0].box, planes);
+    TEST_CHECK(planes == 0);
+
+    printf("frustum: %d failures\n", testFailureCount());
+    return testFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#include "Core/PointCloud.h"
+#include "Loaders/LasLoader.h"
+#include "Loaders/LazLoader.h"
+#include "Tests/TestCheck.h"
+
+#include <cstdlib>
+#include <sys/stat.h>
+#include <vector>
+
+/**
+ * Decodes a laz file written by LASzip and checks every point against the uncompressed las file
+ * it was made from. The reference files aren't part of the repo - the simple.laz and simple.las
+ * of the PDAL test data are a suitable pair - so the test is skipped if they aren't present.
+ */
+
+namespace
+{
+
+bool fileExists(const char* path)
+{
+    struct stat info;
+    return stat(path, &info) == 0;
+}
+
+/// compares the points [lasStart, lasStart + count) of the las cloud to the laz cloud
+void checkPoints(
+    const PCV::PointCloud& las,
+    const size_t lasStart,
+    const PCV::PointCloud& laz,
+    const size_t lazStart,
+    const size_t count)
+{
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t a = lasStart + i;
+        const size_t b = lazStart + i;
+        bool match = las.posX[a] == laz.posX[b] && las.posY[a] == laz.posY[b] &&
+            las.posZ[a] == laz.posZ[b] && las.intensity[a] == laz.intensity[b] &&
+            las.classification[a] == laz.classification[b];
+        if (las.hasAttribute(PCV::PointCloud::AttributeFlags::Colour))
+        {
+            match = match && las.red[a] == laz.red[b] && las.green[a] == laz.green[b] &&
+                las.blue[a] == laz.blue[b];
+        }
+        mismatches += !match;
+    }
+    TEST_CHECK(mismatches == 0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: pcv-test-laz <reference.laz> <reference.las>\n");
+        return EXIT_FAILURE;
+    }
+    const char* lazPath = argv[1];
+    const char* lasPath = argv[2];
+    if (!fileExists(lazPath) || !fileExists(lasPath))
+    {
+        printf("The reference files %s and %s aren't present, skipping.\n", lazPath, lasPath);
+        return TestSkipped;
+    }
+
+    PCV::LasLoader lasLoader;
+    PCV::LazLoader lazLoader;
+    TEST_CHECK(lasLoader.open(lasPath));
+    TEST_CHECK(lazLoader.open(lazPath));
+    if (testFailureCount())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const PCV::LasLoader::Header& lasHeader = lasLoader.getHeader();
+    const PCV::LasLoader::Header& lazHeader = lazLoader.getHeader();
+    TEST_CHECK(lazHeader.isCompressed);
+    TEST_CHECK(lasHeader.pointCount == lazHeader.pointCount);
+    TEST_CHECK(lasHeader.pointFormat == lazHeader.pointFormat);
+
+    // ========= every chunk ===============================
+    std::unique_ptr<PCV::PointCloud> las = lasLoader.createPointCloud();
+    std::unique_ptr<PCV::PointCloud> laz = lazLoader.createPointCloud();
+    TEST_CHECK(las && laz);
+    if (!las || !laz)
+    {
+        return EXIT_FAILURE;
+    }
+    TEST_CHECK(las->size() == laz->size());
+    TEST_CHECK(
+        las->getOrigin().x == laz->getOrigin().x && las->getOrigin().y == laz->getOrigin().y &&
+        las->getOrigin().z == laz->getOrigin().z);
+    TEST_CHECK(
+        las->hasAttribute(PCV::PointCloud::AttributeFlags::Colour) ==
+        laz->hasAttribute(PCV::PointCloud::AttributeFlags::Colour));
+    if (las->size() == laz->size())
+    {
+        checkPoints(*las, 0, *laz, 0, las->size());
+    }
+
+    // ========= a subset of the chunks, out of order ======
+    const std::vector<PCV::LazLoader::Chunk>& chunks = lazLoader.getChunks();
+    TEST_CHECK(!chunks.empty());
+    if (!chunks.empty())
+    {
+        const std::vector<size_t> indices {chunks.size() - 1, 0};
+        std::unique_ptr<PCV::PointCloud> subset = lazLoader.createPointCloud(indices);
+        TEST_CHECK(subset);
+        if (subset)
+        {
+            size_t offset = 0;
+            for (size_t idx : indices)
+            {
+                const PCV::LazLoader::Chunk& chunk = chunks[idx];
+                const size_t lasStart = static_cast<size_t>(chunk.pointOffset);
+                checkPoints(*las, lasStart, *subset, offset, chunk.pointCount);
+                offset += chunk.pointCount;
+            }
+            TEST_CHECK(offset == subset->size());
+        }
+    }
+
+    printf("%s: %d failures\n", lazPath, testFailureCount());
+    return testFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
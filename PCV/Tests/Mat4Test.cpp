@@ -0,0 +1,123 @@
+#include "Maths/OEMaths.h"
+#include "Tests/TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+/**
+ * Compares the SIMD mat4 kernels against the scalar kernels on random matrices - the products,
+ * the matrix vector product and the inverse. The products follow the same order of operations
+ * so should only differ if the compiler contracts either into FMAs, the inverse is computed
+ * differently so is also checked by multiplying it with the matrix.
+ */
+
+namespace
+{
+
+using OEMaths::mat4f;
+using OEMaths::vec4f;
+
+constexpr size_t MatrixCount = 10'000;
+
+// relative to the largest element of the scalar result
+constexpr float ProductTolerance = 1.0e-6f;
+constexpr float InverseTolerance = 1.0e-4f;
+
+/// the largest difference between the two results, relative to their largest element
+template <typename T>
+float relativeError(const T& expected, const T& result, const size_t size)
+{
+    const float* a = reinterpret_cast<const float*>(&expected);
+    const float* b = reinterpret_cast<const float*>(&result);
+    float scale = 0.0f;
+    float diff = 0.0f;
+    for (size_t i = 0; i < size; ++i)
+    {
+        scale = std::max(scale, std::abs(a[i]));
+        diff = std::max(diff, std::abs(a[i] - b[i]));
+    }
+    return scale > 0.0f ? diff / scale : diff;
+}
+
+} // namespace
+
+int main()
+{
+#if !defined(OEMATHS_SIMD_SSE)
+    printf("mat4: no SIMD kernels in this build\n");
+    return TestSkipped;
+#else
+    // diagonally dominant so the matrices are far from singular, with the off diagonal elements
+    // as large as a rotation's
+    std::mt19937 rng {7};
+    std::uniform_real_distribution<float> unit {-1.0f, 1.0f};
+    auto randomMatrix = [&]() {
+        mat4f mat;
+        for (size_t col = 0; col < 4; ++col)
+        {
+            for (size_t row = 0; row < 4; ++row)
+            {
+                mat[col][row] = (col == row ? 4.0f : 0.0f) + unit(rng) * 2.0f;
+            }
+        }
+        return mat;
+    };
+
+    float mulError = 0.0f;
+    float vecError = 0.0f;
+    float invError = 0.0f;
+    float residual = 0.0f;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < MatrixCount; ++i)
+    {
+        const mat4f m1 = randomMatrix();
+        const mat4f m2 = randomMatrix();
+        const vec4f vec {unit(rng) * 100.0f, unit(rng) * 100.0f, unit(rng) * 100.0f, 1.0f};
+
+        // the operators are also checked, as they should dispatch to the SIMD kernels
+        const mat4f product = m1 * m2;
+        const float productError =
+            relativeError(OEMaths::Scalar::multiply(m1, m2), OEMaths::Simd::multiply(m1, m2), 16);
+        mulError = std::max(mulError, productError);
+        mismatches += relativeError(OEMaths::Simd::multiply(m1, m2), product, 16) != 0.0f;
+
+        const vec4f transformed = m1 * vec;
+        const float transformError = relativeError(
+            OEMaths::Scalar::multiply(m1, vec), OEMaths::Simd::multiply(m1, vec), 4);
+        vecError = std::max(vecError, transformError);
+        mismatches += relativeError(OEMaths::Simd::multiply(m1, vec), transformed, 4) != 0.0f;
+
+        const mat4f inverse = mat4f::inverse(m1);
+        invError = std::max(
+            invError, relativeError(OEMaths::Scalar::inverse(m1), OEMaths::Simd::inverse(m1), 16));
+        mismatches += relativeError(OEMaths::Simd::inverse(m1), inverse, 16) != 0.0f;
+
+        const mat4f identity = OEMaths::Scalar::multiply(m1, inverse);
+        for (size_t col = 0; col < 4; ++col)
+        {
+            for (size_t row = 0; row < 4; ++row)
+            {
+                const float expected = col == row ? 1.0f : 0.0f;
+                residual = std::max(residual, std::abs(identity[col][row] - expected));
+            }
+        }
+    }
+
+    TEST_CHECK(mulError <= ProductTolerance);
+    TEST_CHECK(vecError <= ProductTolerance);
+    TEST_CHECK(invError <= InverseTolerance);
+    TEST_CHECK(residual <= InverseTolerance);
+    TEST_CHECK(mismatches == 0);
+
+    printf(
+        "mat4: max relative error mat %g, vec %g, inverse %g, inverse residual %g - %d failures\n",
+        mulError,
+        vecError,
+        invError,
+        residual,
+        testFailureCount());
+    return testFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+#endif
+}
@@ -0,0 +1,115 @@
+#include "Tests/TestCheck.h"
+#include "Vulkan/OffscreenTarget.h"
+#include "Vulkan/VkContext.h"
+
+#include <array>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Renders frames into a headless offscreen target and checks their readbacks. Each frame clears
+ * the image to a different colour in the target's final pass, as the composition pass does, so
+ * the test checks the pass, the copy into the readback buffer and that the frames are delivered
+ * in order with their own pixels. Skipped when there is no Vulkan device.
+ */
+
+namespace
+{
+
+constexpr uint32_t Width = 64;
+constexpr uint32_t Height = 32;
+constexpr size_t FrameCount = 4;
+
+/// the clear colour of each frame, as 8-bit RGBA
+void getFrameColour(const size_t frame, uint8_t* rgba)
+{
+    rgba[0] = static_cast<uint8_t>(255 - frame * 60);
+    rgba[1] = static_cast<uint8_t>(frame * 60);
+    rgba[2] = 51;
+    rgba[3] = 255;
+}
+
+} // namespace
+
+int main()
+{
+    VulkanAPI::VkContext context;
+    if (!context.createInstance(nullptr, 0) || !context.prepareDevice(vk::SurfaceKHR {}))
+    {
+        printf("offscreen: no Vulkan device\n");
+        return TestSkipped;
+    }
+
+    std::vector<uint64_t> delivered;
+    {
+        VulkanAPI::OffscreenTarget target {context};
+        TEST_CHECK(target.prepare(Width, Height, vk::Format::eR8G8B8A8Unorm, 2));
+        if (testFailureCount())
+        {
+            return EXIT_FAILURE;
+        }
+
+        target.setReadbackCallback([&](const VulkanAPI::OffscreenTarget::Readback& readback) {
+            delivered.push_back(readback.frame);
+            TEST_CHECK(readback.width == Width && readback.height == Height);
+            TEST_CHECK(readback.size == size_t(Width) * Height * 4);
+
+            uint8_t expected[4];
+            getFrameColour(readback.frame, expected);
+            size_t wrongPixels = 0;
+            for (size_t i = 0; i < readback.size; i += 4)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    // the clear colour is converted to unorm by the device, so may be rounded
+                    // either way
+                    if (std::abs(readback.pixels[i + c] - expected[c]) > 1)
+                    {
+                        ++wrongPixels;
+                        break;
+                    }
+                }
+            }
+            if (wrongPixels)
+            {
+                fprintf(
+                    stderr, "frame %zu: %zu pixels differ\n", size_t(readback.frame), wrongPixels);
+            }
+            TEST_CHECK(wrongPixels == 0);
+        });
+
+        // more frames than are in flight, so beginFrame waits for and delivers the earlier ones
+        for (size_t frame = 0; frame < FrameCount; ++frame)
+        {
+            vk::CommandBuffer cmds = target.beginFrame();
+
+            uint8_t rgba[4];
+            getFrameColour(frame, rgba);
+            vk::ClearValue clear;
+            clear.color = vk::ClearColorValue(std::array<float, 4> {
+                rgba[0] / 255.0f, rgba[1] / 255.0f, rgba[2] / 255.0f, rgba[3] / 255.0f});
+            vk::RenderPassBeginInfo beginInfo(
+                target.getRenderPass(),
+                target.getFramebuffer(),
+                vk::Rect2D({0, 0}, {Width, Height}),
+                1,
+                &clear);
+            cmds.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+            cmds.endRenderPass();
+
+            target.endFrame();
+            target.processReadbacks();
+        }
+        target.flush();
+    }
+
+    TEST_CHECK(delivered.size() == FrameCount);
+    for (size_t i = 0; i < delivered.size(); ++i)
+    {
+        TEST_CHECK(delivered[i] == i);
+    }
+
+    context.device.waitIdle();
+    printf("offscreen: %zu frames read back - %d failures\n", delivered.size(), testFailureCount());
+    return testFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+#include "Core/Camera.h"
+#include "Core/PointCloud.h"
+#include "Rendering/SoftRasteriser.h"
+#include "Tests/TestCheck.h"
+#include "Threading/JobSystem.h"
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+/**
+ * Renders two single point clouds as Scene::drawSoftware does and checks where they land. The
+ * clouds have different origins which place both points on the camera's axis - the nearer point
+ * hides the other at the centre of the image, so only one pixel is drawn. Ignoring the origins
+ * moves the far point off the axis, and composing the view and projection in the wrong order
+ * moves the near point off the centre. The scene itself needs the Vulkan engine, so the test
+ * uses the same camera matrix and rasteriser calls directly.
+ *
+ * Also checks splats larger than a pixel are clipped at the edges of the image rather than
+ * moved inside it.
+ */
+
+namespace
+{
+
+constexpr uint32_t ImageSize = 65;
+
+std::unique_ptr<PCV::PointCloud> createPoints(
+    const OEMaths::vec3d& origin,
+    const std::vector<OEMaths::vec3f>& positions,
+    const uint8_t red,
+    const uint8_t green)
+{
+    auto cloud = std::make_unique<PCV::PointCloud>();
+    cloud->allocate(
+        positions.size(),
+        PCV::PointCloud::AttributeFlags::Position | PCV::PointCloud::AttributeFlags::Colour);
+    cloud->setOrigin(origin);
+    PCV::PointCloud::Storage& storage = cloud->storage;
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        storage.posX[i] = positions[i].x;
+        storage.posY[i] = positions[i].y;
+        storage.posZ[i] = positions[i].z;
+        storage.red[i] = red;
+        storage.green[i] = green;
+        storage.blue[i] = 0;
+    }
+    return cloud;
+}
+
+/// as Scene::getWorldOffset, with the first cloud's origin as the world origin
+OEMaths::vec3f getWorldOffset(const OEMaths::vec3d& worldOrigin, const OEMaths::vec3d& origin)
+{
+    return OEMaths::vec3f {
+        static_cast<float>(origin.x - worldOrigin.x),
+        static_cast<float>(origin.y - worldOrigin.y),
+        static_cast<float>(origin.z - worldOrigin.z)};
+}
+
+size_t countDrawnPixels(const std::vector<uint8_t>& rgb)
+{
+    size_t drawnPixels = 0;
+    for (size_t i = 0; i < rgb.size(); i += 3)
+    {
+        drawnPixels += rgb[i] || rgb[i + 1] || rgb[i + 2];
+    }
+    return drawnPixels;
+}
+
+void testOrigins(PCV::JobSystem& jobs)
+{
+    // looking down the z axis at the world origin from ten units away
+    PCV::Camera camera;
+    camera.setAspect(1.0f);
+    camera.setPerspective();
+    camera.setPosition(OEMaths::vec3f {0.0f, 0.0f, 10.0f});
+    camera.updateViewMatrix();
+    const OEMaths::mat4f viewProj = camera.getViewProjMatrix();
+
+    // the first cloud fixes the world origin, its point is at the world origin
+    const OEMaths::vec3d origin {500000.0, 4000000.0, 50.0};
+    auto nearCloud = createPoints(origin, {OEMaths::vec3f {0.0f, 0.0f, 0.0f}}, 255, 0);
+
+    // three units along x from the first origin, so the point is behind the first one
+    const OEMaths::vec3d offsetOrigin {origin.x + 3.0, origin.y, origin.z};
+    auto farCloud = createPoints(offsetOrigin, {OEMaths::vec3f {-3.0f, 0.0f, -5.0f}}, 0, 255);
+
+    PCV::SoftRasteriser::Options options;
+    options.width = ImageSize;
+    options.height = ImageSize;
+    PCV::SoftRasteriser rasteriser {options};
+    rasteriser.clear();
+    rasteriser.drawCloud(*nearCloud, viewProj, getWorldOffset(origin, origin), jobs);
+    rasteriser.drawCloud(*farCloud, viewProj, getWorldOffset(origin, offsetOrigin), jobs);
+
+    std::vector<uint8_t> rgb;
+    rasteriser.resolve(rgb);
+    TEST_CHECK(rgb.size() == size_t(ImageSize) * ImageSize * 3);
+    if (rgb.size() != size_t(ImageSize) * ImageSize * 3)
+    {
+        return;
+    }
+
+    const size_t centre = (size_t(ImageSize / 2) * ImageSize + ImageSize / 2) * 3;
+    TEST_CHECK(rasteriser.getStats().submittedPoints == 2);
+    TEST_CHECK(countDrawnPixels(rgb) == 1);
+    TEST_CHECK(rgb[centre] == 255 && rgb[centre + 1] == 0 && rgb[centre + 2] == 0);
+}
+
+void testEdgeSplats(PCV::JobSystem& jobs)
+{
+    constexpr uint32_t Size = 16;
+    constexpr uint32_t PointSize = 3;
+
+    // the positions are in clip space, at the centres of the corner pixels and one in the middle
+    auto pixelCentre = [](const uint32_t pixel) {
+        return 2.0f * (static_cast<float>(pixel) + 0.5f) / static_cast<float>(Size) - 1.0f;
+    };
+    auto cloud = createPoints(
+        OEMaths::vec3d {0.0, 0.0, 0.0},
+        {OEMaths::vec3f {pixelCentre(0), pixelCentre(0), 0.5f},
+         OEMaths::vec3f {pixelCentre(Size - 1), pixelCentre(Size - 1), 0.5f},
+         OEMaths::vec3f {pixelCentre(Size / 2), pixelCentre(Size / 2), 0.5f}},
+        255,
+        255);
+
+    PCV::SoftRasteriser::Options options;
+    options.width = Size;
+    options.height = Size;
+    options.pointSize = PointSize;
+    PCV::SoftRasteriser rasteriser {options};
+    rasteriser.clear();
+    rasteriser.drawCloud(*cloud, OEMaths::mat4f {}, jobs);
+
+    std::vector<uint8_t> rgb;
+    rasteriser.resolve(rgb);
+    TEST_CHECK(rgb.size() == size_t(Size) * Size * 3);
+    if (rgb.size() != size_t(Size) * Size * 3)
+    {
+        return;
+    }
+
+    auto isDrawn = [&](const uint32_t x, const uint32_t y) {
+        return rgb[(size_t(y) * Size + x) * 3] != 0;
+    };
+
+    // the corner splats lose the row and column outside the image, the middle one is whole
+    TEST_CHECK(countDrawnPixels(rgb) == 2 * 2 + 2 * 2 + PointSize * PointSize);
+    TEST_CHECK(isDrawn(0, 0) && isDrawn(1, 1) && !isDrawn(2, 0) && !isDrawn(0, 2));
+    TEST_CHECK(isDrawn(Size - 1, Size - 1) && isDrawn(Size - 2, Size - 2));
+    TEST_CHECK(!isDrawn(Size - 3, Size - 1) && !isDrawn(Size - 1, Size - 3));
+    TEST_CHECK(isDrawn(Size / 2 - 1, Size / 2 - 1) && isDrawn(Size / 2 + 1, Size / 2 + 1));
+}
+
+} // namespace
+
+int main()
+{
+    PCV::JobSystem jobs;
+    testOrigins(jobs);
+    testEdgeSplats(jobs);
+
+    printf("drawSoftware: %d failures\n", testFailureCount());
+    return testFailureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+
+/// the number of checks which have failed, a test returns a failure code if any have
+inline int& testFailureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+// reports the failed expression and carries on, so one run shows every failure
+#define TEST_CHECK(expr)                                                                           \
+    {                                                                                              \
+        if (!(expr))                                                                               \
+        {                                                                                          \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr);               \
+            ++testFailureCount();                                                                  \
+        }                                                                                          \
+    }
+
+/// returned by tests which can't run, i.e. reference files which aren't present
+constexpr int TestSkipped = 77;
@@ -0,0 +1,201 @@
+#include "JobSystem.h"
+
+#include "Threading/ThreadPool.h"
+
+#include <cassert>
+
+namespace PCV
+{
+
+namespace
+{
+
+// the system and worker index of the calling thread
+thread_local JobSystem* currentSystem = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+JobSystem::JobSystem(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = ThreadTaskSplitter::getHardwareThreadCount();
+    }
+
+    workers.resize(threadCount);
+    for (std::unique_ptr<Worker>& worker : workers)
+    {
+        worker = std::make_unique<Worker>();
+        worker->jobs = std::make_unique<Job[]>(MaxJobsPerWorker);
+    }
+
+    // the calling thread is worker zero, it runs jobs while waiting on them
+    currentSystem = this;
+    currentWorker = 0;
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        workers[i]->thread = std::thread(&JobSystem::workerMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock {sleepMutex};
+        stopWorkers = true;
+    }
+    wakeCondition.notify_all();
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        workers[i]->thread.join();
+    }
+
+    if (currentSystem == this)
+    {
+        currentSystem = nullptr;
+    }
+}
+
+size_t JobSystem::getWorkerIndex() const
+{
+    assert(currentSystem == this && "Jobs can only be used from the job system's threads");
+    return currentWorker;
+}
+
+JobSystem::Job* JobSystem::allocateJob(Job* parent)
+{
+    Worker& worker = *workers[getWorkerIndex()];
+    Job* job = &worker.jobs[worker.nextJob++ % MaxJobsPerWorker];
+
+    // the ring has wrapped onto a job which is still running
+    assert(job->unfinished.load(std::memory_order_relaxed) == 0);
+
+    job->parent = parent;
+    job->unfinished.store(1, std::memory_order_relaxed);
+    if (parent)
+    {
+        parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void JobSystem::run(Job* job)
+{
+    Worker& worker = *workers[getWorkerIndex()];
+    {
+        std::lock_guard<std::mutex> lock {worker.mutex};
+        worker.queue.push_back(job);
+        worker.queueSize.store(worker.queue.size(), std::memory_order_relaxed);
+    }
+    queuedJobs.fetch_add(1);
+
+    // the sleep mutex is only taken when a worker may be waiting on it - as both counters are
+    // sequentially consistent either this sees the sleeping worker, or the worker sees the job
+    if (sleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock {sleepMutex};
+        wakeCondition.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::getJob(const size_t workerIdx)
+{
+    if (queuedJobs.load(std::memory_order_relaxed) == 0)
+    {
+        return nullptr;
+    }
+
+    // the most recently queued job of this worker is likely to still be in the cache
+    {
+        Worker& worker = *workers[workerIdx];
+        std::lock_guard<std::mutex> lock {worker.mutex};
+        if (!worker.queue.empty())
+        {
+            Job* job = worker.queue.back();
+            worker.queue.pop_back();
+            worker.queueSize.store(worker.queue.size(), std::memory_order_relaxed);
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // steal the oldest job of another worker, which is the most likely to spawn further work
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        Worker& victim = *workers[(workerIdx + i) % workers.size()];
+        if (victim.queueSize.load(std::memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock {victim.mutex};
+        if (!victim.queue.empty())
+        {
+            Job* job = victim.queue.front();
+            victim.queue.pop_front();
+            victim.queueSize.store(victim.queue.size(), std::memory_order_relaxed);
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job)
+{
+    job->func(*job);
+    finish(job);
+}
+
+void JobSystem::finish(Job* job)
+{
+    // the release makes the job's writes visible to the thread which sees it complete
+    while (job && job->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        job = job->parent;
+    }
+}
+
+void JobSystem::wait(Job* job)
+{
+    const size_t workerIdx = getWorkerIndex();
+    while (job->unfinished.load(std::memory_order_acquire) > 0)
+    {
+        if (Job* next = getJob(workerIdx))
+        {
+            execute(next);
+        }
+        else
+        {
+            // the remaining jobs are running on other workers
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerMain(const size_t workerIdx)
+{
+    currentSystem = this;
+    currentWorker = workerIdx;
+
+    while (true)
+    {
+        if (Job* job = getJob(workerIdx))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock {sleepMutex};
+        sleepingWorkers.fetch_add(1);
+        wakeCondition.wait(lock, [this]() { return stopWorkers || queuedJobs.load() > 0; });
+        sleepingWorkers.fetch_sub(1);
+        if (stopWorkers)
+        {
+            return;
+        }
+    }
+}
+
+} // namespace PCV
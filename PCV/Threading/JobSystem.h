@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace PCV
+{
+
+/**
+ * @brief A work stealing job system. Each worker thread has its own deque of jobs - jobs are
+ * pushed and popped at the back by the owning worker, so recently created and cache warm jobs run
+ * first, while idle workers steal from the front where the oldest, and usually largest, jobs are.
+ * This balances work whose cost varies a lot between items (i.e. octree nodes) far better than
+ * splitting the work into equal chunks up front.
+ *
+ * A job can have a parent, which isn't complete until all of its children have completed, so
+ * waiting on a root job waits on the whole tree of work spawned from it. Waiting threads run
+ * other jobs rather than blocking.
+ *
+ * The thread which creates the system is worker zero and jobs may only be created and run from
+ * the worker threads. Jobs are allocated from a fixed ring per worker, so no more than
+ * **MaxJobsPerWorker** jobs created by a worker may be in flight at once.
+ */
+class JobSystem
+{
+public:
+    static constexpr size_t MaxJobsPerWorker = 4096;
+
+    struct Job
+    {
+        static constexpr size_t DataSize = 64;
+
+        using Function = void (*)(Job& job);
+
+        Function func = nullptr;
+        Job* parent = nullptr;
+
+        /// one for the job itself plus one for each child which hasn't completed
+        std::atomic<uint32_t> unfinished {0};
+
+        /// the function object called by **func**
+        alignas(std::max_align_t) unsigned char data[DataSize];
+    };
+
+    /**
+     * @param threadCount The number of workers including the calling thread. If zero, the number
+     * of hardware threads will be used
+     */
+    explicit JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    // not copyable
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Creates a job which calls the function object when run. The function object is stored
+     * within the job, so it must be trivially copyable - a lambda capturing references, pointers or
+     * plain values.
+     * @param parent If set, the parent will not complete until this job has completed
+     */
+    template <typename Func>
+    Job* createJob(const Func& func, Job* parent = nullptr)
+    {
+        static_assert(sizeof(Func) <= Job::DataSize, "Job function object is too large");
+        static_assert(
+            std::is_trivially_copyable<Func>::value &&
+                std::is_trivially_destructible<Func>::value,
+            "Job function objects must be trivially copyable");
+
+        Job* job = allocateJob(parent);
+        new (job->data) Func(func);
+        job->func = [](Job& self) { (*std::launder(reinterpret_cast<Func*>(self.data)))(); };
+        return job;
+    }
+
+    /// queues the job on the calling worker, where it may be stolen by any other worker
+    void run(Job* job);
+
+    /// runs other jobs until the job and all its children have completed
+    void wait(Job* job);
+
+    /**
+     * @brief Calls func(start, count) for ranges covering [start, start + count) across the
+     * workers and waits for them all to complete. The range is split lazily - a worker only splits
+     * off half of its remaining range when its own queue is empty, so the work is divided finely
+     * when workers are stealing and coarsely when they are all busy.
+     * @param grainSize The smallest range passed to the function. If zero, a size is chosen which
+     * gives each worker several ranges
+     */
+    template <typename Func>
+    void parallelFor(const size_t start, const size_t count, const Func& func, size_t grainSize = 0)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (grainSize == 0)
+        {
+            grainSize = std::max<size_t>(1, count / (workers.size() * 8));
+        }
+        if (workers.size() == 1 || count <= grainSize)
+        {
+            func(start, count);
+            return;
+        }
+
+        Job* root = createJob([]() {});
+        runRange(ForRange<Func> {this, &func, root, start, count, grainSize});
+
+        // the root has no work of its own, it completes once all ranges split from it have
+        finish(root);
+        wait(root);
+    }
+
+    size_t getThreadCount() const
+    {
+        return workers.size();
+    }
+
+    /// the index of the calling worker thread - zero is the thread which created the system
+    size_t getWorkerIndex() const;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Job*> queue;
+
+        /// the queue size, readable without the lock
+        std::atomic<size_t> queueSize {0};
+
+        /// the ring of jobs created by this worker
+        std::unique_ptr<Job[]> jobs;
+        size_t nextJob = 0;
+
+        std::thread thread;
+    };
+
+    template <typename Func>
+    struct ForRange
+    {
+        JobSystem* system;
+        const Func* func;
+        Job* root;
+        size_t start;
+        size_t count;
+        size_t grainSize;
+    };
+
+    template <typename Func>
+    static void runRange(ForRange<Func> range)
+    {
+        JobSystem& system = *range.system;
+        Worker& worker = *system.workers[system.getWorkerIndex()];
+
+        while (range.count > 0)
+        {
+            // the split off half is pushed to the back of this worker's queue, so it's only left
+            // there if no other worker is idle - in which case there's no need to split further
+            if (range.count > range.grainSize &&
+                worker.queueSize.load(std::memory_order_relaxed) == 0)
+            {
+                const size_t half = range.count / 2;
+                ForRange<Func> upper = range;
+                upper.start += half;
+                upper.count -= half;
+                system.run(system.createJob([upper]() { runRange(upper); }, range.root));
+                range.count = half;
+                continue;
+            }
+
+            const size_t count = std::min(range.count, range.grainSize);
+            (*range.func)(range.start, count);
+            range.start += count;
+            range.count -= count;
+        }
+    }
+
+    Job* allocateJob(Job* parent);
+
+    /// takes a job from the worker's own queue, or steals one from another worker
+    Job* getJob(const size_t workerIdx);
+
+    void execute(Job* job);
+
+    /// marks the job's own work as complete, completing the parents if this was the last child
+    void finish(Job* job);
+
+    void workerMain(const size_t workerIdx);
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /// jobs queued across all workers - idle workers sleep while this is zero
+    std::atomic<size_t> queuedJobs {0};
+    std::atomic<size_t> sleepingWorkers {0};
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    bool stopWorkers = false;
+};
+
+} // namespace PCV
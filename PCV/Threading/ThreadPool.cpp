@@ -0,0 +1,68 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace PCV
+{
+
+ThreadTaskSplitter::ThreadTaskSplitter(
+    const size_t startIdx, const size_t size, TaskFunc taskFunc, const size_t count)
+    : start(startIdx), workSize(size), func(std::move(taskFunc)), threadCount(count)
+{
+    if (threadCount == 0)
+    {
+        threadCount = getHardwareThreadCount();
+    }
+}
+
+size_t ThreadTaskSplitter::getHardwareThreadCount()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void ThreadTaskSplitter::run()
+{
+    if (workSize == 0)
+    {
+        return;
+    }
+
+    const size_t chunkCount = std::min(threadCount, workSize);
+    const size_t chunkSize = workSize / chunkCount;
+    const size_t remainder = workSize % chunkCount;
+
+    // not worth the overhead of spawning threads
+    if (chunkCount == 1)
+    {
+        func(start, workSize);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunkCount - 1);
+
+    // the remainder is spread over the first chunks. The last chunk is run on the calling thread
+    size_t curr = start;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        const size_t size = chunkSize + (i < remainder ? 1 : 0);
+        if (i == chunkCount - 1)
+        {
+            func(curr, size);
+        }
+        else
+        {
+            threads.emplace_back(func, curr, size);
+        }
+        curr += size;
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+} // namespace PCV
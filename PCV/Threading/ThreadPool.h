@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace PCV
+{
+
+/**
+ * @brief Splits a range of work into equal sized chunks and runs each chunk on its own thread.
+ * The calling thread blocks until all chunks have completed.
+ */
+class ThreadTaskSplitter
+{
+public:
+    /// called with the first index and the number of items for each chunk
+    using TaskFunc = std::function<void(const size_t start, const size_t chunkSize)>;
+
+    /**
+     * @param start The first index of the work range
+     * @param workSize The number of items to process
+     * @param func The function called for each chunk
+     * @param threadCount The number of threads to split the work across. If zero, the number of
+     * hardware threads will be used
+     */
+    ThreadTaskSplitter(
+        const size_t start, const size_t workSize, TaskFunc func, const size_t threadCount = 0);
+
+    /// runs all the chunks and waits for them to complete
+    void run();
+
+    /// the number of hardware threads - always at least one
+    static size_t getHardwareThreadCount();
+
+private:
+    size_t start;
+    size_t workSize;
+    TaskFunc func;
+    size_t threadCount;
+};
+
+} // namespace PCV
@@ -0,0 +1,96 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replaces the global allocation functions to count every allocation. All of the unaligned forms
+ * are replaced so each allocation and deallocation goes through malloc and free. The over-aligned
+ * forms are left to the library, where they are paired with each other, so they aren't counted -
+ * none of the benchmarked types need them.
+ *
+ * The replacements are kept in their own translation unit so they can't be inlined into callers,
+ * where the compiler would see free called on the result of operator new.
+ */
+
+namespace
+{
+
+std::atomic<size_t> allocationCount {0};
+
+void* allocate(const size_t size) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+namespace PCV
+{
+
+size_t getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+} // namespace PCV
+
+void* operator new(size_t size)
+{
+    if (void* ptr = allocate(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* ptr = allocate(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
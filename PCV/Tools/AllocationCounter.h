@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+namespace PCV
+{
+
+/**
+ * @brief The number of heap allocations made by the process so far. These are counted by the
+ * replacement global operator new in AllocationCounter.cpp, so this is only available to the
+ * tools that link it.
+ */
+size_t getAllocationCount();
+
+} // namespace PCV
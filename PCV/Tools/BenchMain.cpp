@@ -0,0 +1,1755 @@
+#include "Core/Frustum.h"
+#include "Core/MortonSort.h"
+#include "Core/PackedBounds.h"
+#include "Core/PointCloud.h"
+#include "Loaders/LazLoader.h"
+#include "Loaders/PcdLoader.h"
+#include "Loaders/TextLoader.h"
+#include "Maths/BatchTransform.h"
+#include "Maths/OEMaths.h"
+#include "Maths/transform.h"
+#include "Octree/LodSelector.h"
+#include "Octree/OctreeFile.h"
+#include "Rendering/RenderQueue.h"
+#include "Tools/AllocationCounter.h"
+#include "Threading/JobSystem.h"
+#include "Threading/ThreadPool.h"
+#include "Utility/Logger.h"
+#include "Utility/Lzf.h"
+#include "Utility/RadixSort.h"
+#include "Utility/Timer.h"
+#include "Vulkan/OffscreenTarget.h"
+#include "Vulkan/PipelineRegistry.h"
+#include "Vulkan/VkContext.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Timer = Util::Timer<Util::NanoSeconds>;
+
+/// powers of two up to the hardware thread count, which is always included
+std::vector<size_t> getDefaultThreadCounts()
+{
+    std::vector<size_t> counts;
+    const size_t hardwareThreads = PCV::ThreadTaskSplitter::getHardwareThreadCount();
+    for (size_t threads = 1; threads < hardwareThreads; threads *= 2)
+    {
+        counts.emplace_back(threads);
+    }
+    counts.emplace_back(hardwareThreads);
+    return counts;
+}
+
+void printUsage()
+{
+    printf(
+        "Usage: pcv-bench <benchmark> [counts...]\n"
+        "Benchmarks:\n"
+        "  morton   morton code generation, radix sort and point reordering (default 10M 100M)\n"
+        "  queue    render queue sorting against std::sort (default 1k 10k 100k)\n"
+        "  frame    per frame render queue building and fetching (default 10k)\n"
+        "  overdraw depth tested fragments by draw order for clusters of points (default 2k)\n"
+        "  jobs     skewed and recursive workloads by thread count (default 1 2 4 .. hardware)\n"
+        "  mat4     mat4 products and inverse, SIMD against scalar (default 10M)\n"
+        "  transform batched point transform and bounds against per point (default 10M)\n"
+        "  copy     bulk vec3f copies against a user copy constructed vector (default 10M)\n"
+        "  cull     packed frustum culling against a box per node pointer (default 100k)\n"
+        "  text     parsing georeferenced ASCII xyz points (default 100M)\n"
+        "  pcd      loading the ascii, binary and binary_compressed pcd encodings (default 5M)\n"
+        "  pipeline startup pipeline creation with an empty then a warm pipeline cache, needs a\n"
+        "           Vulkan device\n"
+        "  laz      laz decompression by thread count, takes the file then the thread counts:\n"
+        "           pcv-bench laz <file.laz> [threads...] (default 1 2 4 .. hardware)\n"
+        "  lod      octree node selection, serial against the jobs by thread count, takes the\n"
+        "           octree directory then the thread counts:\n"
+        "           pcv-bench lod <octree dir> [threads...] (default 1 2 4 .. hardware)\n");
+}
+
+/// a cloud of uniformly distributed points with all attributes
+std::unique_ptr<PCV::PointCloud> createRandomCloud(const size_t count)
+{
+    auto cloud = std::make_unique<PCV::PointCloud>();
+    cloud->allocate(
+        count,
+        PCV::PointCloud::AttributeFlags::Position | PCV::PointCloud::AttributeFlags::Colour |
+            PCV::PointCloud::AttributeFlags::Intensity |
+            PCV::PointCloud::AttributeFlags::Classification);
+
+    auto fill = [&cloud](const size_t start, const size_t num) {
+        std::mt19937 rng {static_cast<uint32_t>(start)};
+        std::uniform_real_distribution<float> dist {0.0f, 1000.0f};
+        PCV::PointCloud::Storage& storage = cloud->storage;
+        for (size_t i = start; i < start + num; ++i)
+        {
+            storage.posX[i] = dist(rng);
+            storage.posY[i] = dist(rng);
+            storage.posZ[i] = dist(rng) * 0.1f;
+            storage.red[i] = static_cast<uint8_t>(i);
+            storage.green[i] = static_cast<uint8_t>(i >> 8);
+            storage.blue[i] = static_cast<uint8_t>(i >> 16);
+            storage.intensity[i] = static_cast<uint16_t>(i);
+            storage.classification[i] = static_cast<uint8_t>(i % 20);
+        }
+    };
+    PCV::ThreadTaskSplitter split {0, count, fill};
+    split.run();
+
+    cloud->computeBounds();
+    return cloud;
+}
+
+void benchMorton(const size_t count)
+{
+    std::unique_ptr<PCV::PointCloud> cloud = createRandomCloud(count);
+    const double millions = static_cast<double>(count) / 1.0e6;
+
+    // ========= code generation ===========================
+    std::vector<uint64_t> codes(count);
+    Timer timer;
+    PCV::computeMortonCodes(
+        cloud->posX, cloud->posY, cloud->posZ, cloud->getBounds(), codes.data());
+    const double codeSeconds = timer.getElapsedSeconds();
+
+    // ========= radix sort ================================
+    std::vector<uint64_t> keys = codes;
+    std::vector<uint32_t> values(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i] = static_cast<uint32_t>(i);
+    }
+    timer.reset();
+    Util::radixSort(keys.data(), values.data(), count);
+    const double radixSeconds = timer.getElapsedSeconds();
+
+    if (!std::is_sorted(keys.begin(), keys.end()))
+    {
+        LOGGER_ERROR("Radix sort produced an unsorted result.");
+    }
+
+    // ========= std::sort baseline ========================
+    std::vector<std::pair<uint64_t, uint32_t>> pairs(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        pairs[i] = {codes[i], static_cast<uint32_t>(i)};
+    }
+    timer.reset();
+    std::sort(pairs.begin(), pairs.end());
+    const double stdSortSeconds = timer.getElapsedSeconds();
+
+    // free everything but the cloud before reordering
+    codes = {};
+    keys = {};
+    values = {};
+    pairs = {};
+
+    // ========= full reorder ==============================
+    timer.reset();
+    PCV::sortPointsMorton(*cloud);
+    const double reorderSeconds = timer.getElapsedSeconds();
+
+    LOGGER_INFO(
+        "%.1fM points, %zu threads:",
+        millions,
+        PCV::ThreadTaskSplitter::getHardwareThreadCount());
+    LOGGER_INFO(
+        "  morton codes:  %8.3fs (%.1fM points/s)", codeSeconds, millions / codeSeconds);
+    LOGGER_INFO(
+        "  radix sort:    %8.3fs (%.1fM keys/s)", radixSeconds, millions / radixSeconds);
+    LOGGER_INFO(
+        "  std::sort:     %8.3fs (%.1fM keys/s)", stdSortSeconds, millions / stdSortSeconds);
+    LOGGER_INFO(
+        "  full reorder:  %8.3fs (%.1fM points/s)", reorderSeconds, millions / reorderSeconds);
+}
+
+/// random sort keys as would be generated by the scene
+std::vector<OmegaEngine::RenderableQueueInfo> createRenderables(const size_t count)
+{
+    using OmegaEngine::RenderQueue;
+    using OmegaEngine::RenderableQueueInfo;
+
+    std::mt19937 rng {static_cast<uint32_t>(count)};
+    std::vector<RenderableQueueInfo> renderables(count);
+    for (RenderableQueueInfo& info : renderables)
+    {
+        info = {};
+        info.sortingKey = RenderQueue::createSortKey(
+            static_cast<RenderQueue::Layer>(rng() % 3), rng() % 4096, rng() % 64);
+    }
+    return renderables;
+}
+
+void benchQueue(const size_t count)
+{
+    using OmegaEngine::RenderQueue;
+    using OmegaEngine::RenderableQueueInfo;
+
+    const std::vector<RenderableQueueInfo> renderables = createRenderables(count);
+
+    // enough repeats for the smaller queues to give a stable time
+    const size_t iterations = std::max<size_t>(10, 10'000'000 / count);
+
+    RenderQueue queue;
+    double radixSeconds = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        queue.beginFrame();
+        queue.pushRenderables(renderables, RenderQueue::Type::Colour);
+        Timer timer;
+        queue.sortQueue(RenderQueue::Type::Colour);
+        radixSeconds += timer.getElapsedSeconds();
+        queue.submitFrame();
+    }
+
+    // the previous comparison sort of the queue
+    double stdSortSeconds = 0.0;
+    std::vector<RenderableQueueInfo> sorted;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        sorted = renderables;
+        Timer timer;
+        std::sort(
+            sorted.begin(),
+            sorted.end(),
+            [](const RenderableQueueInfo& lhs, const RenderableQueueInfo& rhs) {
+                return lhs.sortingKey.u.flags < rhs.sortingKey.u.flags;
+            });
+        stdSortSeconds += timer.getElapsedSeconds();
+    }
+
+    Util::Span<const RenderableQueueInfo> result = queue.getQueue(RenderQueue::Type::Colour);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (result[i].sortingKey.u.flags != sorted[i].sortingKey.u.flags)
+        {
+            LOGGER_ERROR("Radix sort of the render queue differs from std::sort.");
+            break;
+        }
+    }
+
+    const double radixUs = radixSeconds * 1.0e6 / static_cast<double>(iterations);
+    const double stdSortUs = stdSortSeconds * 1.0e6 / static_cast<double>(iterations);
+    LOGGER_INFO("%zu renderables, %zu iterations:", count, iterations);
+    LOGGER_INFO("  radix sort:  %10.1fus", radixUs);
+    LOGGER_INFO("  std::sort:   %10.1fus (%.2fx)", stdSortUs, stdSortUs / radixUs);
+}
+
+void benchFrame(const size_t count)
+{
+    using OmegaEngine::RenderQueue;
+    using OmegaEngine::RenderableQueueInfo;
+
+    const std::vector<RenderableQueueInfo> renderables = createRenderables(count);
+    constexpr size_t FrameCount = 100;
+
+    // the first frames of each path grow the storage, so aren't counted
+    constexpr size_t WarmupFrames = 2;
+
+    // stands in for the renderer reading the queue
+    size_t drawn = 0;
+
+    // ========= previous path =============================
+    // the scene built a local list, which was copied into the queue and copied again by value
+    // when the renderer fetched it
+    std::vector<RenderableQueueInfo> legacyQueue;
+    size_t legacyAllocations = 0;
+    double legacySeconds = 0.0;
+    for (size_t frame = 0; frame < WarmupFrames + FrameCount; ++frame)
+    {
+        const size_t startCount = PCV::getAllocationCount();
+        Timer timer;
+
+        std::vector<RenderableQueueInfo> queueRend;
+        for (const RenderableQueueInfo& info : renderables)
+        {
+            queueRend.emplace_back(info);
+        }
+        legacyQueue.clear();
+        legacyQueue.resize(queueRend.size());
+        std::copy(queueRend.begin(), queueRend.end(), legacyQueue.begin());
+        std::sort(
+            legacyQueue.begin(),
+            legacyQueue.end(),
+            [](const RenderableQueueInfo& lhs, const RenderableQueueInfo& rhs) {
+                return lhs.sortingKey.u.flags < rhs.sortingKey.u.flags;
+            });
+
+        std::vector<RenderableQueueInfo> fetched = legacyQueue;
+        drawn += fetched.size();
+
+        if (frame >= WarmupFrames)
+        {
+            legacySeconds += timer.getElapsedSeconds();
+            legacyAllocations += PCV::getAllocationCount() - startCount;
+        }
+    }
+
+    // ========= double buffered queue =====================
+    RenderQueue queue;
+    size_t allocations = 0;
+    double seconds = 0.0;
+    for (size_t frame = 0; frame < WarmupFrames + FrameCount; ++frame)
+    {
+        const size_t startCount = PCV::getAllocationCount();
+        Timer timer;
+
+        queue.beginFrame();
+        for (const RenderableQueueInfo& info : renderables)
+        {
+            queue.push(info, RenderQueue::Type::Colour);
+        }
+        queue.submitFrame();
+
+        Util::Span<const RenderableQueueInfo> fetched = queue.getQueue(RenderQueue::Type::Colour);
+        drawn += fetched.size();
+
+        if (frame >= WarmupFrames)
+        {
+            seconds += timer.getElapsedSeconds();
+            allocations += PCV::getAllocationCount() - startCount;
+        }
+    }
+
+    LOGGER_INFO("%zu renderables, %zu frames (%zu drawn):", count, FrameCount, drawn);
+    LOGGER_INFO(
+        "  previous:        %8.1fus, %.1f allocations per frame",
+        legacySeconds * 1.0e6 / FrameCount,
+        static_cast<double>(legacyAllocations) / FrameCount);
+    LOGGER_INFO(
+        "  double buffered: %8.1fus, %.1f allocations per frame",
+        seconds * 1.0e6 / FrameCount,
+        static_cast<double>(allocations) / FrameCount);
+}
+
+void benchOverdraw(const size_t nodeCount)
+{
+    using OmegaEngine::RenderQueue;
+    using OmegaEngine::RenderableQueueInfo;
+
+    constexpr size_t PointsPerNode = 2000;
+    constexpr uint32_t Width = 1280;
+    constexpr uint32_t Height = 720;
+    constexpr float ZNear = 0.5f;
+    constexpr float ZFar = 1000.0f;
+
+    // the camera is at the origin looking down +z, with a 60 degree vertical fov
+    const OEMaths::vec3f cameraPos {0.0f, 0.0f, 0.0f};
+    const OEMaths::vec3f viewDir {0.0f, 0.0f, 1.0f};
+    const float focal = static_cast<float>(Height) * 0.5f / std::tan(30.0f * 3.14159265f / 180.0f);
+
+    // overlapping 10m clusters, as the nodes of a dense street level scan
+    std::mt19937 rng {static_cast<uint32_t>(nodeCount)};
+    std::uniform_real_distribution<float> unit {0.0f, 1.0f};
+    std::vector<OEMaths::vec3f> points(nodeCount * PointsPerNode);
+    std::vector<OEMaths::vec3f> centres(nodeCount);
+    for (size_t node = 0; node < nodeCount; ++node)
+    {
+        const OEMaths::vec3f min {
+            -100.0f + unit(rng) * 200.0f, -20.0f + unit(rng) * 30.0f, 5.0f + unit(rng) * 300.0f};
+        centres[node] = min + OEMaths::vec3f {5.0f, 5.0f, 5.0f};
+        for (size_t i = 0; i < PointsPerNode; ++i)
+        {
+            points[node * PointsPerNode + i] =
+                min + OEMaths::vec3f {unit(rng), unit(rng), unit(rng)} * 10.0f;
+        }
+    }
+
+    // draws the nodes as single pixel points in the given order, counting the fragments which
+    // pass the depth test - each of these would be shaded
+    std::vector<float> depthBuffer(Width * Height);
+    auto draw = [&](const std::vector<size_t>& order) {
+        std::fill(depthBuffer.begin(), depthBuffer.end(), ZFar);
+        size_t shaded = 0;
+        for (size_t node : order)
+        {
+            for (size_t i = 0; i < PointsPerNode; ++i)
+            {
+                const OEMaths::vec3f& point = points[node * PointsPerNode + i];
+                if (point.z < ZNear)
+                {
+                    continue;
+                }
+                const float x = point.x / point.z * focal + Width * 0.5f;
+                const float y = point.y / point.z * focal + Height * 0.5f;
+                if (x < 0.0f || y < 0.0f || x >= Width || y >= Height)
+                {
+                    continue;
+                }
+                float& depth = depthBuffer[static_cast<size_t>(y) * Width + static_cast<size_t>(x)];
+                if (point.z < depth)
+                {
+                    depth = point.z;
+                    ++shaded;
+                }
+            }
+        }
+        const size_t covered = std::count_if(
+            depthBuffer.begin(), depthBuffer.end(), [&](const float d) { return d < ZFar; });
+        return std::make_pair(shaded, covered);
+    };
+
+    // the nodes are queued in the order given by their sort keys
+    RenderQueue queue;
+    auto getQueueOrder = [&](const RenderQueue::Layer layer) {
+        queue.beginFrame();
+        for (size_t node = 0; node < nodeCount; ++node)
+        {
+            RenderableQueueInfo info = {};
+            info.renderableData = reinterpret_cast<void*>(node);
+            const float depth =
+                RenderQueue::getViewDepth(centres[node], cameraPos, viewDir, ZNear, ZFar);
+            info.sortingKey = RenderQueue::createSortKey(layer, 0, 0, depth);
+            queue.push(info, RenderQueue::Type::Colour);
+        }
+        queue.submitFrame();
+
+        std::vector<size_t> order;
+        for (const RenderableQueueInfo& info : queue.getQueue(RenderQueue::Type::Colour))
+        {
+            order.emplace_back(reinterpret_cast<size_t>(info.renderableData));
+        }
+        return order;
+    };
+
+    std::vector<size_t> unsorted(nodeCount);
+    for (size_t node = 0; node < nodeCount; ++node)
+    {
+        unsorted[node] = node;
+    }
+
+    LOGGER_INFO("%zu nodes of %zu points:", nodeCount, PointsPerNode);
+    auto report = [&](const char* name, const std::vector<size_t>& order) {
+        const auto [shaded, covered] = draw(order);
+        LOGGER_INFO(
+            "  %-14s %10zu shaded fragments, %.2f per covered pixel",
+            name,
+            shaded,
+            static_cast<double>(shaded) / static_cast<double>(std::max<size_t>(covered, 1)));
+    };
+    report("unsorted:", unsorted);
+    report("front to back:", getQueueOrder(RenderQueue::Layer::Default));
+    report("back to front:", getQueueOrder(RenderQueue::Layer::Transparent));
+}
+
+/// a loop whose cost is proportional to the iterations, which the compiler can't remove
+float spin(const uint32_t seed, const uint32_t iterations)
+{
+    float value = static_cast<float>(seed & 0xff);
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        value = value * 0.999f + std::sqrt(value + static_cast<float>(i));
+    }
+    return value;
+}
+
+void benchJobs(const std::vector<size_t>& threadCounts)
+{
+    // most items are cheap, with a dense region costing far more - as with the nodes near the
+    // camera, or the renderables of a cluttered part of the scene. Splitting the range into equal
+    // chunks up front leaves one thread with most of the work
+    constexpr size_t ItemCount = 200'000;
+    constexpr uint32_t CheapCost = 16;
+    constexpr uint32_t DenseCost = CheapCost * 64;
+    const size_t denseStart = ItemCount / 4;
+    const size_t denseEnd = denseStart + ItemCount / 16;
+
+    std::vector<float> results(ItemCount);
+    auto skewed = [&](const size_t start, const size_t count) {
+        for (size_t i = start; i < start + count; ++i)
+        {
+            const bool dense = i >= denseStart && i < denseEnd;
+            results[i] = spin(static_cast<uint32_t>(i), dense ? DenseCost : CheapCost);
+        }
+    };
+
+    // an octree like traversal where each node spawns its children as jobs, with the fan out
+    // varying by node so some subtrees are much larger than others. The tree is kept small enough
+    // for its jobs to fit within the job system's ring
+    constexpr uint32_t TreeDepth = 5;
+    constexpr uint32_t NodeCost = 4096;
+    std::atomic<size_t> treeNodes {0};
+    struct TreeNode
+    {
+        static void visit(
+            PCV::JobSystem& jobs,
+            PCV::JobSystem::Job* root,
+            std::atomic<size_t>* counter,
+            const uint32_t id,
+            const uint32_t depth)
+        {
+            counter->fetch_add(1, std::memory_order_relaxed);
+            if (spin(id, NodeCost) < 0.0f || depth == TreeDepth)
+            {
+                return;
+            }
+            const uint32_t childCount = (id * 2654435761u >> 29) + 1;
+            for (uint32_t child = 0; child < childCount; ++child)
+            {
+                PCV::JobSystem* system = &jobs;
+                const uint32_t childId = id * 8 + child + 1;
+                jobs.run(jobs.createJob(
+                    [system, root, counter, childId, depth]() {
+                        visit(*system, root, counter, childId, depth + 1);
+                    },
+                    root));
+            }
+        }
+    };
+
+    LOGGER_INFO(
+        "%zu items with a dense region, tree of depth %u (%zu hardware threads):",
+        ItemCount,
+        TreeDepth,
+        PCV::ThreadTaskSplitter::getHardwareThreadCount());
+
+    double splitterBase = 0.0;
+    double jobsBase = 0.0;
+    double treeBase = 0.0;
+    for (const size_t threads : threadCounts)
+    {
+        Timer timer;
+        PCV::ThreadTaskSplitter split {0, ItemCount, skewed, threads};
+        split.run();
+        const double splitterSeconds = timer.getElapsedSeconds();
+
+        PCV::JobSystem jobs {threads};
+        timer.reset();
+        jobs.parallelFor(0, ItemCount, skewed);
+        const double jobsSeconds = timer.getElapsedSeconds();
+
+        treeNodes = 0;
+        timer.reset();
+        PCV::JobSystem::Job* root = jobs.createJob([]() {});
+        TreeNode::visit(jobs, root, &treeNodes, 0, 0);
+        jobs.run(root);
+        jobs.wait(root);
+        const double treeSeconds = timer.getElapsedSeconds();
+
+        if (splitterBase == 0.0)
+        {
+            splitterBase = splitterSeconds;
+            jobsBase = jobsSeconds;
+            treeBase = treeSeconds;
+        }
+        LOGGER_INFO(
+            "  %2zu threads: splitter %8.2fms (%4.2fx), parallelFor %8.2fms (%4.2fx), "
+            "tree of %zu nodes %8.2fms (%4.2fx)",
+            threads,
+            splitterSeconds * 1.0e3,
+            splitterBase / splitterSeconds,
+            jobsSeconds * 1.0e3,
+            jobsBase / jobsSeconds,
+            treeNodes.load(),
+            treeSeconds * 1.0e3,
+            treeBase / treeSeconds);
+    }
+}
+
+void benchMat4(const size_t count)
+{
+    using OEMaths::mat4f;
+    using OEMaths::vec4f;
+
+    // the operations are repeated over a set of matrices which fits in the cache, so the kernels
+    // are timed rather than the memory bandwidth
+    constexpr size_t SetSize = 1024;
+
+    // transform like matrices - a rotation and scale with a translation - which are far from
+    // singular, as the world and view matrices are
+    std::mt19937 rng {static_cast<uint32_t>(count)};
+    std::uniform_real_distribution<float> unit {-1.0f, 1.0f};
+    std::vector<mat4f> mats(SetSize);
+    std::vector<vec4f> vecs(SetSize);
+    for (size_t i = 0; i < SetSize; ++i)
+    {
+        for (size_t col = 0; col < 4; ++col)
+        {
+            for (size_t row = 0; row < 4; ++row)
+            {
+                mats[i][col][row] = (col == row ? 4.0f : 0.0f) + unit(rng);
+            }
+        }
+        vecs[i] = {unit(rng), unit(rng), unit(rng), 1.0f};
+    }
+
+    std::vector<mat4f> scalarMats(SetSize);
+    std::vector<mat4f> simdMats(SetSize);
+    std::vector<vec4f> scalarVecs(SetSize);
+    std::vector<vec4f> simdVecs(SetSize);
+
+    // each matrix is multiplied by its neighbour, as a chain of node transforms would be
+    auto time = [&](auto func) {
+        Timer timer;
+        for (size_t n = 0; n < count; ++n)
+        {
+            const size_t i = n % SetSize;
+            func(i, (i + 1) % SetSize);
+        }
+        return timer.getElapsedSeconds();
+    };
+
+    // the largest difference relative to the largest element of each result
+    auto maxError = [&](const auto& lhs, const auto& rhs, const size_t size) {
+        float result = 0.0f;
+        for (size_t i = 0; i < SetSize; ++i)
+        {
+            const float* a = reinterpret_cast<const float*>(&lhs[i]);
+            const float* b = reinterpret_cast<const float*>(&rhs[i]);
+            float scale = 0.0f;
+            float diff = 0.0f;
+            for (size_t j = 0; j < size; ++j)
+            {
+                scale = std::max(scale, std::abs(a[j]));
+                diff = std::max(diff, std::abs(a[j] - b[j]));
+            }
+            result = std::max(result, diff / scale);
+        }
+        return result;
+    };
+
+    const double scalarMul = time([&](const size_t i, const size_t j) {
+        scalarMats[i] = OEMaths::Scalar::multiply(mats[i], mats[j]);
+    });
+    const double simdMul = time([&](const size_t i, const size_t j) {
+        simdMats[i] = mats[i] * mats[j];
+    });
+    const float mulError = maxError(scalarMats, simdMats, 16);
+
+    const double scalarVec = time([&](const size_t i, const size_t) {
+        scalarVecs[i] = OEMaths::Scalar::multiply(mats[i], vecs[i]);
+    });
+    const double simdVec = time([&](const size_t i, const size_t) {
+        simdVecs[i] = mats[i] * vecs[i];
+    });
+    const float vecError = maxError(scalarVecs, simdVecs, 4);
+
+    const double scalarInv = time([&](const size_t i, const size_t) {
+        scalarMats[i] = OEMaths::Scalar::inverse(mats[i]);
+    });
+    const double simdInv = time([&](const size_t i, const size_t) {
+        simdMats[i] = mat4f::inverse(mats[i]);
+    });
+    const float invError = maxError(scalarMats, simdMats, 16);
+
+    // the inverses are also checked against the identity, as they are computed differently
+    float residual = 0.0f;
+    for (size_t i = 0; i < SetSize; ++i)
+    {
+        const mat4f identity = OEMaths::Scalar::multiply(mats[i], simdMats[i]);
+        for (size_t col = 0; col < 4; ++col)
+        {
+            for (size_t row = 0; row < 4; ++row)
+            {
+                const float expected = col == row ? 1.0f : 0.0f;
+                residual = std::max(residual, std::abs(identity[col][row] - expected));
+            }
+        }
+    }
+
+#if defined(__AVX__)
+    const char* kernels = "AVX";
+#elif defined(OEMATHS_SIMD_SSE)
+    const char* kernels = "SSE";
+#else
+    const char* kernels = "scalar";
+#endif
+    const double perOp = 1.0e9 / static_cast<double>(count);
+    LOGGER_INFO("%zu operations, %s kernels:", count, kernels);
+    LOGGER_INFO(
+        "  mat4 * mat4: scalar %6.2fns, simd %6.2fns (%4.2fx), max relative error %g",
+        scalarMul * perOp,
+        simdMul * perOp,
+        scalarMul / simdMul,
+        mulError);
+    LOGGER_INFO(
+        "  mat4 * vec4: scalar %6.2fns, simd %6.2fns (%4.2fx), max relative error %g",
+        scalarVec * perOp,
+        simdVec * perOp,
+        scalarVec / simdVec,
+        vecError);
+    LOGGER_INFO(
+        "  inverse:     scalar %6.2fns, simd %6.2fns (%4.2fx), max relative error %g, "
+        "max |M * inv - I| %g",
+        scalarInv * perOp,
+        simdInv * perOp,
+        scalarInv / simdInv,
+        invError,
+        residual);
+}
+
+void benchTransform(const size_t count)
+{
+    using OEMaths::mat4f;
+    using OEMaths::vec3f;
+    using OEMaths::vec4f;
+
+    std::unique_ptr<PCV::PointCloud> cloud = createRandomCloud(count);
+    const float* x = cloud->posX.ptr();
+    const float* y = cloud->posY.ptr();
+    const float* z = cloud->posZ.ptr();
+    const double millions = static_cast<double>(count) / 1.0e6;
+
+    // a rotation about z with a translation, as when moving a cloud into world space
+    mat4f mat = mat4f::translate(vec3f {100.0f, -50.0f, 10.0f});
+    mat[0][0] = 0.8f;
+    mat[0][1] = 0.6f;
+    mat[1][0] = -0.6f;
+    mat[1][1] = 0.8f;
+
+    std::vector<float> outX(count);
+    std::vector<float> outY(count);
+    std::vector<float> outZ(count);
+    std::vector<float> batchX(count);
+    std::vector<float> batchY(count);
+    std::vector<float> batchZ(count);
+
+    // ========= one point at a time =======================
+    Timer timer;
+    PCV::AABBox pointBounds;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const vec4f pos = mat * vec4f {x[i], y[i], z[i], 1.0f};
+        outX[i] = pos.x;
+        outY[i] = pos.y;
+        outZ[i] = pos.z;
+        pointBounds.extend(pos.x, pos.y, pos.z);
+    }
+    const double pointSeconds = timer.getElapsedSeconds();
+
+    // ========= batched ===================================
+    timer.reset();
+    PCV::AABBox batchBounds;
+    OEMaths::transformPoints(
+        mat,
+        x,
+        y,
+        z,
+        count,
+        batchX.data(),
+        batchY.data(),
+        batchZ.data(),
+        &batchBounds.min,
+        &batchBounds.max);
+    const double batchSeconds = timer.getElapsedSeconds();
+
+    // ========= bounds only ===============================
+    timer.reset();
+    PCV::AABBox extendBounds;
+    for (size_t i = 0; i < count; ++i)
+    {
+        extendBounds.extend(x[i], y[i], z[i]);
+    }
+    const double extendSeconds = timer.getElapsedSeconds();
+
+    timer.reset();
+    cloud->computeBounds();
+    const double boundsSeconds = timer.getElapsedSeconds();
+
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        maxDiff = std::max(maxDiff, std::abs(outX[i] - batchX[i]));
+        maxDiff = std::max(maxDiff, std::abs(outY[i] - batchY[i]));
+        maxDiff = std::max(maxDiff, std::abs(outZ[i] - batchZ[i]));
+    }
+    const bool boundsMatch = OEMaths::length(pointBounds.min - batchBounds.min) == 0.0f &&
+        OEMaths::length(pointBounds.max - batchBounds.max) == 0.0f &&
+        OEMaths::length(extendBounds.min - cloud->getBounds().min) == 0.0f &&
+        OEMaths::length(extendBounds.max - cloud->getBounds().max) == 0.0f;
+
+    LOGGER_INFO("%.1fM points:", millions);
+    LOGGER_INFO(
+        "  transform + bounds: per point %7.1fM points/s, batched %7.1fM points/s (%4.2fx)",
+        millions / pointSeconds,
+        millions / batchSeconds,
+        pointSeconds / batchSeconds);
+    LOGGER_INFO(
+        "  bounds only:        per point %7.1fM points/s, batched %7.1fM points/s (%4.2fx)",
+        millions / extendSeconds,
+        millions / boundsSeconds,
+        extendSeconds / boundsSeconds);
+    LOGGER_INFO(
+        "  max position difference %g, bounds %s", maxDiff, boundsMatch ? "match" : "differ");
+}
+
+/// a vec3 with the element wise copy constructor and assignment the maths types used to have,
+/// which makes it non-trivially copyable
+struct LegacyVec3
+{
+    LegacyVec3() = default;
+
+    LegacyVec3(const float x, const float y, const float z)
+        : data {x, y, z}
+    {
+    }
+
+    LegacyVec3(const LegacyVec3& other)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            data[i] = other.data[i];
+        }
+    }
+
+    LegacyVec3& operator=(const LegacyVec3& other)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            data[i] = other.data[i];
+        }
+        return *this;
+    }
+
+    float data[3] = {};
+};
+
+template <typename Vec>
+void benchCopyType(const char* name, const std::vector<Vec>& src)
+{
+    const size_t count = src.size();
+    const double millions = static_cast<double>(count) / 1.0e6;
+
+    // warm the destination so page faults aren't timed
+    std::vector<Vec> dst(count);
+    std::vector<Vec> grown;
+
+    // the best of several runs, as single copies are short enough to be noisy
+    constexpr size_t Runs = 5;
+    double assignSeconds = 1.0e9;
+    double copySeconds = 1.0e9;
+    double growSeconds = 1.0e9;
+    for (size_t run = 0; run < Runs; ++run)
+    {
+        Timer timer;
+        dst = src;
+        assignSeconds = std::min(assignSeconds, timer.getElapsedSeconds());
+
+        timer.reset();
+        std::copy(src.begin(), src.end(), dst.begin());
+        copySeconds = std::min(copySeconds, timer.getElapsedSeconds());
+
+        // growth copies the elements to each new allocation
+        std::vector<Vec>().swap(grown);
+        timer.reset();
+        for (const Vec& vec : src)
+        {
+            grown.push_back(vec);
+        }
+        growSeconds = std::min(growSeconds, timer.getElapsedSeconds());
+    }
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; i += 4099)
+    {
+        sum += dst[i].data[0] + grown[i].data[2];
+    }
+
+    LOGGER_INFO(
+        "  %-10s assign %7.1fM/s, std::copy %7.1fM/s, push_back %7.1fM/s (checksum %g)",
+        name,
+        millions / assignSeconds,
+        millions / copySeconds,
+        millions / growSeconds,
+        sum);
+}
+
+void benchCopy(const size_t count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+
+    std::vector<OEMaths::vec3f> vecs(count);
+    std::vector<LegacyVec3> legacy(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        vecs[i] = OEMaths::vec3f {dist(rng), dist(rng), dist(rng)};
+        legacy[i] = LegacyVec3 {vecs[i].x, vecs[i].y, vecs[i].z};
+    }
+
+    LOGGER_INFO("%.1fM vectors:", static_cast<double>(count) / 1.0e6);
+    benchCopyType("vec3f", vecs);
+    benchCopyType("legacy", legacy);
+}
+
+/// a node as the scene stores them - each is allocated separately and reached through a pointer
+struct CullNode
+{
+    PCV::AABBox bounds;
+
+    /// the rest of the node's state, which shares the cache lines with the bounds
+    uint8_t payload[64];
+    bool visible;
+};
+
+void benchCull(const size_t count)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> posDist(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> sizeDist(1.0f, 20.0f);
+
+    // the nodes are visited in a different order to their allocation, as after a scene has been
+    // edited for a while
+    std::vector<std::unique_ptr<CullNode>> nodes(count);
+    for (std::unique_ptr<CullNode>& node : nodes)
+    {
+        node = std::make_unique<CullNode>();
+        const OEMaths::vec3f min {posDist(rng), posDist(rng), posDist(rng)};
+        const float size = sizeDist(rng);
+        node->bounds = PCV::AABBox {min, min + OEMaths::vec3f {size, size, size}};
+    }
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+
+    PCV::PackedBounds packed;
+    packed.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        packed.set(i, nodes[i]->bounds);
+    }
+    std::vector<uint8_t> visibleMask((count + 7) / 8);
+
+    // a camera at the origin looking along z, with the far plane inside the cloud of nodes
+    PCV::Frustum frustum;
+    frustum.projection(OEMaths::perspective(60.0f, 16.0f / 9.0f, 0.1f, 400.0f));
+
+    // the best of several runs, as a single pass over 100k nodes is short enough to be noisy
+    constexpr size_t Runs = 10;
+    double pointerSeconds = 1.0e9;
+    double packedSeconds = 1.0e9;
+    for (size_t run = 0; run < Runs; ++run)
+    {
+        Timer timer;
+        for (const std::unique_ptr<CullNode>& node : nodes)
+        {
+            node->visible = frustum.checkBoxPlaneIntersect(node->bounds);
+        }
+        pointerSeconds = std::min(pointerSeconds, timer.getElapsedSeconds());
+
+        timer.reset();
+        frustum.checkBoxesPlaneIntersect(packed, 0, count, visibleMask.data());
+        packedSeconds = std::min(packedSeconds, timer.getElapsedSeconds());
+    }
+
+    size_t visibleCount = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const bool visible = visibleMask[i / 8] & (1 << (i % 8));
+        visibleCount += visible;
+        mismatches += visible != nodes[i]->visible;
+    }
+
+    const double millions = static_cast<double>(count) / 1.0e6;
+#if defined(__AVX__)
+    LOGGER_INFO("%zu nodes, AVX kernel, %zu visible:", count, visibleCount);
+#elif defined(__SSE2__) || defined(_M_X64)
+    LOGGER_INFO("%zu nodes, SSE kernel, %zu visible:", count, visibleCount);
+#else
+    LOGGER_INFO("%zu nodes, scalar kernel, %zu visible:", count, visibleCount);
+#endif
+    LOGGER_INFO(
+        "  pointer per node %7.1fM nodes/s (%6.1fus), packed %7.1fM nodes/s (%6.1fus) (%4.2fx)",
+        millions / pointerSeconds,
+        pointerSeconds * 1.0e6,
+        millions / packedSeconds,
+        packedSeconds * 1.0e6,
+        pointerSeconds / packedSeconds);
+    LOGGER_INFO("  %zu results differ", mismatches);
+}
+
+/// the georeferenced position of a point in millimetres - derived from the index so the parsed
+/// positions can be checked without keeping the text or the expected positions in memory
+void getTextPosition(const size_t index, int64_t* pos)
+{
+    uint64_t hash = index * 0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 29;
+    pos[0] = 500'000'000 + static_cast<int64_t>(hash % 1'000'001);
+    pos[1] = 5'000'000'000 + static_cast<int64_t>((hash >> 20) % 1'000'001);
+    pos[2] = static_cast<int64_t>((hash >> 40) % 1'000'001) / 10;
+}
+
+void benchText(const size_t count)
+{
+    // UTM like coordinates with millimetre resolution, which lose most of their precision as
+    // floats unless rebased - x y z intensity r g b, as written by most exporters. The text is
+    // written to a file in blocks as 100M lines don't fit in memory alongside the parsed cloud
+    const char* path = "pcv-bench.xyz";
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        LOGGER_ERROR("Unable to write %s.", path);
+        return;
+    }
+    constexpr size_t BlockLines = 1 << 16;
+    std::string text;
+    text.reserve(BlockLines * 64);
+    char line[128];
+    bool written = true;
+    for (size_t i = 0; i < count && written; ++i)
+    {
+        int64_t pos[3];
+        getTextPosition(i, pos);
+        const int length = snprintf(
+            line,
+            sizeof(line),
+            "%lld.%03lld %lld.%03lld %lld.%03lld %u %u %u %u\n",
+            static_cast<long long>(pos[0] / 1000),
+            static_cast<long long>(pos[0] % 1000),
+            static_cast<long long>(pos[1] / 1000),
+            static_cast<long long>(pos[1] % 1000),
+            static_cast<long long>(pos[2] / 1000),
+            static_cast<long long>(pos[2] % 1000),
+            static_cast<unsigned>(i % 4096),
+            static_cast<unsigned>(i % 256),
+            static_cast<unsigned>((i >> 8) % 256),
+            static_cast<unsigned>((i >> 16) % 256));
+        text.append(line, static_cast<size_t>(length));
+        if (text.size() >= BlockLines * 56 || i + 1 == count)
+        {
+            written = fwrite(text.data(), 1, text.size(), file) == text.size();
+            text.clear();
+        }
+    }
+    fclose(file);
+    if (!written)
+    {
+        LOGGER_ERROR("Unable to write %s.", path);
+        std::remove(path);
+        return;
+    }
+
+    // loaded through the mapped file as a user's file would be, which is unmapped before removing
+    std::unique_ptr<PCV::PointCloud> cloud;
+    double seconds = 0.0;
+    size_t fileSize = 0;
+    {
+        PCV::TextLoader loader;
+        Timer timer;
+        if (loader.open(path))
+        {
+            cloud = loader.createPointCloud();
+        }
+        seconds = timer.getElapsedSeconds();
+        fileSize = loader.getFileSize();
+    }
+    std::remove(path);
+    if (!cloud || cloud->size() != count)
+    {
+        LOGGER_ERROR("Parsed the wrong number of points.");
+        return;
+    }
+
+    // the world positions are recovered with the origin, in doubles
+    const OEMaths::vec3d& origin = cloud->getOrigin();
+    double maxError = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        int64_t expected[3];
+        getTextPosition(i, expected);
+        const double pos[3] = {
+            origin.x + cloud->posX[i], origin.y + cloud->posY[i], origin.z + cloud->posZ[i]};
+        for (size_t axis = 0; axis < 3; ++axis)
+        {
+            const double error = pos[axis] - static_cast<double>(expected[axis]) / 1000.0;
+            maxError = std::max(maxError, std::abs(error));
+        }
+    }
+
+    const double megabytes = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+    LOGGER_INFO(
+        "%.1fM points, %.1fMB with %zu threads:",
+        static_cast<double>(count) / 1.0e6,
+        megabytes,
+        PCV::ThreadTaskSplitter::getHardwareThreadCount());
+    LOGGER_INFO(
+        "  %.3fs, %.1f MB/s, %.2fM points/s, max position error %.3fmm",
+        seconds,
+        megabytes / seconds,
+        static_cast<double>(count) / seconds / 1.0e6,
+        maxError * 1000.0);
+}
+
+/// writes the cloud as a pcd file with the fields and types PCL uses for XYZRGBL points
+bool writePcd(const char* path, const PCV::PointCloud& cloud, const char* encoding)
+{
+    const size_t count = cloud.size();
+    std::string text =
+        "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\n"
+        "FIELDS x y z rgb intensity label\nSIZE 4 4 4 4 4 4\nTYPE F F F U F U\n"
+        "COUNT 1 1 1 1 1 1\nWIDTH " +
+        std::to_string(count) + "\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS " +
+        std::to_string(count) + "\nDATA " + encoding + "\n";
+
+    auto getRgb = [&cloud](const size_t i) -> uint32_t {
+        return (uint32_t(cloud.red[i]) << 16) | (uint32_t(cloud.green[i]) << 8) | cloud.blue[i];
+    };
+
+    // the fields of each point, in field order
+    constexpr size_t FieldCount = 6;
+    auto getFields = [&](const size_t i, uint32_t* values) {
+        const float floats[] = {
+            cloud.posX[i], cloud.posY[i], cloud.posZ[i], static_cast<float>(cloud.intensity[i])};
+        std::memcpy(&values[0], &floats[0], sizeof(float) * 3);
+        values[3] = getRgb(i);
+        std::memcpy(&values[4], &floats[3], sizeof(float));
+        values[5] = cloud.classification[i];
+    };
+
+    std::vector<uint8_t> data;
+    if (!strcmp(encoding, "ascii"))
+    {
+        char line[128];
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int length = snprintf(
+                line,
+                sizeof(line),
+                "%.9g %.9g %.9g %u %u %u\n",
+                cloud.posX[i],
+                cloud.posY[i],
+                cloud.posZ[i],
+                getRgb(i),
+                static_cast<unsigned>(cloud.intensity[i]),
+                static_cast<unsigned>(cloud.classification[i]));
+            text.append(line, static_cast<size_t>(length));
+        }
+    }
+    else if (!strcmp(encoding, "binary"))
+    {
+        data.resize(count * FieldCount * sizeof(uint32_t));
+        for (size_t i = 0; i < count; ++i)
+        {
+            getFields(i, reinterpret_cast<uint32_t*>(data.data()) + i * FieldCount);
+        }
+    }
+    else
+    {
+        // one array per field, compressed as a single block behind its sizes
+        std::vector<uint32_t> arrays(count * FieldCount);
+        uint32_t values[FieldCount];
+        for (size_t i = 0; i < count; ++i)
+        {
+            getFields(i, values);
+            for (size_t field = 0; field < FieldCount; ++field)
+            {
+                arrays[field * count + i] = values[field];
+            }
+        }
+        const uint32_t uncompressedSize = static_cast<uint32_t>(arrays.size() * sizeof(uint32_t));
+        data.resize(8);
+        const uint32_t compressedSize = static_cast<uint32_t>(Util::lzfCompress(
+            reinterpret_cast<const uint8_t*>(arrays.data()), uncompressedSize, data));
+        std::memcpy(data.data(), &compressedSize, sizeof(uint32_t));
+        std::memcpy(data.data() + 4, &uncompressedSize, sizeof(uint32_t));
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        LOGGER_ERROR("Unable to write %s.", path);
+        return false;
+    }
+    bool success = fwrite(text.data(), 1, text.size(), file) == text.size();
+    success &= fwrite(data.data(), 1, data.size(), file) == data.size();
+    fclose(file);
+    return success;
+}
+
+void benchPcd(const size_t count)
+{
+    std::unique_ptr<PCV::PointCloud> source = createRandomCloud(count);
+    const char* path = "pcv-bench.pcd";
+    constexpr size_t Repeats = 3;
+
+    LOGGER_INFO("%.1fM points:", static_cast<double>(count) / 1.0e6);
+    for (const char* encoding : {"ascii", "binary", "binary_compressed"})
+    {
+        if (!writePcd(path, *source, encoding))
+        {
+            return;
+        }
+
+        // the best of a few loads, reusing the loader as a batch conversion would
+        PCV::PcdLoader loader;
+        double bestSeconds = 1.0e9;
+        size_t allocations = 0;
+        size_t mismatches = 0;
+        size_t fileSize = 0;
+        for (size_t repeat = 0; repeat < Repeats; ++repeat)
+        {
+            const size_t allocationsBefore = PCV::getAllocationCount();
+            Timer timer;
+            if (!loader.open(path))
+            {
+                return;
+            }
+            std::unique_ptr<PCV::PointCloud> cloud = loader.createPointCloud();
+            const double seconds = timer.getElapsedSeconds();
+            allocations = PCV::getAllocationCount() - allocationsBefore;
+            if (!cloud || cloud->size() != count)
+            {
+                LOGGER_ERROR("Loaded the wrong number of points.");
+                return;
+            }
+            bestSeconds = std::min(bestSeconds, seconds);
+            fileSize = loader.getFileSize();
+
+            // ascii positions are rebased to the bounds centre
+            const OEMaths::vec3d& origin = cloud->getOrigin();
+            mismatches = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const double dx = origin.x + cloud->posX[i] - source->posX[i];
+                const double dy = origin.y + cloud->posY[i] - source->posY[i];
+                const double dz = origin.z + cloud->posZ[i] - source->posZ[i];
+                const bool match = std::abs(dx) < 1.0e-3 && std::abs(dy) < 1.0e-3 &&
+                    std::abs(dz) < 1.0e-3 && cloud->red[i] == source->red[i] &&
+                    cloud->green[i] == source->green[i] && cloud->blue[i] == source->blue[i] &&
+                    cloud->intensity[i] == source->intensity[i] &&
+                    cloud->classification[i] == source->classification[i];
+                mismatches += !match;
+            }
+        }
+
+        const double megabytes = static_cast<double>(fileSize) / (1024.0 * 1024.0);
+        LOGGER_INFO(
+            "  %-17s %7.1fMB %8.3fs %8.1f MB/s %7.2fM points/s, %zu allocations, %zu mismatches",
+            encoding,
+            megabytes,
+            bestSeconds,
+            megabytes / bestSeconds,
+            static_cast<double>(count) / bestSeconds / 1.0e6,
+            allocations,
+            mismatches);
+    }
+    std::remove(path);
+}
+
+void benchLaz(const char* path, const std::vector<size_t>& threadCounts)
+{
+    PCV::LazLoader loader;
+    if (!loader.open(path))
+    {
+        return;
+    }
+    const size_t chunkCount = loader.getChunks().size();
+    const double millions = static_cast<double>(loader.getHeader().pointCount) / 1.0e6;
+
+    LOGGER_INFO(
+        "%.1fM points in %zu chunks, %.1fMB:",
+        millions,
+        chunkCount,
+        static_cast<double>(loader.getFileSize()) / (1024.0 * 1024.0));
+    for (size_t threads : threadCounts)
+    {
+        // the chunks are the unit of work, so no more threads than chunks are used
+        const size_t usedThreads = std::max<size_t>(1, std::min(threads, chunkCount));
+        loader.setThreadCount(usedThreads);
+
+        Timer timer;
+        std::unique_ptr<PCV::PointCloud> cloud = loader.createPointCloud();
+        const double seconds = timer.getElapsedSeconds();
+        if (!cloud)
+        {
+            return;
+        }
+        LOGGER_INFO(
+            "  %2zu threads: %7.2fM points/s, %6.2fM points/s per core",
+            usedThreads,
+            millions / seconds,
+            millions / seconds / static_cast<double>(usedThreads));
+    }
+}
+
+void benchLod(const char* dir, const std::vector<size_t>& threadCounts)
+{
+    auto file = std::make_shared<PCV::OctreeFile>();
+    if (!file->open(dir))
+    {
+        return;
+    }
+
+    // a grid of copies of the octree, so the scene is larger than the budget from most views
+    constexpr uint32_t GridSize = 2;
+    const PCV::Octree::HierarchyHeader& header = file->getHeader();
+    const float size = header.boundsMax[0] - header.boundsMin[0];
+    std::vector<PCV::LodSelector::Instance> octrees;
+    for (uint32_t y = 0; y < GridSize; ++y)
+    {
+        for (uint32_t x = 0; x < GridSize; ++x)
+        {
+            PCV::LodSelector::Instance instance;
+            instance.file = file;
+            instance.baseId = static_cast<uint32_t>(octrees.size() * file->getNodes().size());
+            instance.offset = OEMaths::vec3f {x * size, y * size, 0.0f};
+            octrees.emplace_back(instance);
+        }
+    }
+
+    // cameras above the scene looking at random points on it
+    constexpr size_t ViewCount = 500;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> posDist(0.0f, size * GridSize);
+    std::uniform_real_distribution<float> heightDist(size * 0.01f, size * 0.5f);
+    std::vector<PCV::Frustum> frustums(ViewCount);
+    std::vector<PCV::LodSelector::View> views(ViewCount);
+    for (size_t i = 0; i < ViewCount; ++i)
+    {
+        const OEMaths::vec3f min {header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]};
+        OEMaths::vec3f position =
+            min + OEMaths::vec3f {posDist(rng), posDist(rng), heightDist(rng)};
+        OEMaths::vec3f target = min + OEMaths::vec3f {posDist(rng), posDist(rng), 0.0f};
+        OEMaths::vec3f up {0.0f, 0.0f, 1.0f};
+        frustums[i].projection(
+            OEMaths::perspective(40.0f, 16.0f / 9.0f, 0.1f, size * 4.0f) *
+            OEMaths::lookAt(position, target, up));
+        views[i].frustum = &frustums[i];
+        views[i].position = position;
+    }
+
+    // a small screen error, so the budget bounds the selection rather than the error
+    PCV::LodSelector::Options options;
+    options.maxScreenError = 0.25f;
+    PCV::LodSelector selector {options};
+    std::vector<std::vector<uint32_t>> serialNodes(ViewCount);
+    size_t evaluated = 0;
+    size_t selected = 0;
+    size_t budgetReached = 0;
+    Timer timer;
+    for (size_t i = 0; i < ViewCount; ++i)
+    {
+        selector.select(octrees, views[i], serialNodes[i]);
+        evaluated += selector.getStats().evaluatedNodes;
+        selected += selector.getStats().selectedNodes;
+        budgetReached += selector.getStats().budgetReached;
+    }
+    const double serialMs = timer.getElapsedSeconds() * 1000.0 / ViewCount;
+
+    LOGGER_INFO(
+        "%zu octrees of %zu nodes, %zu views, %zu point budget reached in %zu views:",
+        octrees.size(),
+        file->getNodes().size(),
+        ViewCount,
+        selector.getPointBudget(),
+        budgetReached);
+    LOGGER_INFO(
+        "  serial:     %7.3fms per view, %7zu nodes evaluated, %6zu selected",
+        serialMs,
+        evaluated / ViewCount,
+        selected / ViewCount);
+
+    std::vector<uint32_t> nodes;
+    for (size_t threads : threadCounts)
+    {
+        PCV::JobSystem jobs {threads};
+        evaluated = 0;
+        size_t mismatches = 0;
+        timer.reset();
+        for (size_t i = 0; i < ViewCount; ++i)
+        {
+            nodes.clear();
+            selector.select(octrees, views[i], nodes, jobs);
+            evaluated += selector.getStats().evaluatedNodes;
+            mismatches += nodes != serialNodes[i];
+        }
+        const double ms = timer.getElapsedSeconds() * 1000.0 / ViewCount;
+        LOGGER_INFO(
+            "  %2zu threads: %7.3fms per view, %7zu nodes evaluated (%4.2fx), %zu views differ",
+            threads,
+            ms,
+            evaluated / ViewCount,
+            serialMs / ms,
+            mismatches);
+    }
+}
+
+// ============== pipeline creation =====================
+
+// the smallest shaders a pipeline can be made from, as SPIR-V so the benchmark doesn't depend on
+// the shader compiler or the engine's shader directory. The vertex shader writes a constant
+// position and point size, the fragment shader a constant colour
+// clang-format off
+constexpr uint32_t BenchVertexSpirv[] = {
+    0x07230203, 0x00010000, 0x00000000, 14, 0x00000000,
+    0x00020011, 1,                                          // OpCapability Shader
+    0x0003000e, 0, 1,                                       // OpMemoryModel Logical GLSL450
+    0x0007000f, 0, 12, 0x6e69616d, 0x00000000, 6, 8,        // OpEntryPoint Vertex "main"
+    0x00040047, 6, 11, 0,                                   // OpDecorate BuiltIn Position
+    0x00040047, 8, 11, 1,                                   // OpDecorate BuiltIn PointSize
+    0x00020013, 1,                                          // OpTypeVoid
+    0x00030021, 2, 1,                                       // OpTypeFunction
+    0x00030016, 3, 32,                                      // OpTypeFloat 32
+    0x00040017, 4, 3, 4,                                    // OpTypeVector 4
+    0x00040020, 5, 3, 4,                                    // OpTypePointer Output vec4
+    0x0004003b, 5, 6, 3,                                    // OpVariable Output
+    0x00040020, 7, 3, 3,                                    // OpTypePointer Output float
+    0x0004003b, 7, 8, 3,                                    // OpVariable Output
+    0x0004002b, 3, 9, 0x00000000,                           // OpConstant 0.0
+    0x0004002b, 3, 10, 0x3f800000,                          // OpConstant 1.0
+    0x0007002c, 4, 11, 9, 9, 9, 10,                         // OpConstantComposite
+    0x00050036, 1, 12, 0, 2,                                // OpFunction
+    0x000200f8, 13,                                         // OpLabel
+    0x0003003e, 6, 11,                                      // OpStore position
+    0x0003003e, 8, 10,                                      // OpStore point size
+    0x000100fd,                                             // OpReturn
+    0x00010038,                                             // OpFunctionEnd
+};
+constexpr uint32_t BenchFragmentSpirv[] = {
+    0x07230203, 0x00010000, 0x00000000, 11, 0x00000000,
+    0x00020011, 1,                                          // OpCapability Shader
+    0x0003000e, 0, 1,                                       // OpMemoryModel Logical GLSL450
+    0x0006000f, 4, 9, 0x6e69616d, 0x00000000, 6,            // OpEntryPoint Fragment "main"
+    0x00030010, 9, 7,                                       // OpExecutionMode OriginUpperLeft
+    0x00040047, 6, 30, 0,                                   // OpDecorate Location 0
+    0x00020013, 1,                                          // OpTypeVoid
+    0x00030021, 2, 1,                                       // OpTypeFunction
+    0x00030016, 3, 32,                                      // OpTypeFloat 32
+    0x00040017, 4, 3, 4,                                    // OpTypeVector 4
+    0x00040020, 5, 3, 4,                                    // OpTypePointer Output vec4
+    0x0004003b, 5, 6, 3,                                    // OpVariable Output
+    0x0004002b, 3, 7, 0x3f800000,                           // OpConstant 1.0
+    0x0007002c, 4, 8, 7, 7, 7, 7,                           // OpConstantComposite
+    0x00050036, 1, 9, 0, 2,                                 // OpFunction
+    0x000200f8, 10,                                         // OpLabel
+    0x0003003e, 6, 8,                                       // OpStore colour
+    0x000100fd,                                             // OpReturn
+    0x00010038,                                             // OpFunctionEnd
+};
+// clang-format on
+
+/// the variants of the fixed function state the renderer switches between
+std::vector<VulkanAPI::PipelineDesc> createBenchPipelineDescs(
+    vk::ShaderModule vertex,
+    vk::ShaderModule fragment,
+    vk::PipelineLayout layout,
+    vk::RenderPass pass)
+{
+    const vk::PrimitiveTopology topologies[] = {
+        vk::PrimitiveTopology::ePointList,
+        vk::PrimitiveTopology::eLineList,
+        vk::PrimitiveTopology::eTriangleList};
+    const vk::CullModeFlags cullModes[] = {
+        vk::CullModeFlagBits::eNone, vk::CullModeFlagBits::eBack, vk::CullModeFlagBits::eFront};
+    const vk::FrontFace frontFaces[] = {
+        vk::FrontFace::eCounterClockwise, vk::FrontFace::eClockwise};
+
+    std::vector<VulkanAPI::PipelineDesc> descs;
+    for (const vk::PrimitiveTopology topology : topologies)
+    {
+        for (const vk::CullModeFlags& cullMode : cullModes)
+        {
+            for (const vk::FrontFace frontFace : frontFaces)
+            {
+                for (const bool blend : {false, true})
+                {
+                    VulkanAPI::PipelineDesc desc;
+                    desc.stages = {
+                        {vk::ShaderStageFlagBits::eVertex, vertex, "main"},
+                        {vk::ShaderStageFlagBits::eFragment, fragment, "main"}};
+                    desc.topology = topology;
+                    desc.cullMode = cullMode;
+                    desc.frontFace = frontFace;
+
+                    vk::PipelineColorBlendAttachmentState colour;
+                    colour.colorWriteMask = vk::ColorComponentFlagBits::eR |
+                        vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB |
+                        vk::ColorComponentFlagBits::eA;
+                    colour.blendEnable = blend;
+                    colour.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+                    colour.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+                    desc.colourAttachs = {colour};
+
+                    desc.width = 64;
+                    desc.height = 64;
+                    desc.layout = layout;
+                    desc.renderpass = pass;
+                    descs.emplace_back(std::move(desc));
+                }
+            }
+        }
+    }
+    return descs;
+}
+
+void benchPipelines()
+{
+    VulkanAPI::VkContext context;
+    if (!context.createInstance(nullptr, 0) || !context.prepareDevice(vk::SurfaceKHR {}))
+    {
+        LOGGER_ERROR("The pipeline benchmark needs a Vulkan device.");
+        return;
+    }
+
+    {
+        // the final pass of an offscreen target is enough to build pipelines against
+        VulkanAPI::OffscreenTarget target {context};
+        if (!target.prepare(64, 64, vk::Format::eR8G8B8A8Unorm, 1))
+        {
+            return;
+        }
+
+        vk::ShaderModuleCreateInfo vertexInfo({}, sizeof(BenchVertexSpirv), BenchVertexSpirv);
+        vk::ShaderModuleCreateInfo fragmentInfo(
+            {}, sizeof(BenchFragmentSpirv), BenchFragmentSpirv);
+        vk::ShaderModule vertex = context.device.createShaderModule(vertexInfo);
+        vk::ShaderModule fragment = context.device.createShaderModule(fragmentInfo);
+        vk::PipelineLayout layout = context.device.createPipelineLayout({});
+        const std::vector<VulkanAPI::PipelineDesc> descs =
+            createBenchPipelineDescs(vertex, fragment, layout, target.getRenderPass());
+
+        // a directory of its own, so the first run always starts with an empty cache. Drivers
+        // with their own on-disk shader cache (i.e. Mesa) will still make the cold run look
+        // better than a first launch
+        namespace fs = std::filesystem;
+        const std::string cacheDir = "pcv-bench-pipelines";
+        fs::remove_all(cacheDir);
+        fs::create_directories(cacheDir);
+
+        LOGGER_INFO("%zu pipelines:", descs.size());
+        for (const char* run : {"empty", "warm"})
+        {
+            // the cache is saved by destroy, so the second run loads what the first compiled
+            if (!context.pipelineCache.prepare(context.device, context.physical, cacheDir))
+            {
+                break;
+            }
+
+            Timer timer;
+            VulkanAPI::PipelineRegistry registry {context};
+            size_t failed = 0;
+            for (const VulkanAPI::PipelineDesc& desc : descs)
+            {
+                failed += !registry.get(desc);
+            }
+            const double ms = timer.getElapsedSeconds() * 1000.0;
+
+            const VulkanAPI::PipelineCache::Stats stats = context.pipelineCache.getStats();
+            LOGGER_INFO(
+                "  %s cache: %8.2fms, %6.3fms per pipeline, %zu bytes loaded, %zu failed",
+                run,
+                ms,
+                ms / static_cast<double>(descs.size()),
+                stats.loadedBytes,
+                failed);
+
+            registry.destroy();
+            context.pipelineCache.destroy();
+        }
+        fs::remove_all(cacheDir);
+
+        context.device.destroyPipelineLayout(layout);
+        context.device.destroyShaderModule(fragment);
+        context.device.destroyShaderModule(vertex);
+    }
+    context.device.waitIdle();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<size_t> counts;
+    for (int i = 2; i < argc; ++i)
+    {
+        counts.emplace_back(strtoull(argv[i], nullptr, 10));
+    }
+
+    if (!strcmp(argv[1], "morton"))
+    {
+        if (counts.empty())
+        {
+            counts = {10'000'000, 100'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchMorton(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "queue"))
+    {
+        if (counts.empty())
+        {
+            counts = {1'000, 10'000, 100'000};
+        }
+        for (size_t count : counts)
+        {
+            benchQueue(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "frame"))
+    {
+        if (counts.empty())
+        {
+            counts = {10'000};
+        }
+        for (size_t count : counts)
+        {
+            benchFrame(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "overdraw"))
+    {
+        if (counts.empty())
+        {
+            counts = {2'000};
+        }
+        for (size_t count : counts)
+        {
+            benchOverdraw(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "jobs"))
+    {
+        if (counts.empty())
+        {
+            counts = getDefaultThreadCounts();
+        }
+        benchJobs(counts);
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "mat4"))
+    {
+        if (counts.empty())
+        {
+            counts = {10'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchMat4(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "transform"))
+    {
+        if (counts.empty())
+        {
+            counts = {10'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchTransform(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "copy"))
+    {
+        if (counts.empty())
+        {
+            counts = {10'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchCopy(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "cull"))
+    {
+        if (counts.empty())
+        {
+            counts = {100'000};
+        }
+        for (size_t count : counts)
+        {
+            benchCull(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "laz"))
+    {
+        if (argc < 3)
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        // the first argument is the file, not a count
+        counts.erase(counts.begin());
+        if (counts.empty())
+        {
+            counts = getDefaultThreadCounts();
+        }
+        benchLaz(argv[2], counts);
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "lod"))
+    {
+        if (argc < 3)
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        // the first argument is the octree directory, not a count
+        counts.erase(counts.begin());
+        if (counts.empty())
+        {
+            counts = getDefaultThreadCounts();
+        }
+        benchLod(argv[2], counts);
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "text"))
+    {
+        if (counts.empty())
+        {
+            counts = {100'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchText(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "pipeline"))
+    {
+        benchPipelines();
+        return EXIT_SUCCESS;
+    }
+
+    if (!strcmp(argv[1], "pcd"))
+    {
+        if (counts.empty())
+        {
+            counts = {5'000'000};
+        }
+        for (size_t count : counts)
+        {
+            benchPcd(count);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    printUsage();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,91 @@
+#include "Octree/OctreeConverter.h"
+
+#include "Utility/Logger.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+
+void printUsage()
+{
+    printf(
+        "Usage: pcv-convert -o <output dir> [options] <input files...>\n"
+        "Options:\n"
+        "  -o, --output <dir>     directory the octree is written to\n"
+        "  -m, --memory <MB>      approximate memory budget (default 4096)\n"
+        "  -t, --threads <count>  indexing threads (default all hardware threads)\n"
+        "  -l, --leaf-size <n>    maximum points of a leaf node (default 20000)\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    PCV::OctreeConverter::Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        auto isOption = [arg](const char* shortName, const char* longName) {
+            return !strcmp(arg, shortName) || !strcmp(arg, longName);
+        };
+
+        if (isOption("-h", "--help"))
+        {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+
+        // all other options are followed by a value
+        if (arg[0] == '-')
+        {
+            if (i + 1 >= argc)
+            {
+                LOGGER_ERROR("Missing value for option %s.", arg);
+                return EXIT_FAILURE;
+            }
+            const char* value = argv[++i];
+
+            if (isOption("-o", "--output"))
+            {
+                options.outputDir = value;
+            }
+            else if (isOption("-m", "--memory"))
+            {
+                options.memoryBudget = strtoull(value, nullptr, 10) << 20;
+            }
+            else if (isOption("-t", "--threads"))
+            {
+                options.threadCount = strtoull(value, nullptr, 10);
+            }
+            else if (isOption("-l", "--leaf-size"))
+            {
+                options.maxLeafPoints = strtoull(value, nullptr, 10);
+            }
+            else
+            {
+                LOGGER_ERROR("Unknown option %s.", arg);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        options.inputs.emplace_back(arg);
+    }
+
+    if (options.outputDir.empty() || options.inputs.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (options.memoryBudget == 0 || options.maxLeafPoints == 0)
+    {
+        LOGGER_ERROR("The memory budget and leaf size must be greater than zero.");
+        return EXIT_FAILURE;
+    }
+
+    PCV::OctreeConverter converter {options};
+    return converter.run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
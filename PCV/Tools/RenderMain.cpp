@@ -0,0 +1,333 @@
+#include "Core/Frustum.h"
+#include "Core/PointCloud.h"
+#include "Loaders/PointLoader.h"
+#include "Maths/transform.h"
+#include "Octree/LodSelector.h"
+#include "Octree/OctreeFile.h"
+#include "Rendering/SoftRasteriser.h"
+#include "Threading/JobSystem.h"
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sys/stat.h>
+#include <vector>
+
+namespace
+{
+
+void printUsage()
+{
+    printf(
+        "Usage: pcv-render -o <image> [options] <octree dirs or point cloud files...>\n"
+        "Renders a preview on the CPU, without a GPU or display. The image is written as a png\n"
+        "or ppm depending on its extension.\n"
+        "Options:\n"
+        "  -o, --output <image>    the image to write\n"
+        "  -w, --width <pixels>    image width (default 1280)\n"
+        "  -h, --height <pixels>   image height (default 720)\n"
+        "  -p, --point-size <n>    width of the square drawn for each point (default 1)\n"
+        "  -b, --budget <points>   octree point budget (default 5000000)\n"
+        "  -t, --threads <count>   rasterising threads (default all hardware threads)\n"
+        "  -y, --yaw <degrees>     camera angle around the vertical axis (default 45)\n"
+        "  -e, --elevation <deg>   camera angle above the horizon (default 30)\n"
+        "  -f, --frames <count>    render the frame repeatedly, reporting the best (default 1)\n");
+}
+
+struct Options
+{
+    const char* output = nullptr;
+    PCV::SoftRasteriser::Options raster;
+    size_t pointBudget = 5'000'000;
+    size_t threadCount = 0;
+    float yaw = 45.0f;
+    float elevation = 30.0f;
+    size_t frames = 1;
+    std::vector<const char*> inputs;
+};
+
+bool isDirectory(const char* path)
+{
+    struct stat info;
+    return stat(path, &info) == 0 && (info.st_mode & S_IFDIR);
+}
+
+/// a view matrix for a camera at the position looking along the direction, with z up
+OEMaths::mat4f createView(const OEMaths::vec3f& position, const OEMaths::vec3f& dir)
+{
+    const OEMaths::vec3f forward = OEMaths::normalise(dir);
+    const OEMaths::vec3f right =
+        OEMaths::normalise(OEMaths::vec3f::cross(OEMaths::vec3f {0.0f, 0.0f, 1.0f}, forward));
+    const OEMaths::vec3f up = OEMaths::vec3f::cross(forward, right);
+
+    // the axes are the rows of the rotation, the matrix is column major
+    OEMaths::mat4f view;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        view[i][0] = right[i];
+        view[i][1] = up[i];
+        view[i][2] = forward[i];
+    }
+    view[3][0] = -OEMaths::dot(right, position);
+    view[3][1] = -OEMaths::dot(up, position);
+    view[3][2] = -OEMaths::dot(forward, position);
+    return view;
+}
+
+int render(const Options& options)
+{
+    PCV::JobSystem jobs {options.threadCount};
+
+    // ========= inputs ====================================
+    // octrees are drawn through the LOD selection, as by the Vulkan renderer, while point clouds
+    // are drawn in full. All are rebased to the origin of the first input.
+    std::vector<PCV::LodSelector::Instance> octrees;
+    std::vector<std::unique_ptr<PCV::PointCloud>> clouds;
+    std::vector<OEMaths::vec3f> cloudOffsets;
+    OEMaths::vec3d worldOrigin;
+    bool hasOrigin = false;
+    PCV::AABBox worldBounds;
+    uint32_t nextBaseId = 0;
+
+    auto getOffset = [&](const OEMaths::vec3d& origin) {
+        if (!hasOrigin)
+        {
+            worldOrigin = origin;
+            hasOrigin = true;
+        }
+        return OEMaths::vec3f {
+            static_cast<float>(origin.x - worldOrigin.x),
+            static_cast<float>(origin.y - worldOrigin.y),
+            static_cast<float>(origin.z - worldOrigin.z)};
+    };
+
+    for (const char* input : options.inputs)
+    {
+        if (isDirectory(input))
+        {
+            auto file = std::make_shared<PCV::OctreeFile>();
+            if (!file->open(input))
+            {
+                return EXIT_FAILURE;
+            }
+            const PCV::Octree::HierarchyHeader& header = file->getHeader();
+
+            PCV::LodSelector::Instance instance;
+            instance.offset =
+                getOffset(OEMaths::vec3d {header.origin[0], header.origin[1], header.origin[2]});
+            instance.baseId = nextBaseId;
+            nextBaseId += static_cast<uint32_t>(file->getNodes().size());
+            worldBounds.extend(
+                header.boundsMin[0] + instance.offset.x,
+                header.boundsMin[1] + instance.offset.y,
+                header.boundsMin[2] + instance.offset.z);
+            worldBounds.extend(
+                header.boundsMax[0] + instance.offset.x,
+                header.boundsMax[1] + instance.offset.y,
+                header.boundsMax[2] + instance.offset.z);
+            instance.file = std::move(file);
+            octrees.emplace_back(std::move(instance));
+            continue;
+        }
+
+        PCV::LoadStats loadStats;
+        std::unique_ptr<PCV::PointCloud> cloud = PCV::loadPointCloud(input, loadStats);
+        if (!cloud)
+        {
+            return EXIT_FAILURE;
+        }
+        PCV::logLoadStats(input, loadStats);
+
+        const OEMaths::vec3f offset = getOffset(cloud->getOrigin());
+        worldBounds.extend(PCV::AABBox {
+            cloud->getBounds().min + offset, cloud->getBounds().max + offset});
+        cloudOffsets.emplace_back(offset);
+        clouds.emplace_back(std::move(cloud));
+    }
+
+    if (!worldBounds.isValid())
+    {
+        LOGGER_ERROR("The inputs contain no points.");
+        return EXIT_FAILURE;
+    }
+
+    // ========= camera ====================================
+    // orbits the centre of the inputs, far enough away that the bounding sphere fits the view
+    constexpr float Fov = 40.0f;
+    const float aspect =
+        static_cast<float>(options.raster.width) / static_cast<float>(options.raster.height);
+    const OEMaths::vec3f centre = worldBounds.getCentre();
+    const float radius = std::max(OEMaths::length(worldBounds.max - centre), 1.0e-3f);
+    const float distance = radius / std::sin(OEMaths::radians(Fov) * 0.5f);
+
+    const float yaw = OEMaths::radians(options.yaw);
+    const float elevation = OEMaths::radians(options.elevation);
+    const OEMaths::vec3f dir {
+        -std::cos(elevation) * std::cos(yaw),
+        -std::cos(elevation) * std::sin(yaw),
+        -std::sin(elevation)};
+    const OEMaths::vec3f position = centre - dir * distance;
+
+    const OEMaths::mat4f viewProj =
+        OEMaths::perspective(Fov, aspect, distance * 0.01f, distance + radius * 2.0f) *
+        createView(position, dir);
+
+    PCV::Frustum frustum;
+    frustum.projection(viewProj);
+
+    PCV::LodSelector::View view;
+    view.frustum = &frustum;
+    view.position = position;
+    view.fov = Fov;
+    view.viewportHeight = static_cast<float>(options.raster.height);
+
+    // ========= render ====================================
+    PCV::LodSelector selector {PCV::LodSelector::Options {}};
+    selector.setPointBudget(options.pointBudget);
+    PCV::SoftRasteriser rasteriser {options.raster};
+    std::vector<uint32_t> nodes;
+
+    double bestSelectSeconds = 0.0;
+    PCV::SoftRasteriser::Stats bestStats;
+    for (size_t frame = 0; frame < options.frames; ++frame)
+    {
+        rasteriser.clear();
+
+        Util::Timer<Util::NanoSeconds> timer;
+        nodes.clear();
+        if (!octrees.empty())
+        {
+            selector.select(octrees, view, nodes, jobs);
+        }
+        const double selectSeconds = timer.getElapsedSeconds();
+
+        rasteriser.drawNodes(octrees, nodes, viewProj, jobs);
+        for (size_t i = 0; i < clouds.size(); ++i)
+        {
+            rasteriser.drawCloud(
+                *clouds[i], viewProj * OEMaths::mat4f::translate(cloudOffsets[i]), jobs);
+        }
+
+        const PCV::SoftRasteriser::Stats& stats = rasteriser.getStats();
+        if (frame == 0 || stats.rasterSeconds < bestStats.rasterSeconds)
+        {
+            bestStats = stats;
+            bestSelectSeconds = selectSeconds;
+        }
+    }
+
+    if (!rasteriser.writeImage(options.output))
+    {
+        return EXIT_FAILURE;
+    }
+
+    LOGGER_INFO(
+        "Rendered %ux%u with %zu threads: %zu octree nodes selected in %.2fms",
+        options.raster.width,
+        options.raster.height,
+        jobs.getThreadCount(),
+        nodes.size(),
+        bestSelectSeconds * 1000.0);
+    LOGGER_INFO(
+        "  %zu points, %zu rasterised in %.2fms - %.1fM points/s",
+        bestStats.submittedPoints,
+        bestStats.rasterisedPoints,
+        bestStats.rasterSeconds * 1000.0,
+        bestStats.getPointsPerSecond() / 1.0e6);
+    return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        auto isOption = [arg](const char* shortName, const char* longName) {
+            return !strcmp(arg, shortName) || !strcmp(arg, longName);
+        };
+
+        if (!strcmp(arg, "--help"))
+        {
+            printUsage();
+            return EXIT_SUCCESS;
+        }
+
+        // all other options are followed by a value
+        if (arg[0] == '-')
+        {
+            if (i + 1 >= argc)
+            {
+                LOGGER_ERROR("Missing value for option %s.", arg);
+                return EXIT_FAILURE;
+            }
+            const char* value = argv[++i];
+
+            if (isOption("-o", "--output"))
+            {
+                options.output = value;
+            }
+            else if (isOption("-w", "--width"))
+            {
+                options.raster.width = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            }
+            else if (isOption("-h", "--height"))
+            {
+                options.raster.height = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            }
+            else if (isOption("-p", "--point-size"))
+            {
+                options.raster.pointSize = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            }
+            else if (isOption("-b", "--budget"))
+            {
+                options.pointBudget = strtoull(value, nullptr, 10);
+            }
+            else if (isOption("-t", "--threads"))
+            {
+                options.threadCount = strtoull(value, nullptr, 10);
+            }
+            else if (isOption("-y", "--yaw"))
+            {
+                options.yaw = strtof(value, nullptr);
+            }
+            else if (isOption("-e", "--elevation"))
+            {
+                options.elevation = strtof(value, nullptr);
+            }
+            else if (isOption("-f", "--frames"))
+            {
+                options.frames = strtoull(value, nullptr, 10);
+            }
+            else
+            {
+                LOGGER_ERROR("Unknown option %s.", arg);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        options.inputs.emplace_back(arg);
+    }
+
+    if (!options.output || options.inputs.empty())
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+    if (options.raster.width == 0 || options.raster.height == 0 || options.raster.pointSize == 0 ||
+        options.frames == 0)
+    {
+        LOGGER_ERROR("The image size, point size and frame count must be greater than zero.");
+        return EXIT_FAILURE;
+    }
+
+    return render(options);
+}
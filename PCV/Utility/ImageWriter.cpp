@@ -0,0 +1,140 @@
+#include "ImageWriter.h"
+
+#include "Utility/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace Util
+{
+
+namespace
+{
+
+// the CRC-32 used by PNG chunks
+uint32_t crc32(const uint8_t* data, const size_t size, uint32_t crc = 0)
+{
+    static const std::vector<uint32_t> table = []() {
+        std::vector<uint32_t> entries(256);
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t value = i;
+            for (uint32_t bit = 0; bit < 8; ++bit)
+            {
+                value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, const uint32_t value)
+{
+    out.emplace_back(static_cast<uint8_t>(value >> 24));
+    out.emplace_back(static_cast<uint8_t>(value >> 16));
+    out.emplace_back(static_cast<uint8_t>(value >> 8));
+    out.emplace_back(static_cast<uint8_t>(value));
+}
+
+void appendChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+{
+    appendBigEndian(out, static_cast<uint32_t>(data.size()));
+    const size_t typeOffset = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBigEndian(out, crc32(out.data() + typeOffset, data.size() + 4));
+}
+
+bool writeFile(const char* path, const uint8_t* data, const size_t size)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        LOGGER_ERROR("Unable to open %s for writing.", path);
+        return false;
+    }
+
+    const bool written = fwrite(data, 1, size, file) == size;
+    fclose(file);
+    if (!written)
+    {
+        LOGGER_ERROR("Unable to write image %s.", path);
+    }
+    return written;
+}
+
+} // namespace
+
+bool writePpm(const char* path, const uint32_t width, const uint32_t height, const uint8_t* rgb)
+{
+    char header[64];
+    const int headerSize = snprintf(header, sizeof(header), "P6\n%u %u\n255\n", width, height);
+
+    std::vector<uint8_t> out(header, header + headerSize);
+    out.insert(out.end(), rgb, rgb + size_t(width) * height * 3);
+    return writeFile(path, out.data(), out.size());
+}
+
+bool writePng(const char* path, const uint32_t width, const uint32_t height, const uint8_t* rgb)
+{
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    std::vector<uint8_t> out(signature, signature + 8);
+
+    // 8-bit RGB, no interlacing
+    std::vector<uint8_t> ihdr;
+    appendBigEndian(ihdr, width);
+    appendBigEndian(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});
+    appendChunk(out, "IHDR", ihdr);
+
+    // each row is preceded by its filter type, none
+    const size_t rowSize = size_t(width) * 3;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        raw.emplace_back(0);
+        raw.insert(raw.end(), rgb + y * rowSize, rgb + (y + 1) * rowSize);
+    }
+
+    // a zlib stream of stored deflate blocks, which hold at most 64k each
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    size_t offset = 0;
+    do
+    {
+        const size_t blockSize = std::min<size_t>(raw.size() - offset, 0xffff);
+        const bool last = offset + blockSize == raw.size();
+        idat.emplace_back(last ? 1 : 0);
+        idat.emplace_back(static_cast<uint8_t>(blockSize));
+        idat.emplace_back(static_cast<uint8_t>(blockSize >> 8));
+        idat.emplace_back(static_cast<uint8_t>(~blockSize));
+        idat.emplace_back(static_cast<uint8_t>(~blockSize >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    // the adler-32 checksum of the uncompressed data
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (const uint8_t byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(idat, (b << 16) | a);
+    appendChunk(out, "IDAT", idat);
+
+    appendChunk(out, "IEND", {});
+    return writeFile(path, out.data(), out.size());
+}
+
+} // namespace Util
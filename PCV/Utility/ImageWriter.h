@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util
+{
+
+/**
+ * @brief Writes an 8-bit RGB image as a binary PPM.
+ * @param rgb The pixels, three bytes each, row by row from the top of the image
+ */
+bool writePpm(const char* path, const uint32_t width, const uint32_t height, const uint8_t* rgb);
+
+/**
+ * @brief Writes an 8-bit RGB image as a PNG. The image data is stored without compression, so
+ * no zlib dependency is needed - previews are small enough that the file size doesn't matter.
+ * @param rgb The pixels, three bytes each, row by row from the top of the image
+ */
+bool writePng(const char* path, const uint32_t width, const uint32_t height, const uint8_t* rgb);
+
+} // namespace Util
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdio>
+
+// very simple logging - everything goes to the console for now
+#define LOGGER_INFO(...)                                                                           \
+    {                                                                                              \
+        printf("Info: ");                                                                          \
+        printf(__VA_ARGS__);                                                                       \
+        printf("\n");                                                                              \
+    }
+
+#define LOGGER_WARN(...)                                                                           \
+    {                                                                                              \
+        printf("Warning: ");                                                                       \
+        printf(__VA_ARGS__);                                                                       \
+        printf("\n");                                                                              \
+    }
+
+#define LOGGER_ERROR(...)                                                                          \
+    {                                                                                              \
+        fprintf(stderr, "Error: ");                                                                \
+        fprintf(stderr, __VA_ARGS__);                                                              \
+        fprintf(stderr, "\n");                                                                     \
+    }
@@ -0,0 +1,279 @@
+#include "Lzf.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Util
+{
+
+namespace
+{
+
+// back references are limited to 8KB behind the current output and 264 bytes long
+constexpr size_t MaxDistance = 1 << 13;
+constexpr size_t MaxRefLength = 7 + 255 + 2;
+constexpr size_t MaxLiteralRun = 1 << 5;
+
+constexpr size_t HashBits = 14;
+
+/**
+ * Tracks the output position across the segments. The current segment is written through a
+ * pointer, so only the copies which cross a segment boundary take the slow byte by byte path.
+ */
+class SegmentWriter
+{
+public:
+    SegmentWriter(const LzfSegment* outputs, const size_t outputCount)
+        : segments(outputs)
+        , count(outputCount)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += segments[i].size;
+        }
+        enterSegment();
+    }
+
+    /// the output bytes still available
+    size_t remaining() const
+    {
+        return total - pos;
+    }
+
+    size_t position() const
+    {
+        return pos;
+    }
+
+    void writeLiterals(const uint8_t* src, const size_t len)
+    {
+        if (len <= static_cast<size_t>(end - op))
+        {
+            std::memcpy(op, src, len);
+            op += len;
+            pos += len;
+            return;
+        }
+        for (size_t i = 0; i < len; ++i)
+        {
+            writeByte(src[i]);
+        }
+    }
+
+    void copyReference(const size_t distance, const size_t len)
+    {
+        // the common case is a reference within the current segment
+        if (len <= static_cast<size_t>(end - op) && distance <= static_cast<size_t>(op - begin))
+        {
+            const uint8_t* ref = op - distance;
+            if (distance >= len)
+            {
+                // the regions don't overlap so can be copied in one go
+                std::memcpy(op, ref, len);
+                op += len;
+            }
+            else
+            {
+                // overlapping references repeat the last **distance** bytes
+                for (size_t i = 0; i < len; ++i)
+                {
+                    *op++ = *ref++;
+                }
+            }
+            pos += len;
+            return;
+        }
+        for (size_t i = 0; i < len; ++i)
+        {
+            writeByte(*locate(pos - distance));
+        }
+    }
+
+private:
+    void enterSegment()
+    {
+        // skip any empty segments
+        while (index < count && segments[index].size == 0)
+        {
+            ++index;
+        }
+        if (index < count)
+        {
+            begin = op = segments[index].data;
+            end = begin + segments[index].size;
+        }
+        else
+        {
+            begin = op = end = nullptr;
+        }
+    }
+
+    void writeByte(const uint8_t value)
+    {
+        if (op == end)
+        {
+            segmentStart += segments[index].size;
+            ++index;
+            enterSegment();
+        }
+        *op++ = value;
+        ++pos;
+    }
+
+    /// the address of an earlier output position - at most 8KB back, so only a few segments away
+    const uint8_t* locate(const size_t target) const
+    {
+        size_t i = index;
+        size_t start = segmentStart;
+        while (target < start)
+        {
+            --i;
+            start -= segments[i].size;
+        }
+        return segments[i].data + (target - start);
+    }
+
+private:
+    const LzfSegment* segments;
+    const size_t count;
+    size_t total = 0;
+
+    /// the current segment and its start within the whole output
+    size_t index = 0;
+    size_t segmentStart = 0;
+
+    uint8_t* begin = nullptr;
+    uint8_t* op = nullptr;
+    uint8_t* end = nullptr;
+
+    size_t pos = 0;
+};
+
+} // namespace
+
+size_t lzfDecompress(const uint8_t* src, const size_t srcSize, uint8_t* dst, const size_t dstSize)
+{
+    LzfSegment segment;
+    segment.data = dst;
+    segment.size = dstSize;
+    return lzfDecompress(src, srcSize, &segment, 1);
+}
+
+size_t lzfDecompress(
+    const uint8_t* src,
+    const size_t srcSize,
+    const LzfSegment* segments,
+    const size_t segmentCount)
+{
+    const uint8_t* ip = src;
+    const uint8_t* inEnd = src + srcSize;
+    SegmentWriter writer {segments, segmentCount};
+
+    while (ip < inEnd)
+    {
+        size_t ctrl = *ip++;
+
+        // literal run of 1 - 32 bytes
+        if (ctrl < (1 << 5))
+        {
+            ++ctrl;
+            if (ctrl > writer.remaining() || ctrl > static_cast<size_t>(inEnd - ip))
+            {
+                return 0;
+            }
+            writer.writeLiterals(ip, ctrl);
+            ip += ctrl;
+            continue;
+        }
+
+        // back reference - the length is stored in the upper three bits, extended by a further
+        // byte if all are set
+        size_t len = ctrl >> 5;
+        if (ip >= inEnd)
+        {
+            return 0;
+        }
+        if (len == 7)
+        {
+            len += *ip++;
+            if (ip >= inEnd)
+            {
+                return 0;
+            }
+        }
+        const size_t distance = ((ctrl & 0x1f) << 8) + *ip++ + 1;
+        len += 2;
+
+        if (distance > writer.position() || len > writer.remaining())
+        {
+            return 0;
+        }
+        writer.copyReference(distance, len);
+    }
+
+    return writer.position();
+}
+
+size_t lzfCompress(const uint8_t* src, const size_t srcSize, std::vector<uint8_t>& dst)
+{
+    const size_t startSize = dst.size();
+
+    // the most recent position of each hashed three byte sequence
+    std::vector<size_t> table(size_t(1) << HashBits, SIZE_MAX);
+
+    size_t literalStart = 0;
+    auto flushLiterals = [&](const size_t literalEnd) {
+        while (literalStart < literalEnd)
+        {
+            const size_t len = std::min(MaxLiteralRun, literalEnd - literalStart);
+            dst.push_back(static_cast<uint8_t>(len - 1));
+            dst.insert(dst.end(), src + literalStart, src + literalStart + len);
+            literalStart += len;
+        }
+    };
+
+    size_t ip = 0;
+    while (ip + 2 < srcSize)
+    {
+        const uint32_t sequence = (uint32_t(src[ip]) << 16) | (uint32_t(src[ip + 1]) << 8) |
+            uint32_t(src[ip + 2]);
+        const size_t hash = ((sequence * 2654435761u) >> (32 - HashBits)) & ((1 << HashBits) - 1);
+        const size_t ref = table[hash];
+        table[hash] = ip;
+
+        if (ref == SIZE_MAX || ip - ref > MaxDistance || std::memcmp(src + ref, src + ip, 3) != 0)
+        {
+            ++ip;
+            continue;
+        }
+
+        const size_t maxLen = std::min(MaxRefLength, srcSize - ip);
+        size_t len = 3;
+        while (len < maxLen && src[ref + len] == src[ip + len])
+        {
+            ++len;
+        }
+
+        flushLiterals(ip);
+        const size_t offset = ip - ref - 1;
+        const size_t storedLen = len - 2;
+        if (storedLen < 7)
+        {
+            dst.push_back(static_cast<uint8_t>((storedLen << 5) | (offset >> 8)));
+        }
+        else
+        {
+            dst.push_back(static_cast<uint8_t>((7 << 5) | (offset >> 8)));
+            dst.push_back(static_cast<uint8_t>(storedLen - 7));
+        }
+        dst.push_back(static_cast<uint8_t>(offset));
+
+        ip += len;
+        literalStart = ip;
+    }
+    flushLiterals(srcSize);
+
+    return dst.size() - startSize;
+}
+
+} // namespace Util
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Util
+{
+
+/// a contiguous part of the output of **lzfDecompress**
+struct LzfSegment
+{
+    uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Decompresses a block of LZF compressed data (as used by the binary_compressed PCD
+ * encoding). The output must be large enough to hold the decompressed data.
+ * @param src The compressed data
+ * @param srcSize The size of the compressed data in bytes
+ * @param dst The buffer to decompress into
+ * @param dstSize The size of the output buffer in bytes
+ * @return The number of bytes written to **dst**, or zero if the data is corrupt or the output
+ * buffer is too small
+ */
+size_t lzfDecompress(const uint8_t* src, const size_t srcSize, uint8_t* dst, const size_t dstSize);
+
+/**
+ * @brief Decompresses a block of LZF compressed data into a list of separate buffers, which are
+ * treated as one contiguous output in the order given. This allows a block made up of several
+ * arrays to be decompressed straight into the arrays' final destinations.
+ * @param segments The output buffers. Empty segments are allowed.
+ * @param segmentCount The number of output buffers
+ * @return The total number of bytes written, or zero if the data is corrupt or the output is too
+ * small
+ */
+size_t lzfDecompress(
+    const uint8_t* src,
+    const size_t srcSize,
+    const LzfSegment* segments,
+    const size_t segmentCount);
+
+/**
+ * @brief Compresses data with LZF, appending the result to **dst**. Used when writing
+ * binary_compressed PCD files.
+ * @return The number of bytes appended
+ */
+size_t lzfCompress(const uint8_t* src, const size_t srcSize, std::vector<uint8_t>& dst);
+
+} // namespace Util
@@ -0,0 +1,156 @@
+#include "MappedFile.h"
+
+#include "Utility/Logger.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Util
+{
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+    HANDLE file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LOGGER_ERROR("Unable to open file %s.", path);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        LOGGER_ERROR("File %s is empty or its size could not be determined.", path);
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!map)
+    {
+        LOGGER_ERROR("Unable to create a file mapping for %s.", path);
+        CloseHandle(file);
+        return false;
+    }
+
+    void* ptr = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr)
+    {
+        LOGGER_ERROR("Unable to map a view of file %s.", path);
+        CloseHandle(map);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mapHandle = map;
+    mapped = static_cast<const uint8_t*>(ptr);
+    fileSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mapped)
+    {
+        UnmapViewOfFile(mapped);
+        mapped = nullptr;
+    }
+    if (mapHandle)
+    {
+        CloseHandle(mapHandle);
+        mapHandle = nullptr;
+    }
+    if (fileHandle)
+    {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+    fileSize = 0;
+}
+
+void MappedFile::adviseSequential()
+{
+    // the sequential scan flag is set when the file is opened
+}
+
+#else
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        LOGGER_ERROR("Unable to open file %s.", path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        LOGGER_ERROR("File %s is empty or its size could not be determined.", path);
+        ::close(fd);
+        return false;
+    }
+
+    void* ptr = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        LOGGER_ERROR("Unable to memory map file %s.", path);
+        return false;
+    }
+
+    mapped = static_cast<const uint8_t*>(ptr);
+    fileSize = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mapped)
+    {
+        munmap(const_cast<uint8_t*>(mapped), fileSize);
+        mapped = nullptr;
+    }
+    fileSize = 0;
+}
+
+void MappedFile::adviseSequential()
+{
+    if (mapped)
+    {
+        madvise(const_cast<uint8_t*>(mapped), fileSize, MADV_SEQUENTIAL);
+    }
+}
+
+#endif
+
+} // namespace Util
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util
+{
+
+/**
+ * @brief A read-only memory mapped file. The contents are paged in by the OS on first access, so
+ * opening a file is cheap regardless of its size.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // not copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps the complete file into the address space of the process
+     * @param path The path of the file to map
+     * @return Whether the file was successfully mapped
+     */
+    bool open(const char* path);
+
+    /// unmaps the file - any pointers into the mapped region are invalid after this call
+    void close();
+
+    /// hints to the OS that the mapped region will be read front to back
+    void adviseSequential();
+
+    const uint8_t* data() const
+    {
+        return mapped;
+    }
+
+    size_t size() const
+    {
+        return fileSize;
+    }
+
+    bool isOpen() const
+    {
+        return mapped != nullptr;
+    }
+
+private:
+    const uint8_t* mapped = nullptr;
+    size_t fileSize = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
+
+} // namespace Util
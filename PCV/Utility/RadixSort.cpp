@@ -0,0 +1,190 @@
+#include "RadixSort.h"
+
+#include "Threading/ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Util
+{
+
+namespace
+{
+
+constexpr size_t DigitBits = 8;
+constexpr size_t DigitCount = 64 / DigitBits;
+constexpr size_t BucketCount = 1 << DigitBits;
+
+// below this the fixed cost of the histograms outweighs that of a comparison sort - the two
+// cross at ~1k pairs of render queue keys
+constexpr size_t MinRadixSortSize = 1 << 10;
+
+// below this each block doesn't have enough keys to cover the cost of the threads
+constexpr size_t MinBlockSize = 1 << 16;
+
+inline size_t getDigit(const uint64_t key, const size_t digit)
+{
+    return (key >> (digit * DigitBits)) & (BucketCount - 1);
+}
+
+} // namespace
+
+void RadixSorter::sort(uint64_t* keys, uint32_t* values, const size_t count, size_t threadCount)
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    keyBuffer.resize(count);
+    valueBuffer.resize(count);
+
+    if (count < MinRadixSortSize)
+    {
+        sortSmall(keys, values, count);
+        return;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = PCV::ThreadTaskSplitter::getHardwareThreadCount();
+    }
+
+    const size_t blockCount = std::max<size_t>(1, std::min(threadCount, count / MinBlockSize));
+    const size_t blockSize = (count + blockCount - 1) / blockCount;
+
+    // runs the function for each block - the blocks are the same for every pass so each block
+    // scatters exactly the keys it histogrammed
+    auto forEachBlock = [&](auto func) {
+        // a single block is run directly, avoiding the allocations of the task splitter
+        if (blockCount == 1)
+        {
+            func(0, 0, count);
+            return;
+        }
+
+        auto task = [&](const size_t start, const size_t num) {
+            for (size_t block = start; block < start + num; ++block)
+            {
+                const size_t first = block * blockSize;
+                func(block, first, std::min(first + blockSize, count));
+            }
+        };
+        PCV::ThreadTaskSplitter split {0, blockCount, task, blockCount};
+        split.run();
+    };
+
+    // ========= trivial digits ============================
+    // the bits which differ between any of the keys - digits where none differ are skipped
+    blockOr.assign(blockCount, 0);
+    blockAnd.assign(blockCount, ~uint64_t(0));
+    forEachBlock([&](const size_t block, const size_t first, const size_t last) {
+        uint64_t orBits = 0;
+        uint64_t andBits = ~uint64_t(0);
+        for (size_t i = first; i < last; ++i)
+        {
+            orBits |= keys[i];
+            andBits &= keys[i];
+        }
+        blockOr[block] = orBits;
+        blockAnd[block] = andBits;
+    });
+
+    uint64_t orBits = 0;
+    uint64_t andBits = ~uint64_t(0);
+    for (size_t block = 0; block < blockCount; ++block)
+    {
+        orBits |= blockOr[block];
+        andBits &= blockAnd[block];
+    }
+    const uint64_t differingBits = orBits ^ andBits;
+    if (differingBits == 0)
+    {
+        return;
+    }
+
+    // ========= sorting passes ============================
+    uint64_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint64_t* dstKeys = keyBuffer.data();
+    uint32_t* dstValues = valueBuffer.data();
+
+    offsets.resize(blockCount * BucketCount);
+
+    for (size_t digit = 0; digit < DigitCount; ++digit)
+    {
+        if (getDigit(differingBits, digit) == 0)
+        {
+            continue;
+        }
+
+        forEachBlock([&](const size_t block, const size_t first, const size_t last) {
+            size_t* hist = &offsets[block * BucketCount];
+            std::fill(hist, hist + BucketCount, 0);
+            for (size_t i = first; i < last; ++i)
+            {
+                ++hist[getDigit(srcKeys[i], digit)];
+            }
+        });
+
+        // convert the counts into the write position of each block within each bucket - the
+        // buckets are ordered by digit and then by block, which keeps the sort stable
+        size_t sum = 0;
+        for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            for (size_t block = 0; block < blockCount; ++block)
+            {
+                const size_t num = offsets[block * BucketCount + bucket];
+                offsets[block * BucketCount + bucket] = sum;
+                sum += num;
+            }
+        }
+
+        forEachBlock([&](const size_t block, const size_t first, const size_t last) {
+            size_t* offset = &offsets[block * BucketCount];
+            for (size_t i = first; i < last; ++i)
+            {
+                const size_t dst = offset[getDigit(srcKeys[i], digit)]++;
+                dstKeys[dst] = srcKeys[i];
+                dstValues[dst] = srcValues[i];
+            }
+        });
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // an odd number of passes leaves the result in the temporary buffers
+    if (srcKeys != keys)
+    {
+        std::memcpy(keys, srcKeys, count * sizeof(uint64_t));
+        std::memcpy(values, srcValues, count * sizeof(uint32_t));
+    }
+}
+
+void RadixSorter::sortSmall(uint64_t* keys, uint32_t* values, const size_t count)
+{
+    // the original position breaks ties, so the order is stable without the allocations of
+    // std::stable_sort
+    pairs.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        pairs[i] = {keys[i], static_cast<uint32_t>(i)};
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        keys[i] = pairs[i].first;
+        valueBuffer[i] = values[pairs[i].second];
+    }
+    std::memcpy(values, valueBuffer.data(), count * sizeof(uint32_t));
+}
+
+void radixSort(uint64_t* keys, uint32_t* values, const size_t count, size_t threadCount)
+{
+    RadixSorter sorter;
+    sorter.sort(keys, values, count, threadCount);
+}
+
+} // namespace Util
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * @brief Sorts 64-bit keys into ascending order using a least significant digit radix sort with
+ * 8-bit digits, applying the same permutation to the values. The sort is stable. Digits which
+ * are the same for every key are skipped, so keys which only use the lower bits (i.e. morton
+ * codes or packed sort keys) take fewer passes. Small arrays use a comparison sort, as the fixed
+ * cost of the histograms dominates.
+ *
+ * Large arrays are split into blocks which are histogrammed and scattered in parallel - each
+ * block scatters into its own precomputed range of every digit bucket, so no synchronisation is
+ * required other than between passes.
+ *
+ * The temporary buffers are kept between calls, so a sorter which is reused each frame doesn't
+ * allocate once it has grown to the largest array sorted on a single thread.
+ */
+class RadixSorter
+{
+public:
+    /**
+     * @param keys The keys to sort
+     * @param values The values which are permuted with the keys, i.e. point indices
+     * @param count The number of keys and values
+     * @param threadCount The maximum number of threads to use. If zero, the number of hardware
+     * threads will be used
+     */
+    void sort(uint64_t* keys, uint32_t* values, const size_t count, size_t threadCount = 0);
+
+private:
+    void sortSmall(uint64_t* keys, uint32_t* values, const size_t count);
+
+private:
+    std::vector<uint64_t> keyBuffer;
+    std::vector<uint32_t> valueBuffer;
+
+    /// the bucket write positions of each block
+    std::vector<size_t> offsets;
+
+    std::vector<uint64_t> blockOr;
+    std::vector<uint64_t> blockAnd;
+
+    /// key and position pairs for the comparison sort of small arrays
+    std::vector<std::pair<uint64_t, uint32_t>> pairs;
+};
+
+/// sorts the keys and values with a temporary **RadixSorter**
+void radixSort(uint64_t* keys, uint32_t* values, const size_t count, size_t threadCount = 0);
+
+} // namespace Util
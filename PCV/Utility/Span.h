@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * @brief A non-owning view over a contiguous array - a minimal stand in for the C++20 std::span.
+ * The view is only valid for as long as the array isn't destroyed or resized.
+ */
+template <typename T>
+class Span
+{
+public:
+    Span() = default;
+
+    Span(T* ptr, size_t num) : base(ptr), count(num)
+    {
+    }
+
+    template <typename U>
+    Span(std::vector<U>& vec) : base(vec.data()), count(vec.size())
+    {
+    }
+
+    template <typename U>
+    Span(const std::vector<U>& vec) : base(vec.data()), count(vec.size())
+    {
+    }
+
+    inline T& operator[](const size_t idx) const
+    {
+        assert(idx < count);
+        return base[idx];
+    }
+
+    T* data() const
+    {
+        return base;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    T* begin() const
+    {
+        return base;
+    }
+
+    T* end() const
+    {
+        return base + count;
+    }
+
+private:
+    T* base = nullptr;
+    size_t count = 0;
+};
+
+} // namespace Util
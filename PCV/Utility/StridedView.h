@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Util
+{
+
+inline bool isLittleEndianHost()
+{
+    const uint16_t value = 1;
+    uint8_t first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
+/**
+ * @brief Reverses the byte order of a trivially copyable value of 1, 2, 4 or 8 bytes
+ */
+template <typename T>
+inline T byteSwap(const T value)
+{
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T) / 2; ++i)
+    {
+        uint8_t temp = bytes[i];
+        bytes[i] = bytes[sizeof(T) - 1 - i];
+        bytes[sizeof(T) - 1 - i] = temp;
+    }
+
+    T result;
+    std::memcpy(&result, bytes, sizeof(T));
+    return result;
+}
+
+/**
+ * @brief A non-owning, read-only view over elements of type T which are spaced **stride** bytes
+ * apart. Used to expose interleaved data (i.e. a memory mapped file) as separate attribute arrays
+ * without copying. The elements don't have to be aligned and can optionally be byte swapped on
+ * access.
+ */
+template <typename T>
+class StridedView
+{
+public:
+    StridedView() = default;
+
+    StridedView(const uint8_t* ptr, size_t byteStride, size_t num, bool swap = false)
+        : base(ptr), stride(byteStride), count(num), swapBytes(swap)
+    {
+    }
+
+    /// a view over a tightly packed array
+    StridedView(const T* ptr, size_t num)
+        : base(reinterpret_cast<const uint8_t*>(ptr)), stride(sizeof(T)), count(num)
+    {
+    }
+
+    inline T operator[](const size_t idx) const
+    {
+        assert(idx < count);
+        T value;
+        std::memcpy(&value, base + idx * stride, sizeof(T));
+        return swapBytes ? byteSwap(value) : value;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return base == nullptr || count == 0;
+    }
+
+    size_t getStride() const
+    {
+        return stride;
+    }
+
+    const uint8_t* getBase() const
+    {
+        return base;
+    }
+
+    /// whether the elements can be accessed directly as a packed array of T
+    bool isContiguous() const
+    {
+        return stride == sizeof(T) && !swapBytes;
+    }
+
+    const T* ptr() const
+    {
+        assert(isContiguous());
+        return reinterpret_cast<const T*>(base);
+    }
+
+    /**
+     * @brief Copies the elements [start, start + num) into a packed array
+     */
+    void copyTo(T* dst, size_t start, size_t num) const
+    {
+        assert(start + num <= count);
+        if (isContiguous())
+        {
+            std::memcpy(dst, base + start * sizeof(T), num * sizeof(T));
+            return;
+        }
+        for (size_t i = 0; i < num; ++i)
+        {
+            dst[i] = (*this)[start + i];
+        }
+    }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t stride = 0;
+    size_t count = 0;
+    bool swapBytes = false;
+};
+
+} // namespace Util
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+namespace Util
+{
+
+using NanoSeconds = std::chrono::nanoseconds;
+using MilliSeconds = std::chrono::milliseconds;
+
+template <typename T>
+class Timer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Timer() : startTime(Clock::now())
+    {
+    }
+
+    T getCurrentTime() const
+    {
+        return std::chrono::duration_cast<T>(Clock::now().time_since_epoch());
+    }
+
+    /// resets the start point used by the elapsed time functions
+    void reset()
+    {
+        startTime = Clock::now();
+    }
+
+    T getElapsedTime() const
+    {
+        return std::chrono::duration_cast<T>(Clock::now() - startTime);
+    }
+
+    /// the elapsed time since the last reset in seconds - mainly used for throughput stats
+    double getElapsedSeconds() const
+    {
+        return std::chrono::duration<double>(Clock::now() - startTime).count();
+    }
+
+private:
+    Clock::time_point startTime;
+};
+
+} // namespace Util
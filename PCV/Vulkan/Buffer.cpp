@@ -0,0 +1,96 @@
+#include "Buffer.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+
+namespace VulkanAPI
+{
+
+Buffer::~Buffer()
+{
+    destroy();
+}
+
+bool Buffer::create(
+    VkContext& context,
+    const vk::DeviceSize bufferSize,
+    const vk::BufferUsageFlags usage,
+    const vk::MemoryPropertyFlags memProps)
+{
+    assert(!buffer);
+    device = context.device;
+    size = bufferSize;
+
+    vk::BufferCreateInfo createInfo({}, size, usage, vk::SharingMode::eExclusive);
+    VK_CHECK_RESULT(device.createBuffer(&createInfo, nullptr, &buffer));
+
+    vk::MemoryRequirements memReqs = device.getBufferMemoryRequirements(buffer);
+    const uint32_t memType = findMemoryType(context.physical, memReqs.memoryTypeBits, memProps);
+    if (memType == UINT32_MAX)
+    {
+        LOGGER_ERROR("Unable to find a suitable memory type for the buffer.");
+        destroy();
+        return false;
+    }
+
+    vk::MemoryAllocateInfo allocInfo(memReqs.size, memType);
+    if (device.allocateMemory(&allocInfo, nullptr, &memory) != vk::Result::eSuccess)
+    {
+        LOGGER_ERROR("Unable to allocate %llu bytes of buffer memory.", (unsigned long long)size);
+        destroy();
+        return false;
+    }
+    allocatedSize = memReqs.size;
+
+    device.bindBufferMemory(buffer, memory, 0);
+    return true;
+}
+
+void Buffer::destroy()
+{
+    if (buffer)
+    {
+        device.destroyBuffer(buffer, nullptr);
+        buffer = nullptr;
+    }
+    if (memory)
+    {
+        device.freeMemory(memory, nullptr);
+        memory = nullptr;
+    }
+    size = 0;
+    allocatedSize = 0;
+}
+
+void* Buffer::map()
+{
+    assert(memory);
+    void* data = nullptr;
+    VK_CHECK_RESULT(device.mapMemory(memory, 0, VK_WHOLE_SIZE, {}, &data));
+    return data;
+}
+
+void Buffer::unmap()
+{
+    assert(memory);
+    device.unmapMemory(memory);
+}
+
+uint32_t Buffer::findMemoryType(
+    const vk::PhysicalDevice& physical,
+    const uint32_t typeBits,
+    const vk::MemoryPropertyFlags memProps)
+{
+    vk::PhysicalDeviceMemoryProperties props = physical.getMemoryProperties();
+    for (uint32_t i = 0; i < props.memoryTypeCount; ++i)
+    {
+        if ((typeBits & (1 << i)) && (props.memoryTypes[i].propertyFlags & memProps) == memProps)
+        {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+} // namespace VulkanAPI
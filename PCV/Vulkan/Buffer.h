@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Vulkan/Common.h"
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief A vulkan buffer and its dedicated memory allocation.
+ */
+class Buffer
+{
+public:
+    Buffer() = default;
+    ~Buffer();
+
+    // not copyable
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    /**
+     * @brief Creates the buffer and allocates memory with the requested properties.
+     * @param context A prepared vulkan device object
+     * @param size The size of the buffer in bytes
+     * @param usage How the buffer will be used, i.e. as a vertex buffer or a transfer source
+     * @param memProps The required memory properties - device local or host visible
+     */
+    bool create(
+        VkContext& context,
+        const vk::DeviceSize size,
+        const vk::BufferUsageFlags usage,
+        const vk::MemoryPropertyFlags memProps);
+
+    void destroy();
+
+    /// maps the whole buffer - only valid for host visible memory
+    void* map();
+    void unmap();
+
+    vk::Buffer& get()
+    {
+        return buffer;
+    }
+
+    vk::DeviceSize getSize() const
+    {
+        return size;
+    }
+
+    /// the size of the memory allocation, which may be larger than the buffer due to alignment
+    vk::DeviceSize getAllocatedSize() const
+    {
+        return allocatedSize;
+    }
+
+    /**
+     * @brief Finds the index of a memory type which satisfies the buffer requirements and
+     * properties.
+     * @return The memory type index, or UINT32_MAX if no suitable type exists
+     */
+    static uint32_t findMemoryType(
+        const vk::PhysicalDevice& physical,
+        const uint32_t typeBits,
+        const vk::MemoryPropertyFlags memProps);
+
+private:
+    vk::Device device;
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+
+    vk::DeviceSize size = 0;
+    vk::DeviceSize allocatedSize = 0;
+};
+
+} // namespace VulkanAPI
@@ -0,0 +1,135 @@
+#include "BufferPool.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace VulkanAPI
+{
+
+BufferPool::BufferPool(
+    VkContext& ctx,
+    const vk::BufferUsageFlags bufferUsage,
+    const vk::MemoryPropertyFlags props,
+    const vk::DeviceSize size)
+    : context(ctx)
+    , usage(bufferUsage)
+    , memProps(props)
+    , blockSize(getAlignedSize(size))
+{
+}
+
+BufferPool::~BufferPool()
+{
+}
+
+bool BufferPool::allocateFromBlock(Block& block, const vk::DeviceSize size, vk::DeviceSize& offset)
+{
+    for (auto iter = block.freeRanges.begin(); iter != block.freeRanges.end(); ++iter)
+    {
+        if (iter->second < size)
+        {
+            continue;
+        }
+        offset = iter->first;
+        const vk::DeviceSize remaining = iter->second - size;
+        block.freeRanges.erase(iter);
+        if (remaining)
+        {
+            block.freeRanges.emplace(offset + size, remaining);
+        }
+        block.usedBytes += size;
+        return true;
+    }
+    return false;
+}
+
+BufferPool::Allocation BufferPool::allocate(const vk::DeviceSize size)
+{
+    assert(size > 0);
+    const vk::DeviceSize alignedSize = getAlignedSize(size);
+
+    Allocation alloc;
+    alloc.size = alignedSize;
+    for (Block& block : blocks)
+    {
+        if (allocateFromBlock(block, alignedSize, alloc.offset))
+        {
+            alloc.buffer = block.buffer.get();
+            return alloc;
+        }
+    }
+
+    // no block has room, so start another
+    Block block;
+    block.buffer = std::make_unique<Buffer>();
+    const vk::DeviceSize newBlockSize = std::max(blockSize, alignedSize);
+    if (!block.buffer->create(context, newBlockSize, usage, memProps))
+    {
+        LOGGER_ERROR(
+            "Unable to allocate a pool block of %llu bytes.",
+            static_cast<unsigned long long>(newBlockSize));
+        return {};
+    }
+    block.freeRanges.emplace(0, newBlockSize);
+    allocateFromBlock(block, alignedSize, alloc.offset);
+    alloc.buffer = block.buffer.get();
+    blocks.emplace_back(std::move(block));
+    return alloc;
+}
+
+void BufferPool::free(const Allocation& alloc)
+{
+    if (!alloc)
+    {
+        return;
+    }
+
+    auto blockIter = std::find_if(blocks.begin(), blocks.end(), [&alloc](const Block& block) {
+        return block.buffer.get() == alloc.buffer;
+    });
+    assert(blockIter != blocks.end());
+    Block& block = *blockIter;
+    block.usedBytes -= alloc.size;
+
+    // merge with the free ranges either side
+    vk::DeviceSize offset = alloc.offset;
+    vk::DeviceSize size = alloc.size;
+    auto next = block.freeRanges.lower_bound(offset);
+    if (next != block.freeRanges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = block.freeRanges.erase(next);
+    }
+    if (next != block.freeRanges.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset)
+        {
+            offset = prev->first;
+            size += prev->second;
+            block.freeRanges.erase(prev);
+        }
+    }
+    block.freeRanges.emplace(offset, size);
+
+    if (block.usedBytes == 0 && blocks.size() > 1)
+    {
+        blocks.erase(blockIter);
+    }
+}
+
+vk::DeviceSize BufferPool::getReservedBytes() const
+{
+    vk::DeviceSize bytes = 0;
+    for (const Block& block : blocks)
+    {
+        bytes += block.buffer->getAllocatedSize();
+    }
+    return bytes;
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Common.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief Sub-allocates ranges of large buffers, so many small buffers - i.e. one per octree
+ * node - don't each need their own memory allocation. Drivers limit the number of allocations
+ * and allocating is slow, so the pool creates a block buffer of **blockSize** bytes at a time
+ * and hands out ranges of it, first fit, merging ranges again when they are freed.
+ *
+ * A block is destroyed once all of its ranges are freed, apart from the last block which is
+ * kept for the next allocations. Freeing isn't deferred, so ranges must only be freed once no
+ * frame in flight can reference them.
+ */
+class BufferPool
+{
+public:
+    struct Allocation
+    {
+        /// the block buffer the range belongs to
+        Buffer* buffer = nullptr;
+
+        vk::DeviceSize offset = 0;
+
+        /// the size of the range, rounded up to the alignment
+        vk::DeviceSize size = 0;
+
+        explicit operator bool() const
+        {
+            return buffer != nullptr;
+        }
+    };
+
+    /// the alignment of every range within its block
+    static constexpr vk::DeviceSize Alignment = 16;
+
+    /**
+     * @param usage How the blocks will be used, i.e. as a vertex buffer and transfer destination
+     * @param memProps The required memory properties of the blocks
+     * @param blockSize The size of each block. Larger allocations get a block of their own
+     */
+    BufferPool(
+        VkContext& context,
+        const vk::BufferUsageFlags usage,
+        const vk::MemoryPropertyFlags memProps,
+        const vk::DeviceSize blockSize);
+    ~BufferPool();
+
+    // not copyable
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /// @return A null allocation if a new block was required and couldn't be created
+    Allocation allocate(const vk::DeviceSize size);
+
+    void free(const Allocation& alloc);
+
+    /// the size of the range **allocate** would use for **size** bytes
+    static vk::DeviceSize getAlignedSize(const vk::DeviceSize size)
+    {
+        return (size + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    size_t getBlockCount() const
+    {
+        return blocks.size();
+    }
+
+    /// the memory held by all blocks, including the ranges which are free
+    vk::DeviceSize getReservedBytes() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<Buffer> buffer;
+
+        /// the free ranges, keyed by offset
+        std::map<vk::DeviceSize, vk::DeviceSize> freeRanges;
+
+        vk::DeviceSize usedBytes = 0;
+    };
+
+    /// takes the first free range of the block which fits, returning false if none does
+    bool allocateFromBlock(Block& block, const vk::DeviceSize size, vk::DeviceSize& offset);
+
+private:
+    VkContext& context;
+    vk::BufferUsageFlags usage;
+    vk::MemoryPropertyFlags memProps;
+    vk::DeviceSize blockSize;
+
+    std::vector<Block> blocks;
+};
+
+} // namespace VulkanAPI
@@ -0,0 +1,99 @@
+#include "CBufferManager.h"
+
+#include "Vulkan/VkContext.h"
+
+namespace VulkanAPI
+{
+
+CBufferManager::CBufferManager(VkContext& ctx)
+    : context(ctx)
+{
+}
+
+CBufferManager::~CBufferManager()
+{
+    // destroying the pools frees their buffers
+    for (WorkerPool& pool : pools)
+    {
+        context.device.destroyCommandPool(pool.cmdPool, nullptr);
+    }
+}
+
+bool CBufferManager::prepare(const size_t threads, const uint32_t frames)
+{
+    assert(threads > 0 && frames > 0);
+    assert(pools.empty());
+
+    threadCount = threads;
+    frameCount = frames;
+    pools.resize(threadCount * frameCount);
+
+    // the pools are only ever reset as a whole, so the buffers don't need to be individually
+    // resettable
+    vk::CommandPoolCreateInfo poolInfo(
+        vk::CommandPoolCreateFlagBits::eTransient, context.queueFamilyIndex.graphics);
+
+    for (WorkerPool& pool : pools)
+    {
+        VK_CHECK_RESULT(context.device.createCommandPool(&poolInfo, nullptr, &pool.cmdPool));
+    }
+
+    stats.threads.resize(threadCount);
+    return true;
+}
+
+void CBufferManager::beginFrame(const uint32_t frameIndex, vk::CommandBuffer primaryBuffer)
+{
+    currentFrame = frameIndex % frameCount;
+    primary = primaryBuffer;
+
+    for (size_t thread = 0; thread < threadCount; ++thread)
+    {
+        WorkerPool& pool = getPool(thread);
+        context.device.resetCommandPool(pool.cmdPool, {});
+        pool.used = 0;
+        stats.threads[thread] = {};
+    }
+}
+
+CmdBuffer* CBufferManager::getSecondaryCmdBuffer(const size_t thread)
+{
+    WorkerPool& pool = getPool(thread);
+    if (pool.used == pool.secondaries.size())
+    {
+        vk::CommandBuffer buffer;
+        vk::CommandBufferAllocateInfo allocInfo(
+            pool.cmdPool, vk::CommandBufferLevel::eSecondary, 1);
+        VK_CHECK_RESULT(context.device.allocateCommandBuffers(&allocInfo, &buffer));
+        pool.secondaries.emplace_back(CmdBuffer {buffer});
+    }
+    return &pool.secondaries[pool.used++];
+}
+
+void CBufferManager::addThreadStats(
+    const size_t thread, const double recordMs, const size_t renderables)
+{
+    assert(thread < threadCount);
+    stats.threads[thread].recordMs += recordMs;
+    stats.threads[thread].renderables += renderables;
+}
+
+void CBufferManager::executeSecondaryCommands(Util::Span<CmdBuffer* const> buffers)
+{
+    executeList.clear();
+    for (CmdBuffer* buffer : buffers)
+    {
+        if (buffer)
+        {
+            executeList.emplace_back(buffer->get());
+        }
+    }
+
+    if (!executeList.empty())
+    {
+        primary.executeCommands(static_cast<uint32_t>(executeList.size()), executeList.data());
+    }
+    stats.secondaryCount = executeList.size();
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Utility/Span.h"
+#include "Vulkan/CommandBuffer.h"
+#include "Vulkan/Common.h"
+
+#include <cassert>
+#include <deque>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief Owns the command pools used to record secondary command buffers in parallel. Each worker
+ * thread has its own pool, as pools can't be accessed from more than one thread, and may record any
+ * number of secondary buffers per frame - one per chunk of work it picks up. The buffers allocated
+ * from a pool are kept, so once the frame's peak is reached no further buffers are allocated. There
+ * is a set of pools per frame in flight, which are reset rather than freed at the start of the
+ * frame so the buffers are recycled.
+ */
+class CBufferManager
+{
+public:
+    /// the work of a single worker thread, summed over all the buffers it recorded this frame
+    struct ThreadStats
+    {
+        double recordMs = 0.0;
+        size_t renderables = 0;
+    };
+
+    /// the stats of the last frame
+    struct Stats
+    {
+        /// the secondary buffers executed from the primary buffer
+        size_t secondaryCount = 0;
+
+        /// indexed by worker thread
+        std::vector<ThreadStats> threads;
+    };
+
+    explicit CBufferManager(VkContext& context);
+    ~CBufferManager();
+
+    // not copyable
+    CBufferManager(const CBufferManager&) = delete;
+    CBufferManager& operator=(const CBufferManager&) = delete;
+
+    /**
+     * @brief Creates a pool for each worker thread and frame in flight
+     * @param threadCount The number of threads which will record, i.e. the job system's workers
+     */
+    bool prepare(const size_t threadCount, const uint32_t frameCount = 2);
+
+    /**
+     * @brief Resets the pools of the frame so their buffers can be recorded again. The commands
+     * of the last frame which used these pools must have completed.
+     * @param primary The buffer the secondary buffers will be executed from
+     */
+    void beginFrame(const uint32_t frameIndex, vk::CommandBuffer primary);
+
+    /**
+     * @brief Returns an unused secondary buffer from the worker thread's pool for the current
+     * frame, allocating one if all the pool's buffers have been used. Only the thread itself may
+     * call this and record into the buffer.
+     */
+    CmdBuffer* getSecondaryCmdBuffer(const size_t thread);
+
+    /// adds the time the worker thread spent recording a buffer to this frame's stats
+    void addThreadStats(const size_t thread, const double recordMs, const size_t renderables);
+
+    /**
+     * @brief Executes secondary buffers from the primary buffer in the order given, skipping any
+     * null entries. Must be called once all worker threads have finished recording them.
+     */
+    void executeSecondaryCommands(Util::Span<CmdBuffer* const> buffers);
+
+    size_t getThreadCount() const
+    {
+        return threadCount;
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    struct WorkerPool
+    {
+        vk::CommandPool cmdPool;
+
+        /// a deque so the buffers handed out don't move when more are allocated
+        std::deque<CmdBuffer> secondaries;
+
+        /// the number of buffers requested this frame
+        size_t used = 0;
+    };
+
+    /// the pool of the worker thread for the current frame
+    WorkerPool& getPool(const size_t thread)
+    {
+        assert(thread < threadCount);
+        return pools[currentFrame * threadCount + thread];
+    }
+
+private:
+    VkContext& context;
+
+    size_t threadCount = 0;
+    uint32_t frameCount = 0;
+    uint32_t currentFrame = 0;
+
+    /// ordered by frame and then by thread
+    std::vector<WorkerPool> pools;
+
+    vk::CommandBuffer primary;
+
+    /// the buffers executed this frame, kept to avoid allocating each frame
+    std::vector<vk::CommandBuffer> executeList;
+
+    Stats stats;
+};
+
+} // namespace VulkanAPI
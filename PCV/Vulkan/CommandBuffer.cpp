@@ -0,0 +1,25 @@
+#include "CommandBuffer.h"
+
+#include "Vulkan/RenderPass.h"
+
+namespace VulkanAPI
+{
+
+void CmdBuffer::beginSecondary(RenderPass& renderpass, FrameBuffer& framebuffer, uint32_t subpass)
+{
+    vk::CommandBufferInheritanceInfo inheritInfo(
+        renderpass.get(), subpass, framebuffer.get(), VK_FALSE, {}, {});
+
+    vk::CommandBufferBeginInfo beginInfo(
+        vk::CommandBufferUsageFlagBits::eRenderPassContinue |
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        &inheritInfo);
+    cmdBuffer.begin(beginInfo);
+}
+
+void CmdBuffer::end()
+{
+    cmdBuffer.end();
+}
+
+} // namespace VulkanAPI
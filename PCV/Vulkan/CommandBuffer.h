@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Vulkan/Common.h"
+
+namespace VulkanAPI
+{
+// forward declerations
+class RenderPass;
+class FrameBuffer;
+
+/**
+ * @brief A thin wrapper around a command buffer which is owned by a **CBufferManager** pool. The
+ * buffer is reset along with its pool, so it is never freed individually.
+ */
+class CmdBuffer
+{
+public:
+    CmdBuffer() = default;
+
+    explicit CmdBuffer(vk::CommandBuffer buffer) : cmdBuffer(buffer)
+    {
+    }
+
+    /**
+     * @brief Begins recording a secondary buffer which is executed within the render pass, so
+     * the pass and framebuffer state is inherited from the primary buffer
+     */
+    void beginSecondary(RenderPass& renderpass, FrameBuffer& framebuffer, uint32_t subpass = 0);
+
+    void end();
+
+    vk::CommandBuffer& get()
+    {
+        return cmdBuffer;
+    }
+
+private:
+    vk::CommandBuffer cmdBuffer;
+};
+
+} // namespace VulkanAPI
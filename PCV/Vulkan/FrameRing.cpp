@@ -0,0 +1,173 @@
+#include "FrameRing.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace VulkanAPI
+{
+
+FrameRing::FrameRing(VkContext& ctx)
+    : context(ctx)
+{
+}
+
+FrameRing::~FrameRing()
+{
+    waitIdle();
+    destroy();
+}
+
+bool FrameRing::prepare(const uint32_t framesInFlight, const vk::DeviceSize uniformSize)
+{
+    assert(frames.empty());
+    frames.resize(std::min(std::max(framesInFlight, MinFramesInFlight), MaxFramesInFlight));
+
+    // the uniform buffers may hold several dynamic ranges, as well as plain uniforms, so both
+    // descriptor types are allowed
+    const vk::DescriptorPoolSize poolSizes[] = {
+        {vk::DescriptorType::eUniformBuffer, MaxDescriptorSets},
+        {vk::DescriptorType::eUniformBufferDynamic, MaxDescriptorSets},
+        {vk::DescriptorType::eCombinedImageSampler, MaxDescriptorSets}};
+
+    for (Frame& frame : frames)
+    {
+        // the pool is reset as a whole each time the frame comes round
+        vk::CommandPoolCreateInfo poolInfo(
+            vk::CommandPoolCreateFlagBits::eTransient, context.queueFamilyIndex.graphics);
+        VK_CHECK_RESULT(context.device.createCommandPool(&poolInfo, nullptr, &frame.cmdPool));
+
+        vk::CommandBufferAllocateInfo cmdInfo(frame.cmdPool, vk::CommandBufferLevel::ePrimary, 1);
+        VK_CHECK_RESULT(context.device.allocateCommandBuffers(&cmdInfo, &frame.cmdBuffer));
+
+        vk::FenceCreateInfo fenceInfo;
+        VK_CHECK_RESULT(context.device.createFence(&fenceInfo, nullptr, &frame.fence));
+
+        vk::SemaphoreCreateInfo semaphoreInfo;
+        VK_CHECK_RESULT(
+            context.device.createSemaphore(&semaphoreInfo, nullptr, &frame.imageAcquired));
+        VK_CHECK_RESULT(
+            context.device.createSemaphore(&semaphoreInfo, nullptr, &frame.renderComplete));
+
+        vk::DescriptorPoolCreateInfo descrInfo(
+            {}, MaxDescriptorSets, static_cast<uint32_t>(std::size(poolSizes)), poolSizes);
+        VK_CHECK_RESULT(
+            context.device.createDescriptorPool(&descrInfo, nullptr, &frame.descriptorPool));
+
+        frame.uniforms = std::make_unique<Buffer>();
+        if (!frame.uniforms->create(
+                context,
+                uniformSize,
+                vk::BufferUsageFlagBits::eUniformBuffer,
+                vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent))
+        {
+            LOGGER_ERROR("Unable to create the uniform buffers of the frames in flight.");
+            destroy();
+            return false;
+        }
+        frame.uniformsMapped = static_cast<uint8_t*>(frame.uniforms->map());
+    }
+    return true;
+}
+
+void FrameRing::destroy()
+{
+    for (Frame& frame : frames)
+    {
+        if (frame.uniformsMapped)
+        {
+            frame.uniforms->unmap();
+        }
+
+        // destroying the pools frees the command buffers and descriptor sets
+        context.device.destroyDescriptorPool(frame.descriptorPool, nullptr);
+        context.device.destroySemaphore(frame.renderComplete, nullptr);
+        context.device.destroySemaphore(frame.imageAcquired, nullptr);
+        context.device.destroyFence(frame.fence, nullptr);
+        context.device.destroyCommandPool(frame.cmdPool, nullptr);
+    }
+    frames.clear();
+}
+
+FrameRing::Frame& FrameRing::beginFrame()
+{
+    assert(!frames.empty() && !recording);
+    current = static_cast<uint32_t>(frameNumber % frames.size());
+    Frame& frame = frames[current];
+
+    // the fence is only reset on submission, so a frame which was abandoned doesn't leave an
+    // unsignalled fence to wait on
+    stats.waitMs = 0.0;
+    if (frame.submitted)
+    {
+        if (context.device.getFenceStatus(frame.fence) != vk::Result::eSuccess)
+        {
+            Util::Timer<Util::NanoSeconds> timer;
+            VK_CHECK_RESULT(context.device.waitForFences(1, &frame.fence, VK_TRUE, UINT64_MAX));
+            stats.waitMs = timer.getElapsedSeconds() * 1000.0;
+            stats.totalWaitMs += stats.waitMs;
+            ++stats.stalledFrames;
+        }
+        frame.submitted = false;
+    }
+
+    // the GPU has finished with everything recorded for the last use of these resources
+    context.device.resetCommandPool(frame.cmdPool, {});
+    context.device.resetDescriptorPool(frame.descriptorPool, {});
+
+    frame.number = frameNumber++;
+    ++stats.frameCount;
+
+    vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    frame.cmdBuffer.begin(beginInfo);
+    recording = true;
+    return frame;
+}
+
+void FrameRing::submit(vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore)
+{
+    assert(recording);
+    Frame& frame = frames[current];
+    frame.cmdBuffer.end();
+    recording = false;
+
+    const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    vk::SubmitInfo submitInfo(
+        waitSemaphore ? 1 : 0,
+        &waitSemaphore,
+        &waitStage,
+        1,
+        &frame.cmdBuffer,
+        signalSemaphore ? 1 : 0,
+        &signalSemaphore);
+
+    VK_CHECK_RESULT(context.device.resetFences(1, &frame.fence));
+    VK_CHECK_RESULT(context.graphicsQueue.submit(1, &submitInfo, frame.fence));
+    frame.submitted = true;
+}
+
+void FrameRing::abandonFrame()
+{
+    assert(recording);
+    frames[current].cmdBuffer.end();
+    recording = false;
+}
+
+void FrameRing::waitIdle()
+{
+    for (Frame& frame : frames)
+    {
+        if (frame.submitted)
+        {
+            VK_CHECK_RESULT(context.device.waitForFences(1, &frame.fence, VK_TRUE, UINT64_MAX));
+            frame.submitted = false;
+        }
+    }
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Common.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief The resources of each frame in flight, so the CPU can record frame N + 1 - and the scene
+ * update before it - while the GPU is still executing frame N. Each frame has its own command
+ * buffer, fence, semaphores, a descriptor pool which is reset when the frame comes round again
+ * and a persistently mapped uniform buffer.
+ *
+ * The CPU only blocks in **beginFrame** if the GPU is more than the number of frames in flight
+ * behind, the time spent waiting on the fence is reported in the stats - if it's a large part of
+ * the frame, the application is GPU bound.
+ */
+class FrameRing
+{
+public:
+    static constexpr uint32_t MinFramesInFlight = 2;
+    static constexpr uint32_t MaxFramesInFlight = 3;
+
+    /// the descriptor sets which can be allocated from a frame's pool
+    static constexpr uint32_t MaxDescriptorSets = 256;
+
+    struct Frame
+    {
+        vk::CommandPool cmdPool;
+        vk::CommandBuffer cmdBuffer;
+
+        /// signalled once the GPU has finished the frame's submission
+        vk::Fence fence;
+
+        /// signalled by the swapchain image acquire, and by the frame's submission
+        vk::Semaphore imageAcquired;
+        vk::Semaphore renderComplete;
+
+        /// reset when the frame begins, so sets allocated from it only live for the frame
+        vk::DescriptorPool descriptorPool;
+
+        std::unique_ptr<Buffer> uniforms;
+        uint8_t* uniformsMapped = nullptr;
+
+        /// the frame number last begun with these resources
+        uint64_t number = 0;
+        bool submitted = false;
+    };
+
+    struct Stats
+    {
+        /// the time the CPU spent waiting on the fence of the last frame begun
+        double waitMs = 0.0;
+        double totalWaitMs = 0.0;
+
+        uint64_t frameCount = 0;
+
+        /// frames where the fence hadn't signalled when the frame began
+        uint64_t stalledFrames = 0;
+    };
+
+    explicit FrameRing(VkContext& context);
+    ~FrameRing();
+
+    // not copyable
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * @brief Creates the resources of each frame in flight.
+     * @param framesInFlight Clamped to [MinFramesInFlight, MaxFramesInFlight]
+     * @param uniformSize The size of each frame's uniform buffer in bytes
+     */
+    bool prepare(const uint32_t framesInFlight, const vk::DeviceSize uniformSize);
+
+    /**
+     * @brief Moves to the next frame's resources, waiting for the GPU to finish the last frame
+     * which used them. The frame's descriptor pool is reset and its command buffer begun.
+     */
+    Frame& beginFrame();
+
+    /**
+     * @brief Ends the frame's command buffer and submits it to the graphics queue, signalling the
+     * frame's fence. Doesn't wait for the GPU.
+     * @param waitSemaphore If set, the colour output waits on it - i.e. the image acquire
+     * @param signalSemaphore If set, signalled once the frame has executed - i.e. for presenting
+     */
+    void submit(vk::Semaphore waitSemaphore = {}, vk::Semaphore signalSemaphore = {});
+
+    /// ends the frame's command buffer without submitting, i.e. if the image acquire failed
+    void abandonFrame();
+
+    /// waits for all submitted frames to complete
+    void waitIdle();
+
+    Frame& getFrame()
+    {
+        return frames[current];
+    }
+
+    /// the index of the current frame's resources, in [0, getFramesInFlight())
+    uint32_t getFrameIndex() const
+    {
+        return current;
+    }
+
+    uint32_t getFramesInFlight() const
+    {
+        return static_cast<uint32_t>(frames.size());
+    }
+
+    const Stats& getStats() const
+    {
+        return stats;
+    }
+
+private:
+    void destroy();
+
+private:
+    VkContext& context;
+
+    std::vector<Frame> frames;
+    uint32_t current = 0;
+    uint64_t frameNumber = 0;
+    bool recording = false;
+
+    Stats stats;
+};
+
+} // namespace VulkanAPI
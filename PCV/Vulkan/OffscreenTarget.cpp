@@ -0,0 +1,360 @@
+#include "OffscreenTarget.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+namespace VulkanAPI
+{
+
+OffscreenTarget::OffscreenTarget(VkContext& ctx)
+    : context(ctx)
+    , imageView(ctx)
+{
+}
+
+OffscreenTarget::~OffscreenTarget()
+{
+    // the readbacks of frames still in flight are delivered rather than dropped
+    flush();
+    destroy();
+}
+
+bool OffscreenTarget::prepare(
+    const uint32_t imageWidth,
+    const uint32_t imageHeight,
+    const vk::Format imageFormat,
+    const uint32_t framesInFlight)
+{
+    assert(imageWidth > 0 && imageHeight > 0 && framesInFlight > 0);
+    assert(!image);
+
+    // the readback is handed out as tightly packed pixels, which is only done for 32-bit formats
+    if (imageFormat != vk::Format::eR8G8B8A8Unorm && imageFormat != vk::Format::eR8G8B8A8Srgb &&
+        imageFormat != vk::Format::eB8G8R8A8Unorm && imageFormat != vk::Format::eB8G8R8A8Srgb)
+    {
+        LOGGER_ERROR("Offscreen targets only support 8-bit RGBA and BGRA formats.");
+        return false;
+    }
+    const vk::FormatProperties formatProps = context.physical.getFormatProperties(imageFormat);
+    const vk::FormatFeatureFlags requiredFeatures =
+        vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eTransferSrc;
+    if ((formatProps.optimalTilingFeatures & requiredFeatures) != requiredFeatures)
+    {
+        LOGGER_ERROR("The offscreen target format can't be rendered to and copied from.");
+        return false;
+    }
+
+    width = imageWidth;
+    height = imageHeight;
+    format = imageFormat;
+    imageSize = size_t(width) * height * 4;
+
+    // ============ colour image ====================
+    vk::ImageCreateInfo imageInfo(
+        {},
+        vk::ImageType::e2D,
+        format,
+        vk::Extent3D(width, height, 1),
+        1,
+        1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+        vk::SharingMode::eExclusive,
+        0,
+        nullptr,
+        vk::ImageLayout::eUndefined);
+    VK_CHECK_RESULT(context.device.createImage(&imageInfo, nullptr, &image));
+
+    vk::MemoryRequirements memReqs = context.device.getImageMemoryRequirements(image);
+    const uint32_t memType = Buffer::findMemoryType(
+        context.physical, memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+    if (memType == UINT32_MAX)
+    {
+        LOGGER_ERROR("Unable to find a suitable memory type for the offscreen target.");
+        destroy();
+        return false;
+    }
+    vk::MemoryAllocateInfo allocInfo(memReqs.size, memType);
+    if (context.device.allocateMemory(&allocInfo, nullptr, &imageMemory) != vk::Result::eSuccess)
+    {
+        LOGGER_ERROR("Unable to allocate %zu bytes for the offscreen target.", imageSize);
+        destroy();
+        return false;
+    }
+    context.device.bindImageMemory(image, imageMemory, 0);
+
+    imageView.create(
+        context.device, image, format, vk::ImageAspectFlagBits::eColor, vk::ImageViewType::e2D);
+
+    // ============ final pass ====================
+    // the image is already a colour attachment when the frame begins, and must still be one
+    // when the frame ends so the readback copy can wait on the colour writes
+    vk::AttachmentDescription attachment(
+        {},
+        format,
+        vk::SampleCountFlagBits::e1,
+        vk::AttachmentLoadOp::eClear,
+        vk::AttachmentStoreOp::eStore,
+        vk::AttachmentLoadOp::eDontCare,
+        vk::AttachmentStoreOp::eDontCare,
+        vk::ImageLayout::eColorAttachmentOptimal,
+        vk::ImageLayout::eColorAttachmentOptimal);
+    vk::AttachmentReference colourRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+    vk::SubpassDescription subpass;
+    subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colourRef;
+    vk::RenderPassCreateInfo passInfo({}, 1, &attachment, 1, &subpass, 0, nullptr);
+    VK_CHECK_RESULT(context.device.createRenderPass(&passInfo, nullptr, &renderPass));
+
+    vk::ImageView view = imageView.get();
+    vk::FramebufferCreateInfo frameInfo({}, renderPass, 1, &view, width, height, 1);
+    VK_CHECK_RESULT(context.device.createFramebuffer(&frameInfo, nullptr, &framebuffer));
+
+    // ============ frames in flight ====================
+    // the command buffers are re-recorded each time their frame comes round
+    vk::CommandPoolCreateInfo poolInfo(
+        vk::CommandPoolCreateFlagBits::eResetCommandBuffer, context.queueFamilyIndex.graphics);
+    VK_CHECK_RESULT(context.device.createCommandPool(&poolInfo, nullptr, &cmdPool));
+
+    slots.resize(framesInFlight);
+    for (FrameSlot& slot : slots)
+    {
+        // kept mapped for the lifetime of the target, the fence wait makes the copy visible
+        slot.readback = std::make_unique<Buffer>();
+        if (!slot.readback->create(
+                context,
+                imageSize,
+                vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent))
+        {
+            destroy();
+            return false;
+        }
+        slot.mapped = static_cast<const uint8_t*>(slot.readback->map());
+
+        vk::CommandBufferAllocateInfo cmdInfo(cmdPool, vk::CommandBufferLevel::ePrimary, 1);
+        VK_CHECK_RESULT(context.device.allocateCommandBuffers(&cmdInfo, &slot.cmdBuffer));
+
+        vk::FenceCreateInfo fenceInfo;
+        VK_CHECK_RESULT(context.device.createFence(&fenceInfo, nullptr, &slot.fence));
+    }
+    return true;
+}
+
+void OffscreenTarget::destroy()
+{
+    for (FrameSlot& slot : slots)
+    {
+        if (slot.mapped)
+        {
+            slot.readback->unmap();
+        }
+        if (slot.fence)
+        {
+            context.device.destroyFence(slot.fence, nullptr);
+        }
+    }
+    slots.clear();
+
+    if (framebuffer)
+    {
+        context.device.destroyFramebuffer(framebuffer, nullptr);
+        framebuffer = nullptr;
+    }
+    if (renderPass)
+    {
+        context.device.destroyRenderPass(renderPass, nullptr);
+        renderPass = nullptr;
+    }
+
+    // destroying the pool frees the command buffers
+    if (cmdPool)
+    {
+        context.device.destroyCommandPool(cmdPool, nullptr);
+        cmdPool = nullptr;
+    }
+    if (image)
+    {
+        context.device.destroyImage(image, nullptr);
+        image = nullptr;
+    }
+    if (imageMemory)
+    {
+        context.device.freeMemory(imageMemory, nullptr);
+        imageMemory = nullptr;
+    }
+}
+
+bool OffscreenTarget::completeFrame(FrameSlot& slot, const bool wait)
+{
+    if (!slot.inFlight)
+    {
+        return true;
+    }
+
+    if (wait)
+    {
+        VK_CHECK_RESULT(context.device.waitForFences(1, &slot.fence, VK_TRUE, UINT64_MAX));
+    }
+    else if (context.device.getFenceStatus(slot.fence) != vk::Result::eSuccess)
+    {
+        return false;
+    }
+    VK_CHECK_RESULT(context.device.resetFences(1, &slot.fence));
+    slot.inFlight = false;
+
+    if (readbackFunc)
+    {
+        Readback readback;
+        readback.frame = slot.frame;
+        readback.width = width;
+        readback.height = height;
+        readback.format = format;
+        readback.pixels = slot.mapped;
+        readback.size = imageSize;
+        readbackFunc(readback);
+    }
+    return true;
+}
+
+vk::CommandBuffer OffscreenTarget::beginFrame()
+{
+    assert(!slots.empty() && !recording);
+
+    // reusing the slot of the oldest frame - the CPU only blocks if it's more than the number
+    // of frames in flight ahead of the GPU
+    currentSlot = frameCount % slots.size();
+    FrameSlot& slot = slots[currentSlot];
+    if (slot.inFlight)
+    {
+        Util::Timer<Util::NanoSeconds> timer;
+        completeFrame(slot, true);
+        waitMs += timer.getElapsedSeconds() * 1000.0;
+    }
+    slot.frame = frameCount++;
+
+    vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    slot.cmdBuffer.begin(beginInfo);
+
+    // the colour image is shared by all frames in flight, so the copy of the previous frame out
+    // of it must complete before this frame's passes write to it. The image is cleared by the
+    // first pass, so its contents are discarded by transitioning from an undefined layout
+    vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+    vk::ImageMemoryBarrier toAttachment(
+        {},
+        vk::AccessFlagBits::eColorAttachmentWrite,
+        vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eColorAttachmentOptimal,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        image,
+        range);
+    slot.cmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        {},
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &toAttachment);
+
+    recording = true;
+    return slot.cmdBuffer;
+}
+
+void OffscreenTarget::endFrame()
+{
+    assert(recording);
+    FrameSlot& slot = slots[currentSlot];
+    vk::CommandBuffer cmds = slot.cmdBuffer;
+
+    // the final pass leaves the image as a colour attachment, it's moved to a transfer source
+    // once all colour writes have completed
+    vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+    vk::ImageMemoryBarrier toTransfer(
+        vk::AccessFlagBits::eColorAttachmentWrite,
+        vk::AccessFlagBits::eTransferRead,
+        vk::ImageLayout::eColorAttachmentOptimal,
+        vk::ImageLayout::eTransferSrcOptimal,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        image,
+        range);
+    cmds.pipelineBarrier(
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &toTransfer);
+
+    // a zero row length packs the rows tightly
+    vk::BufferImageCopy region(
+        0,
+        0,
+        0,
+        vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1),
+        vk::Offset3D(0, 0, 0),
+        vk::Extent3D(width, height, 1));
+    cmds.copyImageToBuffer(
+        image, vk::ImageLayout::eTransferSrcOptimal, slot.readback->get(), 1, &region);
+
+    // makes the copy visible to the host once the fence has signalled
+    vk::BufferMemoryBarrier toHost(
+        vk::AccessFlagBits::eTransferWrite,
+        vk::AccessFlagBits::eHostRead,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        slot.readback->get(),
+        0,
+        VK_WHOLE_SIZE);
+    cmds.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost,
+        {},
+        0,
+        nullptr,
+        1,
+        &toHost,
+        0,
+        nullptr);
+    cmds.end();
+    recording = false;
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &cmds, 0, nullptr);
+    VK_CHECK_RESULT(context.graphicsQueue.submit(1, &submitInfo, slot.fence));
+    slot.inFlight = true;
+}
+
+void OffscreenTarget::processReadbacks()
+{
+    // frames complete in submission order, so stop at the first which hasn't
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        FrameSlot& slot = slots[(frameCount + i) % slots.size()];
+        if (!completeFrame(slot, false))
+        {
+            break;
+        }
+    }
+}
+
+void OffscreenTarget::flush()
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        completeFrame(slots[(frameCount + i) % slots.size()], true);
+    }
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Common.h"
+#include "Vulkan/Image.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief A render target for rendering without a window or swapchain, i.e. batch rendering
+ * thumbnails on servers with no display. The renderer draws into a device local colour image,
+ * which is then copied into a host visible readback buffer as part of the same submission.
+ *
+ * Readback is asynchronous - each frame in flight has its own readback buffer, fence and command
+ * buffer, and a frame's pixels are handed to the readback callback once its fence has signalled,
+ * so the CPU can record the following frames while the GPU is still rendering. Nothing beyond
+ * core Vulkan 1.1 is required, so this also runs on software drivers such as lavapipe.
+ */
+class OffscreenTarget
+{
+public:
+    /// a completed frame - the pixels are only valid for the duration of the callback
+    struct Readback
+    {
+        /// the index of the frame as counted by **beginFrame**
+        uint64_t frame = 0;
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        vk::Format format = vk::Format::eUndefined;
+
+        /// tightly packed rows, from the top of the image
+        const uint8_t* pixels = nullptr;
+        size_t size = 0;
+    };
+
+    using ReadbackFunc = std::function<void(const Readback&)>;
+
+    explicit OffscreenTarget(VkContext& context);
+    ~OffscreenTarget();
+
+    // not copyable
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    /**
+     * @brief Creates the colour image and the readback resources of each frame in flight.
+     * @param format Must support being used as a colour attachment and a transfer source
+     * @param framesInFlight The number of frames which can be rendering or waiting to be read
+     * back before **beginFrame** blocks
+     */
+    bool prepare(
+        const uint32_t width,
+        const uint32_t height,
+        const vk::Format format = vk::Format::eR8G8B8A8Unorm,
+        const uint32_t framesInFlight = 3);
+
+    /// called with the pixels of each frame once the GPU has finished with it
+    void setReadbackCallback(ReadbackFunc func)
+    {
+        readbackFunc = std::move(func);
+    }
+
+    /**
+     * @brief Starts recording a frame into the command buffer of the next frame in flight. If
+     * that frame is still in flight, waits for it and delivers its readback first. The colour
+     * image is left as a colour attachment once the previous frame's copy out of it is done.
+     * @return The command buffer the frame's passes are recorded into
+     */
+    vk::CommandBuffer beginFrame();
+
+    /**
+     * @brief Records the copy of the colour image into the frame's readback buffer and submits
+     * the frame to the graphics queue. Doesn't wait for the GPU.
+     */
+    void endFrame();
+
+    /**
+     * @brief Delivers the readbacks of all frames the GPU has finished with, in frame order,
+     * without waiting. Called once per frame by the renderer.
+     */
+    void processReadbacks();
+
+    /// waits for all submitted frames and delivers their readbacks
+    void flush();
+
+    ImageView& getImageView()
+    {
+        return imageView;
+    }
+
+    /**
+     * @brief The pass the final stage renders into, the counterpart of the swapchain's present
+     * pass. Clears the colour image on load and stores it, leaving it as a colour attachment for
+     * the copy recorded by **endFrame**.
+     */
+    vk::RenderPass getRenderPass() const
+    {
+        return renderPass;
+    }
+
+    vk::Framebuffer getFramebuffer() const
+    {
+        return framebuffer;
+    }
+
+    vk::Image getImage() const
+    {
+        return image;
+    }
+
+    vk::Format getFormat() const
+    {
+        return format;
+    }
+
+    uint32_t getWidth() const
+    {
+        return width;
+    }
+
+    uint32_t getHeight() const
+    {
+        return height;
+    }
+
+    /// the index of the slot of the frame last begun, in [0, getFramesInFlight())
+    uint32_t getFrameIndex() const
+    {
+        return static_cast<uint32_t>(currentSlot);
+    }
+
+    uint32_t getFramesInFlight() const
+    {
+        return static_cast<uint32_t>(slots.size());
+    }
+
+    /// the time the CPU spent blocked in **beginFrame** waiting for frames in flight
+    double getWaitMs() const
+    {
+        return waitMs;
+    }
+
+private:
+    struct FrameSlot
+    {
+        std::unique_ptr<Buffer> readback;
+        const uint8_t* mapped = nullptr;
+
+        vk::CommandBuffer cmdBuffer;
+        vk::Fence fence;
+
+        uint64_t frame = 0;
+
+        /// set from submission until the readback has been delivered
+        bool inFlight = false;
+    };
+
+    /// delivers the slot's readback, waiting for its fence if **wait** is set
+    bool completeFrame(FrameSlot& slot, const bool wait);
+
+    void destroy();
+
+private:
+    VkContext& context;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    vk::Format format = vk::Format::eUndefined;
+    size_t imageSize = 0;
+
+    vk::Image image;
+    vk::DeviceMemory imageMemory;
+    ImageView imageView;
+
+    vk::RenderPass renderPass;
+    vk::Framebuffer framebuffer;
+
+    vk::CommandPool cmdPool;
+    std::vector<FrameSlot> slots;
+
+    /// the number of frames begun, and the slot of the frame being recorded
+    uint64_t frameCount = 0;
+    size_t currentSlot = 0;
+    bool recording = false;
+
+    ReadbackFunc readbackFunc;
+    double waitMs = 0.0;
+};
+
+} // namespace VulkanAPI
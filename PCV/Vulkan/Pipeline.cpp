@@ -37,6 +37,7 @@ vk::PipelineVertexInputStateCreateInfo
 Pipeline::updateVertexInput(std::vector<ShaderProgram::InputBinding>& inputs)
 {
     vk::PipelineVertexInputStateCreateInfo vertexInputState;
+    vertexAttrDescr.clear();
 
     // check for empty vertex input
     if (inputs.empty())
@@ -68,91 +69,66 @@ Pipeline::updateVertexInput(std::vector<ShaderProgram::InputBinding>& inputs)
     return vertexInputState;
 }
 
-void Pipeline::buildPipeline(const RenderPass& renderpass, vk::PolygonMode polygonMode)
+PipelineDesc Pipeline::createDesc(const RenderPass& renderpass, vk::PolygonMode polygonMode)
 {
     auto& renderState = program.renderState;
 
+    PipelineDesc desc;
+    for (auto& stage : program.stages)
+    {
+        const vk::PipelineShaderStageCreateInfo& info = stage.getShader()->get();
+        desc.stages.push_back({info.stage, info.module, info.pName});
+    }
+
     // calculate the offset and stride size
-    vk::PipelineVertexInputStateCreateInfo vertInputState = updateVertexInput(program.inputs);
+    updateVertexInput(program.inputs);
+    desc.vertexAttrs = vertexAttrDescr;
+    desc.vertexBindings = vertexBindDescr;
 
     // ============== primitive topology =====================
-    vk::PipelineInputAssemblyStateCreateInfo assemblyState;
-    assemblyState.topology = renderState->rastState.topology;
-    assemblyState.primitiveRestartEnable = renderState->rastState.primRestart;
+    desc.topology = renderState->rastState.topology;
+    desc.primRestart = renderState->rastState.primRestart;
 
-    // ============== multi-sample state =====================
-    vk::PipelineMultisampleStateCreateInfo sampleState;
-
-
-    // ============== depth/stenicl state ====================
-    vk::PipelineDepthStencilStateCreateInfo depthStencilState;
-    depthStencilState.depthTestEnable =  VK_TRUE;
-    depthStencilState.depthWriteEnable = VK_FALSE;
-    depthStencilState.depthCompareOp = vk::CompareOp::eLessOrEqual;
-
-    // ============== stencil state =====================
-    depthStencilState.stencilTestEnable = VK_FALSE;
+    // ============== depth/stencil state ====================
+    desc.depthTest = true;
+    desc.depthWrite = false;
+    desc.depthCompareOp = vk::CompareOp::eLessOrEqual;
 
     // ============ raster state =======================
-    vk::PipelineRasterizationStateCreateInfo rasterState;
-    rasterState.cullMode = vk::CullModeFlagBits::eBack;
-    rasterState.frontFace = vk::FrontFace::eCounterClockwise;
-    rasterState.polygonMode = polygonMode;
+    desc.cullMode = vk::CullModeFlagBits::eBack;
+    desc.frontFace = vk::FrontFace::eCounterClockwise;
+    desc.polygonMode = polygonMode;
 
     // ============ dynamic states ====================
-    vk::PipelineDynamicStateCreateInfo dynamicCreateState;
-    dynamicCreateState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-    dynamicCreateState.pDynamicStates = dynamicStates.data();
+    desc.dynamicStates = dynamicStates;
 
     // =============== viewport state ====================
-    vk::PipelineViewportStateCreateInfo viewportState;
-    vk::Viewport viewPort(
-        0.0f,
-        0.0f,
-        static_cast<float>(renderpass.getWidth()),
-        static_cast<float>(renderpass.getHeight()),
-        0.0f,
-        1.0f);
-    vk::Rect2D scissor(
-        vk::Offset2D(0, 0), vk::Extent2D((uint32_t) viewPort.width, (uint32_t) viewPort.height));
-    viewportState.pViewports = &viewPort;
-    viewportState.viewportCount = 1;
-    viewportState.pScissors = &scissor;
-    viewportState.scissorCount = 1;
+    desc.width = renderpass.getWidth();
+    desc.height = renderpass.getHeight();
 
     // ============= colour attachment =================
-    auto colAttachments = renderpass.getColourAttachs();
-    vk::PipelineColorBlendStateCreateInfo colourBlendState;
-    colourBlendState.attachmentCount = static_cast<uint32_t>(colAttachments.size());
-    colourBlendState.pAttachments = colAttachments.data();
+    desc.colourAttachs = renderpass.getColourAttachs();
 
-    std::vector<vk::PipelineShaderStageCreateInfo> shaderData;
-    for (auto& stage : program.stages)
+    desc.layout = pipelineLayout;
+    desc.renderpass = renderpass.get();
+    return desc;
+}
+
+void Pipeline::buildPipeline(const RenderPass& renderpass, vk::PolygonMode polygonMode)
+{
+    // pipelines with identical state are shared, so this only compiles on the first use
+    pipeline = context.pipelines.get(createDesc(renderpass, polygonMode));
+}
+
+bool Pipeline::requestPipeline(const RenderPass& renderpass, vk::PolygonMode polygonMode)
+{
+    vk::Pipeline requested = context.pipelines.request(createDesc(renderpass, polygonMode));
+    if (!requested)
     {
-        shaderData.emplace_back(stage.getShader()->get());
+        return false;
     }
-
-    // ================= create the pipeline =======================
-    vk::GraphicsPipelineCreateInfo createInfo(
-        {},
-        static_cast<uint32_t>(shaderData.size()),
-        shaderData.data(),
-        &vertInputState,
-        &assemblyState,
-        nullptr,
-        &viewportState,
-        &rasterState,
-        &sampleState,
-        &depthStencilState,
-        &colourBlendState,
-        &dynamicCreateState,
-        pipelineLayout,
-        renderpass.get(),
-        0,
-        nullptr,
-        0);
-
-    VK_CHECK_RESULT(context.device.createGraphicsPipelines({}, 1, &createInfo, nullptr, &pipeline));
+    pipeline = requested;
+    return true;
 }
 
 } // namespace VulkanAPI
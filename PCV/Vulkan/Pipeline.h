@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Vulkan/Common.h"
+#include "Vulkan/PipelineRegistry.h"
 
 #include <vector>
 
@@ -25,15 +26,27 @@ public:
 
     /**
      * Creates a pipeline using render data from the shader program and associates it with the
-     * declared renderpass
+     * declared renderpass. If a pipeline with the same state already exists in the context's
+     * registry, that pipeline is used instead.
      */
     void buildPipeline(const RenderPass& renderpass, vk::PolygonMode polygonMode);
 
+    /**
+     * As **buildPipeline**, but a pipeline which doesn't exist yet is compiled in the background.
+     * Until it has compiled, returns false and the previously built pipeline is kept, so this
+     * can be called each frame when switching state without stalling.
+     */
+    bool requestPipeline(const RenderPass& renderpass, vk::PolygonMode polygonMode);
+
     vk::Pipeline& get()
     {
         return pipeline;
     }
 
+private:
+    /// the full pipeline state, used to look up the pipeline in the registry
+    PipelineDesc createDesc(const RenderPass& renderpass, vk::PolygonMode polygonMode);
+
 private:
     VkContext& context;
 
@@ -48,6 +61,8 @@ private:
     RenderPass& renderpass;
 
     vk::PipelineLayout layout;
+
+    /// owned by the registry, which may share it with other pipelines
     vk::Pipeline pipeline;
 };
 
@@ -0,0 +1,240 @@
+#include "PipelineCache.h"
+
+#include "Utility/Logger.h"
+#include "Utility/MappedFile.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace VulkanAPI
+{
+
+namespace
+{
+
+constexpr char CacheMagic[4] = {'P', 'C', 'V', 'P'};
+constexpr uint32_t CacheVersion = 1;
+
+/// precedes the cache data returned by the driver
+struct CacheFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t vendorId;
+    uint32_t deviceId;
+    uint32_t driverVersion;
+    uint8_t cacheUuid[VK_UUID_SIZE];
+    uint32_t reserved;
+    uint64_t dataSize;
+
+    /// FNV-1a hash of the data, catches truncated or corrupt files
+    uint64_t dataHash;
+};
+
+static_assert(sizeof(CacheFileHeader) == 56, "Unexpected padding in the cache file header");
+
+/// the header vulkan places at the start of the cache data (VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+struct VkCacheHeader
+{
+    uint32_t headerSize;
+    uint32_t headerVersion;
+    uint32_t vendorId;
+    uint32_t deviceId;
+    uint8_t cacheUuid[VK_UUID_SIZE];
+};
+
+uint64_t hashData(const uint8_t* data, const size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+PipelineCache::~PipelineCache()
+{
+    destroy();
+}
+
+bool PipelineCache::prepare(
+    vk::Device dev, vk::PhysicalDevice physical, const std::string& directory)
+{
+    assert(!cache);
+    device = dev;
+    deviceProps = physical.getProperties();
+
+    // the driver version is part of the name as well as the header, so caches for different
+    // drivers can sit side by side when switching between them
+    char name[64];
+    int offset = snprintf(name, sizeof(name), "pipelines_");
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+    {
+        offset += snprintf(
+            name + offset, sizeof(name) - offset, "%02x", deviceProps.pipelineCacheUUID[i]);
+    }
+    snprintf(name + offset, sizeof(name) - offset, "_%08x.bin", deviceProps.driverVersion);
+    path = directory + "/" + name;
+
+    Util::MappedFile file;
+    const uint8_t* initialData = nullptr;
+    size_t initialSize = 0;
+    if (file.open(path.c_str()))
+    {
+        if (isValid(file.data(), file.size()))
+        {
+            initialData = file.data() + sizeof(CacheFileHeader);
+            initialSize = file.size() - sizeof(CacheFileHeader);
+        }
+        else
+        {
+            LOGGER_WARN("Ignoring the invalid or out of date pipeline cache %s.", path.c_str());
+        }
+    }
+
+    vk::PipelineCacheCreateInfo createInfo({}, initialSize, initialData);
+    vk::Result result = device.createPipelineCache(&createInfo, nullptr, &cache);
+    if (result != vk::Result::eSuccess && initialData)
+    {
+        // drivers may still reject data which passes the checks, i.e. from a build with the
+        // same version but a different compiler
+        LOGGER_WARN("The driver rejected the pipeline cache %s.", path.c_str());
+        initialData = nullptr;
+        initialSize = 0;
+        createInfo = vk::PipelineCacheCreateInfo();
+        result = device.createPipelineCache(&createInfo, nullptr, &cache);
+    }
+    if (result != vk::Result::eSuccess)
+    {
+        LOGGER_ERROR("Unable to create the pipeline cache.");
+        return false;
+    }
+
+    warm = initialData != nullptr;
+    loadedBytes = initialSize;
+    return true;
+}
+
+bool PipelineCache::isValid(const uint8_t* file, const size_t fileSize) const
+{
+    if (fileSize < sizeof(CacheFileHeader) + sizeof(VkCacheHeader))
+    {
+        return false;
+    }
+
+    CacheFileHeader header;
+    memcpy(&header, file, sizeof(CacheFileHeader));
+    if (memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+        header.version != CacheVersion || header.vendorId != deviceProps.vendorID ||
+        header.deviceId != deviceProps.deviceID ||
+        header.driverVersion != deviceProps.driverVersion ||
+        memcmp(header.cacheUuid, deviceProps.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        header.dataSize != fileSize - sizeof(CacheFileHeader))
+    {
+        return false;
+    }
+
+    const uint8_t* data = file + sizeof(CacheFileHeader);
+    VkCacheHeader vkHeader;
+    memcpy(&vkHeader, data, sizeof(VkCacheHeader));
+    if (vkHeader.headerSize < sizeof(VkCacheHeader) || vkHeader.headerSize > header.dataSize ||
+        vkHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        vkHeader.vendorId != deviceProps.vendorID || vkHeader.deviceId != deviceProps.deviceID ||
+        memcmp(vkHeader.cacheUuid, deviceProps.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        return false;
+    }
+
+    // checked last as it reads the whole file
+    return hashData(data, header.dataSize) == header.dataHash;
+}
+
+bool PipelineCache::save()
+{
+    if (!cache)
+    {
+        return false;
+    }
+
+    size_t dataSize = 0;
+    VK_CHECK_RESULT(device.getPipelineCacheData(cache, &dataSize, static_cast<void*>(nullptr)));
+    std::vector<uint8_t> data(dataSize);
+    VK_CHECK_RESULT(
+        device.getPipelineCacheData(cache, &dataSize, static_cast<void*>(data.data())));
+    data.resize(dataSize);
+
+    CacheFileHeader header = {};
+    memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+    header.vendorId = deviceProps.vendorID;
+    header.deviceId = deviceProps.deviceID;
+    header.driverVersion = deviceProps.driverVersion;
+    memcpy(header.cacheUuid, deviceProps.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = dataSize;
+    header.dataHash = hashData(data.data(), dataSize);
+
+    // written to a temporary file first so a crash while saving can't leave a partial cache
+    const std::string tempPath = path + ".tmp";
+    FILE* fp = fopen(tempPath.c_str(), "wb");
+    if (!fp)
+    {
+        LOGGER_ERROR("Unable to create %s.", tempPath.c_str());
+        return false;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+    success &= fwrite(data.data(), 1, dataSize, fp) == dataSize;
+    success &= fclose(fp) == 0;
+
+    // rename doesn't replace an existing file on windows
+    std::remove(path.c_str());
+    if (!success || std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        LOGGER_ERROR("Unable to write the pipeline cache %s.", path.c_str());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void PipelineCache::destroy()
+{
+    if (!cache)
+    {
+        return;
+    }
+
+    const Stats stats = getStats();
+    LOGGER_INFO(
+        "Created %zu pipelines in %.2fms with a %s pipeline cache (%zu bytes loaded).",
+        stats.pipelineCount,
+        stats.createMs,
+        stats.warm ? "warm" : "cold",
+        stats.loadedBytes);
+
+    save();
+    device.destroyPipelineCache(cache, nullptr);
+    cache = nullptr;
+}
+
+void PipelineCache::addCreateTime(const double seconds)
+{
+    pipelineCount.fetch_add(1, std::memory_order_relaxed);
+    createNs.fetch_add(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+}
+
+PipelineCache::Stats PipelineCache::getStats() const
+{
+    Stats stats;
+    stats.warm = warm;
+    stats.loadedBytes = loadedBytes;
+    stats.pipelineCount = pipelineCount.load(std::memory_order_relaxed);
+    stats.createMs = static_cast<double>(createNs.load(std::memory_order_relaxed)) * 1e-6;
+    return stats;
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Vulkan/Common.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace VulkanAPI
+{
+
+/**
+ * @brief A pipeline cache which persists between runs, so pipelines are only compiled from
+ * scratch on the first launch. The cache file is named after the device's pipeline cache UUID
+ * and driver version, so switching GPUs or updating the driver starts a new cache rather than
+ * feeding the driver data it can't use.
+ *
+ * The data is only handed to the driver if both the file header and the header vulkan writes at
+ * the start of the data match the device, and the data hashes to the stored value - drivers
+ * aren't required to survive truncated or corrupt data. Otherwise an empty cache is created.
+ */
+class PipelineCache
+{
+public:
+    /// the pipeline creation stats since the cache was prepared
+    struct Stats
+    {
+        /// whether valid cache data was loaded from disk
+        bool warm = false;
+        size_t loadedBytes = 0;
+
+        size_t pipelineCount = 0;
+        double createMs = 0.0;
+    };
+
+    PipelineCache() = default;
+    ~PipelineCache();
+
+    // not copyable
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    /**
+     * @brief Creates the cache, seeded with the contents of the device's cache file if valid.
+     * @param directory Where the cache file is read from and written to by **save**
+     * @return false only if the cache object couldn't be created - a missing or invalid file
+     * gives an empty cache
+     */
+    bool prepare(vk::Device device, vk::PhysicalDevice physical, const std::string& directory);
+
+    /// writes the cache data to the cache file, replacing the previous file once fully written
+    bool save();
+
+    /// saves and then destroys the cache, must be called before the device is destroyed
+    void destroy();
+
+    vk::PipelineCache get() const
+    {
+        return cache;
+    }
+
+    /// adds the time taken to create a pipeline with this cache, may be called from any thread
+    void addCreateTime(const double seconds);
+
+    Stats getStats() const;
+
+    const std::string& getPath() const
+    {
+        return path;
+    }
+
+private:
+    /// checks the file header and the vulkan header of the data against this device
+    bool isValid(const uint8_t* file, const size_t fileSize) const;
+
+private:
+    vk::Device device;
+    vk::PipelineCache cache;
+
+    vk::PhysicalDeviceProperties deviceProps;
+    std::string path;
+
+    bool warm = false;
+    size_t loadedBytes = 0;
+
+    std::atomic<size_t> pipelineCount {0};
+    std::atomic<uint64_t> createNs {0};
+};
+
+} // namespace VulkanAPI
@@ -0,0 +1,348 @@
+#include "PipelineRegistry.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Logger.h"
+#include "Utility/Timer.h"
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+namespace VulkanAPI
+{
+
+namespace
+{
+
+/// FNV-1a over the bytes of the values added - only used with types that have no padding
+class StateHasher
+{
+public:
+    template <typename T>
+    void add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be hashed");
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        addBytes(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    void addArray(const std::vector<T>& values)
+    {
+        add(values.size());
+        for (const T& value : values)
+        {
+            add(value);
+        }
+    }
+
+    void addBytes(const void* data, const size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    uint64_t get() const
+    {
+        return hash;
+    }
+
+private:
+    uint64_t hash = 14695981039346656037ull;
+};
+
+} // namespace
+
+// ================ pipeline description ===========================
+
+bool PipelineDesc::operator==(const PipelineDesc& other) const
+{
+    return stages == other.stages && vertexAttrs == other.vertexAttrs &&
+        vertexBindings == other.vertexBindings && topology == other.topology &&
+        primRestart == other.primRestart && polygonMode == other.polygonMode &&
+        cullMode == other.cullMode && frontFace == other.frontFace &&
+        depthTest == other.depthTest && depthWrite == other.depthWrite &&
+        depthCompareOp == other.depthCompareOp && colourAttachs == other.colourAttachs &&
+        dynamicStates == other.dynamicStates && width == other.width &&
+        height == other.height && layout == other.layout && renderpass == other.renderpass &&
+        subpass == other.subpass;
+}
+
+size_t PipelineDesc::hash() const
+{
+    StateHasher hasher;
+    hasher.add(stages.size());
+    for (const Stage& stage : stages)
+    {
+        hasher.add(stage.stage);
+        hasher.add(static_cast<VkShaderModule>(stage.module));
+        hasher.addBytes(stage.entryPoint.data(), stage.entryPoint.size());
+    }
+    hasher.addArray(vertexAttrs);
+    hasher.addArray(vertexBindings);
+    hasher.add(topology);
+    hasher.add(primRestart);
+    hasher.add(polygonMode);
+    hasher.add(static_cast<VkCullModeFlags>(cullMode));
+    hasher.add(frontFace);
+    hasher.add(depthTest);
+    hasher.add(depthWrite);
+    hasher.add(depthCompareOp);
+    hasher.add(colourAttachs.size());
+    for (const vk::PipelineColorBlendAttachmentState& attach : colourAttachs)
+    {
+        hasher.add(static_cast<const VkPipelineColorBlendAttachmentState&>(attach));
+    }
+    hasher.addArray(dynamicStates);
+    hasher.add(width);
+    hasher.add(height);
+    hasher.add(static_cast<VkPipelineLayout>(layout));
+    hasher.add(static_cast<VkRenderPass>(renderpass));
+    hasher.add(subpass);
+    return static_cast<size_t>(hasher.get());
+}
+
+// ================ registry ===========================
+
+PipelineRegistry::PipelineRegistry(VkContext& ctx)
+    : context(ctx)
+{
+}
+
+PipelineRegistry::~PipelineRegistry()
+{
+    destroy();
+}
+
+bool PipelineRegistry::prepare()
+{
+    assert(!compileThread.joinable());
+    stopThread = false;
+    compileThread = std::thread(&PipelineRegistry::compileThreadMain, this);
+    return true;
+}
+
+void PipelineRegistry::destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock {mutex};
+        stopThread = true;
+    }
+    queueCondition.notify_all();
+    if (compileThread.joinable())
+    {
+        compileThread.join();
+    }
+
+    for (auto& iter : entries)
+    {
+        if (iter.second.pipeline)
+        {
+            context.device.destroyPipeline(iter.second.pipeline, nullptr);
+        }
+    }
+    entries.clear();
+    compileQueue.clear();
+}
+
+PipelineRegistry::Entry& PipelineRegistry::findEntry(const PipelineDesc& desc, bool& inserted)
+{
+    // the description is only copied if it's new
+    auto result = entries.try_emplace(desc);
+    inserted = result.second;
+    Entry& entry = result.first->second;
+    if (inserted)
+    {
+        entry.desc = &result.first->first;
+        ++misses;
+    }
+    else
+    {
+        ++hits;
+    }
+    return entry;
+}
+
+void PipelineRegistry::compileEntry(Entry& entry, std::unique_lock<std::mutex>& lock)
+{
+    entry.state = State::Compiling;
+    lock.unlock();
+    vk::Pipeline pipeline = compile(*entry.desc);
+    lock.lock();
+
+    entry.pipeline = pipeline;
+    entry.state = pipeline ? State::Ready : State::Failed;
+    readyCondition.notify_all();
+}
+
+vk::Pipeline PipelineRegistry::get(const PipelineDesc& desc)
+{
+    std::unique_lock<std::mutex> lock {mutex};
+    bool inserted;
+    Entry& entry = findEntry(desc, inserted);
+
+    // a queued compile which hasn't started yet is taken over rather than waited on
+    if (entry.state == State::Queued)
+    {
+        compileEntry(entry, lock);
+    }
+    else
+    {
+        readyCondition.wait(lock, [&entry]() { return entry.state != State::Compiling; });
+    }
+    return entry.pipeline;
+}
+
+vk::Pipeline PipelineRegistry::request(const PipelineDesc& desc)
+{
+    std::unique_lock<std::mutex> lock {mutex};
+    bool inserted;
+    Entry& entry = findEntry(desc, inserted);
+    if (inserted)
+    {
+        compileQueue.emplace_back(&entry);
+        lock.unlock();
+        queueCondition.notify_one();
+        return {};
+    }
+    return entry.state == State::Ready ? entry.pipeline : vk::Pipeline {};
+}
+
+PipelineRegistry::Stats PipelineRegistry::getStats() const
+{
+    std::lock_guard<std::mutex> lock {mutex};
+    Stats stats;
+    stats.pipelineCount = entries.size();
+    stats.hits = hits;
+    stats.misses = misses;
+    for (const auto& iter : entries)
+    {
+        const State state = iter.second.state;
+        stats.pending += state == State::Queued || state == State::Compiling;
+        stats.failed += state == State::Failed;
+    }
+    return stats;
+}
+
+void PipelineRegistry::compileThreadMain()
+{
+    std::unique_lock<std::mutex> lock {mutex};
+    while (true)
+    {
+        queueCondition.wait(lock, [this]() { return stopThread || !compileQueue.empty(); });
+        if (stopThread)
+        {
+            return;
+        }
+
+        Entry* entry = compileQueue.front();
+        compileQueue.pop_front();
+
+        // may have already been compiled by a call to get
+        if (entry->state == State::Queued)
+        {
+            compileEntry(*entry, lock);
+        }
+    }
+}
+
+vk::Pipeline PipelineRegistry::compile(const PipelineDesc& desc)
+{
+    // ============== vertex input =====================
+    vk::PipelineVertexInputStateCreateInfo vertInputState(
+        {},
+        static_cast<uint32_t>(desc.vertexBindings.size()),
+        desc.vertexBindings.empty() ? nullptr : desc.vertexBindings.data(),
+        static_cast<uint32_t>(desc.vertexAttrs.size()),
+        desc.vertexAttrs.empty() ? nullptr : desc.vertexAttrs.data());
+
+    // ============== primitive topology =====================
+    vk::PipelineInputAssemblyStateCreateInfo assemblyState;
+    assemblyState.topology = desc.topology;
+    assemblyState.primitiveRestartEnable = desc.primRestart;
+
+    // ============== multi-sample state =====================
+    vk::PipelineMultisampleStateCreateInfo sampleState;
+
+    // ============== depth/stencil state ====================
+    vk::PipelineDepthStencilStateCreateInfo depthStencilState;
+    depthStencilState.depthTestEnable = desc.depthTest;
+    depthStencilState.depthWriteEnable = desc.depthWrite;
+    depthStencilState.depthCompareOp = desc.depthCompareOp;
+    depthStencilState.stencilTestEnable = VK_FALSE;
+
+    // ============ raster state =======================
+    vk::PipelineRasterizationStateCreateInfo rasterState;
+    rasterState.cullMode = desc.cullMode;
+    rasterState.frontFace = desc.frontFace;
+    rasterState.polygonMode = desc.polygonMode;
+    rasterState.lineWidth = 1.0f;
+
+    // ============ dynamic states ====================
+    vk::PipelineDynamicStateCreateInfo dynamicCreateState;
+    dynamicCreateState.dynamicStateCount = static_cast<uint32_t>(desc.dynamicStates.size());
+    dynamicCreateState.pDynamicStates = desc.dynamicStates.data();
+
+    // =============== viewport state ====================
+    vk::PipelineViewportStateCreateInfo viewportState;
+    vk::Viewport viewPort(
+        0.0f, 0.0f, static_cast<float>(desc.width), static_cast<float>(desc.height), 0.0f, 1.0f);
+    vk::Rect2D scissor(vk::Offset2D(0, 0), vk::Extent2D(desc.width, desc.height));
+    viewportState.pViewports = &viewPort;
+    viewportState.viewportCount = 1;
+    viewportState.pScissors = &scissor;
+    viewportState.scissorCount = 1;
+
+    // ============= colour attachment =================
+    vk::PipelineColorBlendStateCreateInfo colourBlendState;
+    colourBlendState.attachmentCount = static_cast<uint32_t>(desc.colourAttachs.size());
+    colourBlendState.pAttachments = desc.colourAttachs.data();
+
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderData;
+    for (const PipelineDesc::Stage& stage : desc.stages)
+    {
+        shaderData.emplace_back(vk::PipelineShaderStageCreateInfo(
+            {}, stage.stage, stage.module, stage.entryPoint.c_str()));
+    }
+
+    // ================= create the pipeline =======================
+    vk::GraphicsPipelineCreateInfo createInfo(
+        {},
+        static_cast<uint32_t>(shaderData.size()),
+        shaderData.data(),
+        &vertInputState,
+        &assemblyState,
+        nullptr,
+        &viewportState,
+        &rasterState,
+        &sampleState,
+        &depthStencilState,
+        &colourBlendState,
+        &dynamicCreateState,
+        desc.layout,
+        desc.renderpass,
+        desc.subpass,
+        nullptr,
+        0);
+
+    // the cache is internally synchronised, so may be used by the compile thread and the
+    // render thread at once
+    vk::Pipeline pipeline;
+    Util::Timer<Util::NanoSeconds> timer;
+    const vk::Result result = context.device.createGraphicsPipelines(
+        context.pipelineCache.get(), 1, &createInfo, nullptr, &pipeline);
+    context.pipelineCache.addCreateTime(timer.getElapsedSeconds());
+    if (result != vk::Result::eSuccess)
+    {
+        LOGGER_ERROR("Unable to create a graphics pipeline, error %i.", static_cast<int>(result));
+        return {};
+    }
+    return pipeline;
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "Vulkan/Common.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief Everything which determines the compiled pipeline. Two descriptions which compare equal
+ * produce identical pipelines, so they can share one.
+ */
+struct PipelineDesc
+{
+    struct Stage
+    {
+        vk::ShaderStageFlagBits stage = vk::ShaderStageFlagBits::eVertex;
+        vk::ShaderModule module;
+        std::string entryPoint = "main";
+
+        bool operator==(const Stage& other) const
+        {
+            return stage == other.stage && module == other.module &&
+                entryPoint == other.entryPoint;
+        }
+    };
+
+    std::vector<Stage> stages;
+
+    /// as returned by **Pipeline::updateVertexInput**, sorted by location
+    std::vector<vk::VertexInputAttributeDescription> vertexAttrs;
+    std::vector<vk::VertexInputBindingDescription> vertexBindings;
+
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+    bool primRestart = false;
+
+    vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+    vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace frontFace = vk::FrontFace::eCounterClockwise;
+
+    bool depthTest = true;
+    bool depthWrite = false;
+    vk::CompareOp depthCompareOp = vk::CompareOp::eLessOrEqual;
+
+    std::vector<vk::PipelineColorBlendAttachmentState> colourAttachs;
+    std::vector<vk::DynamicState> dynamicStates;
+
+    /// the viewport and scissor extents - ignored if they are dynamic states
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    vk::PipelineLayout layout;
+    vk::RenderPass renderpass;
+    uint32_t subpass = 0;
+
+    bool operator==(const PipelineDesc& other) const;
+
+    /// a hash of every field compared by the equality operator
+    size_t hash() const;
+
+    struct Hasher
+    {
+        size_t operator()(const PipelineDesc& desc) const
+        {
+            return desc.hash();
+        }
+    };
+};
+
+/**
+ * @brief Owns all graphics pipelines, shared between every user with the same description. i.e.
+ * the point cloud materials which only differ in their uniforms share a single pipeline.
+ *
+ * Pipelines which aren't yet compiled can either be compiled on the calling thread with **get**,
+ * or requested with **request**, which queues the compile on a background thread and returns a
+ * null pipeline until it has completed. The latter means switching to a new state, such as a
+ * different colouring mode, doesn't stall the frame - the caller keeps drawing with the previous
+ * pipeline until the new one is ready.
+ *
+ * The pipelines are only destroyed with the registry, which must happen before the device is
+ * destroyed.
+ */
+class PipelineRegistry
+{
+public:
+    struct Stats
+    {
+        /// unique descriptions, including those still compiling or which failed
+        size_t pipelineCount = 0;
+
+        /// lookups which found an existing pipeline, compiled or not
+        size_t hits = 0;
+        size_t misses = 0;
+
+        /// pipelines queued or being compiled in the background
+        size_t pending = 0;
+
+        size_t failed = 0;
+    };
+
+    explicit PipelineRegistry(VkContext& context);
+    ~PipelineRegistry();
+
+    // not copyable
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+    /// starts the background compile thread
+    bool prepare();
+
+    /// stops the compile thread and destroys all pipelines
+    void destroy();
+
+    /**
+     * @brief Returns the pipeline for the description, compiling it on the calling thread if it
+     * doesn't exist. If it's already being compiled in the background, waits for it instead.
+     * @return A null pipeline if compilation failed
+     */
+    vk::Pipeline get(const PipelineDesc& desc);
+
+    /**
+     * @brief Returns the pipeline for the description if it has been compiled, otherwise queues
+     * it to be compiled in the background and returns a null pipeline. Never blocks on a compile.
+     */
+    vk::Pipeline request(const PipelineDesc& desc);
+
+    Stats getStats() const;
+
+private:
+    enum class State : uint8_t
+    {
+        Queued,
+        Compiling,
+        Ready,
+        Failed
+    };
+
+    struct Entry
+    {
+        const PipelineDesc* desc = nullptr;
+        vk::Pipeline pipeline;
+        State state = State::Queued;
+    };
+
+    /// finds or adds the entry for the description, must be called with the lock held
+    Entry& findEntry(const PipelineDesc& desc, bool& inserted);
+
+    /// compiles the entry outside of the lock, which is held on entry and exit
+    void compileEntry(Entry& entry, std::unique_lock<std::mutex>& lock);
+
+    vk::Pipeline compile(const PipelineDesc& desc);
+
+    void compileThreadMain();
+
+private:
+    VkContext& context;
+
+    /// guards the entries and the queue, the entries are never removed until destroyed so
+    /// references to them remain valid
+    mutable std::mutex mutex;
+    std::unordered_map<PipelineDesc, Entry, PipelineDesc::Hasher> entries;
+
+    /// signalled when a pipeline has been compiled
+    std::condition_variable readyCondition;
+
+    std::thread compileThread;
+    std::condition_variable queueCondition;
+    std::deque<Entry*> compileQueue;
+    bool stopThread = false;
+
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+} // namespace VulkanAPI
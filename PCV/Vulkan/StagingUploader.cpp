@@ -0,0 +1,184 @@
+#include "StagingUploader.h"
+
+#include "Vulkan/VkContext.h"
+
+#include "Utility/Timer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace VulkanAPI
+{
+
+StagingUploader::StagingUploader(VkContext& ctx)
+    : context(ctx)
+{
+}
+
+StagingUploader::~StagingUploader()
+{
+    for (Slot& slot : slots)
+    {
+        waitForSlot(slot);
+        if (slot.mapped)
+        {
+            slot.staging->unmap();
+        }
+        if (slot.fence)
+        {
+            context.device.destroyFence(slot.fence, nullptr);
+        }
+    }
+
+    // destroying the pool frees the command buffers
+    if (cmdPool)
+    {
+        context.device.destroyCommandPool(cmdPool, nullptr);
+    }
+}
+
+bool StagingUploader::prepare(const vk::DeviceSize stagingCapacity, const uint32_t framesInFlight)
+{
+    assert(slots.empty());
+
+    vk::CommandPoolCreateInfo poolInfo(
+        vk::CommandPoolCreateFlagBits::eResetCommandBuffer, context.queueFamilyIndex.graphics);
+    VK_CHECK_RESULT(context.device.createCommandPool(&poolInfo, nullptr, &cmdPool));
+
+    slots.resize(std::max<uint32_t>(framesInFlight, 1));
+    for (Slot& slot : slots)
+    {
+        vk::CommandBufferAllocateInfo allocInfo(cmdPool, vk::CommandBufferLevel::ePrimary, 1);
+        VK_CHECK_RESULT(context.device.allocateCommandBuffers(&allocInfo, &slot.cmdBuffer));
+
+        vk::FenceCreateInfo fenceInfo;
+        VK_CHECK_RESULT(context.device.createFence(&fenceInfo, nullptr, &slot.fence));
+    }
+
+    capacity = stagingCapacity;
+    return createStaging();
+}
+
+bool StagingUploader::createStaging()
+{
+    for (Slot& slot : slots)
+    {
+        if (slot.mapped)
+        {
+            slot.staging->unmap();
+            slot.mapped = nullptr;
+        }
+
+        slot.staging = std::make_unique<Buffer>();
+        if (!slot.staging->create(
+                context,
+                capacity,
+                vk::BufferUsageFlagBits::eTransferSrc,
+                vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent))
+        {
+            capacity = 0;
+            return false;
+        }
+        slot.mapped = static_cast<uint8_t*>(slot.staging->map());
+    }
+    return true;
+}
+
+void StagingUploader::waitForSlot(Slot& slot)
+{
+    if (slot.submitted)
+    {
+        VK_CHECK_RESULT(context.device.waitForFences(1, &slot.fence, VK_TRUE, UINT64_MAX));
+        VK_CHECK_RESULT(context.device.resetFences(1, &slot.fence));
+        slot.submitted = false;
+    }
+}
+
+bool StagingUploader::reserve(const vk::DeviceSize newCapacity)
+{
+    assert(!recording);
+    if (newCapacity <= capacity)
+    {
+        return true;
+    }
+
+    // the staging memory may still be read by the submissions in flight
+    for (Slot& slot : slots)
+    {
+        waitForSlot(slot);
+    }
+    capacity = newCapacity;
+    return createStaging();
+}
+
+void StagingUploader::begin()
+{
+    current = (current + 1) % slots.size();
+    Slot& slot = slots[current];
+
+    Util::Timer<Util::NanoSeconds> timer;
+    waitForSlot(slot);
+    waitMs = timer.getElapsedSeconds() * 1000.0;
+    offset = 0;
+}
+
+bool StagingUploader::upload(
+    Buffer& dst, const void* data, const vk::DeviceSize size, const vk::DeviceSize dstOffset)
+{
+    assert(dstOffset + size <= dst.getSize());
+    Slot& slot = slots[current];
+
+    // keep each copy aligned for the transfer
+    const vk::DeviceSize alignedOffset = alignOffset(offset);
+    if (alignedOffset + size > capacity)
+    {
+        return false;
+    }
+
+    if (!recording)
+    {
+        vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+        slot.cmdBuffer.begin(beginInfo);
+        recording = true;
+    }
+
+    std::memcpy(slot.mapped + alignedOffset, data, size);
+
+    vk::BufferCopy region(alignedOffset, dstOffset, size);
+    slot.cmdBuffer.copyBuffer(slot.staging->get(), dst.get(), 1, &region);
+
+    offset = alignedOffset + size;
+    return true;
+}
+
+void StagingUploader::submit()
+{
+    if (!recording)
+    {
+        return;
+    }
+    Slot& slot = slots[current];
+
+    // the uploaded buffers are read as vertex data by the draws which follow
+    vk::MemoryBarrier barrier(
+        vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eVertexAttributeRead);
+    slot.cmdBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eVertexInput,
+        {},
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr);
+    slot.cmdBuffer.end();
+    recording = false;
+
+    vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &slot.cmdBuffer, 0, nullptr);
+    VK_CHECK_RESULT(context.graphicsQueue.submit(1, &submitInfo, slot.fence));
+    slot.submitted = true;
+}
+
+} // namespace VulkanAPI
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Vulkan/Buffer.h"
+#include "Vulkan/Common.h"
+
+#include <memory>
+#include <vector>
+
+namespace VulkanAPI
+{
+// forward declearions
+struct VkContext;
+
+/**
+ * @brief Uploads data to device local buffers through persistently mapped, host visible staging
+ * buffers. The copies are recorded into a single command buffer which is submitted once per
+ * frame, so the capacity of the staging buffer also limits the bytes uploaded each frame.
+ *
+ * There is a staging buffer, command buffer and fence per frame in flight, used in turn, so
+ * **begin** only waits for the uploads submitted that many frames ago rather than the last ones.
+ */
+class StagingUploader
+{
+public:
+    explicit StagingUploader(VkContext& context);
+    ~StagingUploader();
+
+    // not copyable
+    StagingUploader(const StagingUploader&) = delete;
+    StagingUploader& operator=(const StagingUploader&) = delete;
+
+    /**
+     * @brief Creates the staging buffers and the command objects used for the transfers.
+     * @param capacity The size of each frame's staging buffer in bytes
+     * @param framesInFlight The number of frames whose uploads may be in flight at once
+     */
+    bool prepare(const vk::DeviceSize capacity, const uint32_t framesInFlight = 2);
+
+    /**
+     * @brief Grows the staging buffers so that a single upload of **capacity** bytes will fit.
+     * Must not be called between **begin** and **submit**. Waits for all uploads in flight if
+     * the buffers are grown.
+     */
+    bool reserve(const vk::DeviceSize capacity);
+
+    /**
+     * @brief Moves to the next frame's staging buffer, waiting for the uploads last submitted
+     * from it to complete so the memory can be reused. Must be called before any uploads each
+     * frame.
+     */
+    void begin();
+
+    /**
+     * @brief Copies the data into the staging buffer and records a transfer into **dst**.
+     * @param dstOffset The byte offset within **dst** the data is copied to
+     * @return false if there isn't enough staging space left this frame
+     */
+    bool upload(
+        Buffer& dst,
+        const void* data,
+        const vk::DeviceSize size,
+        const vk::DeviceSize dstOffset = 0);
+
+    /// submits all recorded transfers to the graphics queue
+    void submit();
+
+    /// the largest upload which will still fit this frame, after aligning the next copy
+    vk::DeviceSize getFreeSpace() const
+    {
+        const vk::DeviceSize alignedOffset = alignOffset(offset);
+        return alignedOffset < capacity ? capacity - alignedOffset : 0;
+    }
+
+    vk::DeviceSize getCapacity() const
+    {
+        return capacity;
+    }
+
+    /// the time spent in **begin** waiting on the fence of an earlier frame's uploads
+    double getWaitMs() const
+    {
+        return waitMs;
+    }
+
+private:
+    /// each copy starts on an aligned offset within the staging buffer
+    static vk::DeviceSize alignOffset(const vk::DeviceSize value)
+    {
+        return (value + 15) & ~vk::DeviceSize(15);
+    }
+
+    struct Slot
+    {
+        std::unique_ptr<Buffer> staging;
+        uint8_t* mapped = nullptr;
+
+        vk::CommandBuffer cmdBuffer;
+        vk::Fence fence;
+        bool submitted = false;
+    };
+
+    /// waits for the slot's last submission if it hasn't completed
+    void waitForSlot(Slot& slot);
+
+    /// (re)creates the staging buffer of each slot with the current capacity
+    bool createStaging();
+
+private:
+    VkContext& context;
+
+    std::vector<Slot> slots;
+    size_t current = 0;
+
+    /// the size of each slot's staging buffer
+    vk::DeviceSize capacity = 0;
+
+    /// the current write position in the current slot's staging buffer
+    vk::DeviceSize offset = 0;
+
+    vk::CommandPool cmdPool;
+
+    bool recording = false;
+    double waitMs = 0.0;
+};
+
+} // namespace VulkanAPI
@@ -164,6 +164,37 @@ void Swapchain::prepareImageViews(VkContext& context, const vk::SurfaceFormatKHR
     }
 }
 
+bool Swapchain::acquireNextImage(
+    VkContext& context,
+    vk::Semaphore imageAcquired,
+    vk::Fence frameFence,
+    uint32_t& imageIndex)
+{
+    const vk::Result result = context.device.acquireNextImageKHR(
+        swapchain, UINT64_MAX, imageAcquired, {}, &imageIndex);
+    if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
+    {
+        return false;
+    }
+
+    SwapchainContext& image = contexts[imageIndex];
+    if (image.frameFence && image.frameFence != frameFence)
+    {
+        VK_CHECK_RESULT(
+            context.device.waitForFences(1, &image.frameFence, VK_TRUE, UINT64_MAX));
+    }
+    image.frameFence = frameFence;
+    return true;
+}
+
+bool Swapchain::present(
+    VkContext& context, const uint32_t imageIndex, vk::Semaphore renderComplete)
+{
+    vk::PresentInfoKHR presentInfo(1, &renderComplete, 1, &swapchain, &imageIndex, nullptr);
+    const vk::Result result = context.presentQueue.presentKHR(&presentInfo);
+    return result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR;
+}
+
 ImageView& Swapchain::getImageView(const uint8_t index)
 {
     assert(index < contexts.size());
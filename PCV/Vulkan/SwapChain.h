@@ -22,8 +22,9 @@ class VkDriver;
 struct SwapchainContext
 {
     ImageView view;
-    vk::CommandBuffer commands;
-    vk::Fence fence;
+
+    /// the fence of the frame in flight which last rendered to this image - owned by the frame
+    vk::Fence frameFence;
 };
 
 class Swapchain
@@ -54,6 +55,25 @@ public:
     static Platform::SurfaceWrapper
     createSurface(OmegaEngine::OEWindowInstance* window, vk::Instance& instance);
 
+    /**
+     * @brief Acquires the next image to render into. There may be fewer images than frames in
+     * flight, so if the image is still being rendered to by an earlier frame, waits for it.
+     * @param imageAcquired Signalled once the presentation engine has released the image
+     * @param frameFence The fence of the frame which will render to the image
+     * @return false if the swapchain is out of date and must be recreated
+     */
+    bool acquireNextImage(
+        VkContext& context,
+        vk::Semaphore imageAcquired,
+        vk::Fence frameFence,
+        uint32_t& imageIndex);
+
+    /**
+     * @brief Queues the image for presentation once **renderComplete** has been signalled.
+     * @return false if the swapchain is out of date and must be recreated
+     */
+    bool present(VkContext& context, const uint32_t imageIndex, vk::Semaphore renderComplete);
+
     vk::SwapchainKHR& get();
     uint32_t getExtentsHeight() const;
     uint32_t getExtentsWidth() const;
@@ -211,7 +211,13 @@ bool VkContext::createInstance(const char** glfwExtension, uint32_t extCount)
         static_cast<uint32_t>(extensions.size()),
         extensions.data());
 
-    VK_CHECK_RESULT(vk::createInstance(&createInfo, nullptr, &instance));
+    // there being no Vulkan driver is expected on headless machines such as build servers, so
+    // is reported to the caller rather than asserted on
+    if (vk::createInstance(&createInfo, nullptr, &instance) != vk::Result::eSuccess)
+    {
+        printf("Unable to create a Vulkan instance, no Vulkan driver was found.\n");
+        return false;
+    }
 
 #ifdef VULKAN_VALIDATION_DEBUG
     vk::DispatchLoaderDynamic dldi(instance);
@@ -310,8 +316,11 @@ bool VkContext::prepareDevice(const vk::SurfaceKHR windowSurface)
     // find queues for this gpu
     std::vector<vk::QueueFamilyProperties> queues = physical.getQueueFamilyProperties();
 
+    // without a surface there is nothing to present to, so only rendering offscreen is possible
+    headless = !windowSurface;
+
     // presentation queue
-    for (uint32_t c = 0; c < queues.size(); ++c)
+    for (uint32_t c = 0; !headless && c < queues.size(); ++c)
     {
         VkBool32 hasPresentionQueue = false;
         physical.getSurfaceSupportKHR(c, windowSurface, &hasPresentionQueue);
@@ -343,8 +352,14 @@ bool VkContext::prepareDevice(const vk::SurfaceKHR windowSurface)
         }
     }
 
+    if (headless)
+    {
+        queueFamilyIndex.present = queueFamilyIndex.graphics;
+    }
+
     // graphics and presentation queues are compulsory
-    if (queueFamilyIndex.present == VK_QUEUE_FAMILY_IGNORED)
+    if (queueFamilyIndex.graphics == VK_QUEUE_FAMILY_IGNORED ||
+        queueFamilyIndex.present == VK_QUEUE_FAMILY_IGNORED)
     {
         printf("Critcal error! Required queues not found.");
         return false;
@@ -371,12 +386,17 @@ bool VkContext::prepareDevice(const vk::SurfaceKHR windowSurface)
     // enable required device features
     auto reqFeatures = prepareFeatures();
 
-    const std::vector<const char*> swapChainExtension = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-
-    if (!findExtensionProperties(swapChainExtension[0], extensions))
+    // software drivers such as lavapipe may not expose the swapchain extension at all, so it's
+    // only required when presenting
+    std::vector<const char*> swapChainExtension;
+    if (!headless)
     {
-        printf("Critical error! Swap chain extension not found.");
-        return false;
+        swapChainExtension.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        if (!findExtensionProperties(swapChainExtension[0], extensions))
+        {
+            printf("Critical error! Swap chain extension not found.");
+            return false;
+        }
     }
 
     vk::DeviceCreateInfo createInfo(
@@ -386,7 +406,7 @@ bool VkContext::prepareDevice(const vk::SurfaceKHR windowSurface)
         static_cast<uint32_t>(requiredLayers.size()),
         requiredLayers.empty() ? nullptr : requiredLayers.data(),
         static_cast<uint32_t>(swapChainExtension.size()),
-        swapChainExtension.data(),
+        swapChainExtension.empty() ? nullptr : swapChainExtension.data(),
         &reqFeatures);
 
     VK_CHECK_RESULT(physical.createDevice(&createInfo, nullptr, &device));
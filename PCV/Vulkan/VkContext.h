@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Vulkan/Common.h"
+#include "Vulkan/PipelineCache.h"
+#include "Vulkan/PipelineRegistry.h"
 
 namespace VulkanAPI
 {
@@ -46,6 +48,8 @@ struct VkContext
 
     /**
      * @brief Sets up all the vulkan devices and queues.
+     * @param windowSurface If null, the device is created for offscreen rendering only - no
+     * presentation queue or swapchain extension is required
      */
     bool prepareDevice(const vk::SurfaceKHR windowSurface);
 
@@ -67,9 +71,19 @@ public:
     vk::Queue presentQueue;
     vk::Queue computeQueue;
 
+    /// set when the device was created without a surface, in which case the present queue is
+    /// the graphics queue and swapchains can't be created
+    bool headless = false;
+
     // supported extensions
     Extensions deviceExtensions;
 
+    /// used for all pipeline creation, persisted to disk between runs
+    PipelineCache pipelineCache;
+
+    /// all graphics pipelines, shared between users with identical state
+    PipelineRegistry pipelines {*this};
+
 private:
 
     // validation layers